@@ -14,7 +14,11 @@
 #include "blockchain/block_validator/eligible.hpp"
 #include "blockchain/block_validator/win_sectors.hpp"
 #include "blockchain/production/block_producer.hpp"
+#include "cbor_blake/ipld_any.hpp"
 #include "cbor_blake/ipld_version.hpp"
+#include "codec/cbor/light_reader/market_reader.hpp"
+#include "codec/cbor/light_reader/partition_reader.hpp"
+#include "codec/cbor/light_reader/sector_info_reader.hpp"
 #include "common/logger.hpp"
 #include "const.hpp"
 #include "crypto/bls/impl/bls_provider_impl.hpp"
@@ -53,6 +57,11 @@
 
 namespace fc::api {
   using connection_t = boost::signals2::connection;
+  using codec::cbor::light_reader::DealProposalView;
+  using codec::cbor::light_reader::DealStatesCursor;
+  using codec::cbor::light_reader::DealStateView;
+  using codec::cbor::light_reader::PartitionView;
+  using codec::cbor::light_reader::SectorInfoView;
   using markets::retrieval::DealProposalParams;
   using markets::retrieval::QueryResponse;
   using node::kNodeVersion;
@@ -625,6 +634,13 @@ namespace fc::api {
       // TODO(artyom-yurin): Make sure at least one of 'to' or 'from' is
       // defined
 
+      if (const auto &index{msg_waiter->msgIndex()}) {
+        if (index->covers(context.tipset, to_height)) {
+          return index->list(
+              match.from, match.to, to_height, context.tipset->height());
+        }
+      }
+
       auto matchFunc = [&](const UnsignedMessage &message) -> bool {
         if (match.to != message.to) {
           return false;
@@ -738,13 +754,56 @@ namespace fc::api {
         [=](auto &tipset_key) -> outcome::result<MarketDealMap> {
       OUTCOME_TRY(context, tipsetContext(tipset_key, false));
       OUTCOME_TRY(state, context.marketState());
+      // deals are read when response is written
       MarketDealMap map;
-      OUTCOME_TRY(state->proposals.visit(
-          [&](auto deal_id, auto &deal) -> outcome::result<void> {
-            OUTCOME_TRY(deal_state, state->states.get(deal_id));
-            map.emplace(std::to_string(deal_id), StorageDeal{deal, deal_state});
-            return outcome::success();
-          }));
+      map.visit = [state](const MarketDealMap::Visitor &visitor)
+          -> outcome::result<void> {
+        // states are read in deal id order with proposals, not looked up
+        const auto &proposals{state->proposals.amt};
+        const auto &states{state->states.amt};
+        const auto proposals_root{asBlake(proposals.cid())};
+        const auto states_root{asBlake(states.cid())};
+        if (!proposals_root || !states_root) {
+          return ERROR_TEXT("StateMarketDeals: unexpected deals root");
+        }
+        DealStatesCursor states_cursor{
+            std::make_shared<AnyAsCbIpld>(states.getIpld()), *states_root};
+        outcome::result<void> visited{outcome::success()};
+        auto parsed{codec::cbor::light_reader::marketDealProposals(
+            std::make_shared<AnyAsCbIpld>(proposals.getIpld()),
+            *proposals_root,
+            [&](uint64_t deal_id, const DealProposalView &view) {
+              bool found{};
+              DealStateView state_view;
+              if (!states_cursor.find(deal_id, found, state_view)) {
+                return false;
+              }
+              DealState deal_state{kChainEpochUndefined,
+                                   kChainEpochUndefined,
+                                   kChainEpochUndefined};
+              if (found) {
+                deal_state = {state_view.sector_start_epoch,
+                              state_view.last_updated_epoch,
+                              state_view.slash_epoch};
+              }
+              auto proposal{
+                  cbor_blake::cbDecodeT<vm::actor::builtin::types::Universal<
+                      vm::actor::builtin::types::market::DealProposal>>(
+                      proposals.getIpld(), view.raw)};
+              if (!proposal) {
+                visited = proposal.error();
+                return false;
+              }
+              visited = visitor(std::to_string(deal_id),
+                                StorageDeal{proposal.value(), deal_state});
+              return visited.has_value();
+            })};
+        OUTCOME_TRY(visited);
+        if (!parsed) {
+          return ERROR_TEXT("StateMarketDeals: deals parsing error");
+        }
+        return outcome::success();
+      };
       return map;
     };
     api->MarketAddBalance =
@@ -864,17 +923,43 @@ namespace fc::api {
       OUTCOME_TRY(state, context.minerState(miner));
       OUTCOME_TRY(deadlines, state->deadlines.get());
       OUTCOME_TRY(deadline, deadlines.due[_deadline].get());
+      // decode only sector bitsets of partitions
+      const auto &amt{deadline->partitions.amt};
+      const auto root{asBlake(amt.cid())};
+      if (!root) {
+        return ERROR_TEXT("StateMinerPartitions: unexpected partitions root");
+      }
       std::vector<Partition> parts;
-      OUTCOME_TRY(deadline->partitions.visit([&](auto, auto &v) {
-        parts.push_back({
-            v->sectors,
-            v->faults,
-            v->recoveries,
-            v->sectors - v->terminated,
-            v->sectors - v->terminated - v->faults,
-        });
-        return outcome::success();
-      }));
+      outcome::result<void> decoded{outcome::success()};
+      const auto visited{codec::cbor::light_reader::minerPartitions(
+          std::make_shared<AnyAsCbIpld>(amt.getIpld()),
+          *root,
+          [&](const PartitionView &view) {
+            decoded = [&]() -> outcome::result<void> {
+              OUTCOME_TRY(sectors,
+                          codec::cbor::decode<RleBitset>(view.sectors));
+              OUTCOME_TRY(faults, codec::cbor::decode<RleBitset>(view.faults));
+              OUTCOME_TRY(recoveries,
+                          codec::cbor::decode<RleBitset>(view.recoveries));
+              OUTCOME_TRY(terminated,
+                          codec::cbor::decode<RleBitset>(view.terminated));
+              auto live{sectors - terminated};
+              auto active{live - faults};
+              parts.push_back({
+                  std::move(sectors),
+                  std::move(faults),
+                  std::move(recoveries),
+                  std::move(live),
+                  std::move(active),
+              });
+              return outcome::success();
+            }();
+            return !decoded.has_error();
+          })};
+      OUTCOME_TRY(decoded);
+      if (!visited) {
+        return ERROR_TEXT("StateMinerPartitions: partitions parsing error");
+      }
       return parts;
     };
     api->StateMinerPower =
@@ -905,12 +990,34 @@ namespace fc::api {
       OUTCOME_TRY(context, tipsetContext(tipset_key, false));
       OUTCOME_TRY(state, context.minerState(address));
       std::vector<SectorOnChainInfo> sectors;
-      OUTCOME_TRY(state->sectors.sectors.visit([&](auto id, auto &info) {
-        if (!filter || filter->count(id)) {
-          sectors.push_back(*info);
-        }
-        return outcome::success();
-      }));
+      // filter by borrowed sector number, decode only returned sectors
+      const auto &amt{state->sectors.sectors.amt};
+      const auto root{asBlake(amt.cid())};
+      if (!root) {
+        return ERROR_TEXT("StateMinerSectors: unexpected sectors root");
+      }
+      outcome::result<void> decoded{outcome::success()};
+      const auto visited{codec::cbor::light_reader::minerSectors(
+          std::make_shared<AnyAsCbIpld>(amt.getIpld()),
+          *root,
+          [&](const SectorInfoView &view) {
+            if (filter && filter->count(view.sector) == 0) {
+              return true;
+            }
+            auto info{cbor_blake::cbDecodeT<
+                vm::actor::builtin::types::Universal<SectorOnChainInfo>>(
+                amt.getIpld(), view.raw)};
+            if (!info) {
+              decoded = info.error();
+              return false;
+            }
+            sectors.push_back(std::move(*info.value()));
+            return true;
+          })};
+      OUTCOME_TRY(decoded);
+      if (!visited) {
+        return ERROR_TEXT("StateMinerSectors: sectors parsing error");
+      }
       return sectors;
     };
     api->StateNetworkName = [=]() -> outcome::result<std::string> {
@@ -90,7 +90,27 @@ namespace fc::api {
     std::string error;
   };
 
-  using MarketDealMap = std::map<std::string, StorageDeal>;
+  /**
+   * Market deals by id.
+   * Server sets visit to read deals from market state while response is
+   * written, client decodes deals into map.
+   */
+  struct MarketDealMap : std::map<std::string, StorageDeal> {
+    using Visitor = std::function<outcome::result<void>(const std::string &,
+                                                        const StorageDeal &)>;
+
+    outcome::result<void> forEach(const Visitor &visitor) const {
+      if (visit) {
+        return visit(visitor);
+      }
+      for (const auto &[id, deal] : *this) {
+        OUTCOME_TRY(visitor(id, deal));
+      }
+      return outcome::success();
+    }
+
+    std::function<outcome::result<void>(const Visitor &)> visit;
+  };
 
   struct FileRef {
     std::string path;
@@ -0,0 +1,114 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "api/rpc/chunk_queue.hpp"
+
+#include <boost/optional.hpp>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "common/error_text.hpp"
+#include "common/logger.hpp"
+
+namespace fc::api::rpc {
+  namespace {
+    auto log() {
+      static common::Logger logger = common::createLogger("chunk_queue");
+      return logger.get();
+    }
+
+    /** Thrown to producer when queue is cancelled */
+    struct Cancelled {};
+  }  // namespace
+
+  struct ChunkQueue::State {
+    void push(Bytes chunk) {
+      std::unique_lock lock{mutex};
+      cv.wait(lock, [&] { return cancelled || chunks.size() < kMaxChunks; });
+      if (cancelled) {
+        throw Cancelled{};
+      }
+      chunks.push_back(std::move(chunk));
+      callWaiting(lock);
+    }
+
+    void finish(outcome::result<void> _result) {
+      std::unique_lock lock{mutex};
+      result = std::move(_result);
+      callWaiting(lock);
+    }
+
+    /** Calls waiting callback if chunk or result is ready, unlocks */
+    void callWaiting(std::unique_lock<std::mutex> &lock) {
+      if (!waiting) {
+        return;
+      }
+      outcome::result<Bytes> chunk{Bytes{}};
+      auto last{true};
+      if (result && !*result) {
+        chunk = result->error();
+      } else if (!chunks.empty()) {
+        chunk = std::move(chunks.front());
+        chunks.pop_front();
+        last = result && chunks.empty();
+        cv.notify_one();
+      } else if (!result) {
+        return;
+      }
+      auto cb{std::move(waiting)};
+      waiting = nullptr;
+      lock.unlock();
+      cb(std::move(chunk), last);
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<Bytes> chunks;
+    /** Set when producer returns */
+    boost::optional<outcome::result<void>> result;
+    bool cancelled{false};
+    OnChunk waiting;
+  };
+
+  std::shared_ptr<ChunkQueue> ChunkQueue::start(Produce produce) {
+    std::shared_ptr<ChunkQueue> queue{new ChunkQueue{}};
+    queue->state_ = std::make_shared<State>();
+    std::thread{[state{queue->state_}, produce{std::move(produce)}] {
+      outcome::result<void> result{outcome::success()};
+      try {
+        produce([&](Bytes chunk) { state->push(std::move(chunk)); });
+      } catch (const Cancelled &) {
+      } catch (const std::system_error &e) {
+        result = e.code();
+      } catch (const std::exception &e) {
+        log()->error("produce: {}", e.what());
+        result = ERROR_TEXT("ChunkQueue: produce failed");
+      }
+      state->finish(std::move(result));
+    }}.detach();
+    return queue;
+  }
+
+  ChunkQueue::~ChunkQueue() {
+    cancel();
+  }
+
+  void ChunkQueue::next(OnChunk cb) {
+    std::unique_lock lock{state_->mutex};
+    assert(!state_->waiting);
+    state_->waiting = std::move(cb);
+    state_->callWaiting(lock);
+  }
+
+  void ChunkQueue::cancel() {
+    std::unique_lock lock{state_->mutex};
+    state_->cancelled = true;
+    state_->waiting = nullptr;
+    state_->chunks.clear();
+    state_->cv.notify_all();
+  }
+}  // namespace fc::api::rpc
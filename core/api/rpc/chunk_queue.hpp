@@ -0,0 +1,61 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include "common/bytes.hpp"
+#include "common/outcome.hpp"
+
+namespace fc::api::rpc {
+  /**
+   * Chunks of large response, produced on own thread while they are written.
+   * Producer waits while kMaxChunks chunks are not taken, so slow client
+   * doesn't make server keep whole response in memory.
+   * Producer is stopped when queue is destroyed.
+   */
+  class ChunkQueue {
+   public:
+    using Sink = std::function<void(Bytes)>;
+    /** Passes chunks to sink, throws on error */
+    using Produce = std::function<void(const Sink &)>;
+    /**
+     * Receives next chunk, or error.
+     * Last chunk is marked, it may be empty.
+     */
+    using OnChunk = std::function<void(outcome::result<Bytes>, bool last)>;
+
+    static constexpr size_t kMaxChunks{2};
+
+    /** Starts producer thread */
+    static std::shared_ptr<ChunkQueue> start(Produce produce);
+
+    ChunkQueue(const ChunkQueue &) = delete;
+    ChunkQueue(ChunkQueue &&) = delete;
+    ChunkQueue &operator=(const ChunkQueue &) = delete;
+    ChunkQueue &operator=(ChunkQueue &&) = delete;
+    ~ChunkQueue();
+
+    /**
+     * Calls cb with next chunk when it is ready.
+     * Called again only after cb.
+     * cb is called on caller or producer thread.
+     */
+    void next(OnChunk cb);
+
+    /** Stops producer, remaining chunks are not needed */
+    void cancel();
+
+   private:
+    struct State;
+
+    ChunkQueue() = default;
+
+    /** Shared with producer thread */
+    std::shared_ptr<State> state_;
+  };
+}  // namespace fc::api::rpc
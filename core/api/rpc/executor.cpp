@@ -0,0 +1,148 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "api/rpc/executor.hpp"
+
+#include <boost/asio/post.hpp>
+
+#include "common/prometheus/rpc.hpp"
+
+namespace fc::api::rpc {
+  namespace {
+    /** Releases slot when handler responds or drops respond */
+    struct Slot {
+      Slot() = default;
+      Slot(const Slot &) = delete;
+      Slot(Slot &&) = delete;
+      ~Slot() {
+        release();
+      }
+      Slot &operator=(const Slot &) = delete;
+      Slot &operator=(Slot &&) = delete;
+
+      void release() {
+        if (!released.exchange(true)) {
+          on_release();
+        }
+      }
+
+      std::function<void()> on_release;
+      std::atomic_bool released{false};
+    };
+  }  // namespace
+
+  Executor::Executor(size_t threads) : work{io.get_executor()} {
+    for (size_t i{0}; i < std::max<size_t>(threads, 1); ++i) {
+      this->threads.emplace_back([this] { io.run(); });
+    }
+  }
+
+  Executor::~Executor() {
+    io.stop();
+    for (auto &thread : threads) {
+      if (thread.joinable()) {
+        thread.join();
+      }
+    }
+  }
+
+  void Executor::wrap(Rpc &rpc,
+                      const std::map<std::string, MethodLimits> &limits) {
+    for (auto &[name, method] : rpc.ms) {
+      const auto it{limits.find(name)};
+      if (it == limits.end() || !method) {
+        continue;
+      }
+      std::unique_lock lock{mutex};
+      auto &queue{queues[name]};
+      if (!queue) {
+        queue = std::make_shared<Queue>();
+        queue->name = name;
+        queue->limits = it->second;
+      }
+      lock.unlock();
+      method = wrap(queue, std::move(method));
+    }
+  }
+
+  Method Executor::wrap(const QueuePtr &queue, Method f) {
+    return [weak{weak_from_this()}, queue, f{std::move(f)}](
+               const Value &value,
+               Respond respond,
+               MakeChan make_chan,
+               Send send,
+               const Permissions &perms) {
+      auto self{weak.lock()};
+      if (!self) {
+        return f(value, respond, make_chan, send, perms);
+      }
+      // request document is owned by caller
+      auto params{std::make_shared<Document>()};
+      static_cast<Value &>(*params) = Value{value, params->GetAllocator()};
+      auto task{[weak,
+                 queue,
+                 f,
+                 params,
+                 respond,
+                 make_chan{std::move(make_chan)},
+                 send{std::move(send)},
+                 perms,
+                 since{Since{}}] {
+        metricApiQueueWait()
+            .Add({{"endpoint", queue->name}}, kDefaultPrometheusMsBuckets)
+            .Observe(since.ms());
+        auto slot{std::make_shared<Slot>()};
+        slot->on_release = [weak, queue] {
+          if (auto self{weak.lock()}) {
+            self->release(queue);
+          }
+        };
+        f(
+            *params,
+            [respond, slot](auto &&value) {
+              respond(std::move(value));
+              slot->release();
+            },
+            make_chan,
+            send,
+            perms);
+      }};
+      if (!self->push(queue, std::move(task))) {
+        respond(Response::Error{kServerBusy, "Too many requests"});
+      }
+    };
+  }
+
+  bool Executor::push(const QueuePtr &queue, Task task) {
+    std::unique_lock lock{mutex};
+    if (queue->running < queue->limits.concurrency) {
+      ++queue->running;
+      boost::asio::post(io, std::move(task));
+    } else if (queue->waiting.size() < queue->limits.queue) {
+      queue->waiting.push_back(std::move(task));
+    } else {
+      return false;
+    }
+    metric(*queue);
+    return true;
+  }
+
+  void Executor::release(const QueuePtr &queue) {
+    std::unique_lock lock{mutex};
+    if (queue->waiting.empty()) {
+      --queue->running;
+    } else {
+      boost::asio::post(io, std::move(queue->waiting.front()));
+      queue->waiting.pop_front();
+    }
+    metric(*queue);
+  }
+
+  void Executor::metric(const Queue &queue) const {
+    metricApiQueueDepth()
+        .Add({{"endpoint", queue.name}})
+        .Set(static_cast<double>(queue.waiting.size()));
+  }
+}  // namespace fc::api::rpc
@@ -0,0 +1,74 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "api/rpc/rpc.hpp"
+
+namespace fc::api::rpc {
+  /** Limits of method offloaded to executor */
+  struct MethodLimits {
+    /** Max handlers running at once */
+    size_t concurrency{1};
+    /** Max requests waiting for free slot, others are rejected */
+    size_t queue{64};
+  };
+
+  /**
+   * Runs handlers of selected methods on worker threads, so slow methods
+   * don't block session io thread.
+   * Other methods are not wrapped and run on session io thread in request
+   * order.
+   * Handler holds its slot until it responds, so asynchronous handlers are
+   * limited too.
+   * Request params are copied, handler may respond from worker thread.
+   */
+  class Executor : public std::enable_shared_from_this<Executor> {
+   public:
+    explicit Executor(size_t threads);
+    Executor(const Executor &) = delete;
+    Executor(Executor &&) = delete;
+    ~Executor();
+    Executor &operator=(const Executor &) = delete;
+    Executor &operator=(Executor &&) = delete;
+
+    /**
+     * Wraps methods present in limits.
+     * Methods with same name share limits across wrapped rpc.
+     */
+    void wrap(Rpc &rpc, const std::map<std::string, MethodLimits> &limits);
+
+   private:
+    using Task = std::function<void()>;
+
+    struct Queue {
+      std::string name;
+      MethodLimits limits;
+      size_t running{};
+      std::deque<Task> waiting;
+    };
+    using QueuePtr = std::shared_ptr<Queue>;
+
+    Method wrap(const QueuePtr &queue, Method f);
+    /** Runs task or enqueues it, false if queue is full */
+    bool push(const QueuePtr &queue, Task task);
+    /** Starts next waiting task or frees slot */
+    void release(const QueuePtr &queue);
+    void metric(const Queue &queue) const;
+
+    std::mutex mutex;
+    std::map<std::string, QueuePtr> queues;
+    boost::asio::io_context io;
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type>
+        work;
+    std::vector<std::thread> threads;
+  };
+}  // namespace fc::api::rpc
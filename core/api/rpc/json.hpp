@@ -161,11 +161,11 @@ namespace fc::primitives {
   using codec::json::innerDecode;
 
   JSON_ENCODE(RleBitset) {
-    return encode(codec::rle::toRuns(v), allocator);
+    return encode(v.runs(), allocator);
   }
 
   JSON_DECODE(RleBitset) {
-    v = codec::rle::fromRuns(innerDecode<codec::rle::Runs64>(j));
+    v = RleBitset::fromRuns(innerDecode<RleBitset::Runs>(j));
   }
 
   JSON_ENCODE(TaskType) {
@@ -1533,6 +1533,9 @@ namespace fc::api {
         },
         [&](const Document &result) {
           Set(j, "result", Value{result, allocator}, allocator);
+        },
+        [&](const Response::Stream &stream) {
+          Set(j, "result", codec::json::populate(stream, allocator), allocator);
         });
     return j;
   }
@@ -1560,6 +1563,20 @@ namespace fc::api {
     v.message = AsString(Get(j, "message"));
   }
 
+  JSON_ENCODE(MarketDealMap) {
+    Value j{rapidjson::kObjectType};
+    OUTCOME_EXCEPT(v.forEach([&](auto &id, auto &deal) {
+      Set(j, id, deal, allocator);
+      return outcome::success();
+    }));
+    return j;
+  }
+
+  JSON_DECODE(MarketDealMap) {
+    codec::json::decode(static_cast<std::map<std::string, StorageDeal> &>(v),
+                        j);
+  }
+
   JSON_ENCODE(KeyInfo) {
     Value j{rapidjson::kObjectType};
     if (v.type == SignatureType::kBls) {
@@ -2145,3 +2162,46 @@ namespace fc::api {
   }
 
 }  // namespace fc::api
+
+namespace fc::codec::json {
+  template <>
+  struct JsonStreamT<api::Response> {
+    static void write(JsonWriter &writer, const api::Response &v) {
+      Document document;
+      writer.StartObject();
+      writer.Key("jsonrpc");
+      writer.String("2.0");
+      writer.Key("id");
+      encode(v.id, document.GetAllocator()).Accept(writer);
+      visit_in_place(
+          v.result,
+          [&](const api::Response::Error &error) {
+            writer.Key("error");
+            writeJson(writer, error);
+          },
+          [&](const Document &result) {
+            writer.Key("result");
+            result.Accept(writer);
+          },
+          [&](const api::Response::Stream &stream) {
+            writer.Key("result");
+            stream(writer);
+          });
+      writer.EndObject();
+    }
+  };
+
+  /** Writes deals one by one, while they are visited */
+  template <>
+  struct JsonStreamT<api::MarketDealMap> {
+    static void write(JsonWriter &writer, const api::MarketDealMap &v) {
+      writer.StartObject();
+      OUTCOME_EXCEPT(v.forEach([&](auto &id, auto &deal) {
+        writer.Key(id.data(), static_cast<rapidjson::SizeType>(id.size()));
+        writeJson(writer, deal);
+        return outcome::success();
+      }));
+      writer.EndObject();
+    }
+  };
+}  // namespace fc::codec::json
@@ -65,7 +65,7 @@ namespace fc::api {
               [respond{std::move(respond)},
                make_chan{std::move(make_chan)},
                send{std::move(send)}](
-                  const outcome::result<Result> &maybe_result) mutable {
+                  outcome::result<Result> maybe_result) mutable {
                 if (!maybe_result) {
                   return respond(Response::Error{
                       kInternalError,
@@ -92,7 +92,12 @@ namespace fc::api {
                       return true;
                     });
                   } else {
-                    respond(codec::json::encode(maybe_result.value()));
+                    auto result{std::make_shared<const Result>(
+                        std::move(maybe_result.value()))};
+                    respond(Response::Stream{
+                        [result](codec::json::JsonWriter &writer) {
+                          codec::json::writeJson(writer, *result);
+                        }});
                   }
                 } else {
                   respond(Document{});
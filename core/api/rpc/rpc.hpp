@@ -10,6 +10,7 @@
 #include <rapidjson/document.h>
 #include <boost/variant.hpp>
 
+#include "codec/json/stream.hpp"
 #include "common/outcome.hpp"
 #include "primitives/jwt/jwt.hpp"
 
@@ -30,13 +31,21 @@ namespace fc::api {
       int64_t code;
       std::string message;
     };
+    /**
+     * Writes result directly to output without building document.
+     * Owns result, large result is written on other thread after respond
+     * returns.
+     */
+    using Stream = std::function<void(codec::json::JsonWriter &)>;
 
     boost::optional<uint64_t> id;
-    boost::variant<Error, Document> result;
+    boost::variant<Error, Document, Stream> result;
   };
 
   constexpr auto kInvalidParams = INT64_C(-32602);
   constexpr auto kInternalError = INT64_C(-32603);
+  /** Implementation defined server error, method queue is full */
+  constexpr auto kServerBusy = INT64_C(-32000);
 
   constexpr auto kRpcChVal{"xrpc.ch.val"};
   constexpr auto kRpcChClose{"xrpc.ch.close"};
@@ -48,8 +57,8 @@ namespace fc::api::rpc {
   using rapidjson::Value;
 
   using OkCb = std::function<void(bool)>;
-  using Respond =
-      std::function<void(boost::variant<Response::Error, Document>)>;
+  using Respond = std::function<void(
+      boost::variant<Response::Error, Document, Response::Stream>)>;
   using Send = std::function<void(std::string, Document, OkCb)>;
   using MakeChan = std::function<uint64_t()>;
   using Permissions = std::vector<Permission>;
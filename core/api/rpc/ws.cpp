@@ -5,6 +5,8 @@
 
 #include "api/rpc/ws.hpp"
 
+#include <atomic>
+#include <deque>
 #include <queue>
 
 #include <boost/asio/deadline_timer.hpp>
@@ -13,6 +15,7 @@
 #include <boost/beast/websocket.hpp>
 
 #include <optional>
+#include "api/rpc/chunk_queue.hpp"
 #include "api/rpc/json.hpp"
 #include "codec/json/json.hpp"
 #include "common/logger.hpp"
@@ -22,6 +25,7 @@ namespace fc::api {
   namespace websocket = beast::websocket;
   namespace net = boost::asio;
   using primitives::jwt::kDefaultPermission;
+  using rpc::ChunkQueue;
   using rpc::OkCb;
 
   const common::Logger logger = common::createLogger("sector server");
@@ -32,6 +36,72 @@ namespace fc::api {
 
   const auto kChanCloseDelay{boost::posix_time::milliseconds(100)};
 
+  /** Thrown by sink when message doesn't fit one chunk */
+  struct MoreChunks {};
+
+  /**
+   * Encodes message which fits one chunk at once.
+   * @return none if message is larger than one chunk
+   */
+  template <typename T>
+  outcome::result<boost::optional<Bytes>> encodeSmall(const T &v) {
+    boost::optional<Bytes> result;
+    try {
+      codec::json::ChunkStream stream{[&](Bytes chunk) {
+        if (chunk.size() >= codec::json::ChunkStream::kChunkSize) {
+          throw MoreChunks{};
+        }
+        result = std::move(chunk);
+      }};
+      codec::json::writeJson(stream, v);
+    } catch (const MoreChunks &) {
+      return boost::none;
+    } catch (const std::system_error &e) {
+      return e.code();
+    } catch (const std::exception &e) {
+      logger->error("rpc encode: {}", e.what());
+      return ERROR_TEXT("rpc encode failed");
+    }
+    return result;
+  }
+
+  Response errorResponse(const Response &response, const std::error_code &e) {
+    return {response.id, Response::Error{kInternalError, e.message()}};
+  }
+
+  /** Copies message, so it may be written after caller returns */
+  std::shared_ptr<Response> own(const Response &v) {
+    auto copy{std::make_shared<Response>()};
+    copy->id = v.id;
+    visit_in_place(
+        v.result,
+        [&](const Response::Error &error) { copy->result = error; },
+        [&](const Document &result) {
+          Document document;
+          document.CopyFrom(result, document.GetAllocator());
+          copy->result = std::move(document);
+        },
+        [&](const Response::Stream &stream) { copy->result = stream; });
+    return copy;
+  }
+
+  std::shared_ptr<Request> own(const Request &v) {
+    auto copy{std::make_shared<Request>()};
+    copy->id = v.id;
+    copy->method = v.method;
+    copy->params.CopyFrom(v.params, copy->params.GetAllocator());
+    return copy;
+  }
+
+  /** Writes large message on producer thread */
+  template <typename T>
+  std::shared_ptr<ChunkQueue> produceLarge(const T &v) {
+    return ChunkQueue::start([v{own(v)}](const ChunkQueue::Sink &sink) {
+      codec::json::ChunkStream stream{sink};
+      codec::json::writeJson(stream, *v);
+    });
+  }
+
   void handleJSONRpcRequest(const Outcome<Document> &j_req,
                             const Rpc &rpc,
                             rpc::MakeChan make_chan,
@@ -98,12 +168,17 @@ namespace fc::api {
           rpc,
           [&]() { return next_channel++; },
           [self{shared_from_this()}](auto method, auto params, auto cb) {
+            // may be called from executor thread
             Request req{self->next_request++, method, std::move(params)};
             if (method == "xrpc.ch.close") {
-              self->timer.expires_from_now(kChanCloseDelay);
-              self->timer.async_wait(
-                  [self, req{std::move(req)}, cb{std::move(cb)}](auto) {
-                    self->_write(req, std::move(cb));
+              net::post(
+                  self->socket.get_executor(),
+                  [self, req{std::move(req)}, cb{std::move(cb)}]() mutable {
+                    self->timer.expires_from_now(kChanCloseDelay);
+                    self->timer.async_wait(
+                        [self, req{std::move(req)}, cb{std::move(cb)}](auto) {
+                          self->_write(req, std::move(cb));
+                        });
                   });
               return;
             }
@@ -115,43 +190,138 @@ namespace fc::api {
           });
     }
 
+    /**
+     * Message written as websocket frames.
+     * Small message is encoded at once and written as one frame, large one
+     * is produced while frames are written.
+     */
+    struct Pending {
+      Bytes small;
+      std::shared_ptr<ChunkQueue> chunks;
+      /** Error response to write instead, if nothing is written yet */
+      std::function<outcome::result<boost::optional<Bytes>>(
+          const std::error_code &)>
+          error;
+      bool started{false};
+      OkCb cb;
+    };
+
     template <typename T>
     void _write(const T &v, OkCb cb) {
-      boost::asio::post(socket.get_executor(),
-                        [self{shared_from_this()},
-                         buffer{*codec::json::format(encode(v))},
-                         cb{std::move(cb)}]() mutable {
-                          self->pending_writes.emplace(std::move(buffer),
-                                                       std::move(cb));
-                          self->_flush();
-                        });
+      auto pending{std::make_shared<Pending>()};
+      pending->cb = std::move(cb);
+      if constexpr (std::is_same_v<T, Response>) {
+        pending->error = [id{v.id}](const std::error_code &e) {
+          return encodeSmall(errorResponse({id, {}}, e));
+        };
+      }
+      auto small{encodeSmall(v)};
+      if (small && !small.value()) {
+        pending->chunks = produceLarge(v);
+      } else {
+        if (!small) {
+          logger->error("rpc encode: {}", small.error().message());
+          if (pending->error) {
+            small = pending->error(small.error());
+          }
+        }
+        if (!small || !small.value()) {
+          if (pending->cb) {
+            pending->cb(false);
+          }
+          return;
+        }
+        pending->small = std::move(*small.value());
+      }
+      net::post(socket.get_executor(),
+                [self{shared_from_this()}, pending{std::move(pending)}] {
+                  self->pending_writes.push(pending);
+                  self->_flush();
+                });
     }
 
     void _flush() {
-      if (!writing && !pending_writes.empty()) {
-        auto &[buffer, cb] = pending_writes.front();
-        writing = true;
-        socket.async_write(
-            net::buffer(buffer.data(), buffer.size()),
-            [self{shared_from_this()}, cb{std::move(cb)}](auto e, auto) {
-              self->writing = false;
-              auto ok = !e;
-              if (!ok) {
-                self->pending_writes = {};
-              } else {
-                self->pending_writes.pop();
-                self->_flush();
-              }
-              if (cb) {
-                cb(ok);
+      if (writing || closed || pending_writes.empty()) {
+        return;
+      }
+      writing = true;
+      auto pending{pending_writes.front()};
+      if (!pending->chunks) {
+        return _writeChunk(pending, std::move(pending->small), true);
+      }
+      // next chunk is produced only after previous one is written
+      pending->chunks->next([self{shared_from_this()}, pending](
+                                outcome::result<Bytes> chunk, bool last) {
+        // may be called from producer thread
+        net::post(self->socket.get_executor(),
+                  [self, pending, chunk{std::move(chunk)}, last]() mutable {
+                    self->_writeChunk(pending, std::move(chunk), last);
+                  });
+      });
+    }
+
+    void _writeChunk(const std::shared_ptr<Pending> &pending,
+                     outcome::result<Bytes> chunk,
+                     bool last) {
+      if (closed) {
+        return;
+      }
+      if (!chunk) {
+        logger->error("rpc response: {}", chunk.error().message());
+        if (!pending->started && pending->error) {
+          if (auto error{pending->error(chunk.error())};
+              error && error.value()) {
+            pending->chunks.reset();
+            return _writeChunk(pending, std::move(*error.value()), true);
+          }
+        }
+        // part of message is written, so error can't be sent as response
+        return _close(fmt::format(
+            "rpc error {}: {}", kInternalError, chunk.error().message()));
+      }
+      pending->started = true;
+      auto buffer{std::make_shared<Bytes>(std::move(chunk.value()))};
+      socket.async_write_some(
+          last,
+          net::buffer(buffer->data(), buffer->size()),
+          [self{shared_from_this()}, pending, buffer, last](auto e, auto) {
+            self->writing = false;
+            if (e) {
+              return self->_close({});
+            }
+            if (last) {
+              self->pending_writes.pop();
+              if (pending->cb) {
+                pending->cb(true);
               }
-            });
+            }
+            self->_flush();
+          });
+    }
+
+    /** Stops writing, producers of pending messages are cancelled */
+    void _close(std::string reason) {
+      if (closed) {
+        return;
       }
+      closed = true;
+      if (!pending_writes.empty() && pending_writes.front()->cb) {
+        pending_writes.front()->cb(false);
+      }
+      pending_writes = {};
+      // close reason is limited by websocket frame
+      constexpr size_t kMaxReason{123};
+      reason.resize(std::min(reason.size(), kMaxReason));
+      socket.async_close(
+          websocket::close_reason{websocket::close_code::internal_error,
+                                  reason},
+          [self{shared_from_this()}](auto) {});
     }
 
-    std::queue<std::pair<Bytes, OkCb>> pending_writes;
+    std::queue<std::shared_ptr<Pending>> pending_writes;
     bool writing{false};
-    uint64_t next_channel{}, next_request{};
+    bool closed{false};
+    std::atomic_uint64_t next_channel{}, next_request{};
     websocket::stream<tcp::socket> socket;
     net::deadline_timer timer;
     beast::flat_buffer buffer;
@@ -270,8 +440,17 @@ namespace fc::api {
                             [self{shared_from_this()}, fn{route.second}]() {
                               fn(self->request,
                                  [self](WrapperResponse response) {
-                                   self->w_response = std::move(response);
-                                   self->doWrite();
+                                   // may be called from executor thread
+                                   net::dispatch(
+                                       self->stream.get_executor(),
+                                       [self,
+                                        response{std::make_shared<
+                                            WrapperResponse>(
+                                            std::move(response))}] {
+                                         self->w_response =
+                                             std::move(*response);
+                                         self->doWrite();
+                                       });
                                  });
                             });
           is_handled = true;
@@ -301,6 +480,9 @@ namespace fc::api {
                      std::get_if<http::response<http::empty_body>>(
                          &(w_response.response))) {
         doWrite(*e_response);
+      } else if (auto *s_response =
+                     std::get_if<StreamResponse>(&(w_response.response))) {
+        doWrite(*s_response);
       }
     }
 
@@ -325,6 +507,55 @@ namespace fc::api {
           });
     }
 
+    void doWrite(StreamResponse &response) {
+      serializer =
+          std::make_shared<http::response_serializer<http::empty_body>>(
+              response.header);
+      http::async_write_header(
+          stream,
+          *serializer,
+          [self{shared_from_this()}](boost::beast::error_code ec, std::size_t) {
+            if (ec) {
+              logger->error("stream response header: {}", ec.message());
+              return self->doClose();
+            }
+            self->writeChunk();
+          });
+    }
+
+    void writeChunk() {
+      auto &response{std::get<StreamResponse>(w_response.response)};
+      response.read([self{shared_from_this()}](outcome::result<Bytes> chunk) {
+        // may be called from producer thread
+        net::dispatch(self->stream.get_executor(),
+                      [self, chunk{std::move(chunk)}]() mutable {
+                        self->onChunk(std::move(chunk));
+                      });
+      });
+    }
+
+    void onChunk(outcome::result<Bytes> chunk) {
+      if (!chunk) {
+        logger->error("stream response: {}", chunk.error().message());
+        return doClose();
+      }
+      if (chunk.value().empty()) {
+        return doClose();
+      }
+      auto buffer{std::make_shared<Bytes>(std::move(chunk.value()))};
+      net::async_write(
+          stream,
+          net::buffer(*buffer),
+          [self{shared_from_this()}, buffer](boost::beast::error_code ec,
+                                             std::size_t) {
+            if (ec) {
+              logger->error("stream response: {}", ec.message());
+              return self->doClose();
+            }
+            self->writeChunk();
+          });
+    }
+
     void doClose() {
       boost::system::error_code ec;
       stream.socket().shutdown(tcp::socket::shutdown_send, ec);
@@ -334,6 +565,7 @@ namespace fc::api {
     beast::flat_buffer buffer;
     http::request<http::string_body> request;
     WrapperResponse w_response;
+    std::shared_ptr<http::response_serializer<http::empty_body>> serializer;
     std::shared_ptr<Routes> routes;
     std::map<std::string, std::shared_ptr<Rpc>> rpc;
   };
@@ -417,15 +649,42 @@ namespace fc::api {
       // TODO(ortyomka): Make error if channel requested
       handleJSONRpcRequest(
           j_req, *rpc, {}, {}, perms, [cb, request](const Response &resp) {
-            auto data = *codec::json::format(encode(resp));
+            auto body{encodeSmall(resp)};
+            const auto *error{boost::get<Response::Error>(&resp.result)};
+            Response error_response;
+            if (!body) {
+              logger->error("rpc encode: {}", body.error().message());
+              error_response = errorResponse(resp, body.error());
+              error = &boost::get<Response::Error>(error_response.result);
+              body = encodeSmall(error_response);
+            }
+            if (!body) {
+              return cb(makeErrorResponse(
+                  request, http::status::internal_server_error));
+            }
+            if (!body.value()) {
+              // large result is written while it is produced
+              StreamResponse response;
+              response.header.version(request.version());
+              response.header.keep_alive(false);
+              response.header.set(http::field::content_type,
+                                  "application/json");
+              response.read = [chunks{produceLarge(resp)}](
+                                  const StreamResponse::ReadCb &cb) {
+                chunks->next([cb](outcome::result<Bytes> chunk, bool) {
+                  cb(std::move(chunk));
+                });
+              };
+              return cb(api::WrapperResponse(std::move(response)));
+            }
+
             http::response<http::string_body> response;
             response.version(request.version());
             response.keep_alive(false);
             response.set(http::field::content_type, "application/json");
-            response.body() = common::span::bytestr(data);
+            response.body() = common::span::bytestr(*body.value());
 
-            if (auto *error = boost::get<Response::Error>(&(resp.result));
-                error) {
+            if (error) {
               switch (error->code) {
                 case kInvalidRequest:
                   response.result(http::status::bad_request);
@@ -433,6 +692,9 @@ namespace fc::api {
                 case kMethodNotFound:
                   response.result(http::status::not_found);
                   break;
+                case kServerBusy:
+                  response.result(http::status::service_unavailable);
+                  break;
                 case kParseError:
                 case kInvalidParams:
                 case kInternalError:
@@ -11,6 +11,7 @@
 #include <variant>
 
 #include "api/rpc/rpc.hpp"
+#include "common/bytes.hpp"
 #include "primitives/jwt/jwt.hpp"
 
 namespace boost::asio {
@@ -24,9 +25,24 @@ namespace fc::api {
   using rpc::Permissions;
   using rpc::Rpc;
 
+  /**
+   * Response with body written by chunks, so body is not stored in memory or
+   * on disk. Handler sets Content-Length in header, or body ends when
+   * connection is closed.
+   */
+  struct StreamResponse {
+    /** Receives next body chunk, empty when body ended */
+    using ReadCb = std::function<void(outcome::result<Bytes>)>;
+
+    http::response<http::empty_body> header;
+    /** Reads next body chunk, cb may be called later from other thread */
+    std::function<void(const ReadCb &)> read;
+  };
+
   using ResponseType = std::variant<http::response<http::file_body>,
                                     http::response<http::string_body>,
-                                    http::response<http::empty_body>>;
+                                    http::response<http::empty_body>,
+                                    StreamResponse>;
 
   // Wrapper for any type of response
   // This is necessary in order not to lose the response before recording
@@ -5,6 +5,8 @@
 
 #include "blockchain/block_validator/validator.hpp"
 
+#include <thread>
+
 #include "blockchain/block_validator/eligible.hpp"
 #include "blockchain/block_validator/win_sectors.hpp"
 #include "cbor_blake/ipld_any.hpp"
@@ -17,11 +19,12 @@
 #include "crypto/bls/impl/bls_provider_impl.hpp"
 #include "primitives/block/rand.hpp"
 #include "primitives/tipset/chain.hpp"
+#include "storage/keystore/keystore.hpp"
 #include "storage/map_prefix/prefix.hpp"
 #include "vm/actor/builtin/states/miner/miner_actor_state.hpp"
 #include "vm/actor/builtin/states/storage_power/storage_power_actor_state.hpp"
 #include "vm/interpreter/interpreter.hpp"
-#include "vm/message/impl/message_signer_impl.hpp"
+#include "vm/message/signature_cache.hpp"
 #include "vm/message/valid.hpp"
 #include "vm/runtime/pricelist.hpp"
 #include "vm/state/impl/state_tree_impl.hpp"
@@ -29,13 +32,18 @@
 #include "vm/toolchain/toolchain.hpp"
 
 namespace fc::blockchain::block_validator {
+  /** Signed messages remembered as verified */
+  constexpr size_t kSignatureCacheSize{1 << 16};
+
   using primitives::Nonce;
   using primitives::block::MsgMeta;
   using primitives::sector::SectorInfo;
   using primitives::sector::toSectorInfo;
+  using storage::keystore::SignatureCheck;
   using vm::actor::kStoragePowerAddress;
   using vm::actor::builtin::states::MinerActorStatePtr;
   using vm::actor::builtin::states::PowerActorStatePtr;
+  using vm::message::SignatureCache;
   using vm::message::SignedMessage;
   using vm::message::UnsignedMessage;
   using vm::version::getNetworkVersion;
@@ -46,7 +54,9 @@ namespace fc::blockchain::block_validator {
         ipld{envx.ipld},
         ts_load{envx.ts_load},
         interpreter_cache{envx.interpreter_cache},
-        ts_branches_mutex{envx.ts_branches_mutex} {}
+        ts_branches_mutex{envx.ts_branches_mutex},
+        verify_pool{std::make_shared<boost::asio::thread_pool>(
+            std::max(1u, std::thread::hardware_concurrency()))} {}
 
   outcome::result<void> BlockValidator::validate(const TsBranchPtr &branch,
                                                  const BlockHeader &block) {
@@ -230,8 +240,9 @@ namespace fc::blockchain::block_validator {
     const auto network{getNetworkVersion(block.height)};
     const auto matcher{vm::toolchain::Toolchain::createAddressMatcher(network)};
     primitives::GasAmount gas_limit{};
-    static const vm::message::MessageSignerImpl signer{
-        storage::keystore::kDefaultKeystore};
+    static SignatureCache sig_cache{kSignatureCacheSize};
+    std::vector<SignatureCheck> sig_checks;
+    std::vector<CID> sig_cids;
     auto check{
         [&](const UnsignedMessage &msg, size_t size) -> outcome::result<void> {
           if (!validForBlockInclusion(
@@ -278,10 +289,24 @@ namespace fc::blockchain::block_validator {
           }
           OUTCOME_TRY(check(smsg.message, cbor.size()));
           OUTCOME_TRY(key, resolveKey(tree, smsg.message.from));
-          OUTCOME_TRY(signer.verify(key, smsg));
+          if (!sig_cache.has(cid, key)) {
+            OUTCOME_TRY(data, smsg.message.getCid().toBytes());
+            sig_checks.push_back({key, std::move(data), smsg.signature});
+            sig_cids.push_back(cid);
+          }
           OUTCOME_TRY(wmeta.secp_messages.append(cid));
           return outcome::success();
         }));
+    if (!sig_checks.empty()) {
+      const auto valid{storage::keystore::kDefaultKeystore->verifyBatch(
+          sig_checks, *verify_pool, std::thread::hardware_concurrency() + 1)};
+      for (size_t i{0}; i < sig_checks.size(); ++i) {
+        if (!valid[i]) {
+          return ERROR_TEXT("validateMessages: wrong signature");
+        }
+        sig_cache.add(sig_cids[i], sig_checks[i].address);
+      }
+    }
     OUTCOME_TRY(root, setCbor(null_ipld, wmeta));
     if (root != block.messages) {
       return ERROR_TEXT("validateMessages: wrong root");
@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <boost/asio/thread_pool.hpp>
+
 #include "common/outcome.hpp"
 #include "storage/buffer_map.hpp"
 #include "vm/runtime/env_context.hpp"
@@ -24,6 +26,8 @@ namespace fc::blockchain::block_validator {
     TsLoadPtr ts_load;
     std::shared_ptr<InterpreterCache> interpreter_cache;
     SharedMutexPtr ts_branches_mutex;
+    /** Verifies message signatures, shared by blocks validated in parallel */
+    std::shared_ptr<boost::asio::thread_pool> verify_pool;
 
     BlockValidator(MapPtr kv, const EnvironmentContext &envx);
 
@@ -60,6 +60,33 @@ namespace fc::cbor_blake {
     return key;
   }
 
+  /**
+   * Stores values, hashing encoded values together.
+   * @return keys in same order as values
+   */
+  template <typename T>
+  outcome::result<std::vector<CID>> setCborMany(CbIpldPtrIn ipld,
+                                                const std::vector<T> &values) {
+    static_assert(!std::is_same_v<T, primitives::block::BlockHeader>);
+    std::vector<Bytes> cbors;
+    cbors.reserve(values.size());
+    for (const auto &value : values) {
+      OUTCOME_TRY(cbor, cbEncodeT(value));
+      cbors.push_back(std::move(cbor));
+    }
+    const std::vector<BytesIn> inputs{cbors.begin(), cbors.end()};
+    std::vector<crypto::blake2b::Blake2b256Hash> hashes(cbors.size());
+    crypto::blake2b::blake2b_256_many(inputs, hashes);
+    std::vector<CID> keys;
+    keys.reserve(cbors.size());
+    for (size_t i{0}; i < cbors.size(); ++i) {
+      CID key{CbCid{hashes[i]}};
+      OUTCOME_TRY(ipld->set(key, std::move(cbors[i])));
+      keys.push_back(std::move(key));
+    }
+    return keys;
+  }
+
   template <typename T>
   struct CbVisitT {
     template <typename Visitor>
@@ -103,4 +130,5 @@ namespace fc::cbor_blake {
 namespace fc {
   using cbor_blake::getCbor;
   using cbor_blake::setCbor;
+  using cbor_blake::setCborMany;
 }  // namespace fc
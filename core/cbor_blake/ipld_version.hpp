@@ -12,7 +12,9 @@ namespace fc {
   struct IpldProxy : Ipld {
     IpldPtr ipld;
 
-    explicit IpldProxy(IpldPtr ipld) : ipld{std::move(ipld)} {}
+    explicit IpldProxy(IpldPtr ipld) : ipld{std::move(ipld)} {
+      node_cache = this->ipld->node_cache;
+    }
 
     outcome::result<bool> contains(const CID &key) const override {
       return ipld->contains(key);
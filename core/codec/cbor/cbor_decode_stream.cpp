@@ -26,6 +26,32 @@ namespace fc::codec::cbor {
     return *this;
   }
 
+  CborDecodeStream &CborDecodeStream::operator>>(BytesIn &bytes) {
+    if (!codec::read(bytes, partial, bytesLength())) {
+      outcome::raise(CborDecodeError::kInvalidCbor);
+    }
+    readToken();
+    return *this;
+  }
+
+  CborDecodeStream &CborDecodeStream::operator>>(std::string_view &str) {
+    BytesIn bytes;
+    if (!codec::read(bytes, partial, _as(token.strSize()))) {
+      outcome::raise(CborDecodeError::kInvalidCbor);
+    }
+    str = common::span::bytestr(bytes);
+    readToken();
+    return *this;
+  }
+
+  CborDecodeStream &CborDecodeStream::operator>>(CidView &cid) {
+    if (!codec::read(cid.bytes, partial, _as(token.cidSize()))) {
+      outcome::raise(CborDecodeError::kInvalidCbor);
+    }
+    readToken();
+    return *this;
+  }
+
   CborDecodeStream &CborDecodeStream::operator>>(Bytes &bytes) {
     bytes.resize(bytesLength());
     return *this >> gsl::make_span(bytes);
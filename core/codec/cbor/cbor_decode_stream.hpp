@@ -10,12 +10,61 @@
 #include "cbor_blake/cid_block.hpp"
 #include "codec/cbor/cbor_errors.hpp"
 #include "codec/cbor/cbor_token.hpp"
+#include "codec/cbor/light_reader/cid.hpp"
 #include "codec/cbor/streams_annotation.hpp"
 #include "common/default_t.hpp"
 #include "primitives/cid/cid.hpp"
 #include "vm/actor/version.hpp"
 
 namespace fc::codec::cbor {
+  /**
+   * CID borrowed from decoded buffer.
+   * Valid while buffer is alive.
+   */
+  struct CidView {
+    BytesIn bytes;
+
+    /** @return hash if CID is "DAG_CBOR blake2b_256", otherwise nullptr */
+    inline const CbCid *asCbCid() const {
+      BytesIn input{bytes};
+      const CbCid *key{nullptr};
+      if (light_reader::readCborBlake(key, input) && input.empty()) {
+        return key;
+      }
+      return nullptr;
+    }
+
+    inline outcome::result<CID> toCid() const {
+      return CID::fromBytes(bytes);
+    }
+  };
+
+  /**
+   * List borrowed from decoded buffer, elements are decoded on visit.
+   * Valid while buffer is alive.
+   */
+  template <typename T>
+  struct ListView : vm::actor::WithActorVersion {
+    /** Encoded list with header */
+    BytesIn cbor;
+    size_t count{};
+
+    inline size_t size() const {
+      return count;
+    }
+
+    inline bool empty() const {
+      return count == 0;
+    }
+
+    /**
+     * Decodes elements one by one
+     * @param f - called with each element, returns outcome::result<void>
+     */
+    template <typename F>
+    outcome::result<void> visit(const F &f) const;
+  };
+
   /** Decodes CBOR */
   class CborDecodeStream : public vm::actor::WithActorVersion {
    public:
@@ -68,7 +117,7 @@ namespace fc::codec::cbor {
       } else {
         T value{common::kDefaultT<T>()};
         *this >> value;
-        optional = value;
+        optional = std::move(value);
       }
       return *this;
     }
@@ -83,7 +132,7 @@ namespace fc::codec::cbor {
       for (auto i = 0u; i < n; ++i) {
         T value{common::kDefaultT<T>()};
         l >> value;
-        values.push_back(value);
+        values.push_back(std::move(value));
       }
       return *this;
     }
@@ -97,8 +146,23 @@ namespace fc::codec::cbor {
       return *this;
     }
 
+    /** Borrows list, elements are decoded later */
+    template <typename T>
+    CborDecodeStream &operator>>(ListView<T> &view) {
+      view.count = listLength();
+      view.actor_version = actor_version;
+      view.cbor = readNested();
+      return *this;
+    }
+
     /// Decodes bytes
     CborDecodeStream &operator>>(BytesOut bytes);
+    /** Borrows bytes from decoded buffer */
+    CborDecodeStream &operator>>(BytesIn &bytes);
+    /** Borrows string from decoded buffer */
+    CborDecodeStream &operator>>(std::string_view &str);
+    /** Borrows CID from decoded buffer */
+    CborDecodeStream &operator>>(CidView &cid);
     /** Decodes bytes */
     CborDecodeStream &operator>>(Bytes &bytes);
     /** Decodes string */
@@ -199,4 +263,22 @@ namespace fc::codec::cbor {
     BytesIn input;
     CborToken token;
   };
+
+  template <typename T>
+  template <typename F>
+  outcome::result<void> ListView<T>::visit(const F &f) const {
+    try {
+      CborDecodeStream stream{cbor};
+      stream.actor_version = actor_version;
+      auto list{stream.list()};
+      for (size_t i{}; i < count; ++i) {
+        T value{common::kDefaultT<T>()};
+        list >> value;
+        OUTCOME_TRY(f(value));
+      }
+    } catch (std::system_error &e) {
+      return outcome::failure(e.code());
+    }
+    return outcome::success();
+  }
 }  // namespace fc::codec::cbor
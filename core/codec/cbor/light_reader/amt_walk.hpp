@@ -9,6 +9,10 @@
 #include "codec/cbor/light_reader/walk.hpp"
 
 namespace fc::codec::cbor::light_reader {
+  /**
+   * Visits AMT nodes breadth first.
+   * All leaves have same height, so values are visited in index order.
+   */
   struct AmtWalk : Walk {
     using Walk::Walk;
 
@@ -34,18 +38,21 @@ namespace fc::codec::cbor::light_reader {
       if (!read(token, node).listCount()) {
         return false;
       }
-      // skip bit width if present
       if (token.listCount() == 4) {
         if (!read(token, node).asUint()) {
           return false;
         }
+        bit_width = *token.asUint();
+        if (bit_width == 0 || bit_width > 16) {
+          return false;
+        }
       } else if (token.listCount() != 3) {
         return false;
       }
-      // skip height
       if (!read(token, node).asUint()) {
         return false;
       }
+      _positions.push_back({0, *token.asUint()});
       // skip count
       if (!read(token, node).asUint()) {
         return false;
@@ -56,10 +63,18 @@ namespace fc::codec::cbor::light_reader {
       return true;
     }
 
+    /**
+     * Reads next value
+     * @param[out] value - encoded value, index is set to its index
+     */
     inline bool next(BytesIn &value) {
       while (!empty()) {
         if (_values) {
           --_values;
+          if (!nextBit()) {
+            return false;
+          }
+          index = _base + _bit++;
           return codec::cbor::readNested(value, node);
         }
         if (!node.empty()) {
@@ -73,31 +88,63 @@ namespace fc::codec::cbor::light_reader {
     }
 
     inline bool readNode() {
+      const auto [base, height]{_positions[next_cid - 1]};
       cbor::CborToken token;
       if (read(token, node).listCount() != 3) {
         return false;
       }
       if (!read(token, node).bytesSize()
-          || !codec::read(node, *token.bytesSize())) {
+          || !codec::read(_bitmap, node, *token.bytesSize())) {
         return false;
       }
+      _bit = 0;
       if (!read(token, node).listCount()) {
         return false;
       }
       for (auto links{*token.listCount()}; links; --links) {
         const CbCid *cid;
-        if (!cbor::readCborBlake(cid, node)) {
+        if (!cbor::readCborBlake(cid, node) || height == 0
+            || bit_width * height >= 64 || !nextBit()) {
           return false;
         }
+        const auto pushed{cids.size()};
         push(*cid);
+        if (cids.size() != pushed) {
+          const auto child_size{uint64_t{1} << (bit_width * height)};
+          _positions.push_back({base + _bit * child_size, height - 1});
+        }
+        ++_bit;
       }
       if (!read(token, node).listCount()) {
         return false;
       }
       _values = *token.listCount();
+      if (_values != 0 && height != 0) {
+        return false;
+      }
+      _base = base;
+      _bit = 0;
       return true;
     }
 
+    /** Moves to next set bit of node bitmap */
+    inline bool nextBit() {
+      for (; _bit < _bitmap.size() * 8; ++_bit) {
+        if ((_bitmap[_bit / 8] >> (_bit % 8)) & 1) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    /** Index of last value */
+    uint64_t index{};
+    uint64_t bit_width{3};
+    /** First index and height of each node in cids */
+    std::vector<std::pair<uint64_t, uint64_t>> _positions;
+    BytesIn _bitmap;
+    uint64_t _bit{};
+    uint64_t _base{};
     size_t _values{};
   };
 }  // namespace fc::codec::cbor::light_reader
@@ -0,0 +1,145 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "codec/cbor/cbor_decode_stream.hpp"
+#include "codec/cbor/light_reader/amt_walk.hpp"
+
+namespace fc::codec::cbor::light_reader {
+  /**
+   * Market DealProposal fields before storage price, label is skipped.
+   * Borrows node buffer of proposals AMT, valid until visitor returns.
+   */
+  struct DealProposalView {
+    CidView piece_cid;
+    uint64_t piece_size{};
+    bool verified{};
+    /** Encoded addresses */
+    BytesIn client;
+    BytesIn provider;
+    int64_t start_epoch{};
+    int64_t end_epoch{};
+    /** Whole encoded DealProposal, to decode remaining fields */
+    BytesIn raw;
+  };
+
+  /** Market DealState, same in all actor versions */
+  struct DealStateView {
+    int64_t sector_start_epoch{};
+    int64_t last_updated_epoch{};
+    int64_t slash_epoch{};
+  };
+
+  inline bool readDealProposal(DealProposalView &view, BytesIn input) {
+    try {
+      CborDecodeStream stream{input};
+      auto list{stream.list()};
+      list >> view.piece_cid >> view.piece_size >> view.verified
+          >> view.client >> view.provider;
+      // label is string or bytes, depending on actor version
+      list.next();
+      list >> view.start_epoch >> view.end_epoch;
+      view.raw = input;
+      return true;
+    } catch (std::system_error &) {
+      return false;
+    }
+  }
+
+  inline bool readDealState(DealStateView &view, BytesIn input) {
+    try {
+      CborDecodeStream stream{input};
+      auto list{stream.list()};
+      list >> view.sector_start_epoch >> view.last_updated_epoch
+          >> view.slash_epoch;
+      return true;
+    } catch (std::system_error &) {
+      return false;
+    }
+  }
+
+  /**
+   * Visits market deal proposals in deal id order without copying them out
+   * of AMT nodes.
+   * @param ipld - lightweight ipld
+   * @param proposals - root of market proposals AMT
+   * @param f - called with deal id and proposal view, returns false to stop
+   * @return false on parsing error or if stopped
+   */
+  template <typename F>
+  inline bool marketDealProposals(const CbIpldPtr &ipld,
+                                  const CbCid &proposals,
+                                  const F &f) {
+    AmtWalk walk{ipld, proposals};
+    if (!walk.load()) {
+      return false;
+    }
+    BytesIn value;
+    DealProposalView view;
+    while (walk.next(value)) {
+      if (!readDealProposal(view, value) || !f(walk.index, view)) {
+        return false;
+      }
+    }
+    return walk.empty();
+  }
+
+  /**
+   * Reads market deal states in deal id order, for merging with proposals.
+   */
+  class DealStatesCursor {
+   public:
+    DealStatesCursor(CbIpldPtr ipld, const CbCid &states)
+        : walk_{std::move(ipld), states} {}
+
+    /**
+     * Finds state of deal, deal ids must be increasing between calls
+     * @param[out] state - state if found
+     * @return false on parsing error, found is set otherwise
+     */
+    bool find(uint64_t deal_id, bool &found, DealStateView &state) {
+      found = false;
+      if (!loaded_) {
+        if (!walk_.load()) {
+          return false;
+        }
+        loaded_ = true;
+        has_ = next();
+      }
+      while (has_ && walk_.index < deal_id) {
+        has_ = next();
+      }
+      if (error_) {
+        return false;
+      }
+      if (has_ && walk_.index == deal_id) {
+        found = true;
+        state = state_;
+      }
+      return true;
+    }
+
+   private:
+    bool next() {
+      BytesIn value;
+      if (!walk_.next(value)) {
+        error_ = !walk_.empty();
+        return false;
+      }
+      if (!readDealState(state_, value)) {
+        error_ = true;
+        return false;
+      }
+      return true;
+    }
+
+    AmtWalk walk_;
+    bool loaded_{};
+    bool has_{};
+    bool error_{};
+    DealStateView state_;
+  };
+}  // namespace fc::codec::cbor::light_reader
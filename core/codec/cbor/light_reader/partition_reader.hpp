@@ -0,0 +1,71 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "codec/cbor/cbor_token.hpp"
+#include "codec/cbor/light_reader/amt_walk.hpp"
+
+namespace fc::codec::cbor::light_reader {
+  /**
+   * Sector bitsets of miner Partition, encoded RleBitset each.
+   * Expirations, early terminations and powers are skipped.
+   * Borrows node buffer of partitions AMT, valid until visitor returns.
+   */
+  struct PartitionView {
+    BytesIn sectors;
+    BytesIn faults;
+    BytesIn recoveries;
+    BytesIn terminated;
+  };
+
+  inline bool readPartition(PartitionView &view, BytesIn input) {
+    CborToken token;
+    if (!read(token, input).listCount()) {
+      return false;
+    }
+    const auto n{*token.listCount()};
+    if (!readNested(view.sectors, input)) {
+      return false;
+    }
+    // v0 partition has no unproven sectors
+    if (n == 11) {
+      if (!skipNested(input, 1)) {
+        return false;
+      }
+    } else if (n != 9) {
+      return false;
+    }
+    return readNested(view.faults, input)
+           && readNested(view.recoveries, input)
+           && readNested(view.terminated, input);
+  }
+
+  /**
+   * Visits partitions of miner deadline in order without decoding
+   * expirations and powers.
+   * @param ipld - lightweight ipld
+   * @param partitions - root of deadline partitions AMT
+   * @param f - called with each partition view, returns false to stop
+   * @return false on parsing error or if stopped
+   */
+  template <typename F>
+  inline bool minerPartitions(const CbIpldPtr &ipld,
+                              const CbCid &partitions,
+                              const F &f) {
+    AmtWalk walk{ipld, partitions};
+    if (!walk.load()) {
+      return false;
+    }
+    BytesIn value;
+    PartitionView view;
+    while (walk.next(value)) {
+      if (!readPartition(view, value) || !f(view)) {
+        return false;
+      }
+    }
+    return walk.empty();
+  }
+}  // namespace fc::codec::cbor::light_reader
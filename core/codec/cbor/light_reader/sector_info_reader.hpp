@@ -0,0 +1,65 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "codec/cbor/cbor_decode_stream.hpp"
+#include "codec/cbor/light_reader/amt_walk.hpp"
+
+namespace fc::codec::cbor::light_reader {
+  /**
+   * Leading fields of miner SectorOnChainInfo, same in all actor versions.
+   * Borrows node buffer of sectors AMT, valid until visitor returns.
+   */
+  struct SectorInfoView {
+    uint64_t sector{};
+    int64_t seal_proof{};
+    CidView sealed_cid;
+    ListView<uint64_t> deals;
+    int64_t activation_epoch{};
+    int64_t expiration{};
+    /** Whole encoded SectorOnChainInfo, to decode remaining fields */
+    BytesIn raw;
+  };
+
+  inline bool readSectorInfo(SectorInfoView &view, BytesIn input) {
+    try {
+      CborDecodeStream stream{input};
+      auto list{stream.list()};
+      list >> view.sector >> view.seal_proof >> view.sealed_cid >> view.deals
+          >> view.activation_epoch >> view.expiration;
+      view.raw = input;
+      return true;
+    } catch (std::system_error &) {
+      return false;
+    }
+  }
+
+  /**
+   * Visits miner sectors in sector number order without copying them out of
+   * AMT nodes.
+   * @param ipld - lightweight ipld
+   * @param sectors - root of miner sectors AMT
+   * @param f - called with each sector view, returns false to stop
+   * @return false on parsing error or if stopped
+   */
+  template <typename F>
+  inline bool minerSectors(const CbIpldPtr &ipld,
+                           const CbCid &sectors,
+                           const F &f) {
+    AmtWalk walk{ipld, sectors};
+    if (!walk.load()) {
+      return false;
+    }
+    BytesIn value;
+    SectorInfoView view;
+    while (walk.next(value)) {
+      if (!readSectorInfo(view, value) || !f(view)) {
+        return false;
+      }
+    }
+    return walk.empty();
+  }
+}  // namespace fc::codec::cbor::light_reader
@@ -0,0 +1,231 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstring>
+#include <functional>
+#include <rapidjson/writer.h>
+#include <vector>
+
+#include "codec/json/coding.hpp"
+#include "common/bytes.hpp"
+
+namespace fc::codec::json {
+  /**
+   * Rapidjson output stream, passes filled chunks to sink, so serialized
+   * value is not kept in memory whole.
+   */
+  class ChunkStream {
+   public:
+    using Ch = char;
+    using Sink = std::function<void(Bytes)>;
+
+    static constexpr size_t kChunkSize{64 << 10};
+
+    explicit ChunkStream(Sink sink, size_t chunk_size = kChunkSize)
+        : sink_{std::move(sink)}, chunk_size_{chunk_size} {
+      chunk_.reserve(chunk_size_);
+    }
+
+    inline void Put(Ch c) {
+      chunk_.push_back(static_cast<uint8_t>(c));
+      if (chunk_.size() >= chunk_size_) {
+        sink_(std::move(chunk_));
+        chunk_.clear();
+        chunk_.reserve(chunk_size_);
+      }
+    }
+
+    /** Called by writer after each top-level value, chunk is sent by finish */
+    inline void Flush() {}
+
+    /** Passes last chunk to sink, it may be empty */
+    inline void finish() {
+      sink_(std::move(chunk_));
+      chunk_.clear();
+    }
+
+   private:
+    Sink sink_;
+    size_t chunk_size_;
+    Bytes chunk_;
+  };
+
+  /**
+   * Json SAX handler with virtual calls, so same value writer emits json text
+   * to stream or builds document.
+   */
+  class JsonWriter {
+   public:
+    using SizeType = rapidjson::SizeType;
+
+    virtual ~JsonWriter() = default;
+
+    virtual bool Null() = 0;
+    virtual bool Bool(bool b) = 0;
+    virtual bool Int(int i) = 0;
+    virtual bool Uint(unsigned i) = 0;
+    virtual bool Int64(int64_t i) = 0;
+    virtual bool Uint64(uint64_t i) = 0;
+    virtual bool Double(double d) = 0;
+    virtual bool String(const char *s, SizeType n, bool copy = false) = 0;
+    virtual bool StartObject() = 0;
+    virtual bool Key(const char *s, SizeType n, bool copy = false) = 0;
+    virtual bool EndObject(SizeType = 0) = 0;
+    virtual bool StartArray() = 0;
+    virtual bool EndArray(SizeType = 0) = 0;
+
+    inline bool String(const char *s) {
+      return String(s, static_cast<SizeType>(strlen(s)));
+    }
+
+    inline bool Key(const char *s) {
+      return Key(s, static_cast<SizeType>(strlen(s)));
+    }
+  };
+
+  /**
+   * Forwards to rapidjson handler.
+   * Counts members and elements, because document handler needs them and
+   * value writers don't pass them.
+   */
+  template <typename Handler>
+  class JsonWriterT : public JsonWriter {
+   public:
+    explicit JsonWriterT(Handler &handler) : handler_{handler} {}
+
+    bool Null() override {
+      value();
+      return handler_.Null();
+    }
+    bool Bool(bool b) override {
+      value();
+      return handler_.Bool(b);
+    }
+    bool Int(int i) override {
+      value();
+      return handler_.Int(i);
+    }
+    bool Uint(unsigned i) override {
+      value();
+      return handler_.Uint(i);
+    }
+    bool Int64(int64_t i) override {
+      value();
+      return handler_.Int64(i);
+    }
+    bool Uint64(uint64_t i) override {
+      value();
+      return handler_.Uint64(i);
+    }
+    bool Double(double d) override {
+      value();
+      return handler_.Double(d);
+    }
+    bool String(const char *s, SizeType n, bool copy) override {
+      value();
+      return handler_.String(s, n, copy);
+    }
+    bool StartObject() override {
+      value();
+      counts_.push_back(0);
+      return handler_.StartObject();
+    }
+    bool Key(const char *s, SizeType n, bool copy) override {
+      return handler_.Key(s, n, copy);
+    }
+    bool EndObject(SizeType) override {
+      const auto count{counts_.back()};
+      counts_.pop_back();
+      return handler_.EndObject(count);
+    }
+    bool StartArray() override {
+      value();
+      counts_.push_back(0);
+      return handler_.StartArray();
+    }
+    bool EndArray(SizeType) override {
+      const auto count{counts_.back()};
+      counts_.pop_back();
+      return handler_.EndArray(count);
+    }
+
+   private:
+    inline void value() {
+      if (!counts_.empty()) {
+        ++counts_.back();
+      }
+    }
+
+    Handler &handler_;
+    std::vector<SizeType> counts_;
+  };
+
+  /**
+   * Writes value to stream.
+   * Default encodes value to document, specializations write elements one by
+   * one to keep document small.
+   */
+  template <typename T, typename = void>
+  struct JsonStreamT {
+    static void write(JsonWriter &writer, const T &v) {
+      Document document;
+      encode(v, document.GetAllocator()).Accept(writer);
+    }
+  };
+
+  template <typename T>
+  inline void writeJson(JsonWriter &writer, const T &v) {
+    JsonStreamT<T>::write(writer, v);
+  }
+
+  template <typename T>
+  struct JsonStreamT<std::vector<T>,
+                     std::enable_if_t<!std::is_same_v<T, uint8_t>>> {
+    static void write(JsonWriter &writer, const std::vector<T> &v) {
+      writer.StartArray();
+      for (const auto &item : v) {
+        writeJson(writer, item);
+      }
+      writer.EndArray();
+    }
+  };
+
+  /** Writes value as json text to stream and finishes it */
+  template <typename T>
+  inline void writeJson(ChunkStream &stream, const T &v) {
+    rapidjson::Writer<ChunkStream> output{stream};
+    JsonWriterT writer{output};
+    writeJson(writer, v);
+    stream.finish();
+  }
+
+  /** Writes value to bytes */
+  template <typename T>
+  inline Bytes formatStream(const T &v) {
+    Bytes bytes;
+    ChunkStream stream{[&](Bytes chunk) { append(bytes, chunk); }};
+    writeJson(stream, v);
+    return bytes;
+  }
+
+  /**
+   * Builds document with writer
+   * @param allocator - allocator of document where result is added
+   */
+  template <typename F>
+  inline Value populate(const F &f,
+                        rapidjson::MemoryPoolAllocator<> &allocator) {
+    Document document{&allocator};
+    auto generator{[&](Document &handler) {
+      JsonWriterT writer{handler};
+      f(writer);
+      return true;
+    }};
+    document.Populate(generator);
+    return std::move(document.Move());
+  }
+}  // namespace fc::codec::json
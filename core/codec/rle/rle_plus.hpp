@@ -28,6 +28,20 @@ namespace fc::codec::rle {
     return encoder.data();
   }
 
+  /**
+   * @brief RLE+ encode runs
+   * @param runs - alternating unset and set run lengths, first run is unset
+   * @return Encoded byte-vector
+   */
+  inline std::vector<uint8_t> encodeRuns(const Runs64 &runs) {
+    if (runs.empty()) {
+      return {};
+    }
+    RLEPlusEncodingStream encoder;
+    encoder << runs;
+    return encoder.data();
+  }
+
   /**
    * @brief RLE+ decode
    * @tparam T - type of elements to decode
@@ -19,6 +19,24 @@ namespace fc::codec::rle {
     }
   }
 
+  RLEPlusEncodingStream &RLEPlusEncodingStream::operator<<(
+      const Runs64 &runs) {
+    initContent();
+    const auto first_set{!runs.empty() && runs[0] == 0};
+    content_.push_back(first_set);
+    for (auto it{runs.begin() + (first_set ? 1 : 0)}; it != runs.end(); ++it) {
+      const auto run{*it};
+      if (run == 1) {
+        content_.push_back(true);
+      } else if (run < LONG_BLOCK_VALUE) {
+        pushSmallBlock(run);
+      } else {
+        pushLongBlock(run);
+      }
+    }
+    return *this;
+  }
+
   Runs64 toRuns(const Set64 &set) {
     Runs64 runs;
     auto it{set.begin()};
@@ -14,6 +14,9 @@
 #include "common/outcome.hpp"
 
 namespace fc::codec::rle {
+  using Set64 = std::set<uint64_t>;
+  using Runs64 = std::vector<uint64_t>;
+
   /**
    * @class RLE+ encoding stream
    */
@@ -45,6 +48,13 @@ namespace fc::codec::rle {
       return *this;
     }
 
+    /**
+     * @brief Encode runs of alternating unset and set bits
+     * @param runs - runs in toRuns layout, first run is unset
+     * @return Encoded stream
+     */
+    RLEPlusEncodingStream &operator<<(const Runs64 &runs);
+
     /**
      * @brief Get encoded stream content
      * @return Stream content
@@ -135,8 +145,6 @@ namespace fc::codec::rle {
     }
   };
 
-  using Set64 = std::set<uint64_t>;
-  using Runs64 = std::vector<uint64_t>;
   Runs64 toRuns(const Set64 &set);
   Set64 fromRuns(const Runs64 &runs);
 }  // namespace fc::codec::rle
@@ -20,12 +20,7 @@ namespace fc::common {
   }
 
   inline uint64_t countSetBits(uint64_t n) {
-    unsigned int count = 0;
-    while (n != 0) {
-      count += n & 1;
-      n >>= 1;
-    }
-    return count;
+    return __builtin_popcountll(n);
   }
 
 }  // namespace fc::common
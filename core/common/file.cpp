@@ -5,15 +5,33 @@
 
 #include "common/file.hpp"
 
+#include <unistd.h>
+
 #include <boost/filesystem/operations.hpp>
+#include <cerrno>
 #include <fstream>
 
 #include "common/error_text.hpp"
 #include "common/span.hpp"
 
 namespace fc::common {
-  Outcome<std::pair<MappedFile, BytesIn>> mapFile(const std::string &path) {
-    MappedFile file{path};
+  Outcome<std::pair<MappedFile, BytesIn>> mapFile(const std::string &path,
+                                                  size_t max_size) {
+    boost::system::error_code ec;
+    const auto size{boost::filesystem::file_size(path, ec)};
+    if (ec) {
+      return {};
+    }
+    MappedFile file;
+    if (std::min<uint64_t>(size, max_size) == 0) {
+      // empty file can't be mapped
+      return std::make_pair(std::move(file), BytesIn{});
+    }
+    try {
+      file.open(path, std::min<uint64_t>(size, max_size));
+    } catch (const std::ios_base::failure &) {
+      return {};
+    }
     if (!file.is_open()) {
       return {};
     }
@@ -22,6 +40,29 @@ namespace fc::common {
     return std::make_pair(std::move(file), input);
   }
 
+  Outcome<size_t> readAt(FILE *file,
+                         uint64_t offset,
+                         gsl::span<uint8_t> bytes) {
+    size_t read{};
+    while (read < bytes.size()) {
+      const auto n{::pread(fileno(file),
+                           bytes.data() + read,
+                           bytes.size() - read,
+                           gsl::narrow<off_t>(offset + read))};
+      if (n < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return {};
+      }
+      if (n == 0) {
+        break;
+      }
+      read += n;
+    }
+    return read;
+  }
+
   Outcome<Bytes> readFile(const boost::filesystem::path &path) {
     std::ifstream file{path.c_str(), std::ios::binary | std::ios::ate};
     if (file.good()) {
@@ -7,6 +7,7 @@
 
 #include <boost/filesystem/path.hpp>
 #include <boost/iostreams/device/mapped_file.hpp>
+#include <cstdio>
 #include <iosfwd>
 
 #include "common/bytes.hpp"
@@ -16,7 +17,19 @@
 namespace fc::common {
   using MappedFile = boost::iostreams::mapped_file_source;
 
-  Outcome<std::pair<MappedFile, BytesIn>> mapFile(const std::string &path);
+  /**
+   * Maps file to memory
+   * @param max_size - maps only prefix of larger file
+   */
+  Outcome<std::pair<MappedFile, BytesIn>> mapFile(
+      const std::string &path, size_t max_size = SIZE_MAX);
+
+  /**
+   * Reads file at offset without moving file position, so concurrent readers
+   * don't need lock
+   * @return count of read bytes, less than requested at end of file
+   */
+  Outcome<size_t> readAt(FILE *file, uint64_t offset, gsl::span<uint8_t> bytes);
 
   Outcome<Bytes> readFile(const boost::filesystem::path &path);
 
@@ -0,0 +1,47 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <prometheus/counter.h>
+
+#include "common/prometheus/metrics.hpp"
+
+namespace fc::mining {
+  constexpr std::initializer_list<double> kCommitBatchSizeBuckets{
+      1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 819,
+  };
+
+  constexpr std::initializer_list<double> kCommitBatchWaitBuckets{
+      10, 60, 300, 900, 1800, 3600, 7200, 14400, 28800, 86400,
+  };
+
+  /** Sectors per ProveCommitAggregate message */
+  inline auto &metricCommitBatchSize() {
+    static auto &x{prometheus::BuildHistogram()
+                       .Name("lotus_commit_batch_size")
+                       .Help("Sectors proven by one aggregate message")
+                       .Register(prometheusRegistry())};
+    return x;
+  }
+
+  /** Time from sector being queued to its commit message */
+  inline auto &metricCommitBatchWait() {
+    static auto &x{prometheus::BuildHistogram()
+                       .Name("lotus_commit_batch_wait_seconds")
+                       .Help("Duration of sector waiting in commit batcher")
+                       .Register(prometheusRegistry())};
+    return x;
+  }
+
+  /** Labeled by "method": "aggregate" or "single" */
+  inline auto &metricCommitMessages() {
+    static auto &x{prometheus::BuildCounter()
+                       .Name("lotus_commit_messages")
+                       .Help("Prove commit messages sent by commit batcher")
+                       .Register(prometheusRegistry())};
+    return x;
+  }
+}  // namespace fc::mining
@@ -0,0 +1,36 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <prometheus/gauge.h>
+#include <prometheus/histogram.h>
+
+#include "common/prometheus/metrics.hpp"
+#include "common/prometheus/since.hpp"
+
+namespace fc::fsm {
+  constexpr std::initializer_list<double> kFsmDwellBuckets{
+      0.01, 0.1, 1, 10, 60, 300, 900, 1800, 3600, 14400, 43200, 86400,
+  };
+
+  /** Labeled by "fsm" name */
+  inline auto &metricFsmQueueDepth() {
+    static auto &x{prometheus::BuildGauge()
+                       .Name("lotus_fsm_queue_depth")
+                       .Help("Events waiting to be applied by fsm")
+                       .Register(prometheusRegistry())};
+    return x;
+  }
+
+  /** Labeled by "fsm" name and "state" name */
+  inline auto &metricFsmStateDwell() {
+    static auto &x{prometheus::BuildHistogram()
+                       .Name("lotus_fsm_state_dwell_seconds")
+                       .Help("Duration of entity staying in fsm state")
+                       .Register(prometheusRegistry())};
+    return x;
+  }
+}  // namespace fc::fsm
@@ -0,0 +1,39 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <prometheus/counter.h>
+#include <prometheus/gauge.h>
+
+#include "common/prometheus/metrics.hpp"
+
+namespace fc::markets::retrieval::provider {
+  /** Labeled by "result": "hit" or "miss", hit ratio is hit over total */
+  inline auto &metricUnsealedCacheRequests() {
+    static auto &x{prometheus::BuildCounter()
+                       .Name("lotus_retrieval_unsealed_cache_requests")
+                       .Help("Retrieval requests of unsealed piece cache")
+                       .Register(prometheusRegistry())};
+    return x;
+  }
+
+  inline auto &metricUnsealedCacheBytes() {
+    static auto &x{prometheus::BuildGauge()
+                       .Name("lotus_retrieval_unsealed_cache_bytes")
+                       .Help("Size of cached unsealed pieces and indexes")
+                       .Register(prometheusRegistry())};
+    return x;
+  }
+
+  /** Labeled by "result": "ok" or "failed" */
+  inline auto &metricUnseals() {
+    static auto &x{prometheus::BuildCounter()
+                       .Name("lotus_retrieval_unseals")
+                       .Help("Pieces unsealed for retrieval")
+                       .Register(prometheusRegistry())};
+    return x;
+  }
+}  // namespace fc::markets::retrieval::provider
@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <prometheus/gauge.h>
+
 #include "api/rpc/rpc.hpp"
 #include "common/prometheus/metrics.hpp"
 #include "common/prometheus/since.hpp"
@@ -18,6 +20,22 @@ namespace fc::api::rpc {
     return x;
   }
 
+  inline auto &metricApiQueueDepth() {
+    static auto &x{prometheus::BuildGauge()
+                       .Name("lotus_api_queue_depth")
+                       .Help("API requests waiting for executor")
+                       .Register(prometheusRegistry())};
+    return x;
+  }
+
+  inline auto &metricApiQueueWait() {
+    static auto &x{prometheus::BuildHistogram()
+                       .Name("lotus_api_queue_wait_ms")
+                       .Help("Duration of API requests waiting for executor")
+                       .Register(prometheusRegistry())};
+    return x;
+  }
+
   inline Method metricApiTime(std::string name, Method f) {
     return [name{std::move(name)}, f{std::move(f)}](
                const Value &value,
@@ -0,0 +1,31 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <prometheus/counter.h>
+
+#include "common/prometheus/metrics.hpp"
+#include "common/prometheus/since.hpp"
+
+namespace fc::sector_storage {
+  /** Labeled by "direction": "sent" by fetch handler, "received" by store */
+  inline auto &metricSectorFetchBytes() {
+    static auto &x{prometheus::BuildCounter()
+                       .Name("lotus_sector_fetch_bytes")
+                       .Help("Bytes of sector files transferred by fetch")
+                       .Register(prometheusRegistry())};
+    return x;
+  }
+
+  /** Labeled by "direction", throughput is bytes rate over duration */
+  inline auto &metricSectorFetchTime() {
+    static auto &x{prometheus::BuildHistogram()
+                       .Name("lotus_sector_fetch_duration_ms")
+                       .Help("Duration of sector file transfers")
+                       .Register(prometheusRegistry())};
+    return x;
+  }
+}  // namespace fc::sector_storage
@@ -0,0 +1,34 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <prometheus/counter.h>
+#include <prometheus/gauge.h>
+
+#include "common/prometheus/metrics.hpp"
+#include "common/prometheus/since.hpp"
+
+namespace fc::mining {
+  /**
+   * Labeled by "kind": "log" for transitions, "snapshot" for folded sectors.
+   * Write amplification is bytes written per transition.
+   */
+  inline auto &metricSectorJournalBytes() {
+    static auto &x{prometheus::BuildCounter()
+                       .Name("lotus_sector_journal_bytes")
+                       .Help("Bytes written by sealing fsm journal")
+                       .Register(prometheusRegistry())};
+    return x;
+  }
+
+  inline auto &metricSectorJournalLoadTime() {
+    static auto &x{prometheus::BuildGauge()
+                       .Name("lotus_sector_journal_load_ms")
+                       .Help("Duration of sealing fsm sectors loading")
+                       .Register(prometheusRegistry())};
+    return x;
+  }
+}  // namespace fc::mining
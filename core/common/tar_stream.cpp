@@ -0,0 +1,442 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "common/tar_stream.hpp"
+
+#include <boost/filesystem.hpp>
+#include <numeric>
+
+#include "common/logger.hpp"
+#include "common/span.hpp"
+
+namespace fc::common {
+  namespace fs = boost::filesystem;
+
+  namespace {
+    // ustar header fields
+    constexpr size_t kNameOffset{0};
+    constexpr size_t kNameSize{100};
+    constexpr size_t kModeOffset{100};
+    constexpr size_t kUidOffset{108};
+    constexpr size_t kGidOffset{116};
+    constexpr size_t kIdSize{8};
+    constexpr size_t kSizeOffset{124};
+    constexpr size_t kSizeSize{12};
+    constexpr size_t kMtimeOffset{136};
+    constexpr size_t kChecksumOffset{148};
+    constexpr size_t kChecksumSize{8};
+    constexpr size_t kTypeOffset{156};
+    constexpr size_t kMagicOffset{257};
+    constexpr size_t kVersionOffset{263};
+    constexpr size_t kPrefixOffset{345};
+    constexpr size_t kPrefixSize{155};
+    constexpr std::string_view kMagic{"ustar"};
+    /** Max pax or gnu long name data kept in memory */
+    constexpr size_t kMaxMetaSize{1 << 20};
+
+    const Logger &log() {
+      static const Logger logger = createLogger("tar stream");
+      return logger;
+    }
+
+    uint64_t roundUp(uint64_t size) {
+      return (size + kTarRecordSize - 1) / kTarRecordSize * kTarRecordSize;
+    }
+
+    void putString(Bytes &record,
+                   size_t offset,
+                   size_t size,
+                   std::string_view value) {
+      std::copy_n(value.begin(),
+                  std::min(size, value.size()),
+                  record.begin() + static_cast<ptrdiff_t>(offset));
+    }
+
+    /** Writes size - 1 octal digits and NUL */
+    void putOctal(Bytes &record, size_t offset, size_t size, uint64_t value) {
+      auto i{size - 1};
+      record[offset + i] = 0;
+      while (i != 0) {
+        --i;
+        record[offset + i] = static_cast<uint8_t>('0' + (value & 7));
+        value >>= 3;
+      }
+    }
+
+    /** Uses base-256 gnu extension for values not fitting octal */
+    void putNumber(Bytes &record, size_t offset, size_t size, uint64_t value) {
+      if (value < (uint64_t{1} << (3 * (size - 1)))) {
+        return putOctal(record, offset, size, value);
+      }
+      for (auto i{size - 1}; i != 0; --i) {
+        record[offset + i] = static_cast<uint8_t>(value & 0xFF);
+        value >>= 8;
+      }
+      record[offset] = 0x80;
+    }
+
+    std::string_view getString(const Bytes &record,
+                               size_t offset,
+                               size_t size) {
+      std::string_view value{
+          span::bytestr(BytesIn{record}.subspan(
+              static_cast<ptrdiff_t>(offset), static_cast<ptrdiff_t>(size)))};
+      return value.substr(0, value.find('\0'));
+    }
+
+    outcome::result<uint64_t> getNumber(const Bytes &record,
+                                        size_t offset,
+                                        size_t size) {
+      uint64_t value{};
+      if ((record[offset] & 0x80) != 0) {
+        value = record[offset] & 0x7F;
+        for (size_t i{1}; i < size; ++i) {
+          if ((value >> 56) != 0) {
+            return TarErrors::kCannotUntarArchive;
+          }
+          value = (value << 8) | record[offset + i];
+        }
+        return value;
+      }
+      size_t i{};
+      while (i < size && record[offset + i] == ' ') {
+        ++i;
+      }
+      for (; i < size && record[offset + i] >= '0' && record[offset + i] <= '7';
+           ++i) {
+        value = (value << 3) | (record[offset + i] - '0');
+      }
+      return value;
+    }
+
+    uint64_t checksum(const Bytes &record) {
+      uint64_t sum{std::accumulate(record.begin(), record.end(), uint64_t{})};
+      for (size_t i{}; i < kChecksumSize; ++i) {
+        sum += ' ' - record[kChecksumOffset + i];
+      }
+      return sum;
+    }
+
+    outcome::result<Bytes> makeHeader(const std::string &name,
+                                      uint64_t size,
+                                      bool dir) {
+      Bytes record(kTarRecordSize, 0);
+      std::string_view prefix;
+      std::string_view suffix{name};
+      if (name.size() > kNameSize) {
+        // split name at slash into prefix and name fields
+        auto slash{name.find('/')};
+        while (slash != std::string::npos
+               && name.size() - slash - 1 > kNameSize) {
+          slash = name.find('/', slash + 1);
+        }
+        if (slash == std::string::npos || slash > kPrefixSize) {
+          log()->error("TarWriter: name is too long {}", name);
+          return TarErrors::kCannotZipTarArchive;
+        }
+        prefix = suffix.substr(0, slash);
+        suffix = suffix.substr(slash + 1);
+      }
+      putString(record, kNameOffset, kNameSize, suffix);
+      putOctal(record, kModeOffset, kIdSize, dir ? 0755 : 0644);
+      putOctal(record, kUidOffset, kIdSize, 0);
+      putOctal(record, kGidOffset, kIdSize, 0);
+      putNumber(record, kSizeOffset, kSizeSize, size);
+      putOctal(record, kMtimeOffset, kSizeSize, 0);
+      record[kTypeOffset] = dir ? '5' : '0';
+      putString(record, kMagicOffset, kMagic.size(), kMagic);
+      putString(record, kVersionOffset, 2, "00");
+      putString(record, kPrefixOffset, kPrefixSize, prefix);
+      // 6 digits, NUL and space
+      putOctal(record, kChecksumOffset, kChecksumSize - 1, checksum(record));
+      record[kChecksumOffset + kChecksumSize - 1] = ' ';
+      return record;
+    }
+  }  // namespace
+
+  outcome::result<TarWriter> TarWriter::make(const fs::path &dir) {
+    if (!fs::is_directory(dir)) {
+      log()->error("TarWriter: {} is not a directory", dir.string());
+      return TarErrors::kCannotZipTarArchive;
+    }
+    TarWriter writer;
+    std::function<outcome::result<void>(const fs::path &, const std::string &)>
+        list{[&](const fs::path &path,
+                 const std::string &name) -> outcome::result<void> {
+          // sorted, so archive is same for resumed transfer
+          std::vector<fs::path> items{fs::directory_iterator{path},
+                                      fs::directory_iterator{}};
+          std::sort(items.begin(), items.end());
+          for (const auto &item : items) {
+            const auto item_name{name + "/" + item.filename().string()};
+            if (fs::is_directory(item)) {
+              if (!fs::is_empty(item)) {
+                OUTCOME_TRY(list(item, item_name));
+                continue;
+              }
+              writer.entries_.push_back({item_name + "/", item, 0, true});
+            } else {
+              boost::system::error_code ec;
+              const auto size{fs::file_size(item, ec)};
+              if (ec) {
+                log()->error("TarWriter: {} {}", item.string(), ec.message());
+                return TarErrors::kCannotReadFile;
+              }
+              writer.entries_.push_back({item_name, item, size, false});
+            }
+          }
+          return outcome::success();
+        }};
+    OUTCOME_TRY(list(dir, dir.filename().string()));
+    for (auto &entry : writer.entries_) {
+      entry.offset = writer.size_;
+      writer.size_ += kTarRecordSize + roundUp(entry.size);
+    }
+    // end of archive
+    writer.size_ += 2 * kTarRecordSize;
+    return writer;
+  }
+
+  outcome::result<void> TarWriter::seek(uint64_t offset) {
+    if (offset > size_) {
+      return TarErrors::kCannotReadFile;
+    }
+    offset_ = offset;
+    entry_ = 0;
+    return outcome::success();
+  }
+
+  outcome::result<Bytes> TarWriter::read(size_t max) {
+    const auto end{[&](size_t i) {
+      return entries_[i].offset + kTarRecordSize + roundUp(entries_[i].size);
+    }};
+    Bytes out;
+    out.reserve(std::min<uint64_t>(max, size_ - offset_));
+    while (out.size() < max && offset_ < size_) {
+      while (entry_ < entries_.size() && offset_ >= end(entry_)) {
+        ++entry_;
+      }
+      const uint64_t left{max - out.size()};
+      uint64_t n{};
+      if (entry_ == entries_.size()) {
+        n = std::min(left, size_ - offset_);
+        out.resize(out.size() + n, 0);
+      } else {
+        const auto &entry{entries_[entry_]};
+        const auto pos{offset_ - entry.offset};
+        if (pos < kTarRecordSize) {
+          OUTCOME_TRY(header, makeHeader(entry.name, entry.size, entry.dir));
+          n = std::min(left, kTarRecordSize - pos);
+          const auto begin{header.begin() + static_cast<ptrdiff_t>(pos)};
+          out.insert(out.end(), begin, begin + static_cast<ptrdiff_t>(n));
+        } else if (pos - kTarRecordSize < entry.size) {
+          n = std::min(left, entry.size - (pos - kTarRecordSize));
+          OUTCOME_TRY(readFile(out, entry_, pos - kTarRecordSize, n));
+        } else {
+          n = std::min(left, end(entry_) - offset_);
+          out.resize(out.size() + n, 0);
+        }
+      }
+      offset_ += n;
+    }
+    return out;
+  }
+
+  outcome::result<void> TarWriter::readFile(Bytes &out,
+                                            size_t entry,
+                                            uint64_t pos,
+                                            uint64_t n) {
+    if (file_entry_ != entry) {
+      file_.close();
+      file_.clear();
+      file_.open(entries_[entry].path.string(), std::ios::binary);
+      if (!file_.is_open()) {
+        log()->error("TarWriter: cannot open {}",
+                     entries_[entry].path.string());
+        return TarErrors::kCannotOpenFile;
+      }
+      file_entry_ = entry;
+      file_pos_ = 0;
+    }
+    if (file_pos_ != pos) {
+      file_.seekg(static_cast<std::streamoff>(pos));
+      file_pos_ = pos;
+    }
+    const auto old{out.size()};
+    out.resize(old + n);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    file_.read(reinterpret_cast<char *>(out.data() + old),
+               static_cast<std::streamsize>(n));
+    if (static_cast<uint64_t>(file_.gcount()) != n) {
+      log()->error("TarWriter: cannot read {}", entries_[entry].path.string());
+      return TarErrors::kCannotReadFile;
+    }
+    file_pos_ += n;
+    return outcome::success();
+  }
+
+  TarReader::TarReader(fs::path output) : output_{std::move(output)} {
+    record_.reserve(kTarRecordSize);
+  }
+
+  outcome::result<void> TarReader::write(BytesIn chunk) {
+    while (!chunk.empty()) {
+      switch (state_) {
+        case State::kHeader: {
+          const auto n{std::min<size_t>(kTarRecordSize - record_.size(),
+                                        chunk.size())};
+          append(record_, chunk.first(static_cast<ptrdiff_t>(n)));
+          chunk = chunk.subspan(static_cast<ptrdiff_t>(n));
+          if (record_.size() == kTarRecordSize) {
+            OUTCOME_TRY(header());
+            record_.clear();
+          }
+          break;
+        }
+        case State::kData: {
+          const auto n{std::min<uint64_t>(left_, chunk.size())};
+          OUTCOME_TRY(data(chunk.first(static_cast<ptrdiff_t>(n))));
+          chunk = chunk.subspan(static_cast<ptrdiff_t>(n));
+          left_ -= n;
+          if (left_ == 0) {
+            OUTCOME_TRY(endData());
+          }
+          break;
+        }
+        case State::kPadding: {
+          const auto n{std::min<uint64_t>(padding_, chunk.size())};
+          chunk = chunk.subspan(static_cast<ptrdiff_t>(n));
+          padding_ -= n;
+          if (padding_ == 0) {
+            state_ = State::kHeader;
+          }
+          break;
+        }
+        case State::kEnd:
+          // ignore records after end
+          return outcome::success();
+      }
+    }
+    return outcome::success();
+  }
+
+  // NOLINTNEXTLINE(readability-function-cognitive-complexity)
+  outcome::result<void> TarReader::header() {
+    if (std::all_of(
+            record_.begin(), record_.end(), [](auto x) { return x == 0; })) {
+      state_ = State::kEnd;
+      return outcome::success();
+    }
+    OUTCOME_TRY(expected_checksum,
+                getNumber(record_, kChecksumOffset, kChecksumSize));
+    if (checksum(record_) != expected_checksum) {
+      log()->error("TarReader: wrong header checksum");
+      return TarErrors::kCannotUntarArchive;
+    }
+    OUTCOME_TRYA(left_, getNumber(record_, kSizeOffset, kSizeSize));
+    padding_ = roundUp(left_) - left_;
+    type_ = static_cast<char>(record_[kTypeOffset]);
+    meta_.clear();
+    if (type_ == 'x' || type_ == 'L') {
+      if (left_ > kMaxMetaSize) {
+        return TarErrors::kCannotUntarArchive;
+      }
+    } else if (type_ != 'g') {
+      std::string name{std::move(long_name_)};
+      long_name_.clear();
+      if (name.empty()) {
+        name = getString(record_, kNameOffset, kNameSize);
+        const auto prefix{getString(record_, kPrefixOffset, kPrefixSize)};
+        if (getString(record_, kMagicOffset, kMagic.size()) == kMagic
+            && !prefix.empty()) {
+          name = std::string{prefix} + "/" + name;
+        }
+      }
+      while (!name.empty() && name.back() == '/') {
+        name.pop_back();
+      }
+      const fs::path relative{name};
+      if (name.empty() || relative.is_absolute()
+          || std::find(relative.begin(), relative.end(), "..")
+                 != relative.end()) {
+        log()->error("TarReader: wrong entry name {}", name);
+        return TarErrors::kCannotUntarArchive;
+      }
+      const auto path{output_ / relative};
+      boost::system::error_code ec;
+      if (type_ == '5') {
+        fs::create_directories(path, ec);
+      } else if (type_ == '0' || type_ == '\0' || type_ == '7') {
+        fs::create_directories(path.parent_path(), ec);
+        if (!ec) {
+          file_.open(path.string(), std::ios::binary | std::ios::trunc);
+          if (!file_.is_open()) {
+            log()->error("TarReader: cannot open {}", path.string());
+            return TarErrors::kCannotUntarArchive;
+          }
+        }
+      } else {
+        log()->warn("TarReader: skipping entry {} of type {}", name, type_);
+      }
+      if (ec) {
+        log()->error("TarReader: {}", ec.message());
+        return TarErrors::kCannotCreateDir;
+      }
+    }
+    state_ = State::kData;
+    if (left_ == 0) {
+      return endData();
+    }
+    return outcome::success();
+  }
+
+  outcome::result<void> TarReader::data(BytesIn chunk) {
+    if (file_.is_open()) {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+      file_.write(reinterpret_cast<const char *>(chunk.data()),
+                  static_cast<std::streamsize>(chunk.size()));
+      if (!file_.good()) {
+        log()->error("TarReader: cannot write file");
+        return TarErrors::kCannotUntarArchive;
+      }
+    } else if (type_ == 'x' || type_ == 'L') {
+      meta_.append(span::bytestr(chunk));
+    }
+    return outcome::success();
+  }
+
+  outcome::result<void> TarReader::endData() {
+    if (file_.is_open()) {
+      file_.close();
+      if (file_.fail()) {
+        log()->error("TarReader: cannot write file");
+        return TarErrors::kCannotUntarArchive;
+      }
+    } else if (type_ == 'L') {
+      long_name_ = meta_.substr(0, meta_.find('\0'));
+    } else if (type_ == 'x') {
+      // records are "<length> <key>=<value>\n"
+      std::string_view records{meta_};
+      while (!records.empty()) {
+        const auto space{records.find(' ')};
+        if (space == std::string_view::npos) {
+          break;
+        }
+        const auto length{std::strtoull(records.data(), nullptr, 10)};
+        if (length <= space + 1 || length > records.size()) {
+          return TarErrors::kCannotUntarArchive;
+        }
+        auto record{records.substr(space + 1, length - space - 2)};
+        constexpr std::string_view kPath{"path="};
+        if (record.substr(0, kPath.size()) == kPath) {
+          long_name_ = record.substr(kPath.size());
+        }
+        records = records.substr(length);
+      }
+    }
+    state_ = padding_ == 0 ? State::kHeader : State::kPadding;
+    return outcome::success();
+  }
+}  // namespace fc::common
@@ -0,0 +1,112 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <boost/filesystem/path.hpp>
+#include <fstream>
+
+#include "common/bytes.hpp"
+#include "common/tarutil.hpp"
+
+namespace fc::common {
+  constexpr size_t kTarRecordSize{512};
+
+  /**
+   * Reads directory as tar archive by chunks, so archive is not stored on
+   * disk.
+   * Layout is same as zipTar: entry names start with directory name, empty
+   * directories are stored as entries.
+   * Archive size is known before files are read, so reading may start from
+   * offset to resume interrupted transfer.
+   */
+  class TarWriter {
+   public:
+    /** Lists directory entries */
+    static outcome::result<TarWriter> make(const boost::filesystem::path &dir);
+
+    /** Size of whole archive */
+    inline uint64_t size() const {
+      return size_;
+    }
+
+    /** Moves read position */
+    outcome::result<void> seek(uint64_t offset);
+
+    /**
+     * Reads next chunk of archive
+     * @param max - max chunk size
+     * @return chunk, empty when archive ended
+     */
+    outcome::result<Bytes> read(size_t max);
+
+   private:
+    struct Entry {
+      /** Name in archive */
+      std::string name;
+      boost::filesystem::path path;
+      uint64_t size{};
+      bool dir{};
+      /** Offset of header in archive */
+      uint64_t offset{};
+    };
+
+    outcome::result<void> readFile(Bytes &out,
+                                   size_t entry,
+                                   uint64_t pos,
+                                   uint64_t n);
+
+    std::vector<Entry> entries_;
+    uint64_t size_{};
+    uint64_t offset_{};
+    /** Entry containing current offset */
+    size_t entry_{};
+    std::ifstream file_;
+    size_t file_entry_{SIZE_MAX};
+    uint64_t file_pos_{};
+  };
+
+  /**
+   * Extracts tar archive received by chunks, so archive is not stored on
+   * disk.
+   * Accepts ustar, pax path records and gnu long names, skips links.
+   */
+  class TarReader {
+   public:
+    explicit TarReader(boost::filesystem::path output);
+
+    /** Extracts next chunk of archive */
+    outcome::result<void> write(BytesIn chunk);
+
+    /** Archive end was received */
+    inline bool done() const {
+      return state_ == State::kEnd;
+    }
+
+   private:
+    enum class State {
+      kHeader,
+      kData,
+      kPadding,
+      kEnd,
+    };
+
+    outcome::result<void> header();
+    outcome::result<void> data(BytesIn chunk);
+    outcome::result<void> endData();
+
+    boost::filesystem::path output_;
+    State state_{State::kHeader};
+    Bytes record_;
+    char type_{};
+    uint64_t left_{};
+    uint64_t padding_{};
+    std::ofstream file_;
+    /** Pax or gnu long name data */
+    std::string meta_;
+    /** Name overriding next header name */
+    std::string long_name_;
+  };
+}  // namespace fc::common
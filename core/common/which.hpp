@@ -38,4 +38,24 @@ namespace fc::common {
   bool which(const boost::variant<T1, T2, T> &v) {
     return v.which() == 2;
   }
+
+  template <typename T, typename T2, typename T3, typename T4>
+  bool which(const boost::variant<T, T2, T3, T4> &v) {
+    return v.which() == 0;
+  }
+
+  template <typename T, typename T1, typename T3, typename T4>
+  bool which(const boost::variant<T1, T, T3, T4> &v) {
+    return v.which() == 1;
+  }
+
+  template <typename T, typename T1, typename T2, typename T4>
+  bool which(const boost::variant<T1, T2, T, T4> &v) {
+    return v.which() == 2;
+  }
+
+  template <typename T, typename T1, typename T2, typename T3>
+  bool which(const boost::variant<T1, T2, T3, T> &v) {
+    return v.which() == 3;
+  }
 }  // namespace fc::common
@@ -8,24 +8,18 @@
 #include "common/error_text.hpp"
 #include "common/ffi.hpp"
 #include "common/span.hpp"
+#include "crypto/blake2/blake2b_kernel.hpp"
 
 #include <openssl/evp.h>
+#include <algorithm>
 #include <array>
 #include <fstream>
+#include <numeric>
 
 #ifndef ROTR64
 #define ROTR64(x, y) (((x) >> (y)) ^ ((x) << (64 - (y))))
 #endif
 
-#define B2B_GET64(p)                                                        \
-  (((uint64_t)((uint8_t *)(p))[0]) ^ (((uint64_t)((uint8_t *)(p))[1]) << 8) \
-   ^ (((uint64_t)((uint8_t *)(p))[2]) << 16)                                \
-   ^ (((uint64_t)((uint8_t *)(p))[3]) << 24)                                \
-   ^ (((uint64_t)((uint8_t *)(p))[4]) << 32)                                \
-   ^ (((uint64_t)((uint8_t *)(p))[5]) << 40)                                \
-   ^ (((uint64_t)((uint8_t *)(p))[6]) << 48)                                \
-   ^ (((uint64_t)((uint8_t *)(p))[7]) << 56))
-
 #define B2B_G(a, b, c, d, x, y)     \
   {                                 \
     v[a] = v[a] + v[b] + (x);       \
@@ -39,33 +33,146 @@
   }
 
 namespace fc::crypto::blake2b {
-  static const std::array<uint64_t, 8> iv{
-      0x6A09E667F3BCC908,
-      0xBB67AE8584CAA73B,
-      0x3C6EF372FE94F82B,
-      0xA54FF53A5F1D36F1,
-      0x510E527FADE682D1,
-      0x9B05688C2B3E6C1F,
-      0x1F83D9ABFB41BD6B,
-      0x5BE0CD19137E2179,
-  };
-  static const std::array<std::array<uint8_t, 16>, 12> sigma{{
-      {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
-      {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3},
-      {11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4},
-      {7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8},
-      {9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13},
-      {2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9},
-      {12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11},
-      {13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10},
-      {6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5},
-      {10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0},
-      {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
-      {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3},
-  }};
-  Ctx::Ctx(size_t outlen, BytesIn key) : h{iv}, outlen{outlen} {
+  using kernel::kBlock;
+  using kernel::kIv;
+  using kernel::kSigma;
+
+  namespace kernel {
+    void compressScalar(uint64_t *h,
+                        const uint8_t *block,
+                        uint64_t t0,
+                        uint64_t t1,
+                        bool last) {
+      std::array<uint64_t, 16> v{};
+      std::array<uint64_t, 16> m{};
+      for (auto i{0}; i < 8; ++i) {
+        v[i] = h[i];
+        v[i + 8] = kIv[i];
+      }
+      v[12] ^= t0;
+      v[13] ^= t1;
+      if (last) {
+        v[14] = ~v[14];
+      }
+      for (auto i{0}; i < 16; ++i) {
+        m[i] = load64(block + 8 * i);
+      }
+      for (const auto &s : kSigma) {
+        B2B_G(0, 4, 8, 12, m[s[0]], m[s[1]]);
+        B2B_G(1, 5, 9, 13, m[s[2]], m[s[3]]);
+        B2B_G(2, 6, 10, 14, m[s[4]], m[s[5]]);
+        B2B_G(3, 7, 11, 15, m[s[6]], m[s[7]]);
+        B2B_G(0, 5, 10, 15, m[s[8]], m[s[9]]);
+        B2B_G(1, 6, 11, 12, m[s[10]], m[s[11]]);
+        B2B_G(2, 7, 8, 13, m[s[12]], m[s[13]]);
+        B2B_G(3, 4, 9, 14, m[s[14]], m[s[15]]);
+      }
+      for (auto i{0}; i < 8; ++i) {
+        h[i] ^= v[i] ^ v[i + 8];
+      }
+    }
+
+#ifdef __x86_64__
+    // cpu model may be not initialized yet when called from static
+    // initializers, so __builtin_cpu_init is called first
+    bool hasAvx2() {
+      static const bool has{
+          (__builtin_cpu_init(), __builtin_cpu_supports("avx2") != 0)};
+      return has;
+    }
+
+    bool hasAvx512() {
+      static const bool has{(__builtin_cpu_init(),
+                             __builtin_cpu_supports("avx2") != 0
+                                 && __builtin_cpu_supports("avx512f") != 0
+                                 && __builtin_cpu_supports("avx512vl") != 0)};
+      return has;
+    }
+#else
+    bool hasAvx2() {
+      return false;
+    }
+
+    bool hasAvx512() {
+      return false;
+    }
+#endif
+  }  // namespace kernel
+
+  namespace {
+    kernel::Compress chooseCompress() {
+#ifdef __x86_64__
+      if (kernel::hasAvx512()) {
+        return kernel::compressAvx512;
+      }
+      if (kernel::hasAvx2()) {
+        return kernel::compressAvx2;
+      }
+#endif
+      return kernel::compressScalar;
+    }
+
+    /// Hashes are computed during static initialization, so kernel is
+    /// chosen on first use
+    kernel::Compress compress() {
+      static const auto compress{chooseCompress()};
+      return compress;
+    }
+
+    /// Hashes inputs of similar size together, lane count is 4 or 8
+    template <size_t N>
+    void hashLanes(void (*compress_lanes)(kernel::Lanes<N> &),
+                   const BytesIn *inputs,
+                   Blake2b256Hash *const *hashes) {
+      kernel::Lanes<N> lanes{};
+      std::array<std::array<uint8_t, kBlock>, N> tail{};
+      size_t blocks{0};
+      for (size_t j{0}; j < N; ++j) {
+        for (size_t i{0}; i < 8; ++i) {
+          lanes.h[i][j] = kIv[i];
+        }
+        lanes.h[0][j] ^= 0x01010000 ^ BLAKE2B256_HASH_LENGTH;
+        blocks = std::max(blocks, (inputs[j].size() + kBlock - 1) / kBlock);
+      }
+      blocks = std::max<size_t>(blocks, 1);
+      for (size_t k{0}; k < blocks; ++k) {
+        const auto offset{k * kBlock};
+        for (size_t j{0}; j < N; ++j) {
+          const auto &input{inputs[j]};
+          const auto size{static_cast<size_t>(input.size())};
+          const auto last{size <= offset + kBlock};
+          lanes.active[j] = offset < size || (offset == 0 && size == 0)
+                                ? ~uint64_t{0}
+                                : 0;
+          lanes.last[j] = last ? ~uint64_t{0} : 0;
+          lanes.t[j] = std::min(size, offset + kBlock);
+          if (!last) {
+            lanes.block[j] = input.data() + offset;
+          } else {
+            // last block is padded with zeros
+            auto &block{tail[j]};
+            block.fill(0);
+            if (offset < size) {
+              std::copy(input.begin() + offset, input.end(), block.begin());
+            }
+            lanes.block[j] = block.data();
+          }
+        }
+        compress_lanes(lanes);
+      }
+      for (size_t j{0}; j < N; ++j) {
+        auto &hash{*hashes[j]};
+        for (size_t i{0}; i < hash.size(); ++i) {
+          hash[i] = (lanes.h[i >> 3][j] >> (8 * (i & 7))) & 0xFF;
+        }
+      }
+    }
+  }  // namespace
+
+  Ctx::Ctx(size_t outlen, BytesIn key) : h{}, outlen{outlen} {
     assert(outlen > 0 && outlen <= 64);
     assert(key.size() >= 0 && key.size() <= 64);
+    std::copy(std::begin(kIv), std::end(kIv), h.begin());
     h[0] ^= 0x01010000 ^ (static_cast<size_t>(key.size()) << 8) ^ outlen;
     if (!key.empty()) {
       update(key);
@@ -73,53 +180,42 @@ namespace fc::crypto::blake2b {
     }
   }
   void Ctx::update(BytesIn in) {
-    for (auto i{0}; i < in.size(); ++i) {
-      if (c == 128) {
-        t[0] += c;
-        if (t[0] < c) {
-          t[1]++;
-        }
+    auto data{in.data()};
+    auto size{static_cast<size_t>(in.size())};
+    while (size != 0) {
+      if (c == kBlock) {
+        _count(kBlock);
         _compress(false);
         c = 0;
       }
-      b[c++] = in[i];
+      if (c == 0) {
+        // full blocks are compressed without copy, last block is kept
+        while (size > kBlock) {
+          _count(kBlock);
+          compress()(h.data(), data, t[0], t[1], false);
+          data += kBlock;
+          size -= kBlock;
+        }
+      }
+      const auto n{std::min(kBlock - c, size)};
+      std::copy(data, data + n, b.begin() + c);
+      c += n;
+      data += n;
+      size -= n;
     }
   }
-  void Ctx::_compress(bool last) {
-    std::array<uint64_t, 16> v{};
-    std::array<uint64_t, 16> m{};
-    for (auto i{0}; i < 8; ++i) {
-      v[i] = h[i];
-      v[i + 8] = iv[i];
-    }
-    v[12] ^= t[0];
-    v[13] ^= t[1];
-    if (last) {
-      v[14] = ~v[14];
-    }
-    for (auto i{0}; i < 16; ++i) {
-      m[i] = B2B_GET64(&b[8 * i]);
-    }
-    for (auto i{0}; i < 12; ++i) {
-      B2B_G(0, 4, 8, 12, m[sigma[i][0]], m[sigma[i][1]]);
-      B2B_G(1, 5, 9, 13, m[sigma[i][2]], m[sigma[i][3]]);
-      B2B_G(2, 6, 10, 14, m[sigma[i][4]], m[sigma[i][5]]);
-      B2B_G(3, 7, 11, 15, m[sigma[i][6]], m[sigma[i][7]]);
-      B2B_G(0, 5, 10, 15, m[sigma[i][8]], m[sigma[i][9]]);
-      B2B_G(1, 6, 11, 12, m[sigma[i][10]], m[sigma[i][11]]);
-      B2B_G(2, 7, 8, 13, m[sigma[i][12]], m[sigma[i][13]]);
-      B2B_G(3, 4, 9, 14, m[sigma[i][14]], m[sigma[i][15]]);
-    }
-    for (auto i{0}; i < 8; ++i) {
-      h[i] ^= v[i] ^ v[i + 8];
+  void Ctx::_count(size_t n) {
+    t[0] += n;
+    if (t[0] < n) {
+      t[1]++;
     }
   }
+  void Ctx::_compress(bool last) {
+    compress()(h.data(), b.data(), t[0], t[1], last);
+  }
   void Ctx::final(gsl::span<uint8_t> hash) {
     assert(hash.size() >= (ssize_t)outlen);
-    t[0] += c;
-    if (t[0] < c) {
-      t[1]++;
-    }
+    _count(c);
     while (c < 128) {
       b[c++] = 0;
     }
@@ -147,6 +243,55 @@ namespace fc::crypto::blake2b {
     return res;
   }
 
+  void blake2b_256_many(gsl::span<const BytesIn> inputs,
+                        gsl::span<Blake2b256Hash> hashes) {
+    assert(inputs.size() == hashes.size());
+    const auto n{static_cast<size_t>(inputs.size())};
+    size_t lanes{1};
+#ifdef __x86_64__
+    if (kernel::hasAvx512()) {
+      lanes = 8;
+    } else if (kernel::hasAvx2()) {
+      lanes = 4;
+    }
+#endif
+    size_t next{0};
+    if (lanes != 1 && n >= lanes) {
+      // inputs of similar size are grouped, so lanes finish together
+      std::vector<size_t> order(n);
+      std::iota(order.begin(), order.end(), 0);
+      std::sort(order.begin(), order.end(), [&](size_t l, size_t r) {
+        return inputs[l].size() < inputs[r].size();
+      });
+      std::array<BytesIn, 8> group_inputs;
+      std::array<Blake2b256Hash *, 8> group_hashes{};
+      for (; next + lanes <= n; next += lanes) {
+        for (size_t j{0}; j < lanes; ++j) {
+          group_inputs[j] = inputs[order[next + j]];
+          group_hashes[j] = &hashes[order[next + j]];
+        }
+#ifdef __x86_64__
+        if (lanes == 8) {
+          hashLanes<8>(kernel::compress8Avx512,
+                       group_inputs.data(),
+                       group_hashes.data());
+        } else {
+          hashLanes<4>(kernel::compress4Avx2,
+                       group_inputs.data(),
+                       group_hashes.data());
+        }
+#endif
+      }
+      for (; next < n; ++next) {
+        hashes[order[next]] = blake2b_256(inputs[order[next]]);
+      }
+      return;
+    }
+    for (; next < n; ++next) {
+      hashes[next] = blake2b_256(inputs[next]);
+    }
+  }
+
   outcome::result<Blake2b512Hash> blake2b_512_from_file(
       const std::string &path) {
     std::ifstream file_stream(path, std::ios::binary | std::ios::in);
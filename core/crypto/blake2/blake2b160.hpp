@@ -22,6 +22,7 @@ namespace fc::crypto::blake2b {
   struct Ctx {
     explicit Ctx(size_t outlen, BytesIn key = {});
     void update(BytesIn in);
+    void _count(size_t n);
     void _compress(bool last);
     void final(gsl::span<uint8_t> hash);
 
@@ -48,6 +49,15 @@ namespace fc::crypto::blake2b {
    */
   Blake2b256Hash blake2b_256(gsl::span<const uint8_t> to_hash);
 
+  /**
+   * @brief Get blake2b-256 hashes of several independent inputs.
+   * Inputs are hashed 8 or 4 at once when cpu supports AVX-512 or AVX2.
+   * @param inputs - data to hash
+   * @param hashes - output, same size as inputs
+   */
+  void blake2b_256_many(gsl::span<const BytesIn> inputs,
+                        gsl::span<Blake2b256Hash> hashes);
+
   outcome::result<Blake2b512Hash> blake2b_512_from_file(const std::string &path);
 
 }  // namespace fc::crypto::blake2b
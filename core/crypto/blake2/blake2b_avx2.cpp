@@ -0,0 +1,90 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// compiled with -mavx2, called only after runtime cpu check
+
+#include <immintrin.h>
+
+#include "crypto/blake2/blake2b_kernel.hpp"
+
+namespace fc::crypto::blake2b::kernel {
+  namespace {
+    struct Avx2 {
+      using V = __m256i;
+
+      static inline V add(V a, V b) {
+        return _mm256_add_epi64(a, b);
+      }
+      static inline V xor_(V a, V b) {
+        return _mm256_xor_si256(a, b);
+      }
+      static inline V ror32(V x) {
+        return _mm256_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1));
+      }
+      static inline V ror24(V x) {
+        const auto mask{_mm256_setr_epi8(3, 4, 5, 6, 7, 0, 1, 2,
+                                         11, 12, 13, 14, 15, 8, 9, 10,
+                                         3, 4, 5, 6, 7, 0, 1, 2,
+                                         11, 12, 13, 14, 15, 8, 9, 10)};
+        return _mm256_shuffle_epi8(x, mask);
+      }
+      static inline V ror16(V x) {
+        const auto mask{_mm256_setr_epi8(2, 3, 4, 5, 6, 7, 0, 1,
+                                         10, 11, 12, 13, 14, 15, 8, 9,
+                                         2, 3, 4, 5, 6, 7, 0, 1,
+                                         10, 11, 12, 13, 14, 15, 8, 9)};
+        return _mm256_shuffle_epi8(x, mask);
+      }
+      static inline V ror63(V x) {
+        return _mm256_xor_si256(_mm256_srli_epi64(x, 63),
+                                _mm256_add_epi64(x, x));
+      }
+      static inline V load(const uint64_t *p) {
+        return _mm256_loadu_si256(reinterpret_cast<const V *>(p));
+      }
+      static inline void store(uint64_t *p, V x) {
+        _mm256_storeu_si256(reinterpret_cast<V *>(p), x);
+      }
+      static inline V set(uint64_t w0, uint64_t w1, uint64_t w2, uint64_t w3) {
+        return _mm256_set_epi64x(static_cast<int64_t>(w3),
+                                 static_cast<int64_t>(w2),
+                                 static_cast<int64_t>(w1),
+                                 static_cast<int64_t>(w0));
+      }
+      static inline V set1(uint64_t w) {
+        return _mm256_set1_epi64x(static_cast<int64_t>(w));
+      }
+      static inline V gather(const uint8_t *const *blocks, size_t offset) {
+        return set(load64(blocks[0] + offset),
+                   load64(blocks[1] + offset),
+                   load64(blocks[2] + offset),
+                   load64(blocks[3] + offset));
+      }
+      static inline V blend(V mask, V a, V b) {
+        return _mm256_or_si256(_mm256_and_si256(mask, a),
+                               _mm256_andnot_si256(mask, b));
+      }
+      static inline void diagonalize(V &b, V &c, V &d) {
+        b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(0, 3, 2, 1));
+        c = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));
+        d = _mm256_permute4x64_epi64(d, _MM_SHUFFLE(2, 1, 0, 3));
+      }
+      static inline void undiagonalize(V &b, V &c, V &d) {
+        b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(2, 1, 0, 3));
+        c = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));
+        d = _mm256_permute4x64_epi64(d, _MM_SHUFFLE(0, 3, 2, 1));
+      }
+    };
+  }  // namespace
+
+  void compressAvx2(
+      uint64_t *h, const uint8_t *block, uint64_t t0, uint64_t t1, bool last) {
+    Rounds<Avx2>::compressRows(h, block, t0, t1, last);
+  }
+
+  void compress4Avx2(Lanes<4> &lanes) {
+    Rounds<Avx2>::compressLanes(lanes);
+  }
+}  // namespace fc::crypto::blake2b::kernel
@@ -0,0 +1,114 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// compiled with -mavx2 -mavx512f -mavx512vl, called only after runtime cpu
+// check
+
+#include <immintrin.h>
+
+#include "crypto/blake2/blake2b_kernel.hpp"
+
+namespace fc::crypto::blake2b::kernel {
+  namespace {
+    /** State rows in 256 bit vectors, avx512vl rotates */
+    struct Avx512Rows {
+      using V = __m256i;
+
+      static inline V add(V a, V b) {
+        return _mm256_add_epi64(a, b);
+      }
+      static inline V xor_(V a, V b) {
+        return _mm256_xor_si256(a, b);
+      }
+      static inline V ror32(V x) {
+        return _mm256_ror_epi64(x, 32);
+      }
+      static inline V ror24(V x) {
+        return _mm256_ror_epi64(x, 24);
+      }
+      static inline V ror16(V x) {
+        return _mm256_ror_epi64(x, 16);
+      }
+      static inline V ror63(V x) {
+        return _mm256_ror_epi64(x, 63);
+      }
+      static inline V load(const uint64_t *p) {
+        return _mm256_loadu_si256(reinterpret_cast<const V *>(p));
+      }
+      static inline void store(uint64_t *p, V x) {
+        _mm256_storeu_si256(reinterpret_cast<V *>(p), x);
+      }
+      static inline V set(uint64_t w0, uint64_t w1, uint64_t w2, uint64_t w3) {
+        return _mm256_set_epi64x(static_cast<int64_t>(w3),
+                                 static_cast<int64_t>(w2),
+                                 static_cast<int64_t>(w1),
+                                 static_cast<int64_t>(w0));
+      }
+      static inline void diagonalize(V &b, V &c, V &d) {
+        b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(0, 3, 2, 1));
+        c = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));
+        d = _mm256_permute4x64_epi64(d, _MM_SHUFFLE(2, 1, 0, 3));
+      }
+      static inline void undiagonalize(V &b, V &c, V &d) {
+        b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(2, 1, 0, 3));
+        c = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));
+        d = _mm256_permute4x64_epi64(d, _MM_SHUFFLE(0, 3, 2, 1));
+      }
+    };
+
+    /** 8 messages in 512 bit vectors */
+    struct Avx512Lanes {
+      using V = __m512i;
+
+      static inline V add(V a, V b) {
+        return _mm512_add_epi64(a, b);
+      }
+      static inline V xor_(V a, V b) {
+        return _mm512_xor_si512(a, b);
+      }
+      static inline V ror32(V x) {
+        return _mm512_ror_epi64(x, 32);
+      }
+      static inline V ror24(V x) {
+        return _mm512_ror_epi64(x, 24);
+      }
+      static inline V ror16(V x) {
+        return _mm512_ror_epi64(x, 16);
+      }
+      static inline V ror63(V x) {
+        return _mm512_ror_epi64(x, 63);
+      }
+      static inline V load(const uint64_t *p) {
+        return _mm512_loadu_si512(p);
+      }
+      static inline void store(uint64_t *p, V x) {
+        _mm512_storeu_si512(p, x);
+      }
+      static inline V set1(uint64_t w) {
+        return _mm512_set1_epi64(static_cast<int64_t>(w));
+      }
+      static inline V gather(const uint8_t *const *blocks, size_t offset) {
+        uint64_t words[8];
+        for (size_t i{0}; i < 8; ++i) {
+          words[i] = load64(blocks[i] + offset);
+        }
+        return load(words);
+      }
+      static inline V blend(V mask, V a, V b) {
+        return _mm512_or_si512(_mm512_and_si512(mask, a),
+                               _mm512_andnot_si512(mask, b));
+      }
+    };
+  }  // namespace
+
+  void compressAvx512(
+      uint64_t *h, const uint8_t *block, uint64_t t0, uint64_t t1, bool last) {
+    Rounds<Avx512Rows>::compressRows(h, block, t0, t1, last);
+  }
+
+  void compress8Avx512(Lanes<8> &lanes) {
+    Rounds<Avx512Lanes>::compressLanes(lanes);
+  }
+}  // namespace fc::crypto::blake2b::kernel
@@ -0,0 +1,177 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+// Kernels are compiled with cpu specific flags, so this header must not
+// include std headers with inline functions, and its functions must not
+// have external linkage, or linker may pick copy compiled for other cpu.
+#include <cstddef>
+#include <cstdint>
+
+namespace fc::crypto::blake2b::kernel {
+  inline constexpr uint64_t kIv[8]{
+      0x6A09E667F3BCC908,
+      0xBB67AE8584CAA73B,
+      0x3C6EF372FE94F82B,
+      0xA54FF53A5F1D36F1,
+      0x510E527FADE682D1,
+      0x9B05688C2B3E6C1F,
+      0x1F83D9ABFB41BD6B,
+      0x5BE0CD19137E2179,
+  };
+  inline constexpr uint8_t kSigma[12][16]{
+      {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+      {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3},
+      {11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4},
+      {7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8},
+      {9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13},
+      {2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9},
+      {12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11},
+      {13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10},
+      {6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5},
+      {10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0},
+      {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+      {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3},
+  };
+
+  /** Block size in bytes */
+  constexpr size_t kBlock{128};
+
+  /**
+   * Compresses one block into state
+   * @param h - 8 words of state
+   * @param block - 128 bytes
+   * @param t0, t1 - byte counter
+   * @param last - whether block is last
+   */
+  using Compress = void (*)(
+      uint64_t *h, const uint8_t *block, uint64_t t0, uint64_t t1, bool last);
+
+  /** State of independent messages compressed together, word-major */
+  template <size_t N>
+  struct Lanes {
+    uint64_t h[8][N];
+    const uint8_t *block[N];
+    /** Byte counter, messages are shorter than 2^64 */
+    uint64_t t[N];
+    /** ~0 for last block */
+    uint64_t last[N];
+    /** ~0 for lanes to update, other lanes keep state */
+    uint64_t active[N];
+  };
+
+  namespace {
+    inline uint64_t load64(const uint8_t *p) {
+      // blake2b words are little-endian, as all supported targets
+      uint64_t x;
+      __builtin_memcpy(&x, p, sizeof(x));
+      return x;
+    }
+  }  // namespace
+
+  void compressScalar(
+      uint64_t *h, const uint8_t *block, uint64_t t0, uint64_t t1, bool last);
+
+  void compressAvx2(
+      uint64_t *h, const uint8_t *block, uint64_t t0, uint64_t t1, bool last);
+  void compress4Avx2(Lanes<4> &lanes);
+
+  void compressAvx512(
+      uint64_t *h, const uint8_t *block, uint64_t t0, uint64_t t1, bool last);
+  void compress8Avx512(Lanes<8> &lanes);
+
+  /** Whether cpu and build support kernels */
+  bool hasAvx2();
+  bool hasAvx512();
+
+  /**
+   * Blake2b G mixing and rounds shared by vector kernels.
+   * Ops provides vector type V and operations on it.
+   * Ops is declared in anonymous namespace of kernel source, so each
+   * instantiation is local to source compiled for its cpu.
+   */
+  template <typename Ops>
+  struct Rounds {
+    using V = typename Ops::V;
+
+    static inline void g(V &a, V &b, V &c, V &d, V x, V y) {
+      a = Ops::add(Ops::add(a, b), x);
+      d = Ops::ror32(Ops::xor_(d, a));
+      c = Ops::add(c, d);
+      b = Ops::ror24(Ops::xor_(b, c));
+      a = Ops::add(Ops::add(a, b), y);
+      d = Ops::ror16(Ops::xor_(d, a));
+      c = Ops::add(c, d);
+      b = Ops::ror63(Ops::xor_(b, c));
+    }
+
+    /** Single block, state rows are vectors of 4 words */
+    static inline void compressRows(uint64_t *h,
+                                    const uint8_t *block,
+                                    uint64_t t0,
+                                    uint64_t t1,
+                                    bool last) {
+      uint64_t m[16];
+      __builtin_memcpy(m, block, sizeof(m));
+      V a{Ops::load(h)};
+      V b{Ops::load(h + 4)};
+      V c{Ops::load(kIv)};
+      V d{Ops::xor_(Ops::load(kIv + 4),
+                    Ops::set(t0, t1, last ? ~uint64_t{0} : 0, 0))};
+      for (const auto &s : kSigma) {
+        g(a,
+          b,
+          c,
+          d,
+          Ops::set(m[s[0]], m[s[2]], m[s[4]], m[s[6]]),
+          Ops::set(m[s[1]], m[s[3]], m[s[5]], m[s[7]]));
+        Ops::diagonalize(b, c, d);
+        g(a,
+          b,
+          c,
+          d,
+          Ops::set(m[s[8]], m[s[10]], m[s[12]], m[s[14]]),
+          Ops::set(m[s[9]], m[s[11]], m[s[13]], m[s[15]]));
+        Ops::undiagonalize(b, c, d);
+      }
+      Ops::store(h, Ops::xor_(Ops::load(h), Ops::xor_(a, c)));
+      Ops::store(h + 4, Ops::xor_(Ops::load(h + 4), Ops::xor_(b, d)));
+    }
+
+    /** One block of each lane, lane j of vector i is word i of message j */
+    template <size_t N>
+    static inline void compressLanes(Lanes<N> &lanes) {
+      V m[16];
+      for (size_t i{0}; i < 16; ++i) {
+        m[i] = Ops::gather(lanes.block, 8 * i);
+      }
+      V v[16];
+      for (size_t i{0}; i < 8; ++i) {
+        v[i] = Ops::load(lanes.h[i]);
+        v[i + 8] = Ops::set1(kIv[i]);
+      }
+      v[12] = Ops::xor_(v[12], Ops::load(lanes.t));
+      v[14] = Ops::xor_(v[14], Ops::load(lanes.last));
+      for (const auto &s : kSigma) {
+        g(v[0], v[4], v[8], v[12], m[s[0]], m[s[1]]);
+        g(v[1], v[5], v[9], v[13], m[s[2]], m[s[3]]);
+        g(v[2], v[6], v[10], v[14], m[s[4]], m[s[5]]);
+        g(v[3], v[7], v[11], v[15], m[s[6]], m[s[7]]);
+        g(v[0], v[5], v[10], v[15], m[s[8]], m[s[9]]);
+        g(v[1], v[6], v[11], v[12], m[s[10]], m[s[11]]);
+        g(v[2], v[7], v[8], v[13], m[s[12]], m[s[13]]);
+        g(v[3], v[4], v[9], v[14], m[s[14]], m[s[15]]);
+      }
+      const V active{Ops::load(lanes.active)};
+      for (size_t i{0}; i < 8; ++i) {
+        const V h{Ops::load(lanes.h[i])};
+        Ops::store(
+            lanes.h[i],
+            Ops::blend(active, Ops::xor_(h, Ops::xor_(v[i], v[i + 8])), h));
+      }
+    }
+  };
+}  // namespace fc::crypto::blake2b::kernel
@@ -6,7 +6,10 @@
 #pragma once
 
 #include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
 #include <boost/optional.hpp>
+#include <deque>
 #include <functional>
 #include <map>
 #include <mutex>
@@ -16,8 +19,10 @@
 #include <unordered_map>
 #include <utility>
 
+#include "common/enum.hpp"
 #include "common/error_text.hpp"
 #include "common/outcome.hpp"
+#include "common/prometheus/fsm.hpp"
 
 /**
  * The namespace is related to a generic implementation of a finite state
@@ -31,11 +36,18 @@ namespace fc::fsm {
     }
   };
 
-  template <typename F>
-  void postWithFlag(boost::asio::io_context &io,
-                    std::weak_ptr<bool> flag,
-                    F f) {
-    io.post([f{std::move(f)}, flag{std::move(flag)}] {
+  /** Names state by its enum conversion table, or by number */
+  template <typename State>
+  std::string stateName(State state) {
+    if (auto name{common::toString(state)}) {
+      return std::string{*name};
+    }
+    return std::to_string(common::to_int(state));
+  }
+
+  template <typename Executor, typename F>
+  void postWithFlag(Executor &io, std::weak_ptr<bool> flag, F f) {
+    boost::asio::post(io, [f{std::move(f)}, flag{std::move(flag)}] {
       if (auto _flag{flag.lock()}; _flag && *_flag) {
         f();
       }
@@ -289,6 +301,9 @@ namespace fc::fsm {
 
     ~FSM() {
       stop();
+      if (pool_) {
+        pool_->join();
+      }
     }
 
     FSM &operator=(const FSM &) = delete;
@@ -318,6 +333,35 @@ namespace fc::fsm {
       return std::move(std::make_shared<make_unique_enabler>(
           transition_rules, io_context, discard_event));
     }
+
+    /**
+     * Creates state machine applying events on own thread pool.
+     * Events of one entity are applied in order, one at a time, while
+     * events of different entities are applied concurrently, so slow
+     * transition action doesn't delay other entities.
+     * Transition actions must synchronize state shared between entities.
+     * @param transition_rules - defines state transitions
+     * @param threads - thread pool size
+     * @param discard_event - discards event if it cannot be applied instantly.
+     * If set to false the event is applied after next transition of entity.
+     * @return class instance
+     */
+    static outcome::result<std::shared_ptr<FSM>> createParallelFsm(
+        std::vector<TransitionRule> transition_rules,
+        size_t threads,
+        bool discard_event) {
+      OUTCOME_TRY(validateTransitionRules(transition_rules));
+
+      struct make_unique_enabler : public FSM {
+        make_unique_enabler(std::vector<TransitionRule> transition_rules,
+                            size_t threads,
+                            bool discard_event)
+            : FSM{std::move(transition_rules), threads, discard_event} {};
+      };
+
+      return std::move(std::make_shared<make_unique_enabler>(
+          transition_rules, threads, discard_event));
+    }
     friend class FSM;
 
     /**
@@ -334,6 +378,7 @@ namespace fc::fsm {
         return ERROR_TEXT("FSM is tracking the entity's state already");
       }
       states_.emplace(entity_ptr, initial_state);
+      entered_[entity_ptr] = {};
       return outcome::success();
     }
 
@@ -351,6 +396,7 @@ namespace fc::fsm {
         return ERROR_TEXT("Specified element was not tracked by FSM");
       }
       lookup->second = state;
+      entered_[entity_ptr] = {};
       return outcome::success();
     }
 
@@ -362,6 +408,18 @@ namespace fc::fsm {
         return ERROR_TEXT("FSM has been stopped. No more events get processed");
       }
       std::lock_guard lock(event_queue_mutex_);
+      if (queue_depth_) {
+        queue_depth_->Increment();
+      }
+      if (pool_) {
+        auto &queue{entity_queues_[entity_ptr]};
+        queue.events.emplace_back(event, event_context);
+        if (!queue.running) {
+          queue.running = true;
+          drainAsync(entity_ptr);
+        }
+        return outcome::success();
+      }
       auto was_empty{event_queue_.empty()};
       event_queue_.emplace(entity_ptr,
                            std::make_pair(event, std::move(event_context)));
@@ -407,6 +465,9 @@ namespace fc::fsm {
     /// Prevent further events processing
     void stop() {
       *running_ = false;
+      if (pool_) {
+        pool_->stop();
+      }
     }
 
     /**
@@ -428,7 +489,25 @@ namespace fc::fsm {
     }
 
     size_t getEventQueueSize() const {
-      return event_queue_.size();
+      std::lock_guard lock(event_queue_mutex_);
+      auto size{event_queue_.size()};
+      for (const auto &[entity, queue] : entity_queues_) {
+        size += queue.events.size() + queue.parked.size();
+      }
+      return size;
+    }
+
+    /**
+     * Enables queue depth and state dwell time metrics
+     * @param name - "fsm" label of metrics
+     * @param state_name - "state" label of dwell time metric
+     */
+    void setMetricsName(
+        const std::string &name,
+        std::function<std::string(StateEnumType)> state_name) {
+      name_ = name;
+      state_name_ = std::move(state_name);
+      queue_depth_ = &metricFsmQueueDepth().Add({{"fsm", name}});
     }
 
    private:
@@ -443,7 +522,16 @@ namespace fc::fsm {
         boost::asio::io_context &io_context,
         bool discard_event)
         : running_{std::make_shared<bool>(true)},
-          io_context_{io_context},
+          io_context_{&io_context},
+          discard_event_(discard_event) {
+      initTransitions(std::move(transition_rules));
+    }
+
+    FSM(std::vector<TransitionRule> transition_rules,
+        size_t threads,
+        bool discard_event)
+        : running_{std::make_shared<bool>(true)},
+          pool_{std::make_unique<boost::asio::thread_pool>(threads)},
           discard_event_(discard_event) {
       initTransitions(std::move(transition_rules));
     }
@@ -503,7 +591,7 @@ namespace fc::fsm {
     }
 
     void tickAsync() {
-      postWithFlag(io_context_, running_, [this] { tick(); });
+      postWithFlag(*io_context_, running_, [this] { tick(); });
     }
 
     /// async events processor routine
@@ -516,19 +604,84 @@ namespace fc::fsm {
         if (!event_queue_.empty()) {
           tickAsync();
         }
+        if (queue_depth_) {
+          queue_depth_->Decrement();
+        }
+      }
+
+      if (!apply(event_pair.first, event_pair.second) && !discard_event_) {
+        // There were no rule for transition. Put event in queue in case it
+        // can be handled when 'from' state is changed.
+        std::lock_guard lock(event_queue_mutex_);
+        event_queue_.push(event_pair);
+        if (queue_depth_) {
+          queue_depth_->Increment();
+        }
+      }
+    }
+
+    void drainAsync(const EntityPtr &entity_ptr) {
+      postWithFlag(
+          *pool_, running_, [this, entity_ptr] { drain(entity_ptr); });
+    }
+
+    /// applies next event of entity, used with thread pool
+    void drain(const EntityPtr &entity_ptr) {
+      ParametrizedEvent event;
+      {
+        std::lock_guard lock(event_queue_mutex_);
+        auto &queue{entity_queues_.at(entity_ptr)};
+        event = std::move(queue.events.front());
+        queue.events.pop_front();
+        if (queue_depth_) {
+          queue_depth_->Decrement();
+        }
       }
 
+      const auto applied{apply(entity_ptr, event)};
+
+      std::lock_guard lock(event_queue_mutex_);
+      auto it{entity_queues_.find(entity_ptr)};
+      auto &queue{it->second};
+      if (applied) {
+        // retry postponed events in their order before newer events
+        queue.events.insert(queue.events.begin(),
+                            std::make_move_iterator(queue.parked.begin()),
+                            std::make_move_iterator(queue.parked.end()));
+        queue.parked.clear();
+      } else if (!discard_event_) {
+        queue.parked.push_back(std::move(event));
+        if (queue_depth_) {
+          queue_depth_->Increment();
+        }
+      }
+      if (queue.events.empty()) {
+        queue.running = false;
+        if (queue.parked.empty()) {
+          entity_queues_.erase(it);
+        }
+        return;
+      }
+      // one event per task, so entities share threads fairly
+      drainAsync(entity_ptr);
+    }
+
+    /**
+     * Applies event to entity
+     * @return false if there was no rule for transition
+     */
+    bool apply(const EntityPtr &entity_ptr,
+               const ParametrizedEvent &parametrized_event) {
       StateEnumType source_state;
       {
         std::shared_lock lock(states_mutex_);
-        auto current_state = states_.find(event_pair.first);
+        auto current_state = states_.find(entity_ptr);
         if (states_.end() == current_state) {
-          return;  // entity is not tracked
+          return true;  // entity is not tracked, event is dropped
         }
         // copy to prevent invalidation of iterator
         source_state = current_state->second;
       }
-      auto parametrized_event = event_pair.second;
       auto event_to = parametrized_event.first;
       auto event_ctx = parametrized_event.second;
       // at least one rule was applied
@@ -539,15 +692,23 @@ namespace fc::fsm {
            event_handler != event_handlers.second;
            ++event_handler) {
         auto resulting_state = event_handler->second.dispatch(
-            source_state, event_ctx, event_pair.first);
+            source_state, event_ctx, entity_ptr);
         if (resulting_state) {
           {
             std::unique_lock lock(states_mutex_);
-            states_[event_pair.first] = resulting_state.get();
+            states_[entity_ptr] = resulting_state.get();
+            auto &entered{entered_[entity_ptr]};
+            if (queue_depth_) {
+              metricFsmStateDwell()
+                  .Add({{"fsm", name_}, {"state", state_name_(source_state)}},
+                       kFsmDwellBuckets)
+                  .Observe(entered.ms() / 1000);
+            }
+            entered = {};
           }
           if (any_change_cb_) {
             any_change_cb_.get()(
-                event_pair.first,        // pointer to entity
+                entity_ptr,              // pointer to entity
                 event_to,                // trigger event
                 std::move(event_ctx),    // event context or params
                 source_state,            // source state
@@ -557,20 +718,25 @@ namespace fc::fsm {
           break;
         }
       }
-
-      if (!applied && !discard_event_) {
-        // There were no rule for transition. Put event in queue in case it
-        // can be handled when 'from' state is changed.
-        std::lock_guard lock(event_queue_mutex_);
-        event_queue_.push(event_pair);
-      }
+      return applied;
     }
 
+    /// events of entity, used with thread pool
+    struct EntityQueue {
+      std::deque<ParametrizedEvent> events;
+      /// events without rule for current state, retried after transition
+      std::deque<ParametrizedEvent> parked;
+      /// drain task is posted
+      bool running{};
+    };
+
     std::shared_ptr<bool> running_;
-    boost::asio::io_context &io_context_;
+    boost::asio::io_context *io_context_{};
+    std::unique_ptr<boost::asio::thread_pool> pool_;
 
-    std::mutex event_queue_mutex_;
+    mutable std::mutex event_queue_mutex_;
     std::queue<EventQueueItem> event_queue_;
+    std::unordered_map<EntityPtr, EntityQueue> entity_queues_;
 
     /// a dispatching list of events and what to do on event
     std::multimap<EventEnumType, TransitionRule> transitions_;
@@ -579,10 +745,16 @@ namespace fc::fsm {
     mutable std::shared_mutex states_mutex_;
     // TODO(turuslan): FIL-420 check cache memory usage
     std::unordered_map<EntityPtr, StateEnumType> states_;
+    /// when entities entered current state
+    std::unordered_map<EntityPtr, Since> entered_;
 
     /// optional callback called after any transition
     boost::optional<ActionFunction> any_change_cb_;
 
     bool discard_event_;
+
+    std::string name_;
+    std::function<std::string(StateEnumType)> state_name_;
+    prometheus::Gauge *queue_depth_{};
   };
 }  // namespace fc::fsm
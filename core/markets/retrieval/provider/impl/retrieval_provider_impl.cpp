@@ -17,7 +17,6 @@ namespace fc::markets::retrieval::provider {
   using primitives::piece::UnpaddedByteIndex;
   using primitives::sector::SectorId;
   using primitives::sector::SectorRef;
-  using storage::kStorageMarketImportDir;
   namespace fs = boost::filesystem;
 
   RetrievalProviderImpl::RetrievalProviderImpl(
@@ -27,7 +26,8 @@ namespace fc::markets::retrieval::provider {
       std::shared_ptr<PieceStorage> piece_storage,
       std::shared_ptr<OneKey> config_key,
       std::shared_ptr<Manager> sealer,
-      std::shared_ptr<Miner> miner)
+      std::shared_ptr<Miner> miner,
+      std::shared_ptr<UnsealedCache> unsealed_cache)
       : host_{std::move(host)},
         datatransfer_{std::move(datatransfer)},
         api_{std::move(api)},
@@ -40,7 +40,8 @@ namespace fc::markets::retrieval::provider {
             kDefaultPaymentIntervalIncrease,
         },
         sealer_{std::move(sealer)},
-        miner_{std::move(miner)} {
+        miner_{std::move(miner)},
+        unsealed_cache_{std::move(unsealed_cache)} {
     if (!config_key_->has()) {
       config_key_->setCbor(config_);
     }
@@ -219,39 +220,34 @@ namespace fc::markets::retrieval::provider {
     if (!_piece) {
       return doFail(deal, _piece.error().message());
     }
-    if (!fs::exists(kStorageMarketImportDir)) {
-      fs::create_directories(kStorageMarketImportDir);
+    const auto &piece{_piece.value()};
+    auto _unsealed{unsealed_cache_->get(
+        piece.piece_cid,
+        [&](const std::string &car_path) -> outcome::result<void> {
+          for (const auto &info : piece.deals) {
+            if (unsealSector(info.sector_id,
+                             info.offset.unpadded(),
+                             info.length.unpadded(),
+                             car_path)) {
+              return outcome::success();
+            }
+            boost::system::error_code ec;
+            fs::remove(car_path, ec);
+          }
+          return ERROR_TEXT("unsealing all failed");
+        })};
+    if (!_unsealed) {
+      return doFail(deal, _unsealed.error().message());
     }
-    // TODO(turuslan): deterministic name
-    const auto car_path = kStorageMarketImportDir / fs::unique_path();
-    auto _ = gsl::finally([&car_path]() {
-      if (fs::exists(car_path)) {
-        fs::remove_all(car_path);
-      }
+    deal->ipld = _unsealed.value();
+    deal->traverser.emplace(Traverser{
+        *deal->ipld,
+        deal->proposal->payload_cid,
+        deal->proposal->params.selector,
+        false,
     });
-    for (auto &info : _piece.value().deals) {
-      if (auto _error{unsealSector(info.sector_id,
-                                   info.offset.unpadded(),
-                                   info.length.unpadded(),
-                                   car_path.string())}) {
-        assert(info.length.unpadded() == fs::file_size(car_path));
-        auto _load{MemoryIndexedCar::make(car_path.string(), false)};
-        if (!_load) {
-          return doFail(deal, _load.error().message());
-        }
-        deal->ipld = _load.value();
-        deal->traverser.emplace(Traverser{
-            *deal->ipld,
-            deal->proposal->payload_cid,
-            deal->proposal->params.selector,
-            false,
-        });
-        deal->unsealed = true;
-        doBlocks(deal);
-        return;
-      }
-    }
-    doFail(deal, "unsealing all failed");
+    deal->unsealed = true;
+    doBlocks(deal);
   }
 
   void RetrievalProviderImpl::doBlocks(const std::shared_ptr<DealState> &deal) {
@@ -13,9 +13,9 @@
 #include "markets/common.hpp"
 #include "markets/retrieval/protocols/query_protocol.hpp"
 #include "markets/retrieval/protocols/retrieval_protocol.hpp"
+#include "markets/retrieval/provider/impl/unsealed_cache.hpp"
 #include "markets/retrieval/provider/retrieval_provider.hpp"
 #include "miner/miner.hpp"
-#include "storage/ipld/memory_indexed_car.hpp"
 #include "storage/ipld/traverser.hpp"
 #include "storage/map_prefix/prefix.hpp"
 #include "storage/piece/piece_storage.hpp"
@@ -55,7 +55,7 @@ namespace fc::markets::retrieval::provider {
     PeerDtId pdtid;
     PeerGsId pgsid;
     bool unsealed{false};
-    std::shared_ptr<MemoryIndexedCar> ipld;
+    std::shared_ptr<UnsealedPiece> ipld;
     std::optional<Traverser> traverser;
   };
 
@@ -69,7 +69,8 @@ namespace fc::markets::retrieval::provider {
                           std::shared_ptr<PieceStorage> piece_storage,
                           std::shared_ptr<OneKey> config_key,
                           std::shared_ptr<Manager> sealer,
-                          std::shared_ptr<Miner> miner);
+                          std::shared_ptr<Miner> miner,
+                          std::shared_ptr<UnsealedCache> unsealed_cache);
 
     RetrievalAsk getAsk() const override;
     void setAsk(const RetrievalAsk &ask) override;
@@ -291,6 +292,7 @@ namespace fc::markets::retrieval::provider {
     RetrievalAsk config_;
     std::shared_ptr<Manager> sealer_;
     std::shared_ptr<Miner> miner_;
+    std::shared_ptr<UnsealedCache> unsealed_cache_;
     common::Logger logger_ = common::createLogger("RetrievalProvider");
     IoThread io_;
   };
@@ -0,0 +1,289 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "markets/retrieval/provider/impl/unsealed_cache.hpp"
+
+#include <boost/filesystem.hpp>
+
+#include "codec/uvarint.hpp"
+#include "common/error_text.hpp"
+#include "common/logger.hpp"
+#include "common/prometheus/retrieval.hpp"
+
+namespace fc::markets::retrieval::provider {
+  namespace fs = boost::filesystem;
+  using ::fc::storage::cids_index::kHeaderV0;
+  using ::fc::storage::cids_index::kTrailerV0;
+  using ::fc::storage::cids_index::maxSize64;
+  using ::fc::storage::cids_index::Row;
+
+  namespace {
+    constexpr std::string_view kCarExtension{".car"};
+    constexpr std::string_view kIndexExtension{".cids"};
+    constexpr std::string_view kTempExtension{".tmp"};
+
+    const common::Logger &log() {
+      static const common::Logger logger =
+          common::createLogger("unsealed cache");
+      return logger;
+    }
+
+    uint64_t fileSize(const fs::path &path) {
+      boost::system::error_code ec;
+      const auto size{fs::file_size(path, ec)};
+      return ec ? 0 : size;
+    }
+
+    /** Updates modification time, which orders pieces after restart */
+    void touchFile(const fs::path &path) {
+      boost::system::error_code ec;
+      fs::last_write_time(path, std::time(nullptr), ec);
+      if (ec) {
+        log()->warn("cannot touch {}: {}", path.string(), ec.message());
+      }
+    }
+
+    void removeFile(const fs::path &path) {
+      boost::system::error_code ec;
+      fs::remove(path, ec);
+      if (ec) {
+        log()->warn("cannot remove {}: {}", path.string(), ec.message());
+      }
+    }
+  }  // namespace
+
+  outcome::result<bool> UnsealedPiece::contains(const CID &key) const {
+    OUTCOME_TRY(value, view(key));
+    return value.has_value();
+  }
+
+  outcome::result<void> UnsealedPiece::set(const CID &key, BytesCow &&value) {
+    return ERROR_TEXT("UnsealedPiece is readonly");
+  }
+
+  outcome::result<Bytes> UnsealedPiece::get(const CID &key) const {
+    OUTCOME_TRY(value, view(key));
+    if (!value) {
+      return ::fc::storage::ipfs::IpfsDatastoreError::kNotFound;
+    }
+    return copy(*value);
+  }
+
+  outcome::result<boost::optional<BytesIn>> UnsealedPiece::view(
+      const CID &key) const {
+    OUTCOME_TRY(cid, key.toBytes());
+    OUTCOME_TRY(row, index->find(CbCid::hash(cid)));
+    if (!row || row->offset.value() >= car.size()) {
+      return boost::none;
+    }
+    auto input{car.subspan(static_cast<ptrdiff_t>(row->offset.value()))};
+    BytesIn item;
+    // key is hash, compare cid
+    if (!codec::uvarint::readBytes(item, input) || !startsWith(item, cid)) {
+      return boost::none;
+    }
+    return item.subspan(static_cast<ptrdiff_t>(cid.size()));
+  }
+
+  outcome::result<CbCid> unsealedIndexKey(const CID &cid) {
+    OUTCOME_TRY(bytes, cid.toBytes());
+    return CbCid::hash(bytes);
+  }
+
+  outcome::result<void> indexUnsealedCar(const std::string &car_path,
+                                         const std::string &index_path) {
+    OUTCOME_TRY(mapped, common::mapFile(car_path));
+    const auto car{mapped.second};
+    auto input{car};
+    BytesIn header;
+    if (!codec::uvarint::readBytes(header, input)) {
+      return ERROR_TEXT("indexUnsealedCar: read header failed");
+    }
+    std::vector<Row> rows;
+    while (!input.empty()) {
+      const auto offset{static_cast<uint64_t>(car.size() - input.size())};
+      BytesIn item;
+      // incomplete item or zero padding
+      if (!codec::uvarint::readBytes(item, input) || item.empty()) {
+        break;
+      }
+      BytesIn cid_input{item};
+      OUTCOME_TRY(CID::read(cid_input));
+      auto &row{rows.emplace_back()};
+      row.key = CbCid::hash(item.first(item.size() - cid_input.size()));
+      row.offset = offset;
+      row.max_size64 = maxSize64(car.size() - input.size() - offset);
+    }
+    // index rows must have unique keys
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(),
+                           rows.end(),
+                           [](auto &l, auto &r) { return l.key == r.key; }),
+               rows.end());
+    std::ofstream file{index_path, std::ios::binary | std::ios::trunc};
+    if (!common::writeStruct(file, kHeaderV0)
+        || !common::write(file, gsl::make_span(rows))
+        || !common::writeStruct(file, kTrailerV0) || !file.flush()) {
+      return ERROR_TEXT("indexUnsealedCar: write error");
+    }
+    return outcome::success();
+  }
+
+  outcome::result<std::shared_ptr<UnsealedCache>> UnsealedCache::make(
+      const fs::path &dir, uint64_t max_size) {
+    boost::system::error_code ec;
+    fs::create_directories(dir, ec);
+    if (ec) {
+      return ec;
+    }
+    auto cache{std::make_shared<UnsealedCache>()};
+    cache->dir_ = dir;
+    cache->max_size_ = max_size;
+    std::vector<std::pair<std::time_t, Entry>> found;
+    for (const auto &item : fs::directory_iterator{dir}) {
+      const auto &path{item.path()};
+      const auto extension{path.extension().string()};
+      // temp car or index of unseal interrupted by restart
+      if (path.filename().string().find(kTempExtension) != std::string::npos) {
+        removeFile(path);
+        continue;
+      }
+      if (extension == kCarExtension) {
+        const auto index_path{path.string() + std::string{kIndexExtension}};
+        if (fs::exists(index_path)) {
+          found.emplace_back(fs::last_write_time(path, ec),
+                             Entry{path.stem().string(),
+                                   fileSize(path) + fileSize(index_path),
+                                   {}});
+          continue;
+        }
+      } else if (extension == kIndexExtension
+                 && fs::exists(path.parent_path() / path.stem())) {
+        continue;
+      }
+      // incomplete unseal
+      removeFile(path);
+    }
+    std::sort(found.begin(), found.end(), [](auto &l, auto &r) {
+      return l.first < r.first;
+    });
+    for (auto &entry : found) {
+      cache->insert(std::move(entry.second));
+    }
+    cache->evict();
+    log()->info("loaded {} pieces, {} bytes", found.size(), cache->size_);
+    return cache;
+  }
+
+  outcome::result<std::shared_ptr<UnsealedPiece>> UnsealedCache::get(
+      const CID &piece, const Unseal &unseal) {
+    OUTCOME_TRY(name, piece.toString());
+    std::unique_lock lock{mutex_};
+    auto it{entries_.find(name)};
+    if (it != entries_.end()) {
+      lru_.splice(lru_.begin(), lru_, it->second);
+      auto _piece{open(*it->second)};
+      if (_piece) {
+        touchFile(carPath(name));
+        metricUnsealedCacheRequests().Add({{"result", "hit"}}).Increment();
+        return _piece;
+      }
+      log()->warn("cannot open {}: {}", name, _piece.error().message());
+      remove(it->second);
+    }
+    lock.unlock();
+    metricUnsealedCacheRequests().Add({{"result", "miss"}}).Increment();
+
+    // concurrent unseals of same piece don't share temp files
+    const auto temp{carPath(name).string() + "."
+                    + fs::unique_path().string()
+                    + std::string{kTempExtension}};
+    const auto temp_index{temp + std::string{kIndexExtension}};
+    auto _remove{gsl::finally([&] {
+      removeFile(temp);
+      removeFile(temp_index);
+    })};
+    auto _unsealed{unseal(temp)};
+    metricUnseals()
+        .Add({{"result", _unsealed ? "ok" : "failed"}})
+        .Increment();
+    if (!_unsealed) {
+      return _unsealed.error();
+    }
+    OUTCOME_TRY(indexUnsealedCar(temp, temp_index));
+    const auto size{fileSize(temp) + fileSize(temp_index)};
+
+    lock.lock();
+    it = entries_.find(name);
+    if (it == entries_.end()) {
+      const auto car_path{carPath(name).string()};
+      boost::system::error_code ec;
+      // car without index is removed on restart
+      fs::rename(temp_index, car_path + std::string{kIndexExtension}, ec);
+      if (!ec) {
+        fs::rename(temp, car_path, ec);
+      }
+      if (ec) {
+        log()->error("cannot store {}: {}", name, ec.message());
+        return ec;
+      }
+      insert({name, size, {}});
+      evict();
+      it = entries_.find(name);
+    }
+    return open(*it->second);
+  }
+
+  uint64_t UnsealedCache::size() const {
+    std::unique_lock lock{mutex_};
+    return size_;
+  }
+
+  fs::path UnsealedCache::carPath(const std::string &name) const {
+    return dir_ / (name + std::string{kCarExtension});
+  }
+
+  outcome::result<std::shared_ptr<UnsealedPiece>> UnsealedCache::open(
+      Entry &entry) const {
+    if (auto piece{entry.piece.lock()}) {
+      return piece;
+    }
+    const auto car_path{carPath(entry.name).string()};
+    auto piece{std::make_shared<UnsealedPiece>()};
+    OUTCOME_TRY(mapped, common::mapFile(car_path));
+    piece->car_file = std::move(mapped.first);
+    piece->car = mapped.second;
+    OUTCOME_TRYA(piece->index,
+                 MappedIndex::load(car_path + std::string{kIndexExtension}));
+    entry.piece = piece;
+    return piece;
+  }
+
+  void UnsealedCache::insert(Entry entry) {
+    size_ += entry.size;
+    lru_.push_front(std::move(entry));
+    entries_[lru_.front().name] = lru_.begin();
+    metricUnsealedCacheBytes().Add({}).Set(static_cast<double>(size_));
+  }
+
+  void UnsealedCache::remove(std::list<Entry>::iterator it) {
+    const auto car_path{carPath(it->name).string()};
+    // mapped by deals in progress until they end
+    removeFile(car_path);
+    removeFile(car_path + std::string{kIndexExtension});
+    size_ -= it->size;
+    entries_.erase(it->name);
+    lru_.erase(it);
+    metricUnsealedCacheBytes().Add({}).Set(static_cast<double>(size_));
+  }
+
+  void UnsealedCache::evict() {
+    // most recent piece is kept even if it exceeds limit
+    while (size_ > max_size_ && lru_.size() > 1) {
+      log()->info("evicting {}", lru_.back().name);
+      remove(std::prev(lru_.end()));
+    }
+  }
+}  // namespace fc::markets::retrieval::provider
@@ -0,0 +1,103 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <boost/filesystem/path.hpp>
+#include <list>
+#include <map>
+#include <mutex>
+
+#include "common/file.hpp"
+#include "storage/car/cids_index/cids_index.hpp"
+#include "storage/ipfs/datastore.hpp"
+
+namespace fc::markets::retrieval::provider {
+  using ::fc::storage::cids_index::MappedIndex;
+
+  /**
+   * Read-only blocks of cached unsealed piece car.
+   * Car and index are mapped to memory and shared by concurrent deals,
+   * mapping stays valid after piece is evicted from cache.
+   */
+  struct UnsealedPiece : Ipld {
+    outcome::result<bool> contains(const CID &key) const override;
+    outcome::result<void> set(const CID &key, BytesCow &&value) override;
+    outcome::result<Bytes> get(const CID &key) const override;
+
+    /**
+     * Get value without copying it from mapped car
+     * @return value, or nothing if cid is not in piece
+     */
+    outcome::result<boost::optional<BytesIn>> view(const CID &key) const;
+
+    common::MappedFile car_file;
+    BytesIn car;
+    std::shared_ptr<MappedIndex> index;
+  };
+
+  /**
+   * Index key of block cid.
+   * Retrieved blocks are not only cbor-blake, so whole cid is hashed to fit
+   * fixed-size key of cids_index row.
+   */
+  outcome::result<CbCid> unsealedIndexKey(const CID &cid);
+
+  /** Writes cids_index of car blocks keyed by unsealedIndexKey */
+  outcome::result<void> indexUnsealedCar(const std::string &car_path,
+                                         const std::string &index_path);
+
+  /**
+   * Size-bounded disk cache of unsealed pieces for retrieval, so popular
+   * pieces are not unsealed and indexed for each deal.
+   * Piece is stored as "<piece cid>.car" with persistent "<piece cid>.car.cids"
+   * index, and survives restart.
+   * Least recently used pieces are evicted when size exceeds limit.
+   * Recency survives restart as modification time of car, which is updated
+   * on each cache hit.
+   */
+  class UnsealedCache {
+   public:
+    /** Unseals piece to given path */
+    using Unseal = std::function<outcome::result<void>(const std::string &)>;
+
+    /** Loads pieces cached in dir, removes incomplete files */
+    static outcome::result<std::shared_ptr<UnsealedCache>> make(
+        const boost::filesystem::path &dir, uint64_t max_size);
+
+    /**
+     * Returns cached piece, or unseals and indexes it.
+     * Unsealing doesn't hold lock, so requests for other pieces are not
+     * blocked.
+     */
+    outcome::result<std::shared_ptr<UnsealedPiece>> get(const CID &piece,
+                                                        const Unseal &unseal);
+
+    /** Size of cached cars and indexes */
+    uint64_t size() const;
+
+   private:
+    struct Entry {
+      std::string name;
+      uint64_t size{};
+      /** Mapping shared by concurrent deals */
+      std::weak_ptr<UnsealedPiece> piece;
+    };
+
+    boost::filesystem::path carPath(const std::string &name) const;
+    outcome::result<std::shared_ptr<UnsealedPiece>> open(Entry &entry) const;
+    void insert(Entry entry);
+    void remove(std::list<Entry>::iterator it);
+    void evict();
+
+    boost::filesystem::path dir_;
+    uint64_t max_size_{};
+    mutable std::mutex mutex_;
+    /** Most recently used first */
+    std::list<Entry> lru_;
+    std::map<std::string, std::list<Entry>::iterator> entries_;
+    uint64_t size_{};
+  };
+}  // namespace fc::markets::retrieval::provider
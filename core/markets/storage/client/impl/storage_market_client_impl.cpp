@@ -155,6 +155,8 @@ namespace fc::markets::storage::client {
   outcome::result<void> StorageMarketClientImpl::init() {
     OUTCOME_TRYA(fsm_,
                  ClientFSM::createFsm(makeFSMTransitions(), *context_, false));
+    fsm_->setMetricsName("storage_client",
+                         fsm::stateName<StorageDealStatus>);
     return outcome::success();
   }
 
@@ -190,11 +192,13 @@ namespace fc::markets::storage::client {
     OUTCOME_TRY(chain_head, api_->ChainHead());
     OUTCOME_TRY(all_deals, api_->StateMarketDeals(chain_head->key));
     std::vector<StorageDeal> client_deals;
-    for (const auto &deal : all_deals) {
-      if (deal.second.proposal->client == address) {
-        client_deals.emplace_back(deal.second);
-      }
-    }
+    OUTCOME_TRY(all_deals.forEach(
+        [&](auto &, auto &deal) -> outcome::result<void> {
+          if (deal.proposal->client == address) {
+            client_deals.emplace_back(deal);
+          }
+          return outcome::success();
+        }));
     return client_deals;
   }
 
@@ -105,6 +105,8 @@ namespace fc::markets::storage::provider {
     // init fsm transitions
     OUTCOME_TRYA(
         fsm_, ProviderFSM::createFsm(makeFSMTransitions(), *context_, false));
+    fsm_->setMetricsName("storage_provider",
+                         fsm::stateName<StorageDealStatus>);
 
     datatransfer_->on_push.emplace(
         StorageDataTransferVoucherType,
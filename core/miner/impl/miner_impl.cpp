@@ -6,6 +6,7 @@
 #include "miner_impl.hpp"
 #include "miner/address_selector.hpp"
 #include "miner/storage_fsm/impl/basic_precommit_policy.hpp"
+#include "miner/storage_fsm/impl/commit_batcher_impl.hpp"
 #include "miner/storage_fsm/impl/events_impl.hpp"
 #include "miner/storage_fsm/impl/sealing_impl.hpp"
 #include "miner/storage_fsm/impl/tipset_cache_impl.hpp"
@@ -17,9 +18,13 @@
 namespace fc::miner {
   using api::MinerInfo;
   using mining::BasicPreCommitPolicy;
+  using mining::CommitBatcher;
+  using mining::CommitBatcherImpl;
   using mining::Events;
   using mining::EventsImpl;
   using mining::kGlobalChainConfidence;
+  using mining::kMaxAggregatedSectors;
+  using mining::kMinAggregatedSectors;
   using mining::PreCommitBatcher;
   using mining::PreCommitBatcherImpl;
   using mining::PreCommitPolicy;
@@ -61,7 +66,7 @@ namespace fc::miner {
       const Address &miner_address,
       const Address &worker_address,
       const std::shared_ptr<Counter> &counter,
-      const std::shared_ptr<BufferMap> &sealing_fsm_kv,
+      const std::shared_ptr<PersistentBufferMap> &sealing_fsm_kv,
       const std::shared_ptr<Manager> &sector_manager,
       const std::shared_ptr<Scheduler> &scheduler,
       const std::shared_ptr<boost::asio::io_context> &context,
@@ -95,6 +100,8 @@ namespace fc::miner {
         TokenAmount{"2000000000000000"};
     fee_config->max_precommit_gas_fee = TokenAmount{"25000000000000000"};
     fee_config->max_commit_gas_fee = TokenAmount{"50000000000000000"};
+    fee_config->max_commit_batch_gas_fee.per_sector =
+        TokenAmount{"30000000000000000"};
 
     std::shared_ptr<PreCommitBatcher> precommit_batcher =
         std::make_shared<PreCommitBatcherImpl>(std::chrono::seconds(60),
@@ -104,6 +111,17 @@ namespace fc::miner {
                                                SelectAddress,
                                                fee_config);
 
+    std::shared_ptr<CommitBatcher> commit_batcher =
+        std::make_shared<CommitBatcherImpl>(std::chrono::hours(24),
+                                            kMinAggregatedSectors,
+                                            kMaxAggregatedSectors,
+                                            api,
+                                            miner_address,
+                                            scheduler,
+                                            SelectAddress,
+                                            fee_config,
+                                            sector_manager->getProofEngine());
+
     OUTCOME_TRY(sealing,
                 SealingImpl::newSealing(api,
                                         events,
@@ -115,6 +133,7 @@ namespace fc::miner {
                                         context,
                                         scheduler,
                                         precommit_batcher,
+                                        commit_batcher,
                                         SelectAddress,
                                         fee_config,
                                         config));
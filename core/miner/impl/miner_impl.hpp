@@ -28,7 +28,7 @@ namespace fc::miner {
   using primitives::piece::PieceData;
   using primitives::piece::UnpaddedPieceSize;
   using sector_storage::Manager;
-  using storage::BufferMap;
+  using storage::PersistentBufferMap;
 
   class MinerImpl : public Miner {
    public:
@@ -37,7 +37,7 @@ namespace fc::miner {
         const Address &miner_address,
         const Address &worker_address,
         const std::shared_ptr<Counter> &counter,
-        const std::shared_ptr<BufferMap> &sealing_fsm_kv,
+        const std::shared_ptr<PersistentBufferMap> &sealing_fsm_kv,
         const std::shared_ptr<Manager> &sector_manager,
         const std::shared_ptr<Scheduler> &scheduler,
         const std::shared_ptr<boost::asio::io_context> &context,
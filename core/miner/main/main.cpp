@@ -44,7 +44,8 @@
 #include "proofs/proof_param_provider.hpp"
 #include "sector_storage/fetch_handler.hpp"
 #include "sector_storage/impl/manager_impl.hpp"
-#include "sector_storage/impl/scheduler_impl.hpp"
+#include "sector_storage/impl/new_scheduler_impl.hpp"
+#include "sector_storage/impl/worker_estimator_impl.hpp"
 #include "sector_storage/stores/impl/index_impl.hpp"
 #include "sector_storage/stores/impl/local_store.hpp"
 #include "sector_storage/stores/impl/remote_store.hpp"
@@ -105,6 +106,9 @@ namespace fc {
 
     bool disable_http_rpc{};
 
+    /** Max size of unsealed pieces cached for retrieval */
+    uint64_t unsealed_cache_size{};
+
     auto join(const std::string &path) const {
       return (repo_path / path).string();
     }
@@ -168,6 +172,10 @@ namespace fc {
            "Path to presealed metadata");
     option("disable-http-rpc",
            po::bool_switch(&config.disable_http_rpc)->default_value(false));
+    option("unsealed-cache-size",
+           po::value(&config.unsealed_cache_size)
+               ->default_value(uint64_t{32} << 30),
+           "max bytes of unsealed pieces cached for retrieval");
     desc.add(configProfile());
     primitives::address::configCurrentNetwork(option);
 
@@ -429,10 +437,14 @@ namespace fc {
         local_store, std::move(auth_headers))};
 
     IoThread io_thread2;
-    // TODO(ortoymka): Use scheduler with estimator, when it will done
+    // averages last 10 durations of task type on worker
+    auto estimator{std::make_shared<sector_storage::EstimatorImpl>(10)};
     OUTCOME_TRY(wscheduler,
-                sector_storage::SchedulerImpl::newScheduler(
-                    io_thread2.io, prefixed("scheduler_works/")));
+                sector_storage::EstimateSchedulerImpl::newScheduler(
+                    io_thread2.io,
+                    prefixed("scheduler_works/"),
+                    estimator,
+                    sector_index));
 
     IoThread io_thread3;
 
@@ -457,7 +469,8 @@ namespace fc {
                                   .max_sealing_sectors = 0,
                                   .max_sealing_sectors_for_deals = 0,
                                   .wait_deals_delay = std::chrono::hours(6),
-                                  .batch_pre_commits = true};
+                                  .batch_pre_commits = true,
+                                  .aggregate_commits = true};
     OUTCOME_TRY(miner,
                 miner::MinerImpl::newMiner(
                     napi,
@@ -520,6 +533,9 @@ namespace fc {
             filestore,
             std::make_shared<DealInfoManagerImpl>(napi))};
     OUTCOME_TRY(storage_provider->init());
+    OUTCOME_TRY(unsealed_cache,
+                markets::retrieval::provider::UnsealedCache::make(
+                    config.join("unsealed"), config.unsealed_cache_size));
     auto retrieval_provider{
         std::make_shared<markets::retrieval::provider::RetrievalProviderImpl>(
             host,
@@ -528,7 +544,8 @@ namespace fc {
             piece_storage,
             one_key("retrieval_provider_ask", leveldb),
             manager,
-            miner)};
+            miner,
+            unsealed_cache)};
     retrieval_provider->start();
 
     auto mapi = api::makeStorageApi(io,
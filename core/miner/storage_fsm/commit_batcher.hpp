@@ -0,0 +1,42 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "miner/storage_fsm/precommit_batcher.hpp"
+#include "primitives/sector/sector.hpp"
+
+namespace fc::mining {
+  using primitives::ChainEpoch;
+  using primitives::sector::AggregateSealVerifyInfo;
+  using primitives::sector::Proof;
+  using CommitCallback = std::function<void(const outcome::result<CID> &)>;
+
+  /** Sector proof waiting for aggregation */
+  struct AggregateInput {
+    AggregateSealVerifyInfo info;
+    Proof proof;
+    /** Value sent with prove commit, initial pledge minus precommit deposit */
+    TokenAmount collateral;
+    /** Last epoch when precommit may be proven */
+    ChainEpoch deadline{};
+  };
+
+  /**
+   * Collects ProveCommits of ready sectors and sends them as
+   * ProveCommitAggregate, or one by one if batch is too small.
+   */
+  class CommitBatcher {
+   public:
+    virtual ~CommitBatcher() = default;
+
+    virtual outcome::result<void> addCommit(const SectorInfo &sector_info,
+                                            const AggregateInput &input,
+                                            const CommitCallback &callback) = 0;
+
+    virtual void forceSend() = 0;
+  };
+
+}  // namespace fc::mining
@@ -0,0 +1,250 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "miner/storage_fsm/impl/commit_batcher_impl.hpp"
+
+#include <utility>
+
+#include "common/prometheus/commit_batcher.hpp"
+#include "vm/actor/actor.hpp"
+#include "vm/actor/builtin/methods/miner.hpp"
+#include "vm/actor/builtin/types/miner/v6/monies.hpp"
+
+namespace fc::mining {
+  using api::kPushNoSpec;
+  using primitives::sector::AggregateSealVerifyProofAndInfos;
+  using primitives::sector::RegisteredAggregationProof;
+  using vm::actor::MethodParams;
+  using vm::actor::builtin::v6::miner::aggregateProveCommitNetworkFee;
+  namespace miner = vm::actor::builtin::miner;
+
+  CommitBatcherImpl::CommitBatcherImpl(
+      const std::chrono::milliseconds &max_time,
+      size_t min_batch,
+      size_t max_batch,
+      std::shared_ptr<FullNodeApi> api,
+      Address miner_address,
+      std::shared_ptr<Scheduler> scheduler,
+      AddressSelector address_selector,
+      std::shared_ptr<FeeConfig> fee_config,
+      std::shared_ptr<proofs::ProofEngine> proofs)
+      : max_delay_(max_time),
+        min_batch_(std::max(min_batch, kMinAggregatedSectors)),
+        max_batch_(std::clamp(max_batch, min_batch_, kMaxAggregatedSectors)),
+        api_(std::move(api)),
+        miner_address_(std::move(miner_address)),
+        scheduler_(std::move(scheduler)),
+        fee_config_(std::move(fee_config)),
+        address_selector_(std::move(address_selector)),
+        proofs_(std::move(proofs)) {
+    logger_ = common::createLogger("commit batcher");
+    logger_->info("Commit batcher has been started, batch {}..{}",
+                  min_batch_,
+                  max_batch_);
+  }
+
+  void CommitBatcherImpl::reschedule(std::chrono::milliseconds time) {
+    cutoff_ = std::chrono::system_clock::now() + time;
+    handle_ = scheduler_->scheduleWithHandle(
+        [this]() {
+          std::unique_lock lock{mutex_};
+          const auto results{sendWithoutLock()};
+          lock.unlock();
+          callback(results);
+        },
+        time);
+  }
+
+  void CommitBatcherImpl::callback(const Results &results) {
+    for (const auto &[cb, result] : results) {
+      cb(result);
+    }
+  }
+
+  ChainEpoch CommitBatcherImpl::getCutoff(const SectorInfo &sector_info,
+                                          const AggregateInput &input) const {
+    ChainEpoch cutoff_epoch{input.deadline - kCommitBatchSlack};
+    for (const auto &piece : sector_info.pieces) {
+      if (piece.deal_info) {
+        cutoff_epoch = std::min(cutoff_epoch,
+                                piece.deal_info->deal_schedule.start_epoch);
+      }
+    }
+    return cutoff_epoch;
+  }
+
+  outcome::result<void> CommitBatcherImpl::addCommit(
+      const SectorInfo &sector_info,
+      const AggregateInput &input,
+      const CommitCallback &callback) {
+    std::unique_lock lock{mutex_};
+    OUTCOME_TRY(head, api_->ChainHead());
+
+    if (entries_.empty()) {
+      reschedule(max_delay_);
+    }
+    entries_[sector_info.sector_number] =
+        CommitEntry{sector_info.sector_type, input, callback, {}};
+
+    const auto cutoff_epoch{getCutoff(sector_info, input)};
+    if (cutoff_epoch <= head->epoch() || entries_.size() >= max_batch_) {
+      const auto results{sendWithoutLock()};
+      lock.unlock();
+      CommitBatcherImpl::callback(results);
+      return outcome::success();
+    }
+    const auto time{std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::seconds{(cutoff_epoch - head->epoch())
+                             * static_cast<ChainEpoch>(kBlockDelaySecs)})};
+    if (std::chrono::system_clock::now() + time < cutoff_) {
+      reschedule(time);
+    }
+    return outcome::success();
+  }
+
+  void CommitBatcherImpl::forceSend() {
+    std::unique_lock lock{mutex_};
+    const auto results{sendWithoutLock()};
+    lock.unlock();
+    callback(results);
+  }
+
+  CommitBatcherImpl::Results CommitBatcherImpl::sendWithoutLock() {
+    handle_.cancel();
+    Results results;
+    if (entries_.empty()) {
+      return results;
+    }
+    logger_->info("Sending {} commits", entries_.size());
+
+    // sectors of different proof types can't be aggregated together
+    std::map<RegisteredSealProof, std::vector<Batch>> batches;
+    for (auto &[sector, entry] : entries_) {
+      auto &type_batches{batches[entry.seal_proof]};
+      if (type_batches.empty() || type_batches.back().size() >= max_batch_) {
+        type_batches.emplace_back();
+      }
+      type_batches.back().push_back(std::move(entry));
+    }
+    entries_.clear();
+
+    for (const auto &[seal_proof, type_batches] : batches) {
+      for (const auto &batch : type_batches) {
+        if (batch.size() >= min_batch_) {
+          auto maybe_cid{sendAggregate(batch)};
+          if (maybe_cid) {
+            for (const auto &entry : batch) {
+              results.emplace_back(entry.callback, maybe_cid);
+            }
+            continue;
+          }
+          logger_->warn("aggregate of {} commits failed, sending singles: {}",
+                        batch.size(),
+                        maybe_cid.error().message());
+        }
+        for (const auto &entry : batch) {
+          results.emplace_back(entry.callback, sendSingle(entry));
+        }
+      }
+    }
+    return results;
+  }
+
+  outcome::result<CID> CommitBatcherImpl::sendAggregate(const Batch &batch) {
+    OUTCOME_TRY(head, api_->ChainHead());
+    OUTCOME_TRY(minfo, api_->StateMinerInfo(miner_address_, head->key));
+
+    // infos and proofs are ordered by sector number, same as actor expects
+    AggregateSealVerifyProofAndInfos aggregate{
+        .miner = miner_address_.getId(),
+        .seal_proof = batch.front().seal_proof,
+        .aggregate_proof = RegisteredAggregationProof::SnarkPackV1,
+        .proof = {},
+        .infos = {},
+    };
+    std::vector<BytesIn> proofs;
+    miner::ProveCommitAggregate::Params params;
+    TokenAmount collateral;
+    for (const auto &entry : batch) {
+      aggregate.infos.push_back(entry.input.info);
+      proofs.emplace_back(entry.input.proof);
+      params.sectors.insert(entry.input.info.number);
+      collateral += entry.input.collateral;
+    }
+    OUTCOME_TRY(proofs_->aggregateSealProofs(aggregate, proofs));
+    params.proof = std::move(aggregate.proof);
+
+    const TokenAmount max_fee =
+        fee_config_->max_commit_batch_gas_fee.FeeForSector(batch.size());
+    const auto base_fee = head->blks[0].parent_base_fee;
+    const TokenAmount agg_fee_raw =
+        aggregateProveCommitNetworkFee(batch.size(), base_fee);
+    static TokenAmount kAggFeeNum{110};
+    static TokenAmount kAggFeeDen{100};
+    const TokenAmount agg_fee = bigdiv(agg_fee_raw * kAggFeeNum, kAggFeeDen);
+    const auto need_funds = collateral + agg_fee;
+    const TokenAmount good_funds = max_fee + need_funds;
+
+    OUTCOME_TRY(encoded_params, codec::cbor::encode(params));
+    OUTCOME_TRY(address, address_selector_(minfo, good_funds, api_));
+    OUTCOME_TRY(signed_message,
+                api_->MpoolPushMessage(
+                    vm::message::UnsignedMessage(
+                        miner_address_,
+                        address,
+                        0,
+                        need_funds,
+                        max_fee,
+                        {},
+                        miner::ProveCommitAggregate::Number,
+                        MethodParams{encoded_params}),
+                    kPushNoSpec));
+
+    metricCommitMessages().Add({{"method", "aggregate"}}).Increment();
+    metricCommitBatchSize()
+        .Add({}, kCommitBatchSizeBuckets)
+        .Observe(static_cast<double>(batch.size()));
+    for (const auto &entry : batch) {
+      metricCommitBatchWait()
+          .Add({}, kCommitBatchWaitBuckets)
+          .Observe(entry.since.ms() / 1000);
+    }
+    return signed_message.getCid();
+  }
+
+  outcome::result<CID> CommitBatcherImpl::sendSingle(
+      const CommitEntry &entry) {
+    OUTCOME_TRY(head, api_->ChainHead());
+    OUTCOME_TRY(minfo, api_->StateMinerInfo(miner_address_, head->key));
+
+    const miner::ProveCommitSector::Params params{
+        .sector = entry.input.info.number,
+        .proof = entry.input.proof,
+    };
+    const auto &max_fee{fee_config_->max_commit_gas_fee};
+    const auto good_funds = max_fee + entry.input.collateral;
+
+    OUTCOME_TRY(encoded_params, codec::cbor::encode(params));
+    OUTCOME_TRY(address, address_selector_(minfo, good_funds, api_));
+    OUTCOME_TRY(signed_message,
+                api_->MpoolPushMessage(
+                    vm::message::UnsignedMessage(
+                        miner_address_,
+                        address,
+                        0,
+                        entry.input.collateral,
+                        max_fee,
+                        {},
+                        miner::ProveCommitSector::Number,
+                        MethodParams{encoded_params}),
+                    kPushNoSpec));
+
+    metricCommitMessages().Add({{"method", "single"}}).Increment();
+    metricCommitBatchWait()
+        .Add({}, kCommitBatchWaitBuckets)
+        .Observe(entry.since.ms() / 1000);
+    return signed_message.getCid();
+  }
+}  // namespace fc::mining
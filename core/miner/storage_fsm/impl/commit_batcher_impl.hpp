@@ -0,0 +1,99 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "miner/storage_fsm/commit_batcher.hpp"
+
+#include <chrono>
+#include <libp2p/basic/scheduler.hpp>
+#include <map>
+#include <mutex>
+#include "common/prometheus/since.hpp"
+#include "const.hpp"
+#include "miner/storage_fsm/types.hpp"
+#include "primitives/address/address.hpp"
+#include "proofs/proof_engine.hpp"
+
+namespace fc::mining {
+  using libp2p::basic::Scheduler;
+  using primitives::SectorNumber;
+  using primitives::address::Address;
+  using primitives::sector::RegisteredSealProof;
+  using types::FeeConfig;
+
+  /** Actor limits of ProveCommitAggregate */
+  constexpr size_t kMinAggregatedSectors{4};
+  constexpr size_t kMaxAggregatedSectors{819};
+
+  /** Batch is sent before sector deadline, so message has time to land */
+  constexpr ChainEpoch kCommitBatchSlack{kEpochsInHour};
+
+  class CommitBatcherImpl : public CommitBatcher {
+   public:
+    /**
+     * @param max_time - max delay between sector queuing and sending
+     * @param min_batch - smaller batches are sent as individual commits
+     * @param max_batch - batch is sent immediately when it reaches size
+     */
+    CommitBatcherImpl(const std::chrono::milliseconds &max_time,
+                      size_t min_batch,
+                      size_t max_batch,
+                      std::shared_ptr<FullNodeApi> api,
+                      Address miner_address,
+                      std::shared_ptr<Scheduler> scheduler,
+                      AddressSelector address_selector,
+                      std::shared_ptr<FeeConfig> fee_config,
+                      std::shared_ptr<proofs::ProofEngine> proofs);
+
+    outcome::result<void> addCommit(const SectorInfo &sector_info,
+                                    const AggregateInput &input,
+                                    const CommitCallback &callback) override;
+
+    void forceSend() override;
+
+   private:
+    struct CommitEntry {
+      RegisteredSealProof seal_proof{};
+      AggregateInput input;
+      CommitCallback callback;
+      Since since;
+    };
+    using Batch = std::vector<CommitEntry>;
+    /** Callbacks are called after mutex is released */
+    using Results =
+        std::vector<std::pair<CommitCallback, outcome::result<CID>>>;
+
+    Results sendWithoutLock();
+
+    outcome::result<CID> sendAggregate(const Batch &batch);
+
+    outcome::result<CID> sendSingle(const CommitEntry &entry);
+
+    ChainEpoch getCutoff(const SectorInfo &sector_info,
+                         const AggregateInput &input) const;
+
+    void reschedule(std::chrono::milliseconds time);
+
+    static void callback(const Results &results);
+
+    std::mutex mutex_;
+    std::map<SectorNumber, CommitEntry> entries_;
+    std::chrono::milliseconds max_delay_;
+    size_t min_batch_;
+    size_t max_batch_;
+    std::shared_ptr<FullNodeApi> api_;
+    Address miner_address_;
+    std::shared_ptr<Scheduler> scheduler_;
+    Scheduler::Handle handle_;
+    /** When scheduled send happens */
+    std::chrono::system_clock::time_point cutoff_;
+    common::Logger logger_;
+    std::shared_ptr<FeeConfig> fee_config_;
+    AddressSelector address_selector_;
+    std::shared_ptr<proofs::ProofEngine> proofs_;
+  };
+
+}  // namespace fc::mining
@@ -83,13 +83,14 @@ namespace fc::mining {
       std::shared_ptr<Events> events,
       Address miner_address,
       std::shared_ptr<Counter> counter,
-      std::shared_ptr<BufferMap> fsm_kv,
+      std::shared_ptr<PersistentBufferMap> fsm_kv,
       std::shared_ptr<Manager> sealer,
       std::shared_ptr<PreCommitPolicy> policy,
       const std::shared_ptr<boost::asio::io_context> &context,
       std::shared_ptr<Scheduler> scheduler,
       std::shared_ptr<StorageFSM> fsm,
       std::shared_ptr<PreCommitBatcher> precommit_batcher,
+      std::shared_ptr<CommitBatcher> commit_batcher,
       AddressSelector address_selector,
       std::shared_ptr<FeeConfig> fee_config,
       Config config)
@@ -100,17 +101,20 @@ namespace fc::mining {
         events_(std::move(events)),
         policy_(std::move(policy)),
         counter_(std::move(counter)),
-        fsm_kv_{std::move(fsm_kv)},
+        journal_{std::make_shared<SectorJournal>(std::move(fsm_kv),
+                                                 scheduler_)},
         miner_address_(std::move(miner_address)),
         fee_config_(std::move(fee_config)),
         sealer_(std::move(sealer)),
         precommit_batcher_(std::move(precommit_batcher)),
+        commit_batcher_(std::move(commit_batcher)),
         address_selector_(std::move(address_selector)),
         config_(config) {
     fsm_->setAnyChangeAction(
         [this](auto info, auto event, auto context, auto from, auto to) {
           callbackHandle(info, event, context, from, to);
         });
+    fsm_->setMetricsName("sealing", fsm::stateName<SealingState>);
     stat_ = std::make_shared<SectorStatImpl>();
     logger_ = common::createLogger("sealing");
   }
@@ -127,15 +131,17 @@ namespace fc::mining {
       const std::shared_ptr<Events> &events,
       const Address &miner_address,
       const std::shared_ptr<Counter> &counter,
-      const std::shared_ptr<BufferMap> &fsm_kv,
+      const std::shared_ptr<PersistentBufferMap> &fsm_kv,
       const std::shared_ptr<Manager> &sealer,
       const std::shared_ptr<PreCommitPolicy> &policy,
       const std::shared_ptr<boost::asio::io_context> &context,
       const std::shared_ptr<Scheduler> &scheduler,
       const std::shared_ptr<PreCommitBatcher> &precommit_batcher,
+      const std::shared_ptr<CommitBatcher> &commit_batcher,
       const AddressSelector &address_selector,
       const std::shared_ptr<FeeConfig> &fee_config,
       Config config) {
+    // handlers use scheduler, which is bound to io context
     OUTCOME_TRY(fsm,
                 StorageFSM::createFsm(makeFSMTransitions(), *context, true));
     struct make_unique_enabler : public SealingImpl {
@@ -144,13 +150,14 @@ namespace fc::mining {
           std::shared_ptr<Events> events,
           Address miner_address,
           std::shared_ptr<Counter> counter,
-          std::shared_ptr<BufferMap> fsm_kv,
+          std::shared_ptr<PersistentBufferMap> fsm_kv,
           std::shared_ptr<Manager> sealer,
           std::shared_ptr<PreCommitPolicy> policy,
           const std::shared_ptr<boost::asio::io_context> &context,
           std::shared_ptr<Scheduler> scheduler,
           std::shared_ptr<StorageFSM> fsm,
           std::shared_ptr<PreCommitBatcher> precommit_bathcer,
+          std::shared_ptr<CommitBatcher> commit_batcher,
           AddressSelector address_selector,
           std::shared_ptr<FeeConfig> fee_config,
           Config config)
@@ -165,6 +172,7 @@ namespace fc::mining {
                         std::move(scheduler),
                         std::move(fsm),
                         std::move(precommit_bathcer),
+                        std::move(commit_batcher),
                         std::move(address_selector),
                         std::move(fee_config),
                         config} {};
@@ -181,6 +189,7 @@ namespace fc::mining {
                                               scheduler,
                                               fsm,
                                               precommit_batcher,
+                                              commit_batcher,
                                               address_selector,
                                               fee_config,
                                               config);
@@ -214,22 +223,17 @@ namespace fc::mining {
   }
 
   outcome::result<void> SealingImpl::fsmLoad() {
-    if (auto it{fsm_kv_->cursor()}) {
-      for (it->seekToFirst(); it->isValid(); it->next()) {
-        OUTCOME_TRY(_info, codec::cbor::decode<SectorInfo>(it->value()));
-        auto info{std::make_shared<SectorInfo>(std::move(_info))};
-        sectors_.emplace(info->sector_number, info);
-        OUTCOME_TRY(fsm_->begin(info, info->state));
-        callbackHandle(info, {}, {}, {}, info->state);
-      }
+    OUTCOME_TRY(infos, journal_->load());
+    for (auto &info : infos) {
+      sectors_.emplace(info->sector_number, info);
+      OUTCOME_TRY(fsm_->begin(info, info->state));
+      callbackHandle(info, {}, {}, {}, info->state);
     }
     return outcome::success();
   }
 
   void SealingImpl::fsmSave(const std::shared_ptr<SectorInfo> &info) {
-    OUTCOME_EXCEPT(fsm_kv_->put(
-        copy(common::span::cbytes(std::to_string(info->sector_number))),
-        codec::cbor::encode(*info).value()));
+    OUTCOME_EXCEPT(journal_->save(*info));
   }
 
   outcome::result<PieceLocation> SealingImpl::addPieceToAnySector(
@@ -1792,6 +1796,11 @@ namespace fc::mining {
       collateral = 0;
     }
 
+    if (config_.aggregate_commits) {
+      return submitCommitAggregate(
+          info, head->key, collateral, precommit_info_opt->precommit_epoch);
+    }
+
     // TODO(ortyomka): check seed / ticket are up to date
     api_->MpoolPushMessage(
         [fsm{fsm_}, logger{logger_}, info](
@@ -1824,6 +1833,59 @@ namespace fc::mining {
     return outcome::success();
   }
 
+  outcome::result<void> SealingImpl::submitCommitAggregate(
+      const std::shared_ptr<SectorInfo> &info,
+      const TipsetKey &tipset_key,
+      const TokenAmount &collateral,
+      ChainEpoch precommit_epoch) {
+    if (not(info->comm_d.has_value() and info->comm_r.has_value())) {
+      logger_->error("sector {} had nil commR or commD", info->sector_number);
+      FSM_SEND(info, SealingEvent::kSectorCommitFailed);
+      return outcome::success();
+    }
+    OUTCOME_TRY(network, api_->StateNetworkVersion(tipset_key));
+    OUTCOME_TRY(max_prove_commit_duration,
+                checks::getMaxProveCommitDuration(network, info));
+
+    const AggregateInput input{
+        .info =
+            {
+                .number = info->sector_number,
+                .randomness = info->ticket,
+                .interactive_randomness = info->seed,
+                .sealed_cid = *info->comm_r,
+                .unsealed_cid = *info->comm_d,
+            },
+        .proof = info->proof,
+        .collateral = collateral,
+        .deadline = precommit_epoch + max_prove_commit_duration,
+    };
+
+    logger_->info("submitting commit for sector: {}", info->sector_number);
+    const auto maybe_error = commit_batcher_->addCommit(
+        *info, input, [=](const outcome::result<CID> &maybe_cid) -> void {
+          if (maybe_cid.has_error()) {
+            logger_->error("submitting message to commit batcher: {}",
+                           maybe_cid.error().message());
+            OUTCOME_EXCEPT(
+                fsm_->send(info, SealingEvent::kSectorCommitFailed, {}));
+            return;
+          }
+          std::shared_ptr<SectorCommittedContext> context =
+              std::make_shared<SectorCommittedContext>();
+          context->message = maybe_cid.value();
+          OUTCOME_EXCEPT(
+              fsm_->send(info, SealingEvent::kSectorCommitted, context));
+        });
+
+    if (maybe_error.has_error()) {
+      logger_->error("queuing commit batch failed: {:#}",
+                     maybe_error.error().message());
+      FSM_SEND(info, SealingEvent::kSectorCommitFailed);
+    }
+    return outcome::success();
+  }
+
   outcome::result<void> SealingImpl::handleCommitWait(
       const std::shared_ptr<SectorInfo> &info) {
     if (!info->message) {
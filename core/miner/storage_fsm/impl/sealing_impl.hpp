@@ -10,8 +10,10 @@
 #include "api/full_node/node_api.hpp"
 #include "common/logger.hpp"
 #include "fsm/fsm.hpp"
+#include "miner/storage_fsm/commit_batcher.hpp"
 #include "miner/storage_fsm/events.hpp"
 #include "miner/storage_fsm/impl/precommit_batcher_impl.hpp"
+#include "miner/storage_fsm/impl/sector_journal.hpp"
 #include "miner/storage_fsm/precommit_policy.hpp"
 #include "miner/storage_fsm/sealing_events.hpp"
 #include "miner/storage_fsm/sector_stat.hpp"
@@ -36,7 +38,7 @@ namespace fc::mining {
   using libp2p::basic::Scheduler;
   using primitives::Counter;
   using primitives::tipset::TipsetKey;
-  using storage::BufferMap;
+  using storage::PersistentBufferMap;
   using vm::actor::builtin::types::miner::SectorPreCommitInfo;
 
   class SealingImpl : public Sealing,
@@ -54,12 +56,13 @@ namespace fc::mining {
         const std::shared_ptr<Events> &events,
         const Address &miner_address,
         const std::shared_ptr<Counter> &counter,
-        const std::shared_ptr<BufferMap> &fsm_kv,
+        const std::shared_ptr<PersistentBufferMap> &fsm_kv,
         const std::shared_ptr<Manager> &sealer,
         const std::shared_ptr<PreCommitPolicy> &policy,
         const std::shared_ptr<boost::asio::io_context> &context,
         const std::shared_ptr<Scheduler> &scheduler,
         const std::shared_ptr<PreCommitBatcher> &precommit_batcher,
+        const std::shared_ptr<CommitBatcher> &commit_batcher,
         const AddressSelector &address_selector,
         const std::shared_ptr<FeeConfig> &fee_config,
         Config config);
@@ -96,13 +99,14 @@ namespace fc::mining {
                 std::shared_ptr<Events> events,
                 Address miner_address,
                 std::shared_ptr<Counter> counter,
-                std::shared_ptr<BufferMap> fsm_kv,
+                std::shared_ptr<PersistentBufferMap> fsm_kv,
                 std::shared_ptr<Manager> sealer,
                 std::shared_ptr<PreCommitPolicy> policy,
                 const std::shared_ptr<boost::asio::io_context> &context,
                 std::shared_ptr<Scheduler> scheduler,
                 std::shared_ptr<StorageFSM> fsm,
                 std::shared_ptr<PreCommitBatcher> precommit_batcher,
+                std::shared_ptr<CommitBatcher> commit_batcher,
                 AddressSelector address_selector,
                 std::shared_ptr<FeeConfig> fee_config,
                 Config config);
@@ -199,6 +203,16 @@ namespace fc::mining {
     outcome::result<void> handleCommitting(
         const std::shared_ptr<SectorInfo> &info);
 
+    /**
+     * @brief Queues sector proof to commit batcher, used by kCommitting when
+     * commits are aggregated
+     */
+    outcome::result<void> submitCommitAggregate(
+        const std::shared_ptr<SectorInfo> &info,
+        const TipsetKey &tipset_key,
+        const TokenAmount &collateral,
+        ChainEpoch precommit_epoch);
+
     /**
      * @brief Handle incoming in kCommitWait state
      */
@@ -403,7 +417,7 @@ namespace fc::mining {
     std::shared_ptr<PreCommitPolicy> policy_;
 
     std::shared_ptr<Counter> counter_;
-    std::shared_ptr<BufferMap> fsm_kv_;
+    std::shared_ptr<SectorJournal> journal_;
 
     std::shared_ptr<SectorStat> stat_;
 
@@ -414,6 +428,7 @@ namespace fc::mining {
     std::shared_ptr<Manager> sealer_;
 
     std::shared_ptr<PreCommitBatcher> precommit_batcher_;
+    std::shared_ptr<CommitBatcher> commit_batcher_;
 
     AddressSelector address_selector_;
 
@@ -0,0 +1,333 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "miner/storage_fsm/impl/sector_journal.hpp"
+
+#include <atomic>
+#include <boost/endian/buffers.hpp>
+#include <set>
+#include <thread>
+
+#include "codec/cbor/cbor_token.hpp"
+#include "common/error_text.hpp"
+#include "common/logger.hpp"
+#include "common/prometheus/sector_journal.hpp"
+#include "common/span.hpp"
+
+namespace fc::mining {
+  using boost::endian::big_uint64_buf_t;
+  using crypto::blake2b::blake2b_256;
+
+  namespace {
+    /** Sorts before decimal snapshot keys */
+    constexpr std::string_view kLogPrefix{"\0log/", 5};
+    /** Snapshots per decoding thread */
+    constexpr size_t kDecodePerThread{1024};
+
+    const common::Logger &log() {
+      static const common::Logger logger =
+          common::createLogger("sector journal");
+      return logger;
+    }
+
+    Bytes snapshotKey(SectorNumber sector) {
+      return copy(common::span::cbytes(std::to_string(sector)));
+    }
+
+    Bytes logKey(uint64_t seq) {
+      Bytes key{copy(common::span::cbytes(kLogPrefix))};
+      const big_uint64_buf_t seq_be{seq};
+      append(key, gsl::make_span(seq_be.data(), sizeof(seq_be)));
+      return key;
+    }
+
+    /** @return sequence of log key, or nothing if key is malformed */
+    boost::optional<uint64_t> logSeq(BytesIn key) {
+      if (key.size() != kLogPrefix.size() + sizeof(big_uint64_buf_t)) {
+        return boost::none;
+      }
+      big_uint64_buf_t seq_be;
+      std::copy(key.begin() + kLogPrefix.size(), key.end(), seq_be.data());
+      return seq_be.value();
+    }
+
+    SectorJournal::Messages messagesOf(const SectorInfo &info) {
+      return {info.precommit_message,
+              info.message,
+              info.fault_report_message,
+              info.update_message};
+    }
+
+    /** Digest of encoded SectorInfo without leading state field */
+    outcome::result<Blake2b256Hash> digestWithoutState(BytesIn encoded) {
+      codec::cbor::CborToken token;
+      if (!read(token, encoded).listCount()
+          || !codec::cbor::skipNested(encoded, 1)) {
+        return ERROR_TEXT("SectorJournal: invalid SectorInfo");
+      }
+      return blake2b_256(encoded);
+    }
+
+    /** Runs f(i) for i in [0, n) on several threads */
+    template <typename F>
+    void parallelFor(size_t n, const F &f) {
+      const size_t threads{std::min<size_t>(
+          n / kDecodePerThread + 1,
+          std::max(1u, std::thread::hardware_concurrency()))};
+      std::atomic_size_t next{0};
+      const auto work{[&] {
+        for (size_t i{}; (i = next++) < n;) {
+          f(i);
+        }
+      }};
+      std::vector<std::thread> pool;
+      for (size_t i{1}; i < threads; ++i) {
+        pool.emplace_back(work);
+      }
+      work();
+      for (auto &thread : pool) {
+        thread.join();
+      }
+    }
+
+    /** Encoded sector info with its decoded value */
+    struct Decoded {
+      std::error_code error;
+      SectorInfo info;
+      Blake2b256Hash digest;
+
+      void decode(BytesIn encoded) {
+        auto _info{codec::cbor::decode<SectorInfo>(encoded)};
+        if (!_info) {
+          error = _info.error();
+          return;
+        }
+        auto _digest{digestWithoutState(encoded)};
+        if (!_digest) {
+          error = _digest.error();
+          return;
+        }
+        info = std::move(_info.value());
+        digest = _digest.value();
+      }
+    };
+  }  // namespace
+
+  SectorJournal::SectorJournal(std::shared_ptr<PersistentBufferMap> kv,
+                               std::shared_ptr<Scheduler> scheduler)
+      : kv_{std::move(kv)}, scheduler_{std::move(scheduler)} {}
+
+  SectorJournal::~SectorJournal() {
+    std::unique_lock lock{mutex_};
+    auto flushed{flushWithoutLock()};
+    if (!flushed) {
+      log()->error("flush: {}", flushed.error().message());
+    }
+  }
+
+  outcome::result<std::vector<std::shared_ptr<SectorInfo>>>
+  SectorJournal::load() {
+    const Since since;
+    std::unique_lock lock{mutex_};
+    std::vector<std::pair<Bytes, Bytes>> snapshots;
+    std::vector<std::pair<Bytes, Bytes>> logs;
+    if (auto it{kv_->cursor()}) {
+      for (it->seekToFirst(); it->isValid(); it->next()) {
+        auto key{it->key()};
+        auto &items{startsWith(key, common::span::cbytes(kLogPrefix))
+                        ? logs
+                        : snapshots};
+        items.emplace_back(std::move(key), it->value());
+      }
+    }
+    // big endian sequence keeps log keys in transition order
+    std::sort(logs.begin(), logs.end());
+    if (!logs.empty()) {
+      // removal of log may fail, new records must not overwrite it
+      if (auto seq{logSeq(logs.back().first)}) {
+        next_seq_ = *seq + 1;
+        log_begin_ = next_seq_;
+      }
+    }
+
+    std::vector<Decoded> decoded_snapshots(snapshots.size());
+    parallelFor(snapshots.size(), [&](size_t i) {
+      decoded_snapshots[i].decode(snapshots[i].second);
+    });
+    std::vector<SectorJournalRecord> records(logs.size());
+    std::vector<boost::optional<Decoded>> decoded_logs(logs.size());
+    std::vector<std::error_code> log_errors(logs.size());
+    parallelFor(logs.size(), [&](size_t i) {
+      auto _record{codec::cbor::decode<SectorJournalRecord>(logs[i].second)};
+      if (!_record) {
+        log_errors[i] = _record.error();
+        return;
+      }
+      records[i] = std::move(_record.value());
+      if (records[i].info) {
+        decoded_logs[i].emplace();
+        decoded_logs[i]->decode(*records[i].info);
+      }
+    });
+
+    auto batch{kv_->batch()};
+    std::map<SectorNumber, std::shared_ptr<SectorInfo>> sectors;
+    std::set<SectorNumber> changed;
+    for (size_t i{}; i < snapshots.size(); ++i) {
+      auto &decoded{decoded_snapshots[i]};
+      if (decoded.error) {
+        return decoded.error;
+      }
+      const auto sector{decoded.info.sector_number};
+      // snapshot under other key is moved to canonical key
+      if (snapshots[i].first != snapshotKey(sector)) {
+        OUTCOME_TRY(batch->remove(snapshots[i].first));
+        changed.insert(sector);
+        if (sectors.count(sector) != 0) {
+          continue;
+        }
+      }
+      sectors[sector] = std::make_shared<SectorInfo>(std::move(decoded.info));
+      digests_[sector] = decoded.digest;
+    }
+    for (size_t i{}; i < logs.size(); ++i) {
+      if (log_errors[i]) {
+        return log_errors[i];
+      }
+      OUTCOME_TRY(batch->remove(logs[i].first));
+      const auto &record{records[i]};
+      if (auto &decoded{decoded_logs[i]}) {
+        if (decoded->error) {
+          return decoded->error;
+        }
+        sectors[record.sector] =
+            std::make_shared<SectorInfo>(std::move(decoded->info));
+        digests_[record.sector] = decoded->digest;
+      } else {
+        auto it{sectors.find(record.sector)};
+        if (it == sectors.end()) {
+          log()->warn("transition of unknown sector {}", record.sector);
+          continue;
+        }
+        it->second->state = record.state;
+      }
+      changed.insert(record.sector);
+    }
+
+    for (const auto &sector : changed) {
+      OUTCOME_TRY(encoded, codec::cbor::encode(*sectors.at(sector)));
+      metricSectorJournalBytes()
+          .Add({{"kind", "snapshot"}})
+          .Increment(static_cast<double>(encoded.size()));
+      OUTCOME_TRY(batch->put(snapshotKey(sector), std::move(encoded)));
+    }
+    // log is removed even if it changed nothing, e.g. of unknown sector
+    if (!changed.empty() || !logs.empty()) {
+      OUTCOME_TRY(batch->commit());
+    }
+
+    std::vector<std::shared_ptr<SectorInfo>> result;
+    result.reserve(sectors.size());
+    for (auto &[sector, info] : sectors) {
+      messages_[sector] = messagesOf(*info);
+      result.push_back(std::move(info));
+    }
+    const auto time{since.ms()};
+    metricSectorJournalLoadTime().Add({}).Set(time);
+    log()->info("loaded {} sectors and {} transitions in {:.0f}ms",
+                result.size(),
+                logs.size(),
+                time);
+    return result;
+  }
+
+  outcome::result<void> SectorJournal::save(const SectorInfo &info) {
+    std::unique_lock lock{mutex_};
+    OUTCOME_TRY(encoded, codec::cbor::encode(info));
+    OUTCOME_TRY(digest, digestWithoutState(encoded));
+    SectorJournalRecord record{info.sector_number, info.state, {}};
+    auto it{digests_.find(info.sector_number)};
+    if (it == digests_.end() || it->second != digest) {
+      record.info = encoded;
+      digests_[info.sector_number] = digest;
+    }
+    OUTCOME_TRY(value, codec::cbor::encode(record));
+    metricSectorJournalBytes()
+        .Add({{"kind", "log"}})
+        .Increment(static_cast<double>(value.size()));
+    if (!batch_) {
+      batch_ = kv_->batch();
+    }
+    OUTCOME_TRY(batch_->put(logKey(next_seq_++), std::move(value)));
+    dirty_[info.sector_number] = std::move(encoded);
+
+    ++pending_;
+    // message is already sent, losing its cid would make fsm send it again
+    auto messages{messagesOf(info)};
+    auto &saved_messages{messages_[info.sector_number]};
+    const auto sent{messages != saved_messages};
+    saved_messages = std::move(messages);
+    if (sent || pending_ >= kGroupCommitSize) {
+      return flushWithoutLock();
+    }
+    if (pending_ == 1) {
+      handle_ = scheduler_->scheduleWithHandle(
+          [this] {
+            auto flushed{flush()};
+            if (!flushed) {
+              log()->error("flush: {}", flushed.error().message());
+            }
+          },
+          kGroupCommitDelay);
+    }
+    return outcome::success();
+  }
+
+  outcome::result<void> SectorJournal::flush() {
+    std::unique_lock lock{mutex_};
+    return flushWithoutLock();
+  }
+
+  outcome::result<void> SectorJournal::flushWithoutLock() {
+    handle_.cancel();
+    if (pending_ == 0) {
+      return outcome::success();
+    }
+    auto batch{std::move(batch_)};
+    pending_ = 0;
+    auto committed{batch->commit()};
+    if (!committed) {
+      // next records of sectors must contain whole info
+      digests_.clear();
+      return committed;
+    }
+    if (next_seq_ - log_begin_ >= kSnapshotInterval) {
+      // records are written, log keeps them until fold is written
+      auto folded{snapshotWithoutLock()};
+      if (!folded) {
+        log()->warn("snapshot: {}", folded.error().message());
+      }
+    }
+    return outcome::success();
+  }
+
+  outcome::result<void> SectorJournal::snapshotWithoutLock() {
+    auto batch{kv_->batch()};
+    for (const auto &[sector, encoded] : dirty_) {
+      metricSectorJournalBytes()
+          .Add({{"kind", "snapshot"}})
+          .Increment(static_cast<double>(encoded.size()));
+      OUTCOME_TRY(batch->put(snapshotKey(sector), BytesIn{encoded}));
+    }
+    for (auto seq{log_begin_}; seq < next_seq_; ++seq) {
+      OUTCOME_TRY(batch->remove(logKey(seq)));
+    }
+    // state is kept on failure, fold is retried by next flush
+    OUTCOME_TRY(batch->commit());
+    dirty_.clear();
+    log_begin_ = next_seq_;
+    return outcome::success();
+  }
+}  // namespace fc::mining
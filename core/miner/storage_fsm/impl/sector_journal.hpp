@@ -0,0 +1,102 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <array>
+#include <libp2p/basic/scheduler.hpp>
+#include <mutex>
+#include <unordered_map>
+
+#include "crypto/blake2/blake2b160.hpp"
+#include "miner/storage_fsm/types.hpp"
+#include "storage/buffer_map.hpp"
+
+namespace fc::mining {
+  using crypto::blake2b::Blake2b256Hash;
+  using libp2p::basic::Scheduler;
+  using primitives::SectorNumber;
+  using storage::BufferBatch;
+  using storage::PersistentBufferMap;
+  using types::SectorInfo;
+
+  /**
+   * Transition of sector.
+   * Info is omitted when only state changed since previous record.
+   */
+  struct SectorJournalRecord {
+    SectorNumber sector{};
+    SealingState state{};
+    boost::optional<Bytes> info;
+  };
+  CBOR_TUPLE(SectorJournalRecord, sector, state, info)
+
+  /**
+   * Persists sealing fsm sectors as snapshots and append-only transition
+   * log.
+   * Snapshot is encoded SectorInfo under decimal sector number key, same
+   * layout as before the log was introduced.
+   * Log records are written by group commit, several transitions in one
+   * batch, but transitions recording sent message cid are written at once.
+   * Log is folded into snapshots periodically and on load.
+   */
+  class SectorJournal {
+   public:
+    /** Message cids of sector, written without delay when changed */
+    using Messages = std::array<boost::optional<CID>, 4>;
+
+    /** Log records after which log is folded into snapshots */
+    static constexpr size_t kSnapshotInterval{4096};
+    /** Pending records after which batch is written without delay */
+    static constexpr size_t kGroupCommitSize{256};
+    /**
+     * Max delay of pending records.
+     * Losing them on crash is same as crashing before transitions, which
+     * fsm already recovers from by restarting handlers of saved state.
+     */
+    static constexpr std::chrono::milliseconds kGroupCommitDelay{100};
+
+    SectorJournal(std::shared_ptr<PersistentBufferMap> kv,
+                  std::shared_ptr<Scheduler> scheduler);
+
+    /** Writes pending records */
+    ~SectorJournal();
+
+    /**
+     * Decodes snapshots in parallel, replays log and folds it into
+     * snapshots.
+     * @return sectors ordered by number
+     */
+    outcome::result<std::vector<std::shared_ptr<SectorInfo>>> load();
+
+    /** Appends sector transition to pending batch */
+    outcome::result<void> save(const SectorInfo &info);
+
+    /** Writes pending records */
+    outcome::result<void> flush();
+
+   private:
+    outcome::result<void> flushWithoutLock();
+
+    /** Folds written log into snapshots as separate batch */
+    outcome::result<void> snapshotWithoutLock();
+
+    std::shared_ptr<PersistentBufferMap> kv_;
+    std::shared_ptr<Scheduler> scheduler_;
+    Scheduler::Handle handle_;
+    std::mutex mutex_;
+    std::unique_ptr<BufferBatch> batch_;
+    size_t pending_{};
+    /** Sequence of next log record */
+    uint64_t next_seq_{};
+    /** Sequence of first log record not folded into snapshots */
+    uint64_t log_begin_{};
+    /** Digest of encoded info without state, to detect state transitions */
+    std::unordered_map<SectorNumber, Blake2b256Hash> digests_;
+    /** Latest encoded info of sectors changed since snapshot */
+    std::map<SectorNumber, Bytes> dirty_;
+    std::unordered_map<SectorNumber, Messages> messages_;
+  };
+}  // namespace fc::mining
@@ -33,6 +33,9 @@ namespace fc::mining {
     std::chrono::milliseconds wait_deals_delay{};  // in milliseconds
 
     bool batch_pre_commits = false;
+
+    // send ProveCommitAggregate through commit batcher
+    bool aggregate_commits = false;
   };
 
   class Sealing {
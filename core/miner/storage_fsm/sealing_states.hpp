@@ -7,6 +7,8 @@
 
 #include <cstdint>
 
+#include "common/enum.hpp"
+
 namespace fc::mining {
   /**
    * SealingState is an state that occurs in a sealing lifecycle
@@ -69,4 +71,55 @@ namespace fc::mining {
     // Hacks
     kForce,
   };
+  inline auto &classConversionMap(SealingState &&) {
+    using E = SealingState;
+    static fc::common::ConversionTable<E, 45> table{{
+        {E::kStateUnknown, "Unknown"},
+        {E::kSealPreCommit1Fail, "SealPreCommit1Failed"},
+        {E::kSealPreCommit2Fail, "SealPreCommit2Failed"},
+        {E::kPreCommitFail, "PreCommitFailed"},
+        {E::kComputeProofFail, "ComputeProofFailed"},
+        {E::kCommitFail, "CommitFailed"},
+        {E::kFinalizeFail, "FinalizeFailed"},
+        {E::kDealsExpired, "DealsExpired"},
+        {E::kRecoverDealIDs, "RecoverDealIDs"},
+        {E::kPacking, "Packing"},
+        {E::kWaitDeals, "WaitDeals"},
+        {E::kPreCommit1, "PreCommit1"},
+        {E::kPreCommit2, "PreCommit2"},
+        {E::kPreCommitting, "PreCommitting"},
+        {E::kSubmitPreCommitBatch, "SubmitPreCommitBatch"},
+        {E::kPreCommittingWait, "PreCommitWait"},
+        {E::kWaitSeed, "WaitSeed"},
+        {E::kComputeProof, "ComputeProof"},
+        {E::kCommitting, "Committing"},
+        {E::kCommitWait, "CommitWait"},
+        {E::kFinalizeSector, "FinalizeSector"},
+        {E::kProving, "Proving"},
+        {E::kSnapDealsWaitDeals, "SnapDealsWaitDeals"},
+        {E::kSnapDealsAddPiece, "SnapDealsAddPiece"},
+        {E::kSnapDealsPacking, "SnapDealsPacking"},
+        {E::kUpdateReplica, "UpdateReplica"},
+        {E::kProveReplicaUpdate, "ProveReplicaUpdate"},
+        {E::kSubmitReplicaUpdate, "SubmitReplicaUpdate"},
+        {E::kReplicaUpdateWait, "ReplicaUpdateWait"},
+        {E::kFinalizeReplicaUpdate, "FinalizeReplicaUpdate"},
+        {E::kUpdateActivating, "UpdateActivating"},
+        {E::kReleaseSectorKey, "ReleaseSectorKey"},
+        {E::kSnapDealsAddPieceFailed, "SnapDealsAddPieceFailed"},
+        {E::kSnapDealsDealsExpired, "SnapDealsDealsExpired"},
+        {E::kSnapDealsRecoverDealIDs, "SnapDealsRecoverDealIDs"},
+        {E::kAbortUpgrade, "AbortUpgrade"},
+        {E::kReplicaUpdateFailed, "ReplicaUpdateFailed"},
+        {E::kReleaseSectorKeyFailed, "ReleaseSectorKeyFailed"},
+        {E::kFinalizeReplicaUpdateFailed, "FinalizeReplicaUpdateFailed"},
+        {E::kFaulty, "Faulty"},
+        {E::kFaultReported, "FaultReported"},
+        {E::kRemoving, "Removing"},
+        {E::kRemoveFail, "RemoveFailed"},
+        {E::kRemoved, "Removed"},
+        {E::kForce, "Force"},
+    }};
+    return table;
+  }
 }  // namespace fc::mining
@@ -177,17 +177,9 @@ namespace fc::sync::blocksync {
                 BlocksyncRequest::Error::kInconsistentResponse);
           }
 
-          secp_cids.reserve(_msgs->secp_msgs.size());
-          for (const auto &msg : _msgs->secp_msgs) {
-            OUTCOME_EXCEPT(cid, setCbor(ipld, msg));
-            secp_cids.push_back(std::move(cid));
-          }
-
-          bls_cids.reserve(_msgs->bls_msgs.size());
-          for (const auto &msg : _msgs->bls_msgs) {
-            OUTCOME_EXCEPT(cid, setCbor(ipld, msg));
-            bls_cids.push_back(std::move(cid));
-          }
+          // hash messages of bundle together
+          secp_cids = OUTCOME_EXCEPT(setCborMany(ipld, _msgs->secp_msgs));
+          bls_cids = OUTCOME_EXCEPT(setCborMany(ipld, _msgs->bls_msgs));
         }
       } catch (const std::system_error &e) {
         log()->error("cannot store tipset bundle, {}", e.code().message());
@@ -64,6 +64,7 @@
 #include "storage/compacter/util.hpp"
 #include "storage/ipfs/graphsync/impl/graphsync_impl.hpp"
 #include "storage/ipfs/impl/datastore_leveldb.hpp"
+#include "storage/ipfs/node_cache.hpp"
 #include "storage/keystore/impl/filesystem/filesystem_keystore.hpp"
 #include "storage/leveldb/leveldb.hpp"
 #include "storage/mpool/mpool.hpp"
@@ -358,17 +359,23 @@ namespace fc::node {
                                            writableIpld(config, o),
                                            ts_mutex);
     o.ipld = std::make_shared<CbAsAnyIpld>(o.compacter);
+    if (config.ipld_node_cache_size != 0) {
+      o.ipld->node_cache = std::make_shared<storage::ipfs::NodeCache>(
+          config.ipld_node_cache_size);
+    }
 
     // estimated, 80gb
     o.compacter->compact_on_car = uint64_t{80} << 30;
     o.compacter->epochs_full_state = 30;
     o.compacter->epochs_lookback_state = 2400;
     o.compacter->epochs_messages = 60;
+    o.compacter->walk_threads =
+        std::max(1u, std::thread::hardware_concurrency());
 
     o.ts_load_ipld = std::make_shared<primitives::tipset::TsLoadIpld>(o.ipld);
     o.compacter->ts_load = o.ts_load_ipld;
     o.ts_load = std::make_shared<primitives::tipset::TsLoadCache>(
-        o.ts_load_ipld, 8 << 10);
+        o.ts_load_ipld, 8 << 10, 16);
 
     auto genesis_cids{storage::car::readHeader(config.genesisCar()).value()};
     assert(genesis_cids.size() == 1);
@@ -555,8 +562,14 @@ namespace fc::node {
 
     createMessagePool(config, o);
 
+    auto msg_index{std::make_shared<storage::blockchain::MsgIndex>(
+        o.ts_load,
+        o.ipld,
+        std::make_shared<storage::MapPrefix>("msg_index/", o.kv_store))};
     auto msg_waiter = storage::blockchain::MsgWaiter::create(
-        o.ts_load, o.ipld, o.io_context, o.chain_store);
+        o.ts_load, o.ipld, o.io_context, o.chain_store, msg_index);
+    // subscription indexed head, index older tipsets in background
+    msg_index->rebuild();
 
     o.key_store = std::make_shared<storage::keystore::FileSystemKeyStore>(
         (config.repo_path / "keystore").string(), bls_provider, secp_provider);
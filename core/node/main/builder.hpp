@@ -10,6 +10,7 @@
 
 #include "api/full_node/node_api.hpp"
 #include "api/full_node/node_api_v1_wrapper.hpp"
+#include "api/rpc/executor.hpp"
 #include "api/rpc/json.hpp"
 #include "api/types/key_info.hpp"
 #include "common/outcome.hpp"
@@ -121,6 +122,8 @@ namespace fc::node {
     std::shared_ptr<api::FullNodeApiV1Wrapper> api_v1;
     // Full node API v2.x.x (latest)
     std::shared_ptr<api::FullNodeApi> api;
+    // Runs slow API methods off io thread
+    std::shared_ptr<api::rpc::Executor> api_executor;
   };
 
   /**
@@ -71,6 +71,8 @@ namespace fc::node {
            "on first run, imports a default key from a given file. The key "
            "must be a BLS private key.");
     option("mpool_bls_cache_size", po::value(&config.mpool_bls_cache_size));
+    option("ipld_node_cache_size", po::value(&config.ipld_node_cache_size));
+    option("api_threads", po::value(&config.api_threads));
 
     po::options_description drand_desc("Drand server options");
     auto drand_option{drand_desc.add_options()};
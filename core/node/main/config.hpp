@@ -49,6 +49,10 @@ namespace fc::node {
     boost::optional<std::string> wallet_default_key_path;
 
     size_t mpool_bls_cache_size{1000};
+    /** Max number of decoded hamt/amt nodes cached, 0 disables cache */
+    size_t ipld_node_cache_size{0};
+    /** Threads running slow API methods */
+    size_t api_threads{4};
 
     static Config read(int argc, char *argv[]);
 
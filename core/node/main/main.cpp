@@ -244,6 +244,21 @@ namespace fc {
     metricApiTime(*rpc_v1);
     metricApiTime(*rpc);
 
+    // state queries and gas estimates may take seconds, don't block ChainHead
+    // and other methods served on io thread
+    const api::rpc::MethodLimits state_limits{2, 64};
+    const std::map<std::string, api::rpc::MethodLimits> offload{
+        {node_objects.api->GasEstimateMessageGas.getName(), {4, 64}},
+        {node_objects.api->StateCall.getName(), state_limits},
+        {node_objects.api->StateListMessages.getName(), state_limits},
+        {node_objects.api->StateMarketDeals.getName(), {1, 16}},
+        {node_objects.api->StateSearchMsg.getName(), state_limits},
+    };
+    node_objects.api_executor =
+        std::make_shared<api::rpc::Executor>(config.api_threads);
+    node_objects.api_executor->wrap(*rpc_v1, offload);
+    node_objects.api_executor->wrap(*rpc, offload);
+
     std::map<std::string, std::shared_ptr<api::Rpc>> rpcs;
     rpcs.emplace("/rpc/v0", rpc_v1);
     rpcs.emplace("/rpc/v1", rpc);
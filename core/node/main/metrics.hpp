@@ -64,6 +64,12 @@ namespace fc::node {
 
       metric("fd", fdUsage());
 
+      const auto ts_load_stats{o.ts_load->stats()};
+      metric("ts_load_cache_size", ts_load_stats.size);
+      metric("ts_load_cache_hits", ts_load_stats.hits);
+      metric("ts_load_cache_misses", ts_load_stats.misses);
+      metric("ts_load_cache_stale", ts_load_stats.stale);
+
       std::shared_lock ts_lock{*o.env_context.ts_branches_mutex};
       metric("ts_branches", o.ts_branches->size());
       auto height_head{o.ts_main->chain.rbegin()->first};
@@ -6,6 +6,7 @@
 #include "node/sync_job.hpp"
 
 #include "common/error_text.hpp"
+#include "common/libp2p/timer_loop.hpp"
 #include "common/logger.hpp"
 #include "common/outcome_fmt.hpp"
 #include "node/blocksync_common.hpp"
@@ -19,6 +20,8 @@ namespace fc::sync {
   using primitives::tipset::chain::stepParent;
 
   constexpr auto kBranchCompactTreshold{200u};
+  /** Tipsets prefetched ahead of interpreter */
+  constexpr size_t kPrefetchTipsets{8};
 
   namespace {
     auto log() {
@@ -112,6 +115,23 @@ namespace fc::sync {
     peers_ = std::make_shared<PeerHeight>(events_);
 
     fetch_msg_ = std::make_shared<FetchMsg>(host_, scheduler_, peers_, ipld_);
+    fetcher_ = std::make_unique<TipsetFetcher>(
+        [this](const PeerId &peer, const TipsetKey &tsk) {
+          return BlocksyncRequest::newRequest(
+              *host_,
+              *scheduler_,
+              ipld_,
+              put_block_header_,
+              peer,
+              tsk.cids(),
+              TipsetFetcher::kDepth,
+              blocksync::kBlocksOnly,
+              15000,
+              [this, tsk, peer](auto r) {
+                downloaderCallback(tsk, peer, std::move(r));
+              });
+        },
+        [this](ChainEpoch height, const auto &f) { peers_->visit(height, f); });
     fetch_msg_->on_fetch = [this](TipsetKey tsk) {
       std::unique_lock lock{*ts_branches_mutex_};
       if (interpret_ts_ && interpret_ts_->key == tsk) {
@@ -119,6 +139,8 @@ namespace fc::sync {
       }
     };
 
+    timerLoop(scheduler_, std::chrono::seconds{1}, [this] { fetchDequeue(); });
+
     possible_head_event_ =
         events_->subscribePossibleHead([this](const events::PossibleHead &e) {
           io_->post([=] { onPossibleHead(e); });
@@ -139,7 +161,7 @@ namespace fc::sync {
     if (auto ts{getLocal(e.head)}) {
       onTs(e.source, ts);
     } else if (e.source) {
-      fetch(*e.source, e.head);
+      fetch(*e.source, e.head, e.height);
     }
   }
 
@@ -227,7 +249,9 @@ namespace fc::sync {
             continue;
           }
           if (peer) {
-            fetch(*peer, *branch->parent_key);
+            fetch(*peer,
+                  *branch->parent_key,
+                  branch->chain.begin()->first - 1);
           }
         }
       }
@@ -373,6 +397,7 @@ namespace fc::sync {
       return;
     }
     interpreting_ = true;
+    prefetch(ts);
     interpret_thread.io->post([=] {
       auto result{interpreter_->interpret(branch, ts)};
       if (!result) {
@@ -405,64 +430,84 @@ namespace fc::sync {
     });
   }
 
-  void SyncJob::fetch(const PeerId &peer, const TipsetKey &tsk) {
+  void SyncJob::prefetch(TipsetCPtr ts) {
+    std::vector<TipsetCPtr> next;
+    for (size_t i{0}; i < kPrefetchTipsets; ++i) {
+      auto _ts{stepUp(ts_load_, attached_heaviest_.first, ts)};
+      if (!_ts || !_ts.value()) {
+        break;
+      }
+      ts = _ts.value();
+      // tipsets up to last prefetched were prefetched with it, unless head
+      // moved down or to other branch, and then it is not on the way
+      if (prefetch_last_ && ts->key == prefetch_last_->key) {
+        next.clear();
+        continue;
+      }
+      next.push_back(ts);
+    }
+    if (next.empty()) {
+      return;
+    }
+    prefetch_last_ = next.back();
+    prefetch_thread.io->post([this, next{std::move(next)}] {
+      for (const auto &ts : next) {
+        primitives::tipset::MessageVisitor visitor{ipld_, false, true};
+        for (const auto &block : ts->blks) {
+          if (!visitor.visit(block, [](auto &&...) {
+                return outcome::success();
+              })) {
+            break;
+          }
+        }
+      }
+    });
+  }
+
+  void SyncJob::fetch(const PeerId &peer,
+                      const TipsetKey &tsk,
+                      ChainEpoch height) {
     std::unique_lock lock{requests_mutex_};
-    requests_.emplace(peer, tsk);
+    requests_.emplace(peer, tsk, height);
     lock.unlock();
     io_->post([=] { fetchDequeue(); });
   }
 
   void SyncJob::fetchDequeue() {
     std::lock_guard lock{requests_mutex_};
-    static size_t hung_blocksync{};
-    if (request_ && Clock::now() >= request_expiry_) {
-      ++hung_blocksync;
-      log()->warn("hung blocksync {}", hung_blocksync);
-      request_.reset();
-    }
-    if (request_) {
-      return;
-    }
-    if (requests_.empty()) {
-      return;
-    }
-    auto [peer, tsk]{std::move(requests_.front())};
-    requests_.pop();
-    if (auto ts{getLocal(tsk)}) {
-      io_->post([=, peer{std::move(peer)}] { onTs(peer, ts); });
-      return;
+    const auto now{TipsetFetcher::Clock::now()};
+    fetcher_->tick(now);
+    while (fetcher_->size() < TipsetFetcher::kMaxFetching
+           && !requests_.empty()) {
+      auto [peer, tsk, height]{std::move(requests_.front())};
+      requests_.pop();
+      if (auto ts{getLocal(tsk)}) {
+        io_->post([=, peer{std::move(peer)}] { onTs(peer, ts); });
+        continue;
+      }
+      fetcher_->fetch(tsk, height, peer, now);
     }
-    uint64_t probable_depth = 100;
-    request_expiry_ = Clock::now() + std::chrono::seconds{20};
-    request_ = BlocksyncRequest::newRequest(
-        *host_,
-        *scheduler_,
-        ipld_,
-        put_block_header_,
-        peer,
-        tsk.cids(),
-        probable_depth,
-        blocksync::kBlocksOnly,
-        15000,
-        [this](auto r) { downloaderCallback(std::move(r)); });
   }
 
-  void SyncJob::downloaderCallback(BlocksyncRequest::Result r) {
-    std::unique_lock lock{requests_mutex_};
-    if (request_) {
-      request_.reset();
-    }
-    lock.unlock();
-
+  void SyncJob::downloaderCallback(const TipsetKey &tsk,
+                                   const PeerId &peer,
+                                   BlocksyncRequest::Result r) {
     TipsetCPtr ts;
     if (auto _ts{ts_load_->load(r.blocks_available)}) {
       ts = _ts.value();
     } else {
-      peers_->onError(*r.from);
+      peers_->onError(peer);
     }
 
+    std::unique_lock lock{requests_mutex_};
+    fetcher_->onResponse(tsk,
+                         peer,
+                         ts ? 1 + r.parents.size() : 0,
+                         TipsetFetcher::Clock::now());
+    lock.unlock();
+
     if (ts) {
-      io_->post([this, peer{r.from}, ts] { onTs(peer, ts); });
+      io_->post([this, peer, ts] { onTs(peer, ts); });
     }
 
     fetchDequeue();
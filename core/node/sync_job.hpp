@@ -10,6 +10,7 @@
 
 #include "common/io_thread.hpp"
 #include "node/blocksync_request.hpp"
+#include "node/tipset_fetcher.hpp"
 #include "primitives/tipset/chain.hpp"
 #include "storage/buffer_map.hpp"
 #include "vm/interpreter/interpreter.hpp"
@@ -71,11 +72,16 @@ namespace fc::sync {
 
     void interpretDequeue();
 
-    void fetch(const PeerId &peer, const TipsetKey &tsk);
+    /** Loads messages of next tipsets ahead of interpreter */
+    void prefetch(TipsetCPtr ts);
+
+    void fetch(const PeerId &peer, const TipsetKey &tsk, ChainEpoch height);
 
     void fetchDequeue();
 
-    void downloaderCallback(BlocksyncRequest::Result r);
+    void downloaderCallback(const TipsetKey &tsk,
+                            const PeerId &peer,
+                            BlocksyncRequest::Result r);
 
     std::shared_ptr<libp2p::Host> host_;
     std::shared_ptr<boost::asio::io_context> io_;
@@ -95,9 +101,13 @@ namespace fc::sync {
     TipsetCPtr interpret_ts_;
     bool interpreting_{false};
     IoThread interpret_thread;
+    /** Last tipset prefetched for interpreter */
+    TipsetCPtr prefetch_last_;
+    IoThread prefetch_thread;
 
     // TODO(turuslan): FIL-420 check cache memory usage
-    std::queue<std::pair<PeerId, TipsetKey>> requests_;
+    std::queue<std::tuple<PeerId, TipsetKey, ChainEpoch>> requests_;
+    std::unique_ptr<TipsetFetcher> fetcher_;
     std::mutex requests_mutex_;
 
     std::shared_ptr<events::Events> events_;
@@ -106,11 +116,6 @@ namespace fc::sync {
     events::Connection block_event_;
     events::Connection possible_head_event_;
 
-    std::shared_ptr<BlocksyncRequest> request_;
-
-    using Clock = std::chrono::steady_clock;
-    Clock::time_point request_expiry_;
-
     std::shared_ptr<PeerHeight> peers_;
     std::shared_ptr<FetchMsg> fetch_msg_;
   };
@@ -0,0 +1,185 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "node/tipset_fetcher.hpp"
+
+#include <algorithm>
+
+#include "common/logger.hpp"
+
+namespace fc::sync {
+  namespace {
+    auto log() {
+      static common::Logger logger = common::createLogger("tipset_fetcher");
+      return logger.get();
+    }
+
+    bool asked(const std::vector<PeerId> &peers, const PeerId &peer) {
+      return std::find(peers.begin(), peers.end(), peer) != peers.end();
+    }
+  }  // namespace
+
+  TipsetFetcher::TipsetFetcher(Send send, VisitPeers visit_peers)
+      : send_{std::move(send)}, visit_peers_{std::move(visit_peers)} {}
+
+  size_t TipsetFetcher::size() const {
+    return fetching_.size();
+  }
+
+  bool TipsetFetcher::fetch(const TipsetKey &tsk,
+                            ChainEpoch height,
+                            const boost::optional<PeerId> &hint,
+                            Clock::time_point now) {
+    auto [it, inserted]{fetching_.emplace(tsk, Fetching{})};
+    if (!inserted) {
+      return true;
+    }
+    it->second.height = height;
+    it->second.expiry = now + kExpiry;
+    if (!request(tsk, it->second, hint, now)) {
+      fetching_.erase(it);
+      return false;
+    }
+    return true;
+  }
+
+  void TipsetFetcher::tick(Clock::time_point now) {
+    static size_t hung_blocksync{};
+    for (auto it{fetching_.begin()}; it != fetching_.end();) {
+      auto &fetching{it->second};
+      if (now >= fetching.expiry) {
+        ++hung_blocksync;
+        log()->warn("hung blocksync {}", hung_blocksync);
+        for (auto &request : fetching.requests) {
+          penalize(request.peer);
+        }
+        it = fetching_.erase(it);
+        continue;
+      }
+      if (now >= fetching.hedge_time
+          && fetching.peers.size() < kMaxPeersPerFetch) {
+        // slow peer, ask another one
+        if (!request(it->first, fetching, boost::none, now)) {
+          fetching.hedge_time = now + kHedgeMin;
+        }
+      }
+      if (fetching.requests.empty()) {
+        it = fetching_.erase(it);
+        continue;
+      }
+      ++it;
+    }
+  }
+
+  void TipsetFetcher::onResponse(const TipsetKey &tsk,
+                                 const PeerId &peer,
+                                 size_t tipsets,
+                                 Clock::time_point now) {
+    auto it{fetching_.find(tsk)};
+    if (it == fetching_.end()) {
+      // other peer responded first
+      return;
+    }
+    auto &requests{it->second.requests};
+    const auto responded{
+        std::find_if(requests.begin(), requests.end(), [&](auto &request) {
+          return request.peer == peer;
+        })};
+    if (responded == requests.end()) {
+      return;
+    }
+    if (tipsets == 0) {
+      penalize(peer);
+      requests.erase(responded);
+      it->second.hedge_time = now;
+      return;
+    }
+    const auto ms{
+        std::chrono::duration<double, std::milli>(now - responded->started)
+            .count()
+        / static_cast<double>(tipsets)};
+    auto &stats{peer_stats_[peer]};
+    stats.ms_per_ts =
+        stats.ms_per_ts == 0 ? ms : (ms + 3 * stats.ms_per_ts) / 4;
+    // first response wins, other requests are cancelled
+    for (auto &request : requests) {
+      done(request.peer);
+    }
+    fetching_.erase(it);
+  }
+
+  bool TipsetFetcher::request(const TipsetKey &tsk,
+                              Fetching &fetching,
+                              const boost::optional<PeerId> &hint,
+                              Clock::time_point now) {
+    auto peer{choosePeer(fetching, hint)};
+    if (!peer) {
+      return false;
+    }
+    auto &stats{peer_stats_[*peer]};
+    ++stats.in_flight;
+    fetching.hedge_time =
+        now
+        + std::max<Clock::duration>(
+            kHedgeMin,
+            std::chrono::milliseconds{
+                static_cast<int64_t>(2 * stats.ms_per_ts * kDepth)});
+    fetching.peers.push_back(*peer);
+    fetching.requests.push_back({*peer, now, send_(*peer, tsk)});
+    return true;
+  }
+
+  boost::optional<PeerId> TipsetFetcher::choosePeer(
+      const Fetching &fetching, const boost::optional<PeerId> &hint) {
+    boost::optional<PeerId> best;
+    double best_score{};
+    auto consider{[&](const PeerId &peer) {
+      if (asked(fetching.peers, peer)) {
+        return;
+      }
+      double score{};
+      size_t in_flight{};
+      auto it{peer_stats_.find(peer)};
+      if (it != peer_stats_.end()) {
+        score = it->second.ms_per_ts;
+        in_flight = it->second.in_flight;
+      }
+      if (in_flight >= kMaxFetchPerPeer) {
+        return;
+      }
+      // busy peer responds slower
+      score *= 1 + in_flight;
+      if (!best || score < best_score) {
+        best = peer;
+        best_score = score;
+      }
+    }};
+    if (hint) {
+      consider(*hint);
+    }
+    visit_peers_(fetching.height, [&](const PeerId &peer) {
+      consider(peer);
+      return true;
+    });
+    if (!best && hint && !asked(fetching.peers, *hint)) {
+      // announcing peer is asked even if busy
+      best = *hint;
+    }
+    return best;
+  }
+
+  void TipsetFetcher::done(const PeerId &peer) {
+    auto &stats{peer_stats_[peer]};
+    if (stats.in_flight != 0) {
+      --stats.in_flight;
+    }
+  }
+
+  void TipsetFetcher::penalize(const PeerId &peer) {
+    done(peer);
+    auto &stats{peer_stats_[peer]};
+    stats.ms_per_ts = std::max(2 * stats.ms_per_ts, kPenaltyMs);
+  }
+}  // namespace fc::sync
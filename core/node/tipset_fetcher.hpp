@@ -0,0 +1,129 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <unordered_map>
+
+#include "node/common.hpp"
+
+namespace fc::sync {
+  using primitives::ChainEpoch;
+
+  /**
+   * Chooses peers for tipset fetch requests.
+   * Each request goes to the fastest known peer at the needed height,
+   * ranked by moving average of milliseconds per returned tipset.
+   * Unknown peers are tried first, failed peers are penalized.
+   * Slow request is hedged by asking another peer, first response wins.
+   * Not thread safe.
+   */
+  class TipsetFetcher {
+   public:
+    using Clock = std::chrono::steady_clock;
+    /**
+     * Sends request for tipset with parents to peer.
+     * Returned handle owns request, it is dropped when fetch ends.
+     * Response must be reported later, not from send.
+     */
+    using Send = std::function<std::shared_ptr<void>(const PeerId &peer,
+                                                     const TipsetKey &tsk)>;
+    /** Visits peers with head at or above height, until f returns false */
+    using VisitPeers = std::function<void(
+        ChainEpoch height, const std::function<bool(const PeerId &)> &f)>;
+
+    /** Max tipsets fetched concurrently */
+    static constexpr size_t kMaxFetching{8};
+    /** Max peers asked for same tipset */
+    static constexpr size_t kMaxPeersPerFetch{3};
+    /** Max concurrent requests to same peer */
+    static constexpr size_t kMaxFetchPerPeer{2};
+    /** Tipsets requested with parents */
+    static constexpr uint64_t kDepth{100};
+    static constexpr std::chrono::seconds kExpiry{20};
+    /** Min time before asking another peer */
+    static constexpr std::chrono::seconds kHedgeMin{5};
+    /** Moving average assigned to failed peer */
+    static constexpr double kPenaltyMs{1000};
+
+    TipsetFetcher(Send send, VisitPeers visit_peers);
+
+    /** Count of tipsets being fetched */
+    size_t size() const;
+
+    /**
+     * Starts fetching tipset unless it is fetched already
+     * @param height - height hint to choose peers
+     * @param hint - peer which announced tipset, asked if no other peer
+     * @return false if no peer to ask
+     */
+    bool fetch(const TipsetKey &tsk,
+               ChainEpoch height,
+               const boost::optional<PeerId> &hint,
+               Clock::time_point now);
+
+    /** Drops hung fetches and asks another peer for slow ones */
+    void tick(Clock::time_point now);
+
+    /**
+     * Handles response of peer
+     * @param tipsets - count of returned tipsets, 0 if requested tipset is
+     * missing from response
+     */
+    void onResponse(const TipsetKey &tsk,
+                    const PeerId &peer,
+                    size_t tipsets,
+                    Clock::time_point now);
+
+   private:
+    struct Request {
+      PeerId peer;
+      Clock::time_point started;
+      std::shared_ptr<void> handle;
+    };
+
+    /** Tipset being fetched, possibly from several peers */
+    struct Fetching {
+      ChainEpoch height{};
+      /** Peers asked for tipset */
+      std::vector<PeerId> peers;
+      std::vector<Request> requests;
+      /** Another peer is asked after this time */
+      Clock::time_point hedge_time;
+      Clock::time_point expiry;
+    };
+
+    /** Measured blocksync performance of peer */
+    struct PeerStats {
+      /** Moving average of milliseconds per tipset */
+      double ms_per_ts{};
+      size_t in_flight{};
+    };
+
+    /**
+     * Requests tipset from best peer not asked yet
+     * @return false if no peer to ask
+     */
+    bool request(const TipsetKey &tsk,
+                 Fetching &fetching,
+                 const boost::optional<PeerId> &hint,
+                 Clock::time_point now);
+
+    /** Chooses fastest not busy peer, unknown peers are tried first */
+    boost::optional<PeerId> choosePeer(const Fetching &fetching,
+                                       const boost::optional<PeerId> &hint);
+
+    void done(const PeerId &peer);
+
+    void penalize(const PeerId &peer);
+
+    Send send_;
+    VisitPeers visit_peers_;
+    std::map<TipsetKey, Fetching> fetching_;
+    std::unordered_map<PeerId, PeerStats> peer_stats_;
+  };
+}  // namespace fc::sync
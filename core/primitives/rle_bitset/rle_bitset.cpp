@@ -0,0 +1,207 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "primitives/rle_bitset/rle_bitset.hpp"
+
+#include <algorithm>
+
+namespace fc::primitives {
+  namespace {
+    /// Appends run of given polarity to canonical runs, merging neighbours
+    void appendRun(RleBitset::Runs &runs, bool set, uint64_t run) {
+      if (run == 0) {
+        return;
+      }
+      if (runs.empty()) {
+        if (set) {
+          runs.push_back(0);
+        }
+        runs.push_back(run);
+      } else if ((runs.size() % 2 == 0) == set) {
+        runs.back() += run;
+      } else {
+        runs.push_back(run);
+      }
+    }
+  }  // namespace
+
+  RleBitset::RleBitset(const std::set<uint64_t> &set)
+      : RleBitset{fromRuns(codec::rle::toRuns(set))} {}
+
+  RleBitset RleBitset::fromRuns(const Runs &runs) {
+    RleBitset result;
+    result.runs_.reserve(runs.size());
+    bool set{false};
+    for (const auto run : runs) {
+      appendRun(result.runs_, set, run);
+      set = !set;
+    }
+    if (result.runs_.size() % 2 != 0) {
+      result.runs_.pop_back();
+    }
+    for (size_t i{0}; i < result.runs_.size(); i += 2) {
+      result.end_ += result.runs_[i] + result.runs_[i + 1];
+      result.count_ += result.runs_[i + 1];
+    }
+    return result;
+  }
+
+  bool RleBitset::has(uint64_t v) const {
+    if (v >= end_) {
+      return false;
+    }
+    uint64_t offset{0};
+    for (size_t i{0}; i < runs_.size(); i += 2) {
+      offset += runs_[i];
+      if (v < offset) {
+        return false;
+      }
+      offset += runs_[i + 1];
+      if (v < offset) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  RleBitset::const_iterator RleBitset::find(uint64_t v) const {
+    if (v >= end_) {
+      return end();
+    }
+    uint64_t offset{0};
+    for (size_t i{0}; i < runs_.size(); i += 2) {
+      offset += runs_[i];
+      if (v < offset) {
+        break;
+      }
+      offset += runs_[i + 1];
+      if (v < offset) {
+        return {&runs_, i + 1, v, offset};
+      }
+    }
+    return end();
+  }
+
+  bool RleBitset::insert(uint64_t v) {
+    if (v >= end_) {
+      if (!runs_.empty() && v == end_) {
+        ++runs_.back();
+      } else {
+        runs_.push_back(v - end_);
+        runs_.push_back(1);
+      }
+      end_ = v + 1;
+      ++count_;
+      return true;
+    }
+    if (has(v)) {
+      return false;
+    }
+    *this = fromRuns(runsOr(runs_, Runs{v, 1}));
+    return true;
+  }
+
+  size_t RleBitset::erase(uint64_t v) {
+    if (!has(v)) {
+      return 0;
+    }
+    *this = fromRuns(runsAnd(runs_, Runs{v, 1}, true));
+    return 1;
+  }
+
+  void RleBitset::operator+=(const RleBitset &other) {
+    if (other.empty()) {
+      return;
+    }
+    if (empty()) {
+      *this = other;
+      return;
+    }
+    *this = fromRuns(runsOr(runs_, other.runs_));
+  }
+
+  void RleBitset::operator-=(const RleBitset &other) {
+    if (empty() || other.empty()) {
+      return;
+    }
+    *this = fromRuns(runsAnd(runs_, other.runs_, true));
+  }
+
+  RleBitset RleBitset::cut(const RleBitset &to_cut) const {
+    // bits left after subtraction never overlap cut runs, so each remaining
+    // run is shifted by number of cut bits below it
+    const auto left{*this - to_cut};
+    Runs runs;
+    uint64_t shift{0};
+    uint64_t cut_offset{0};
+    size_t cut_run{0};
+    uint64_t offset{0};
+    uint64_t last{0};
+    for (size_t i{0}; i < left.runs_.size(); i += 2) {
+      offset += left.runs_[i];
+      while (cut_run < to_cut.runs_.size()) {
+        const auto cut_begin{cut_offset + to_cut.runs_[cut_run]};
+        if (cut_begin >= offset) {
+          break;
+        }
+        shift += to_cut.runs_[cut_run + 1];
+        cut_offset = cut_begin + to_cut.runs_[cut_run + 1];
+        cut_run += 2;
+      }
+      const auto begin{offset - shift};
+      appendRun(runs, false, begin - last);
+      appendRun(runs, true, left.runs_[i + 1]);
+      offset += left.runs_[i + 1];
+      last = begin + left.runs_[i + 1];
+    }
+    return fromRuns(runs);
+  }
+
+  RleBitset RleBitset::intersect(const RleBitset &other) const {
+    if (empty() || other.empty()) {
+      return {};
+    }
+    return fromRuns(runsAnd(runs_, other.runs_));
+  }
+
+  RleBitset RleBitset::slice(uint64_t start, uint64_t count) const {
+    assert(start + count <= size());
+    Runs runs;
+    uint64_t offset{0};
+    uint64_t last{0};
+    for (size_t i{0}; i < runs_.size() && count != 0; i += 2) {
+      offset += runs_[i];
+      const auto run{runs_[i + 1]};
+      if (start >= run) {
+        start -= run;
+        offset += run;
+        continue;
+      }
+      const auto begin{offset + start};
+      const auto take{std::min(run - start, count)};
+      appendRun(runs, false, begin - last);
+      appendRun(runs, true, take);
+      last = begin + take;
+      count -= take;
+      start = 0;
+      offset += run;
+    }
+    return fromRuns(runs);
+  }
+
+  bool RleBitset::contains(const RleBitset &other) const {
+    if (other.empty()) {
+      return true;
+    }
+    if (other.count_ > count_ || other.end_ > end_) {
+      return false;
+    }
+    return (other - *this).empty();
+  }
+
+  bool RleBitset::containsAny(const RleBitset &other) const {
+    return !intersect(other).empty();
+  }
+}  // namespace fc::primitives
@@ -5,31 +5,188 @@
 
 #pragma once
 
+#include <cassert>
+#include <iterator>
 #include <set>
+#include <vector>
 
 #include "codec/cbor/streams_annotation.hpp"
 #include "codec/rle/rle_plus.hpp"
 #include "common/outcome.hpp"
+#include "primitives/rle_bitset/runs_utils.hpp"
 
 namespace fc::primitives {
-  struct RleBitset : public std::set<uint64_t> {
-    using set::set;
+  /**
+   * Set of unsigned integers stored as runs of alternating unset and set bits
+   * (same layout as codec::rle::toRuns and runs_utils).
+   * Set operations cost O(runs) instead of O(bits), so contiguous sector
+   * ranges take a few words of memory.
+   * Runs are kept canonical: first run is unset (may be zero), other runs are
+   * non-zero, last run is set.
+   */
+  class RleBitset {
+   public:
+    using value_type = uint64_t;
+    using size_type = size_t;
+    using Runs = std::vector<uint64_t>;
+
+    /** Ordered iterator over set bits */
+    class const_iterator {
+     public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = uint64_t;
+      using difference_type = ptrdiff_t;
+      using pointer = const uint64_t *;
+      using reference = uint64_t;
+
+      const_iterator() = default;
+
+      inline uint64_t operator*() const {
+        return value_;
+      }
+
+      inline const_iterator &operator++() {
+        ++value_;
+        if (value_ == run_end_) {
+          run_ += 2;
+          if (run_ < runs_->size()) {
+            value_ = run_end_ + (*runs_)[run_ - 1];
+            run_end_ = value_ + (*runs_)[run_];
+          } else {
+            value_ = 0;
+            run_end_ = 0;
+          }
+        }
+        return *this;
+      }
+
+      inline const_iterator operator++(int) {
+        auto it{*this};
+        ++*this;
+        return it;
+      }
+
+      inline bool operator==(const const_iterator &other) const {
+        return run_ == other.run_ && value_ == other.value_;
+      }
+
+      inline bool operator!=(const const_iterator &other) const {
+        return !(*this == other);
+      }
+
+     private:
+      friend class RleBitset;
+
+      const_iterator(const Runs *runs,
+                     size_t run,
+                     uint64_t value,
+                     uint64_t run_end)
+          : runs_{runs}, run_{run}, value_{value}, run_end_{run_end} {}
+
+      const Runs *runs_{};
+      /** Index of current set run, runs size + 1 for end */
+      size_t run_{};
+      uint64_t value_{};
+      uint64_t run_end_{};
+    };
+    using iterator = const_iterator;
+
+    RleBitset() = default;
+
+    inline RleBitset(std::initializer_list<uint64_t> values)
+        : RleBitset(values.begin(), values.end()) {}
+
+    template <typename It>
+    RleBitset(It first, It last) {
+      insert(first, last);
+    }
 
     // TODO (a.chernyshov) make constructors explicit (FIL-415)
     // NOLINTNEXTLINE(google-explicit-constructor)
-    inline RleBitset(set &&s) : set{s} {}
+    RleBitset(const std::set<uint64_t> &set);
+
+    /**
+     * Construct from runs, runs are normalized
+     * @param runs - alternating unset/set run lengths, starting with unset
+     */
+    static RleBitset fromRuns(const Runs &runs);
+
+    inline const Runs &runs() const {
+      return runs_;
+    }
+
+    inline const_iterator begin() const {
+      if (runs_.empty()) {
+        return end();
+      }
+      return {&runs_, 1, runs_[0], runs_[0] + runs_[1]};
+    }
+
+    inline const_iterator end() const {
+      return {&runs_, runs_.size() + 1, 0, 0};
+    }
+
+    inline const_iterator cbegin() const {
+      return begin();
+    }
+
+    inline const_iterator cend() const {
+      return end();
+    }
+
+    /** Number of set bits, O(1) */
+    inline size_t size() const {
+      return count_;
+    }
+
+    inline bool empty() const {
+      return runs_.empty();
+    }
+
+    inline void clear() {
+      runs_.clear();
+      count_ = 0;
+      end_ = 0;
+    }
+
+    /** Largest set bit, set must not be empty */
+    inline uint64_t back() const {
+      assert(!empty());
+      return end_ - 1;
+    }
+
+    bool has(uint64_t v) const;
 
-    inline bool has(uint64_t v) const {
-      return find(v) != end();
+    inline size_t count(uint64_t v) const {
+      return has(v) ? 1 : 0;
     }
 
-    inline void operator+=(const RleBitset &other) {
-      insert(other.begin(), other.end());
+    const_iterator find(uint64_t v) const;
+
+    /**
+     * Insert bit, appending above largest bit is O(1)
+     * @return true if bit was not set
+     */
+    bool insert(uint64_t v);
+
+    template <typename It>
+    void insert(It first, It last) {
+      for (; first != last; ++first) {
+        insert(*first);
+      }
     }
 
+    /**
+     * Unset bit
+     * @return number of erased bits
+     */
+    size_t erase(uint64_t v);
+
+    void operator+=(const RleBitset &other);
+
     inline void operator+=(const std::vector<RleBitset> &others) {
       for (const auto &other : others) {
-        insert(other.begin(), other.end());
+        *this += other;
       }
     }
 
@@ -41,17 +198,11 @@ namespace fc::primitives {
 
     inline RleBitset operator+(const std::vector<RleBitset> &others) const {
       auto result{*this};
-      for (const auto &other : others) {
-        result += other;
-      }
+      result += others;
       return result;
     }
 
-    inline void operator-=(const RleBitset &other) {
-      for (const auto i : other) {
-        erase(i);
-      }
-    }
+    void operator-=(const RleBitset &other);
 
     inline RleBitset operator-(const RleBitset &other) const {
       auto result{*this};
@@ -59,80 +210,65 @@ namespace fc::primitives {
       return result;
     }
 
-    inline RleBitset cut(const RleBitset &to_cut) const {
-      RleBitset result;
-      uint64_t shift = 0;
-      auto it = to_cut.begin();
-      for (const auto element : *this) {
-        while ((it != to_cut.end()) && (*it < element)) {
-          ++shift;
-          ++it;
-        }
-        if (it == to_cut.end() || *it > element) {
-          result.insert(element - shift);
-        }
-      }
-      return result;
-    }
+    /**
+     * Removes bits of to_cut and shifts remaining bits down to fill the gaps
+     * @param to_cut - bits to cut out
+     * @return cut bitset
+     */
+    RleBitset cut(const RleBitset &to_cut) const;
 
-    inline RleBitset intersect(const RleBitset &other) const {
-      RleBitset result;
-      for (const auto i : other) {
-        if (this->has(i)) {
-          result.insert(i);
-        }
-      }
-      return result;
-    }
+    RleBitset intersect(const RleBitset &other) const;
 
-    inline RleBitset slice(uint64_t start, uint64_t count) const {
-      assert(start + count <= size());
-      const auto it{std::next(begin(), static_cast<ptrdiff_t>(start))};
-      return {it, std::next(it, static_cast<ptrdiff_t>(count))};
-    }
+    /**
+     * Selects set bits by their ordinal positions
+     * @param start - ordinal of first bit to select
+     * @param count - number of bits to select
+     * @return selected bits
+     */
+    RleBitset slice(uint64_t start, uint64_t count) const;
 
     /**
      * Checks that current bitset contains all bits of other bitset
      * @param other - other bitset to check
      * @return true if contains all bits
      */
-    inline bool contains(const RleBitset &other) const {
-      bool result = true;
-      for (const auto i : other) {
-        if (!this->has(i)) {
-          result = false;
-          break;
-        }
-      }
-      return result;
-    }
+    bool contains(const RleBitset &other) const;
 
     /**
      * Checks that current bitset contains any bit of other bitset
      * @param other - other bitset to check
      * @return true if contains any bit
      */
-    inline bool containsAny(const RleBitset &other) const {
-      bool result = false;
-      for (const auto i : other) {
-        if (this->has(i)) {
-          result = true;
-          break;
-        }
-      }
-      return result;
+    bool containsAny(const RleBitset &other) const;
+
+    inline bool operator==(const RleBitset &other) const {
+      return runs_ == other.runs_;
+    }
+
+    inline bool operator!=(const RleBitset &other) const {
+      return !(*this == other);
     }
+
+   private:
+    Runs runs_;
+    /** Number of set bits */
+    size_t count_{};
+    /** Largest set bit + 1 */
+    uint64_t end_{};
   };
 
   CBOR_ENCODE(RleBitset, set) {
-    return s << codec::rle::encode(set);
+    return s << codec::rle::encodeRuns(set.runs());
   }
 
   CBOR_DECODE(RleBitset, set) {
     std::vector<uint8_t> rle;
     s >> rle;
-    OUTCOME_EXCEPT(decoded, codec::rle::decode<RleBitset::value_type>(rle));
-    set = RleBitset{std::move(decoded)};
+    if (rle.size() > codec::rle::BYTES_MAX_SIZE) {
+      outcome::raise(codec::rle::RLEPlusDecodeError::kMaxSizeExceed);
+    }
+    OUTCOME_EXCEPT(runs, runsFromBuffer(rle));
+    set = RleBitset::fromRuns(runs);
     return s;
   }
 }  // namespace fc::primitives
@@ -6,7 +6,6 @@
 #include "primitives/tipset/chain.hpp"
 
 #include "common/error_text.hpp"
-#include "common/file.hpp"
 #include "primitives/tipset/file.hpp"
 #include "vm/actor/builtin/types/miner/policy.hpp"
 #include "vm/version/version.hpp"
@@ -83,44 +82,37 @@ namespace fc::primitives::tipset::chain {
     return lazy ? lazy->bottom : *chain.begin();
   }
 
-  // NOLINTNEXTLINE(readability-function-cognitive-complexity)
   void TsBranch::lazyLoad(ChainEpoch height) {
-    const auto bottom{chain.begin()->first};
-    if (height < bottom && lazy && updater) {
-      if (height >= lazy->bottom.first) {
-        size_t batch{};
+    if (lazy && updater) {
+      // callers hold shared branches lock, so insertions are serialized here
+      std::unique_lock lock{updater->load_mutex};
+      const auto bottom{chain.begin()->first};
+      if (height < bottom && height >= lazy->bottom.first) {
         const auto min_height{lazy->bottom.first};
         const auto &counts{updater->counts};
-        auto i{updater->counts.size() - 1};
-        auto offset{updater->count_sum};
-        while (true) {
+        // height index gives position in file directly, load at least
+        // min_load tipsets to amortize map insertions
+        auto i{static_cast<size_t>(bottom - min_height)};
+        size_t batch{};
+        while (i != 0
+               && (static_cast<ChainEpoch>(min_height + i) > height
+                   || batch < lazy->min_load)) {
+          --i;
           if (counts[i] != 0) {
-            offset -= counts[i];
             ++batch;
-            if (static_cast<ChainEpoch>(min_height + i) <= height
-                && batch >= lazy->min_load) {
-              break;
-            }
-          }
-          if (i == 0) {
-            break;
           }
-          --i;
         }
-        std::unique_lock lock{updater->read_mutex};
-        updater->file_hash_read.seekg(gsl::narrow<std::streamoff>(
-            sizeof(file::Seed) + offset * sizeof(CbCid)));
-        std::vector<CbCid> tsk;
-        while (i != counts.size()
-               && static_cast<ChainEpoch>(min_height + i) < bottom) {
+        auto hint{chain.begin()};
+        for (auto end{static_cast<size_t>(bottom - min_height)}; i != end;
+             ++i) {
           if (counts[i] != 0) {
-            tsk.resize(counts[i]);
-            if (!common::read(updater->file_hash_read, gsl::make_span(tsk))) {
+            const auto tsk{updater->mappedAt(i)};
+            if (tsk.empty()) {
               outcome::raise(ERROR_TEXT("TsBranch::lazyLoad read error"));
             }
-            chain.emplace(min_height + i, TsLazy{tsk});
+            hint = std::next(chain.emplace_hint(
+                hint, min_height + i, TsLazy{{{tsk.begin(), tsk.end()}}}));
           }
-          ++i;
         }
       }
     }
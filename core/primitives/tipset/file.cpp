@@ -29,19 +29,19 @@ namespace fc::primitives::tipset::chain::file {
     if (n) {
       common::write(file_hash, ts);
     }
-    count_sum += n;
     counts.push_back(n);
+    offsets.push_back(offsets.back() + n);
     file_count.put(n);
     return *this;
   }
   Updater &Updater::revert() {
     assert(!counts.empty());
-    count_sum -= counts.back();
-    assert(count_sum);
     do {
       counts.pop_back();
+      offsets.pop_back();
       assert(!counts.empty());
     } while (!counts.back());
+    assert(offsets.back());
     file_count.put(kRevert);
     return *this;
   }
@@ -50,6 +50,12 @@ namespace fc::primitives::tipset::chain::file {
     file_count.flush();
     return *this;
   }
+  CbCidsIn Updater::mappedAt(size_t i) const {
+    if (i >= counts.size() || offsets[i + 1] > mapped_hashes.size()) {
+      return {};
+    }
+    return mapped_hashes.subspan(offsets[i], counts[i]);
+  }
 
   bool write(const std::string &path_hash,
              const std::string &path_count,
@@ -275,12 +281,22 @@ namespace fc::primitives::tipset::chain::file {
     branch->updater->file_count.open(path_count, std::ios::app);
     BOOL_TRY(*branch->updater);
     branch->updater->counts = counts;
+    branch->updater->offsets.reserve(counts.size() + 1);
     for (const auto &count : counts) {
-      branch->updater->count_sum += count;
+      branch->updater->offsets.push_back(branch->updater->offsets.back()
+                                         + count);
     }
     if (lazy_limit) {
-      branch->updater->file_hash_read.open(path_hash);
-      BOOL_TRY(branch->updater->file_hash_read);
+      // hashes below loaded chain are not changed while running
+      auto mapped{common::mapFile(path_hash)};
+      BOOL_TRY(mapped);
+      auto &[file, input]{mapped.value()};
+      input = input.subspan(sizeof(Seed));
+      branch->updater->mapped_hashes = gsl::make_span(
+          common::span::cast<const CbCid>(input.data()),
+          std::min<ptrdiff_t>(input.size() / sizeof(CbCid),
+                              branch->updater->offsets.back()));
+      branch->updater->mapped = std::move(file);
       branch->lazy.emplace(TsBranch::Lazy{
           {min_height, TsLazy{{{hashes.begin(), hashes.begin() + counts[0]}}}},
       });
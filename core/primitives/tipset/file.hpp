@@ -9,6 +9,7 @@
 #include <mutex>
 
 #include "cbor_blake/ipld.hpp"
+#include "common/file.hpp"
 #include "primitives/tipset/chain.hpp"
 
 namespace fc::primitives::tipset::chain::file {
@@ -17,15 +18,25 @@ namespace fc::primitives::tipset::chain::file {
 
   struct Updater {
     std::ofstream file_hash, file_count;
-    std::ifstream file_hash_read;
+    /** Tipset size by height index */
     Bytes counts;
-    uint32_t count_sum{};
-    std::mutex read_mutex;
+    /**
+     * Height index, offsets[i] is index of first hash of height i in hash
+     * file, last is hash count.
+     */
+    std::vector<uint32_t> offsets{0};
+    /** Hash file mapped on load, contains all tipsets not loaded to chain */
+    common::MappedFile mapped;
+    CbCidsIn mapped_hashes;
+    /** Serializes lazy loads extending chain of branch */
+    std::mutex load_mutex;
 
     operator bool() const;
     Updater &apply(gsl::span<const CbCid> ts);
     Updater &revert();
     Updater &flush();
+    /** Tipset key of height index from mapped hash file, empty if missing */
+    CbCidsIn mappedAt(size_t i) const;
   };
 
   TsBranchPtr loadOrCreate(bool *updated,
@@ -5,6 +5,8 @@
 
 #include "primitives/tipset/load.hpp"
 
+#include <thread>
+
 namespace fc::primitives::tipset {
 
   outcome::result<TipsetCPtr> TsLoad::load(std::vector<BlockHeader> blocks) {
@@ -33,8 +35,92 @@ namespace fc::primitives::tipset {
     return load(lazy.key);  // we don't have cache
   }
 
-  TsLoadCache::TsLoadCache(TsLoadPtr ts_load, size_t cache_size)
-      : ts_load{std::move(ts_load)}, capacity{cache_size} {}
+  namespace {
+    /** Removed table entry, probing continues past it */
+    constexpr uint32_t kTombstone{UINT32_MAX};
+  }  // namespace
+
+  TsLoadCache::Shard::Shard(size_t size) : slots(size) {
+    if (size != 0) {
+      size_t capacity{1};
+      while (capacity < 4 * size) {
+        capacity <<= 1;
+      }
+      table = std::vector<std::atomic_uint32_t>(capacity);
+    }
+  }
+
+  TsLoadCache::Shard::~Shard() {
+    for (auto &slot : slots) {
+      delete slot.tipset.load();
+    }
+  }
+
+  const TipsetCPtr *TsLoadCache::Shard::find(size_t hash,
+                                             const TipsetKey &key,
+                                             size_t &slot) const {
+    const auto mask{table.size() - 1};
+    for (size_t i{0}; i < std::min(kProbes, table.size()); ++i) {
+      const auto value{table[(hash + i) & mask].load()};
+      if (value == 0) {
+        break;
+      }
+      if (value == kTombstone) {
+        continue;
+      }
+      const auto tipset{slots[value - 1].tipset.load()};
+      if (tipset != nullptr && (*tipset)->key == key) {
+        slot = value - 1;
+        return tipset;
+      }
+    }
+    return nullptr;
+  }
+
+  size_t TsLoadCache::Shard::position(size_t hash, uint32_t value) const {
+    const auto mask{table.size() - 1};
+    for (size_t i{0}; i < std::min(kProbes, table.size()); ++i) {
+      const auto pos{(hash + i) & mask};
+      if (table[pos].load() == value) {
+        return pos;
+      }
+    }
+    return table.size();
+  }
+
+  void TsLoadCache::Shard::synchronize() {
+    const auto old_phase{phase.fetch_add(1)};
+    while (readers[old_phase % 2].load() != 0) {
+      std::this_thread::yield();
+    }
+  }
+
+  TsLoadCache::ReadGuard::ReadGuard(Shard &shard) : shard_{shard} {
+    while (true) {
+      phase_ = shard_.phase.load();
+      ++shard_.readers[phase_ % 2];
+      // writer may have waited for readers of this phase already
+      if (shard_.phase.load() == phase_) {
+        break;
+      }
+      --shard_.readers[phase_ % 2];
+    }
+  }
+
+  TsLoadCache::ReadGuard::~ReadGuard() {
+    --shard_.readers[phase_ % 2];
+  }
+
+  TsLoadCache::TsLoadCache(TsLoadPtr ts_load,
+                           size_t cache_size,
+                           size_t shard_count)
+      : ts_load{std::move(ts_load)} {
+    shard_count = std::max<size_t>(1, std::min(shard_count, cache_size));
+    const auto shard_size{(cache_size + shard_count - 1) / shard_count};
+    for (size_t i{0}; i < shard_count; ++i) {
+      shards.emplace_back(std::make_unique<Shard>(shard_size));
+    }
+  }
 
   outcome::result<TipsetCPtr> TsLoadCache::load(const TipsetKey &key) {
     OUTCOME_TRY(ts, loadWithCacheInfo(key));
@@ -62,103 +148,123 @@ namespace fc::primitives::tipset {
     return std::move(ts.tipset);
   }
 
-  uint64_t TsLoadCache::cacheInsert(TipsetCPtr tipset) {
-    std::lock_guard lock{mutex};
+  size_t TsLoadCache::shardIndex(size_t hash) const {
+    // table uses low bits of same hash
+    return (hash >> 32) % shards.size();
+  }
 
-    auto res = map_cache.insert(std::make_pair(tipset->key, 0));
+  size_t TsLoadCache::hash(const TipsetKey &key) {
+    return std::hash<TipsetKey>{}(key);
+  }
 
-    // is inserted
-    if (!res.second) {
-      return 0;  // it is not a problem, we check key before get tipset
+  uint64_t TsLoadCache::cacheInsert(TipsetCPtr tipset) {
+    const auto key_hash{hash(tipset->key)};
+    const auto shard_index{shardIndex(key_hash)};
+    auto &shard{*shards[shard_index]};
+    auto &slots{shard.slots};
+    if (slots.empty()) {
+      return 0;
     }
+    std::unique_lock lock{shard.mutex};
 
-    auto it{res.first};
+    size_t slot{};
+    if (shard.find(key_hash, tipset->key, slot) != nullptr) {
+      return slot * shards.size() + shard_index;
+    }
 
-    if (tipset_cache.size() < capacity) {
-      auto index{tipset_cache.size()};
-      if (index != 0) {
-        tipset_cache[begin_index].prev = index;
+    const auto &table{shard.table};
+    const auto mask{table.size() - 1};
+    const TipsetCPtr *old{nullptr};
+    if (shard.size < slots.size()) {
+      slot = shard.size++;
+    } else {
+      while (slots[shard.hand].used.exchange(false)) {
+        shard.hand = (shard.hand + 1) % slots.size();
+      }
+      slot = shard.hand;
+      shard.hand = (shard.hand + 1) % slots.size();
+      old = slots[slot].tipset.load();
+      auto pos{shard.position(hash((*old)->key), slot + 1)};
+      if (pos != table.size()) {
+        shard.table[pos] = kTombstone;
+        // tombstones before empty position don't continue any probe
+        if (table[(pos + 1) & mask].load() == 0) {
+          for (size_t i{0}; i < table.size(); ++i) {
+            if (table[pos].load() != kTombstone) {
+              break;
+            }
+            shard.table[pos] = 0;
+            pos = (pos - 1) & mask;
+          }
+        }
       }
-      LoadNode tcn{
-          .prev = index,
-          .next = begin_index,
-          .tipset = std::move(tipset),
-      };
-      it->second = index;
-      tipset_cache.push_back(tcn);
-      begin_index = index;
-      return index;
     }
 
-    uint64_t new_index = end_index;
-    auto &new_tipset{tipset_cache[new_index]};
-    map_cache.erase(new_tipset.tipset->key);
-    it->second = new_index;
-
-    tipset_cache[new_tipset.prev].next = new_tipset.prev;
-    end_index = new_tipset.prev;
-
-    tipset_cache[begin_index].prev = new_index;
-    new_tipset.prev = new_index;
-    new_tipset.next = begin_index;
-    new_tipset.tipset = tipset;
+    // readers see new tipset in slot before table points to it
+    auto tipset_ptr{new TipsetCPtr{std::move(tipset)}};
+    slots[slot].tipset.exchange(tipset_ptr);
+    for (size_t i{0}; i < std::min(kProbes, table.size()); ++i) {
+      const auto pos{(key_hash + i) & mask};
+      const auto value{table[pos].load()};
+      if (value == 0 || value == kTombstone) {
+        // if probe window is full, tipset is found only by cache index
+        shard.table[pos] = slot + 1;
+        break;
+      }
+    }
 
-    begin_index = new_index;
-    return new_index;
+    if (old != nullptr) {
+      shard.synchronize();
+      delete old;
+    }
+    return slot * shards.size() + shard_index;
   }
 
   outcome::result<TipsetCPtr> TsLoadCache::lazyLoad(const TsLazy &lazy) {
     return lazyLoad(lazy.index, lazy.key);
   }
 
-  TipsetCPtr TsLoadCache::getFromCache(uint64_t index) {
-    auto &ts{tipset_cache[index]};
-    // when it first
-    if (index == begin_index) {
-      return ts.tipset;
-    }
-
-    // when it last
-    if (end_index == index) {
-      tipset_cache[ts.prev].next = ts.prev;
-      end_index = ts.prev;
-    } else {
-      // when it medium
-      tipset_cache[ts.next].prev = ts.prev;
-      tipset_cache[ts.prev].next = ts.next;
-    }
-
-    tipset_cache[begin_index].prev = index;
-    ts.prev = index;
-    ts.next = begin_index;
-
-    begin_index = index;
-    return ts.tipset;
-  }
-
   boost::optional<TipsetCPtr> TsLoadCache::getFromCache(uint64_t index,
                                                         const TipsetKey &key) {
-    std::lock_guard lock{mutex};
-
-    if (index >= tipset_cache.size()) {
+    const auto shard_index{index % shards.size()};
+    auto &shard{*shards[shard_index]};
+    const auto slot{index / shards.size()};
+    if (slot >= shard.slots.size()) {
       return boost::none;
     }
-    if (key != tipset_cache[index].tipset->key) {
+    ReadGuard guard{shard};
+    auto &ts{shard.slots[slot]};
+    const auto tipset{ts.tipset.load()};
+    if (tipset == nullptr) {
       return boost::none;
     }
-
-    return getFromCache(index);
+    if ((*tipset)->key != key) {
+      ++shard.stale;
+      return boost::none;
+    }
+    ts.used = true;
+    ++shard.hits;
+    return *tipset;
   }
 
   boost::optional<LoadCache> TsLoadCache::getFromCache(const TipsetKey &key) {
-    std::lock_guard lock{mutex};
-    auto it{map_cache.find(key)};
-
-    if (it == map_cache.end()) {
+    const auto key_hash{hash(key)};
+    const auto shard_index{shardIndex(key_hash)};
+    auto &shard{*shards[shard_index]};
+    if (shard.slots.empty()) {
+      ++shard.misses;
       return boost::none;
     }
-
-    return LoadCache{getFromCache(it->second), it->second};
+    ReadGuard guard{shard};
+    size_t slot{};
+    const auto tipset{shard.find(key_hash, key, slot)};
+    if (tipset == nullptr) {
+      ++shard.misses;
+      return boost::none;
+    }
+    shard.slots[slot].used = true;
+    ++shard.hits;
+    return LoadCache{*tipset, slot * shards.size() + shard_index};
   }
 
   outcome::result<LoadCache> TsLoadCache::loadWithCacheInfo(
@@ -172,6 +278,18 @@ namespace fc::primitives::tipset {
     return LoadCache{.tipset = ts, .index = cacheInsert(ts)};
   }
 
+  TsLoadCache::Stats TsLoadCache::stats() const {
+    Stats stats;
+    for (const auto &shard : shards) {
+      stats.hits += shard->hits;
+      stats.misses += shard->misses;
+      stats.stale += shard->stale;
+      std::unique_lock lock{shard->mutex};
+      stats.size += shard->size;
+    }
+    return stats;
+  }
+
   CID put(const IpldPtr &ipld,
           const std::shared_ptr<PutBlockHeader> &put,
           const BlockHeader &header) {
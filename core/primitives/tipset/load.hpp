@@ -5,7 +5,8 @@
 
 #pragma once
 
-#include <map>
+#include <array>
+#include <atomic>
 #include <mutex>
 
 #include "cbor_blake/cid.hpp"
@@ -27,13 +28,6 @@ namespace fc::primitives::tipset {
     CacheIndex index{};
   };
 
-  struct LoadNode {
-    uint64_t prev = 0;
-    uint64_t next = 0;
-
-    TipsetCPtr tipset = nullptr;
-  };
-
   struct TsLoad {
    public:
     virtual ~TsLoad() = default;
@@ -57,31 +51,109 @@ namespace fc::primitives::tipset {
     IpldPtr ipld;
   };
 
+  /**
+   * Tipset cache split into shards by key hash.
+   * Hits don't take locks: slots are found by open addressing table and
+   * tipsets are read through atomic pointers. Writers of shard are
+   * serialized, replaced tipsets are freed after readers which could see
+   * them leave (RCU-style).
+   * Entries are evicted in clock order (approximate LRU).
+   * Cache index is slot * shards + shard.
+   */
   struct TsLoadCache : public TsLoad {
    public:
-    TsLoadCache(TsLoadPtr ts_load, size_t cache_size);
+    struct Stats {
+      uint64_t hits{};
+      uint64_t misses{};
+      /** Lazy loads with index of evicted tipset, reloaded by key */
+      uint64_t stale{};
+      uint64_t size{};
+    };
+
+    /** Table positions probed for key */
+    static constexpr size_t kProbes{16};
+
+    TsLoadCache(TsLoadPtr ts_load, size_t cache_size, size_t shard_count = 1);
     outcome::result<LoadCache> loadWithCacheInfo(const TipsetKey &key) override;
     outcome::result<TipsetCPtr> load(const TipsetKey &key) override;
     outcome::result<TipsetCPtr> load(std::vector<BlockHeader> blocks) override;
     outcome::result<TipsetCPtr> lazyLoad(const TsLazy &lazy) override;
 
+    Stats stats() const;
+
    private:
+    struct Slot {
+      /** Owned by slot, replaced only by writer */
+      std::atomic<const TipsetCPtr *> tipset{nullptr};
+      mutable std::atomic_bool used{false};
+    };
+
+    struct Shard {
+      explicit Shard(size_t size);
+      Shard(const Shard &) = delete;
+      Shard(Shard &&) = delete;
+      Shard &operator=(const Shard &) = delete;
+      Shard &operator=(Shard &&) = delete;
+      ~Shard();
+
+      /**
+       * Finds tipset by key, called by reader or writer
+       * @param[out] slot - slot of found tipset
+       * @return tipset, valid while reader or writer holds shard
+       */
+      const TipsetCPtr *find(size_t hash,
+                             const TipsetKey &key,
+                             size_t &slot) const;
+      /**
+       * Finds table position of slot
+       * @param value - slot + 1
+       * @return position, or table size if not found
+       */
+      size_t position(size_t hash, uint32_t value) const;
+      /** Waits until readers which could see replaced tipsets leave */
+      void synchronize();
+
+      /** Serializes writers */
+      std::mutex mutex;
+      std::vector<Slot> slots;
+      /** Slot + 1 by key hash, linear probing */
+      std::vector<std::atomic_uint32_t> table;
+      std::array<std::atomic_uint64_t, 2> readers{};
+      std::atomic_size_t phase{};
+      size_t size{};
+      size_t hand{};
+      std::atomic_uint64_t hits{};
+      std::atomic_uint64_t misses{};
+      std::atomic_uint64_t stale{};
+    };
+
+    /** Marks reader of shard, so tipsets it reads are not freed */
+    class ReadGuard {
+     public:
+      explicit ReadGuard(Shard &shard);
+      ReadGuard(const ReadGuard &) = delete;
+      ReadGuard(ReadGuard &&) = delete;
+      ReadGuard &operator=(const ReadGuard &) = delete;
+      ReadGuard &operator=(ReadGuard &&) = delete;
+      ~ReadGuard();
+
+     private:
+      Shard &shard_;
+      size_t phase_{};
+    };
+
     outcome::result<TipsetCPtr> lazyLoad(uint64_t &cache_index,
                                          const TipsetKey &key);
+    size_t shardIndex(size_t hash) const;
+    static size_t hash(const TipsetKey &key);
     uint64_t cacheInsert(TipsetCPtr tipset);
     boost::optional<LoadCache> getFromCache(const TipsetKey &key);
     boost::optional<TipsetCPtr> getFromCache(uint64_t index,
                                              const TipsetKey &key);
-    TipsetCPtr getFromCache(uint64_t index);
 
     TsLoadPtr ts_load;
 
-    std::mutex mutex;
-    std::map<TipsetKey, uint64_t> map_cache;
-    std::vector<LoadNode> tipset_cache;
-    uint64_t capacity;
-    uint64_t begin_index{};
-    uint64_t end_index{};
+    std::vector<std::unique_ptr<Shard>> shards;
   };
 
   struct PutBlockHeader {
@@ -6,10 +6,13 @@
 #include "sector_storage/fetch_handler.hpp"
 
 #include <boost/filesystem.hpp>
+#include <fstream>
 #include <regex>
 #include "codec/json/json.hpp"
+#include "common/error_text.hpp"
 #include "common/logger.hpp"
-#include "common/tarutil.hpp"
+#include "common/prometheus/sector_fetch.hpp"
+#include "common/tar_stream.hpp"
 #include "primitives/json_types.hpp"
 #include "sector_storage/stores/store_error.hpp"
 
@@ -23,6 +26,25 @@ namespace fc::sector_storage {
 
   common::Logger server_logger = common::createLogger("remote server");
 
+  /** Sector file chunk written to socket at once */
+  constexpr size_t kFetchChunkSize{1 << 20};
+
+  /** Parses "Range: bytes=<start>-" sent by resumed fetch */
+  std::optional<uint64_t> rangeStart(
+      const http::request<http::string_body> &request) {
+    const auto it{request.find(http::field::range)};
+    if (it == request.end()) {
+      return std::nullopt;
+    }
+    static const std::regex range_rgx{R"(^bytes=(\d{1,19})-$)"};
+    std::smatch matches;
+    const auto value{it->value().to_string()};
+    if (!std::regex_match(value, matches, range_rgx)) {
+      return std::nullopt;
+    }
+    return std::stoull(matches[1]);
+  }
+
   api::WrapperResponse remoteStatFs(
       const http::request<http::string_body> &request,
       const std::shared_ptr<stores::LocalStore> &local_store,
@@ -116,41 +138,89 @@ namespace fc::sector_storage {
                                     http::status::internal_server_error);
     }
 
-    std::string response_file = maybe_path.value();
-
-    std::function<void()> clear_function;
-    http::response<http::file_body> response;
-    response.version(request.version());
-    response.keep_alive(false);
-    if (boost::filesystem::is_directory(maybe_path.value())) {
-      auto temp_file = fs::temp_directory_path() / fs::unique_path();
-      clear_function = [temp_file]() {
-        if (fs::exists(temp_file)) {
-          fs::remove_all(temp_file);
-        }
-      };
-      auto maybe_tar = fc::common::zipTar(maybe_path.value(), temp_file);
+    const auto &path{maybe_path.value()};
+    const auto range_start{rangeStart(request)};
+    api::StreamResponse response;
+    response.header.version(request.version());
+    response.header.keep_alive(false);
+    uint64_t size{};
+    std::function<outcome::result<Bytes>()> read;
+    if (fs::is_directory(path)) {
+      auto maybe_tar{common::TarWriter::make(path)};
       if (maybe_tar.has_error()) {
         logger->error("Error remote get sector: {}",
                       maybe_tar.error().message());
         return api::makeErrorResponse(request,
                                       http::status::internal_server_error);
       }
-      response_file = temp_file.string();
-      response.set(http::field::content_type, "application/x-tar");
+      auto tar{std::make_shared<common::TarWriter>(
+          std::move(maybe_tar.value()))};
+      size = tar->size();
+      if (range_start && *range_start < size) {
+        std::ignore = tar->seek(*range_start);
+      }
+      read = [tar] { return tar->read(kFetchChunkSize); };
+      response.header.set(http::field::content_type, "application/x-tar");
     } else {
-      response.set(http::field::content_type, "application/octet-stream");
+      boost::system::error_code ec;
+      size = fs::file_size(path, ec);
+      auto file{std::make_shared<std::ifstream>(path, std::ios::binary)};
+      if (ec.failed() || !file->is_open()) {
+        logger->error("Error remote get sector: cannot open {}", path);
+        return api::makeErrorResponse(request,
+                                      http::status::internal_server_error);
+      }
+      if (range_start && *range_start < size) {
+        file->seekg(static_cast<std::streamoff>(*range_start));
+      }
+      read = [file]() -> outcome::result<Bytes> {
+        Bytes chunk(kFetchChunkSize);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        file->read(reinterpret_cast<char *>(chunk.data()),
+                   static_cast<std::streamsize>(chunk.size()));
+        chunk.resize(static_cast<size_t>(file->gcount()));
+        if (chunk.empty() && file->bad()) {
+          return ERROR_TEXT("remoteGetSector: cannot read file");
+        }
+        return chunk;
+      };
+      response.header.set(http::field::content_type,
+                          "application/octet-stream");
     }
 
-    boost::system::error_code ec;
-    response.body().open(
-        response_file.c_str(), boost::beast::file_mode::scan, ec);
-    if (ec.failed()) {
-      logger->error("Error remote get sector: {}", ec.message());
-      return api::makeErrorResponse(request,
-                                    http::status::internal_server_error);
+    response.header.set(http::field::accept_ranges, "bytes");
+    if (range_start) {
+      if (*range_start >= size) {
+        auto error{api::makeErrorResponse(
+            request, http::status::range_not_satisfiable)};
+        std::get<http::response<http::empty_body>>(error.response)
+            .set(http::field::content_range, fmt::format("bytes */{}", size));
+        return error;
+      }
+      response.header.result(http::status::partial_content);
+      response.header.set(
+          http::field::content_range,
+          fmt::format("bytes {}-{}/{}", *range_start, size - 1, size));
+    } else {
+      response.header.result(http::status::ok);
     }
-    return api::WrapperResponse(std::move(response), std::move(clear_function));
+    response.header.content_length(size - range_start.value_or(0));
+    response.read = [read{std::move(read)}, since{Since{}}](
+                        const api::StreamResponse::ReadCb &cb) {
+      auto chunk{read()};
+      if (chunk) {
+        metricSectorFetchBytes()
+            .Add({{"direction", "sent"}})
+            .Increment(static_cast<double>(chunk.value().size()));
+        if (chunk.value().empty()) {
+          metricSectorFetchTime()
+              .Add({{"direction", "sent"}}, kDefaultPrometheusMsBuckets)
+              .Observe(since.ms());
+        }
+      }
+      cb(std::move(chunk));
+    };
+    return api::WrapperResponse(std::move(response));
   }
 
   api::WrapperResponse remoteRemoveSector(
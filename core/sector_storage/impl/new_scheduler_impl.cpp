@@ -13,24 +13,30 @@
 namespace fc::sector_storage {
   using primitives::Resources;
   using primitives::WorkerResources;
+  using primitives::sector_file::SectorFileType;
 
   outcome::result<std::shared_ptr<EstimateSchedulerImpl>>
   EstimateSchedulerImpl::newScheduler(
       std::shared_ptr<boost::asio::io_context> io_context,
       std::shared_ptr<BufferMap> datastore,
-      std::shared_ptr<Estimator> estimator) {
+      std::shared_ptr<Estimator> estimator,
+      std::shared_ptr<SectorIndex> index) {
     struct make_unique_enabler : public EstimateSchedulerImpl {
       make_unique_enabler(std::shared_ptr<boost::asio::io_context> io_context,
                           std::shared_ptr<BufferMap> datastore,
-                          std::shared_ptr<Estimator> estimator)
+                          std::shared_ptr<Estimator> estimator,
+                          std::shared_ptr<SectorIndex> index)
           : EstimateSchedulerImpl{std::move(io_context),
                           std::move(datastore),
-                          std::move(estimator)} {};
+                          std::move(estimator),
+                          std::move(index)} {};
     };
 
     std::shared_ptr<EstimateSchedulerImpl> scheduler =
-        std::make_shared<make_unique_enabler>(
-            std::move(io_context), std::move(datastore), std::move(estimator));
+        std::make_shared<make_unique_enabler>(std::move(io_context),
+                                              std::move(datastore),
+                                              std::move(estimator),
+                                              std::move(index));
 
     OUTCOME_TRY(scheduler->resetWorks());
 
@@ -40,9 +46,11 @@ namespace fc::sector_storage {
   EstimateSchedulerImpl::EstimateSchedulerImpl(
       std::shared_ptr<boost::asio::io_context> io_context,
       std::shared_ptr<BufferMap> datastore,
-      std::shared_ptr<Estimator> estimator)
+      std::shared_ptr<Estimator> estimator,
+      std::shared_ptr<SectorIndex> index)
       : current_worker_id_(0),
         estimator_(std::move(estimator)),
+        index_(std::move(index)),
         call_kv_(std::move(datastore)),
         io_(std::move(io_context)),
         logger_(common::createLogger("scheduler")) {}
@@ -132,14 +140,22 @@ namespace fc::sector_storage {
                                       std::move(job),
                                       std::move(callback));
 
+    OUTCOME_TRY(storages,
+                index_->storageFindSector(sector.id,
+                                          SectorFileType::FTUnsealed
+                                              | SectorFileType::FTSealed
+                                              | SectorFileType::FTCache,
+                                          boost::none));
+    for (const auto &storage : storages) {
+      request->sector_storages.insert(storage.id);
+    }
+
     {
       std::lock_guard<std::mutex> lock(request_lock_);
 
-      OUTCOME_TRY(scheduled, maybeScheduleRequest(request));
-
-      if (!scheduled) {
-        request_queue_.insert(request);
-      }
+      // queued requests with higher priority may reserve workers
+      request_queue_.insert(request);
+      OUTCOME_TRY(scheduleQueue(request));
     }
 
     return outcome::success();
@@ -151,17 +167,44 @@ namespace fc::sector_storage {
       current_worker_id_ = 0;  // TODO(ortyomka): maybe better mechanism
     }
     WorkerId wid = current_worker_id_++;
-    workers_.insert({wid, std::move(worker)});
+    std::shared_ptr<WorkerHandle> handle{std::move(worker)};
+    workers_.insert({wid, handle});
     lock.unlock();
 
+    updatePaths(wid, handle);
     freeWorker(wid);
   }
 
+  void EstimateSchedulerImpl::updatePaths(
+      WorkerId wid, const std::shared_ptr<WorkerHandle> &worker) {
+    // remote call, so it is not made under locks
+    auto maybe_paths{worker->worker->getAccessiblePaths()};
+    if (!maybe_paths) {
+      logger_->warn("worker accessible paths: "
+                    + maybe_paths.error().message());
+      return;
+    }
+    std::set<StorageID> storages;
+    for (const auto &path : maybe_paths.value()) {
+      storages.insert(path.id);
+    }
+    std::lock_guard<std::mutex> lock(workers_lock_);
+    worker_storages_[wid] = std::move(storages);
+  }
+
   outcome::result<bool> EstimateSchedulerImpl::maybeScheduleRequest(
-      const std::shared_ptr<NewTaskRequest> &request) {
+      const std::shared_ptr<NewTaskRequest> &request,
+      Reservations &reservations) {
     std::lock_guard<std::mutex> lock(workers_lock_);
 
-    std::vector<WorkerId> acceptable;
+    struct Candidate {
+      WorkerId wid{};
+      bool ready{};
+      double wait{};
+      boost::optional<double> time;
+      double cost{};
+    };
+    std::vector<Candidate> candidates;
     uint64_t tried = 0;
 
     for (const auto &[wid, worker] : workers_) {
@@ -174,43 +217,40 @@ namespace fc::sector_storage {
       }
       tried++;
 
+      Candidate candidate{wid, true};
       if (!worker->preparing.canHandleRequest(request->need_resources,
                                               worker->info.resources)) {
         if ((workers_.size() > 1) || (active_jobs != 0)) {
-          continue;
+          const auto wait{waitTime(wid)};
+          if (!wait) {
+            continue;
+          }
+          candidate.ready = false;
+          candidate.wait = *wait;
         }
       }
 
-      acceptable.push_back(wid);
+      // if worker doesn't have data about time, then we prefer it, to give a
+      // chance to prove yourself
+      candidate.time = estimator_->getTime(wid, request->task_type);
+      OUTCOME_TRY(fetch, fetchTime(*request, wid));
+      candidate.cost = candidate.wait + candidate.time.value_or(0) + fetch;
+      candidates.push_back(candidate);
     }
 
-    if (!acceptable.empty()) {
+    if (!candidates.empty()) {
       bool does_error_occurs = false;
       std::stable_sort(
-          acceptable.begin(),
-          acceptable.end(),
-          [&](WorkerId lhs, WorkerId rhs) {
-            const auto l_time = estimator_->getTime(lhs, request->task_type);
-            const auto r_time = estimator_->getTime(rhs, request->task_type);
-
-            // if time is available, then compare them
-            if (l_time and r_time) {
-              return l_time < r_time;
+          candidates.begin(),
+          candidates.end(),
+          [&](const Candidate &lhs, const Candidate &rhs) {
+            if (lhs.cost != rhs.cost) {
+              return lhs.cost < rhs.cost;
             }
 
-            // if some workers don't have data about time, then we prefer worker
-            // without time, to give a chance to prove yourself
-            if (l_time) {
-              return false;
-            }
-
-            if (r_time) {
-              return true;
-            }
-
-            // if both workers without time, then compare with selector
+            // if costs are same, then compare with selector
             auto maybe_res = request->sel->is_preferred(
-                request->task_type, workers_[lhs], workers_[rhs]);
+                request->task_type, workers_[lhs.wid], workers_[rhs.wid]);
 
             if (maybe_res.has_error()) {
               logger_->error("selecting best worker: "
@@ -226,11 +266,29 @@ namespace fc::sector_storage {
         return SchedulerErrors::kCannotSelectWorker;
       }
 
-      WorkerId wid = acceptable[0];
+      for (const auto &candidate : candidates) {
+        const auto reservation{reservations.find(candidate.wid)};
+        if (!candidate.ready) {
+          if (reservation != reservations.end()) {
+            continue;
+          }
+          // busy worker finishes sooner than others, wait for it
+          reservations.emplace(candidate.wid, candidate.wait);
+          return false;
+        }
+        // backfill only if it doesn't delay reserved request
+        if (reservation != reservations.end()
+            && !(candidate.time && *candidate.time <= reservation->second)) {
+          continue;
+        }
+
+        request->estimate = candidate.time;
+        assignWorker(candidate.wid, workers_[candidate.wid], request);
 
-      assignWorker(wid, workers_[wid], request);
+        return true;
+      }
 
-      return true;
+      return false;
     }
 
     if (tried == 0) {
@@ -240,11 +298,55 @@ namespace fc::sector_storage {
     return false;
   }
 
+  boost::optional<double> EstimateSchedulerImpl::waitTime(WorkerId wid) const {
+    const auto it{assigned_.find(wid)};
+    if (it == assigned_.end()) {
+      return boost::none;
+    }
+    const auto now{std::chrono::steady_clock::now()};
+    boost::optional<double> wait;
+    for (const auto &request : it->second) {
+      if (!request->estimate) {
+        continue;
+      }
+      const std::chrono::duration<double, std::milli> elapsed{
+          now - request->assigned};
+      const auto left{*request->estimate - elapsed.count()};
+      // overrun task may take any time, so it is unknown as without estimate
+      if (left <= 0) {
+        continue;
+      }
+      if (!wait || left < *wait) {
+        wait = left;
+      }
+    }
+    return wait;
+  }
+
+  outcome::result<double> EstimateSchedulerImpl::fetchTime(
+      const NewTaskRequest &request, WorkerId wid) const {
+    if (request.sector_storages.empty()) {
+      return 0;
+    }
+    const auto storages{worker_storages_.find(wid)};
+    if (storages != worker_storages_.end()) {
+      for (const auto &storage : storages->second) {
+        if (request.sector_storages.count(storage) != 0) {
+          return 0;
+        }
+      }
+    }
+    OUTCOME_TRY(sector_size, getSectorSize(request.sector.proof_type));
+    return static_cast<double>(sector_size) / kFetchBytesPerMs;
+  }
+
   void EstimateSchedulerImpl::assignWorker(
       WorkerId wid,
       const std::shared_ptr<WorkerHandle> &worker,
       const std::shared_ptr<NewTaskRequest> &request) {
     worker->preparing.add(worker->info.resources, request->need_resources);
+    request->assigned = std::chrono::steady_clock::now();
+    assigned_[wid].insert(request);
 
     io_->post([this, wid, worker, request]() {
       auto cb = [this, wid, worker, request](
@@ -258,6 +360,9 @@ namespace fc::sector_storage {
         auto clear = [this, wid, worker, request]() {
           worker->active.free(worker->info.resources, request->need_resources);
           --active_jobs;
+          unassign(wid, request);
+          // storages may have been attached to worker meanwhile
+          updatePaths(wid, worker);
           freeWorker(wid);
         };
 
@@ -307,6 +412,7 @@ namespace fc::sector_storage {
       if (maybe_call_id.has_error()) {
         worker->preparing.free(worker->info.resources, request->need_resources);
         request->cb(maybe_call_id.error());
+        unassign(wid, request);
         freeWorker(wid);
         return;
       }
@@ -324,40 +430,45 @@ namespace fc::sector_storage {
     });
   }
 
-  void EstimateSchedulerImpl::freeWorker(WorkerId wid) {
-    std::shared_ptr<WorkerHandle> worker;
-    {
-      std::lock_guard<std::mutex> lock(workers_lock_);
-      worker = workers_[wid];
-    }
+  void EstimateSchedulerImpl::unassign(
+      WorkerId wid, const std::shared_ptr<NewTaskRequest> &request) {
+    std::lock_guard<std::mutex> lock(workers_lock_);
+    assigned_[wid].erase(request);
+  }
 
+  void EstimateSchedulerImpl::freeWorker(WorkerId) {
     std::lock_guard<std::mutex> lock(request_lock_);
+    auto maybe_error = scheduleQueue(nullptr);
+    if (maybe_error.has_error()) {
+      logger_->error("schedule queue: " + maybe_error.error().message());
+    }
+  }
+
+  outcome::result<void> EstimateSchedulerImpl::scheduleQueue(
+      const std::shared_ptr<NewTaskRequest> &new_request) {
+    Reservations reservations;
     for (auto it = request_queue_.begin(); it != request_queue_.end();) {
       auto req = *it;
-      const auto maybe_satisfying = req->sel->is_satisfying(
-          req->task_type, req->sector.proof_type, worker);
-      if (maybe_satisfying.has_error()) {
-        logger_->error("free worker satisfactory check: "
-                       + maybe_satisfying.error().message());
-        ++it;
-        continue;
-      }
-
-      if (!maybe_satisfying.value()) {
+      const auto maybe_scheduled = maybeScheduleRequest(req, reservations);
+      if (maybe_scheduled.has_error()) {
+        if (req == new_request) {
+          request_queue_.erase(it);
+          return maybe_scheduled.error();
+        }
+        logger_->error("schedule queued request: "
+                       + maybe_scheduled.error().message());
         ++it;
         continue;
       }
 
-      if (!worker->preparing.canHandleRequest(req->need_resources,
-                                              worker->info.resources)) {
+      if (!maybe_scheduled.value()) {
         ++it;
         continue;
       }
 
-      assignWorker(wid, worker, req);
-
       it = request_queue_.erase(it);
     }
+    return outcome::success();
   }
 
   outcome::result<void> EstimateSchedulerImpl::returnResult(const CallId &call_id,
@@ -8,16 +8,21 @@
 #include "sector_storage/scheduler.hpp"
 
 #include <boost/asio/io_context.hpp>
+#include <chrono>
 #include <future>
 #include <mutex>
+#include <set>
 #include <unordered_map>
 #include <utility>
 #include "primitives/resources/resources.hpp"
+#include "sector_storage/stores/index.hpp"
 #include "sector_storage/worker_estimator.hpp"
 #include "storage/buffer_map.hpp"
 
 namespace fc::sector_storage {
   using primitives::Resources;
+  using primitives::StorageID;
+  using stores::SectorIndex;
   using storage::BufferMap;
 
   struct NewTaskRequest {
@@ -53,6 +58,13 @@ namespace fc::sector_storage {
     WorkerAction work;
 
     ReturnCb cb;
+
+    /** Storages with sector files, workers without access fetch them */
+    std::set<StorageID> sector_storages;
+
+    /** Estimated duration in milliseconds on assigned worker */
+    boost::optional<double> estimate;
+    std::chrono::steady_clock::time_point assigned;
   };
 
   inline bool operator<(const NewTaskRequest &lhs, const NewTaskRequest &rhs) {
@@ -62,14 +74,24 @@ namespace fc::sector_storage {
   }
 
   /**
-   * It is an improved scheduler with estimator
+   * It is an improved scheduler with estimator.
+   * Request is assigned to worker with minimal estimated completion time:
+   * wait for worker resources, task duration from estimator and fetch of
+   * sector files from storages not accessible by worker.
+   * If busy worker finishes sooner than idle one, request waits for it.
+   * Worker is reserved for such request, and lower priority requests are
+   * backfilled to it only if they finish before reservation.
    */
   class EstimateSchedulerImpl : public Scheduler {
    public:
+    /** Assumed bandwidth of sector files fetch, about 100MiB/s */
+    static constexpr double kFetchBytesPerMs{100 << 10};
+
     static outcome::result<std::shared_ptr<EstimateSchedulerImpl>> newScheduler(
         std::shared_ptr<boost::asio::io_context> io_context,
         std::shared_ptr<BufferMap> datastore,
-        std::shared_ptr<Estimator> estimator);
+        std::shared_ptr<Estimator> estimator,
+        std::shared_ptr<SectorIndex> index);
 
     outcome::result<void> schedule(
         const SectorRef &sector,
@@ -87,27 +109,56 @@ namespace fc::sector_storage {
                                        CallResult result) override;
 
    private:
+    /** Time in milliseconds until which worker is kept for waiting request */
+    using Reservations = std::unordered_map<WorkerId, double>;
+
     explicit EstimateSchedulerImpl(
         std::shared_ptr<boost::asio::io_context> io_context,
         std::shared_ptr<BufferMap> datastore,
-        std::shared_ptr<Estimator> estimator);
+        std::shared_ptr<Estimator> estimator,
+        std::shared_ptr<SectorIndex> index);
 
     outcome::result<void> resetWorks();
 
     outcome::result<bool> maybeScheduleRequest(
-        const std::shared_ptr<NewTaskRequest> &request);
+        const std::shared_ptr<NewTaskRequest> &request,
+        Reservations &reservations);
+
+    /**
+     * Tries to assign queued requests in priority order
+     * @param new_request - just queued request, it is removed and its error
+     * is returned if it cannot be scheduled
+     */
+    outcome::result<void> scheduleQueue(
+        const std::shared_ptr<NewTaskRequest> &new_request);
+
+    /** Estimated time until worker frees resources of some task */
+    boost::optional<double> waitTime(WorkerId wid) const;
+
+    /** Estimated time to fetch sector files to worker */
+    outcome::result<double> fetchTime(const NewTaskRequest &request,
+                                      WorkerId wid) const;
+
+    /** Refreshes storages accessible by worker, used by fetchTime */
+    void updatePaths(WorkerId wid, const std::shared_ptr<WorkerHandle> &worker);
 
     void assignWorker(WorkerId wid,
                       const std::shared_ptr<WorkerHandle> &worker,
                       const std::shared_ptr<NewTaskRequest> &request);
 
+    void unassign(WorkerId wid, const std::shared_ptr<NewTaskRequest> &request);
+
     void freeWorker(WorkerId wid);
 
     std::mutex workers_lock_;
     WorkerId current_worker_id_;
     std::unordered_map<WorkerId, std::shared_ptr<WorkerHandle>> workers_;
+    std::unordered_map<WorkerId, std::set<std::shared_ptr<NewTaskRequest>>>
+        assigned_;
+    std::unordered_map<WorkerId, std::set<StorageID>> worker_storages_;
 
     std::shared_ptr<Estimator> estimator_;
+    std::shared_ptr<SectorIndex> index_;
 
     std::mutex cbs_lock_;
     std::map<CallId, ReturnCb> callbacks_;
@@ -116,10 +167,14 @@ namespace fc::sector_storage {
     std::shared_ptr<BufferMap> call_kv_;
 
     std::mutex request_lock_;
+    struct RequestLess {
+      bool operator()(const std::shared_ptr<NewTaskRequest> &lhs,
+                      const std::shared_ptr<NewTaskRequest> &rhs) const {
+        return *lhs < *rhs;
+      }
+    };
     // TODO(turuslan): FIL-420 check cache memory usage
-    std::multiset<std::shared_ptr<NewTaskRequest>,
-                  std::owner_less<std::shared_ptr<NewTaskRequest>>>
-        request_queue_;
+    std::multiset<std::shared_ptr<NewTaskRequest>, RequestLess> request_queue_;
 
     std::shared_ptr<boost::asio::io_context> io_;
 
@@ -7,10 +7,12 @@
 
 #include <curl/curl.h>
 #include <boost/filesystem.hpp>
+#include <fstream>
 #include <utility>
 
 #include "codec/json/json.hpp"
-#include "common/tarutil.hpp"
+#include "common/prometheus/sector_fetch.hpp"
+#include "common/tar_stream.hpp"
 #include "common/uri_parser/uri_parser.hpp"
 #include "primitives/json_types.hpp"
 #include "sector_storage/stores/impl/util.hpp"
@@ -28,14 +30,6 @@ namespace {
     return totalBytes;
   }
 
-  std::size_t callbackFile(const char *ptr,
-                           std::size_t size,
-                           std::size_t nmemb,
-                           std::ofstream *stream) {
-    const std::size_t totalBytes(size * nmemb);
-    stream->write(ptr, size);
-    return totalBytes;
-  }
 }  // namespace
 
 namespace fc::sector_storage::stores {
@@ -302,93 +296,191 @@ namespace fc::sector_storage::stores {
     return StoreError::kUnableRemoteAcquireSector;
   }
 
-  outcome::result<void> RemoteStoreImpl::fetch(const std::string &url,
-                                               const std::string &output_path) {
-    logger_->info("fetch: {} -> {}", url, output_path);
+  namespace {
+    /** Attempts of fetch, interrupted transfer is resumed from received */
+    constexpr int kFetchAttempts{3};
+
+    /**
+     * Writes fetched body to output as it is received, archive is extracted
+     * without temp file.
+     */
+    struct FetchState {
+      outcome::result<void> write(BytesIn chunk) {
+        if (!checked) {
+          checked = true;
+          long status_code{};
+          curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status_code);
+          if (status_code == 200 && received != 0) {
+            // server ignored range, start again
+            OUTCOME_TRY(reset());
+          } else if (status_code != 200 && status_code != 206) {
+            return StoreError::kNotOkStatusCode;
+          }
+          if (!tar && !file.is_open()) {
+            char *content_type{};
+            curl_easy_getinfo(curl, CURLINFO_CONTENT_TYPE, &content_type);
+            const std::string_view type{content_type ? content_type : ""};
+            if (type == "application/x-tar") {
+              boost::system::error_code ec;
+              fs::create_directories(output_path, ec);
+              if (ec.failed()) {
+                return StoreError::kCannotCreateDir;
+              }
+              tar.emplace(output_path);
+            } else if (type == "application/octet-stream") {
+              file.open(output_path, std::ios::binary | std::ios::trunc);
+              if (!file.is_open()) {
+                return StoreError::kCannotOpenTempFile;
+              }
+            } else {
+              return StoreError::kUnknownContentType;
+            }
+          }
+        }
+        if (tar) {
+          OUTCOME_TRY(tar->write(chunk));
+        } else {
+          // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+          file.write(reinterpret_cast<const char *>(chunk.data()),
+                     static_cast<std::streamsize>(chunk.size()));
+          if (!file.good()) {
+            return StoreError::kCannotMoveFile;
+          }
+        }
+        received += chunk.size();
+        metricSectorFetchBytes()
+            .Add({{"direction", "received"}})
+            .Increment(static_cast<double>(chunk.size()));
+        return outcome::success();
+      }
 
-    CURL *curl = curl_easy_init();
+      outcome::result<void> reset() {
+        tar.reset();
+        file.close();
+        received = 0;
+        boost::system::error_code ec;
+        fs::remove_all(output_path, ec);
+        if (ec.failed()) {
+          return StoreError::kCannotRemovePath;
+        }
+        return outcome::success();
+      }
 
-    if (!curl) {
-      return StoreError::kUnableCreateRequest;
+      std::string output_path;
+      std::optional<common::TarReader> tar;
+      std::ofstream file;
+      uint64_t received{};
+      /** Response status and content type were checked in this attempt */
+      bool checked{};
+      CURL *curl{};
+      outcome::result<void> error{outcome::success()};
+    };
+
+    std::size_t callbackFetch(const char *ptr,
+                              std::size_t size,
+                              std::size_t nmemb,
+                              FetchState *state) {
+      const std::size_t totalBytes(size * nmemb);
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+      auto res{state->write({reinterpret_cast<const uint8_t *>(ptr),
+                             static_cast<ptrdiff_t>(totalBytes)})};
+      if (!res) {
+        state->error = res.error();
+        // aborts transfer
+        return 0;
+      }
+      return totalBytes;
     }
-    curl_easy_setopt(curl, CURLOPT_IPRESOLVE, CURL_IPRESOLVE_V4);
-
-    // Follow HTTP redirects if necessary
-    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-
-    fs::path temp_file_path =
-        fs::temp_directory_path() / (fs::unique_path().string() + ".tar");
+  }  // namespace
 
-    std::ofstream temp_file(temp_file_path.string(),
-                            std::ios_base::out | std::ios_base::binary);
-
-    if (!temp_file.good()) {
-      curl_easy_cleanup(curl);
-      return StoreError::kCannotOpenTempFile;
-    }
+  outcome::result<void> RemoteStoreImpl::fetch(const std::string &url,
+                                               const std::string &output_path) {
+    logger_->info("fetch: {} -> {}", url, output_path);
 
-    struct curl_slist *headers = nullptr;
+    FetchState state;
+    state.output_path = output_path;
+    OUTCOME_TRY(state.reset());
+    const Since since;
+    for (int attempt{1};; ++attempt) {
+      CURL *curl = curl_easy_init();
 
-    for (const auto &header : auth_headers_) {
-      headers = curl_slist_append(
-          headers, (header.first + ": " + header.second).c_str());
-    }
+      if (!curl) {
+        return StoreError::kUnableCreateRequest;
+      }
+      curl_easy_setopt(curl, CURLOPT_IPRESOLVE, CURL_IPRESOLVE_V4);
 
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, callbackFile);
+      // Follow HTTP redirects if necessary
+      curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
 
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &temp_file);
+      curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
 
-    if (headers) {
-      curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    }
+      struct curl_slist *headers = nullptr;
 
-    long status_code;
-    std::string content_type;
-    curl_easy_perform(curl);
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status_code);
-    curl_easy_getinfo(curl, CURLINFO_CONTENT_TYPE, &content_type);
-    curl_easy_cleanup(curl);
-    if (headers) {
-      curl_slist_free_all(headers);
-    }
+      for (const auto &header : auth_headers_) {
+        headers = curl_slist_append(
+            headers, (header.first + ": " + header.second).c_str());
+      }
+      if (state.received != 0) {
+        headers = curl_slist_append(
+            headers, fmt::format("Range: bytes={}-", state.received).c_str());
+      }
 
-    temp_file.close();
+      state.curl = curl;
+      state.checked = false;
+      curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, callbackFetch);
 
-    if (status_code != 200) {
-      logger_->error("non-200 code - {}", status_code);
-      return StoreError::kNotOkStatusCode;
-    }
+      curl_easy_setopt(curl, CURLOPT_WRITEDATA, &state);
 
-    boost::system::error_code ec;
-    fs::remove_all(output_path, ec);
+      if (headers) {
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+      }
 
-    if (ec.failed()) {
-      logger_->error("Cannot remove output path: {}", ec.message());
-      return StoreError::kCannotRemovePath;
-    }
-    ec.clear();
+      long status_code{};
+      const auto code{curl_easy_perform(curl)};
+      curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status_code);
+      if (code == CURLE_OK && !state.checked) {
+        // empty body, check status and content type
+        state.error = state.write({});
+      }
+      curl_easy_cleanup(curl);
+      if (headers) {
+        curl_slist_free_all(headers);
+      }
 
-    if (content_type == "application/x-tar") {
-      auto result = common::extractTar(temp_file_path, output_path);
-      fs::remove_all(temp_file_path, ec);
-      if (ec.failed()) {
-        logger_->warn("fetch: failed to remove archive - {}", ec.message());
+      if (state.error.has_error()) {
+        if (state.error.error() == StoreError::kNotOkStatusCode) {
+          logger_->error("non-200 code - {}", status_code);
+        }
+        return state.error.error();
+      }
+      if (code == CURLE_OK) {
+        break;
       }
-      return result;
+      if (attempt == kFetchAttempts) {
+        logger_->error("fetch: {}", curl_easy_strerror(code));
+        return StoreError::kUnableRemoteAcquireSector;
+      }
+      logger_->warn("fetch: {}, resuming from {}",
+                    curl_easy_strerror(code),
+                    state.received);
     }
 
-    if (content_type == "application/octet-stream") {
-      fs::rename(temp_file_path, output_path, ec);
-      if (ec.failed()) {
-        logger_->error("Cannot move file: {}", ec.message());
+    if (state.tar) {
+      if (!state.tar->done()) {
+        logger_->error("fetch: archive is incomplete");
+        return common::TarErrors::kCannotUntarArchive;
+      }
+    } else {
+      state.file.close();
+      if (state.file.fail()) {
+        logger_->error("fetch: cannot write file");
         return StoreError::kCannotMoveFile;
       }
-      return outcome::success();
     }
-
-    return StoreError::kUnknownContentType;
+    metricSectorFetchTime()
+        .Add({{"direction", "received"}}, kDefaultPrometheusMsBuckets)
+        .Observe(since.ms());
+    return outcome::success();
   }
 
   outcome::result<void> RemoteStoreImpl::deleteFromRemote(
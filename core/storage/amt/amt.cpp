@@ -6,6 +6,7 @@
 #include "storage/amt/amt.hpp"
 
 #include "common/which.hpp"
+#include "storage/ipfs/node_cache.hpp"
 
 OUTCOME_CPP_DEFINE_CATEGORY(fc::storage::amt, AmtError, e) {
   using fc::storage::amt::AmtError;
@@ -328,12 +329,14 @@ namespace fc::storage::amt {
   outcome::result<void> Amt::loadRoot() const {
     lazyCreateRoot();
     if (which<CID>(root_)) {
-      OUTCOME_TRY(root, fc::getCbor<Root>(ipld_, boost::get<CID>(root_)));
-      root_ = root;
-      if (v3() ? root.bits != bits() : root.bits.has_value()) {
+      OUTCOME_TRY(root,
+                  storage::ipfs::getCborCached<Root>(ipld_,
+                                                     boost::get<CID>(root_)));
+      root_ = *root;
+      if (v3() ? root->bits != bits() : root->bits.has_value()) {
         return AmtError::kRootBitsWrong;
       }
-      if (root.node.bits_bytes != bitsBytes()) {
+      if (root->node.bits_bytes != bitsBytes()) {
         return AmtError::kRootBitsWrong;
       }
     }
@@ -361,14 +364,16 @@ namespace fc::storage::amt {
     }
     auto &link = it->second;
     if (which<CID>(link)) {
-      OUTCOME_TRY(node, fc::getCbor<Node>(ipld_, boost::get<CID>(link)));
-      if (node.bits_bytes != bitsBytes()) {
+      OUTCOME_TRY(node,
+                  storage::ipfs::getCborCached<Node>(ipld_,
+                                                     boost::get<CID>(link)));
+      if (node->bits_bytes != bitsBytes()) {
         return AmtError::kRootBitsWrong;
       }
       if (visiting) {
-        return std::make_shared<Node>(std::move(node));
+        return std::make_shared<Node>(*node);
       }
-      link = std::make_shared<Node>(std::move(node));
+      link = std::make_shared<Node>(*node);
     }
     return boost::get<Node::Ptr>(link);
   }
@@ -5,6 +5,12 @@
 
 #include "storage/car/cids_index/cids_index.hpp"
 
+#include <boost/endian/conversion.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <future>
+#include <thread>
+
+#include "codec/cbor/light_reader/cid.hpp"
 #include "codec/uvarint.hpp"
 #include "common/error_text.hpp"
 #include "common/file.hpp"
@@ -15,7 +21,29 @@
 #include "storage/ipfs/ipfs_datastore_error.hpp"
 
 namespace fc::storage::cids_index {
-  outcome::result<size_t> checkIndex(std::ifstream &file) {
+  inline gsl::span<const Row> asRows(BytesIn bytes) {
+    return gsl::make_span(common::span::cast<const Row>(bytes.data()),
+                          bytes.size() / sizeof(Row));
+  }
+
+  outcome::result<size_t> checkIndex(BytesIn index) {
+    if (index.size() % sizeof(Row) != 0) {
+      return ERROR_TEXT("checkIndex: invalid file size");
+    }
+    const auto rows{asRows(index)};
+    if (rows.size() < 2) {
+      return ERROR_TEXT("checkIndex: read header failed");
+    }
+    if (rows[0] != kHeaderV0) {
+      return ERROR_TEXT("checkIndex: invalid header");
+    }
+    if (rows[rows.size() - 1] != kTrailerV0) {
+      return ERROR_TEXT("checkIndex: invalid trailer");
+    }
+    return rows.size() - 2;
+  }
+
+  outcome::result<size_t> checkIndex(std::istream &file) {
     file.seekg(0, std::ios::end);
     auto _size{file.tellg()};
     if (_size < 0) {
@@ -66,6 +94,41 @@ namespace fc::storage::cids_index {
     return {false, 0};
   }
 
+  boost::optional<BytesIn> readCarItem(BytesIn car, const Row &row) {
+    if (row.offset.value() >= car.size()) {
+      return boost::none;
+    }
+    auto item{car.subspan(row.offset.value())};
+    BytesIn input;
+    const CbCid *key{};
+    if (codec::uvarint::readBytes(input, item)
+        && codec::cbor::light_reader::readCborBlake(key, input)
+        && *key == row.key) {
+      return input;
+    }
+    return boost::none;
+  }
+
+  boost::optional<BytesIn> readCarItem(FILE *car,
+                                       const Row &row,
+                                       Bytes &buffer) {
+    buffer.resize(maxSize(row.max_size64.value()));
+    const auto read{common::readAt(car, row.offset.value(), buffer)};
+    if (!read) {
+      return boost::none;
+    }
+    buffer.resize(read.value());
+    auto item{BytesIn{buffer}};
+    BytesIn input;
+    const CbCid *key{};
+    if (codec::uvarint::readBytes(input, item)
+        && codec::cbor::light_reader::readCborBlake(key, input)
+        && *key == row.key) {
+      return input;
+    }
+    return boost::none;
+  }
+
   RowsInfo &RowsInfo::feed(const Row &row) {
     valid = valid && !row.isMeta();
     if (valid) {
@@ -150,72 +213,134 @@ namespace fc::storage::cids_index {
     return outcome::success();
   }
 
-  outcome::result<size_t> readCar(std::istream &car_file,
+  void parallelSort(std::vector<Row> &rows, size_t threads) {
+    // estimated, sorting less than 64k rows is not worth threads
+    threads = std::min(threads, rows.size() >> 16);
+    if (threads <= 1) {
+      std::sort(rows.begin(), rows.end());
+      return;
+    }
+    std::vector<size_t> bounds;
+    for (size_t i{0}; i <= threads; ++i) {
+      bounds.push_back(rows.size() * i / threads);
+    }
+    auto parallel{[&](size_t count, auto &&f) {
+      std::vector<std::thread> pool;
+      for (size_t i{0}; i < count; ++i) {
+        pool.emplace_back([&f, i] { f(i); });
+      }
+      for (auto &thread : pool) {
+        thread.join();
+      }
+    }};
+    parallel(threads, [&](size_t i) {
+      std::sort(rows.begin() + bounds[i], rows.begin() + bounds[i + 1]);
+    });
+    // merge adjacent pairs of sorted parts until one part is left
+    while (bounds.size() > 2) {
+      const auto pairs{(bounds.size() - 1) / 2};
+      parallel(pairs, [&](size_t i) {
+        std::inplace_merge(rows.begin() + bounds[2 * i],
+                           rows.begin() + bounds[2 * i + 1],
+                           rows.begin() + bounds[2 * i + 2]);
+      });
+      std::vector<size_t> merged;
+      for (size_t i{0}; i < bounds.size(); i += 2) {
+        merged.push_back(bounds[i]);
+      }
+      if (merged.back() != bounds.back()) {
+        merged.push_back(bounds.back());
+      }
+      bounds = std::move(merged);
+    }
+  }
+
+  outcome::result<size_t> readCar(BytesIn car,
                                   uint64_t car_min,
                                   uint64_t car_max,
                                   boost::optional<size_t> max_memory,
                                   IpldPtr ipld,
                                   Progress *progress,
                                   std::fstream &rows_file,
-                                  std::vector<MergeRange> &ranges) {
+                                  std::vector<MergeRange> &ranges,
+                                  size_t threads) {
     assert(car_min <= car_max);
+    assert(car_max <= car.size());
     auto write_error{ERROR_TEXT("readCar: write error")};
-    // estimated, 64kb
-    car_file.rdbuf()->pubsetbuf(nullptr, 64 << 10);
-    std::vector<Row> rows;
+    size_t capacity{};
     if (max_memory) {
-      // estimated, 16mb, 512mb
-      rows.reserve(std::clamp<size_t>(*max_memory, 16 << 20, 512 << 20)
-                   / sizeof(Row));
+      // estimated, 512mb, but within max memory
+      // one run is scanned while other run and its merge buffer are sorted
+      capacity = std::max<size_t>(
+          1, std::min<size_t>(*max_memory / 3, 512 << 20) / sizeof(Row));
     } else {
       // estimated
-      rows.reserve((car_max - car_min) * 33 / 23520);
+      capacity = (car_max - car_min) * 33 / 23520;
     }
+    std::vector<Row> rows;
     if (!common::writeStruct(rows_file, kHeaderV0)) {
       return write_error;
     }
     size_t offset{car_min};
-    car_file.clear();
-    car_file.seekg(offset);
     size_t total{};
-    Bytes item;
+    // sorts and writes previous run while next run is scanned
+    std::future<bool> sorting;
     auto flush{[&] {
+      if (sorting.valid() && !sorting.get()) {
+        return false;
+      }
       auto &range{ranges.emplace_back()};
       range.begin = 1 + total - rows.size();
       range.end = 1 + total;
       range.file = &rows_file;
-      std::sort(rows.begin(), rows.end());
-      auto res{common::write(rows_file, gsl::make_span(rows))};
-      rows.resize(0);
-      return res;
+      sorting = std::async(
+          std::launch::async,
+          [&rows_file, threads, rows{std::move(rows)}]() mutable {
+            parallelSort(rows, threads);
+            return common::write(rows_file, gsl::make_span(rows));
+          });
+      rows = {};
+      return true;
     }};
     while (offset < car_max) {
-      auto varint{codec::uvarint::readBytes(car_file, item)};
-      if (!varint) {
+      auto input{car.subspan(offset, car_max - offset)};
+      size_t length{};
+      BytesIn item;
+      if (!codec::uvarint::read(length, input)) {
+        // incomplete item at end of car being written
         break;
       }
-      BytesIn input{item};
-      auto size{varint + item.size()};
+      if (length > kMaxCarItem) {
+        return ERROR_TEXT("readCar: item too large");
+      }
+      if (!codec::read(item, input, length)) {
+        break;
+      }
+      BytesIn cid_input{item};
+      const auto size{car_max - offset - input.size()};
       if (startsWith(item, kCborBlakePrefix)) {
-        input = input.subspan(kCborBlakePrefix.size());
-        OUTCOME_TRY(key, fromSpan<CbCid>(input, false));
+        cid_input = cid_input.subspan(kCborBlakePrefix.size());
+        OUTCOME_TRY(key, fromSpan<CbCid>(cid_input, false));
+        if (rows.empty()) {
+          rows.reserve(capacity);
+        }
         auto &row{rows.emplace_back()};
         row.key = key;
         row.offset = offset;
         row.max_size64 = maxSize64(size);
         ++total;
       } else {
-        if (!startsWith(input, kMainnetGenesisBlockParent)) {
-          OUTCOME_TRY(cid, CID::read(input));
+        if (!startsWith(cid_input, kMainnetGenesisBlockParent)) {
+          OUTCOME_TRY(cid, CID::read(cid_input));
           if (ipld) {
             if (!asIdentity(cid)) {
-              OUTCOME_TRY(ipld->set(cid, input));
+              OUTCOME_TRY(ipld->set(cid, cid_input));
             }
           }
         }
       }
       offset += size;
-      if (max_memory && rows.size() == rows.capacity() && !flush()) {
+      if (max_memory && rows.size() == capacity && !flush()) {
         return write_error;
       }
       if (progress) {
@@ -224,7 +349,7 @@ namespace fc::storage::cids_index {
         progress->update();
       }
     }
-    if (!flush()) {
+    if (!flush() || !sorting.get()) {
       return write_error;
     }
     if (!common::writeStruct(rows_file, kTrailerV0)) {
@@ -234,40 +359,63 @@ namespace fc::storage::cids_index {
     return total;
   }
 
-  inline boost::optional<size_t> sparseSize(
-      size_t count, boost::optional<size_t> max_memory) {
-    if (max_memory && count * sizeof(Row) > *max_memory) {
-      return *max_memory / sizeof(CbCid);
+  const Row *lowerBound(gsl::span<const Row> rows, const CbCid &key) {
+    const auto begin{rows.data()};
+    const auto n{static_cast<size_t>(rows.size())};
+    if (n == 0 || n > UINT32_MAX) {
+      return std::lower_bound(begin, begin + n, key);
     }
-    return boost::none;
+    const auto prefix{boost::endian::load_big_u64(key.data())};
+    const size_t guess{((prefix >> 32) * n) >> 32};
+    // lower bound is in [lo, hi]
+    size_t lo{guess};
+    size_t hi{guess};
+    size_t step{1};
+    if (begin[guess] < key) {
+      lo = guess + 1;
+      hi = lo;
+      while (hi < n && begin[hi] < key) {
+        lo = hi + 1;
+        hi = lo + step;
+        step *= 2;
+      }
+      hi = std::min(hi, n);
+    } else {
+      while (lo != 0 && !(begin[lo - 1] < key)) {
+        hi = lo - 1;
+        lo = hi > step ? hi - step : 0;
+        step *= 2;
+      }
+    }
+    return std::lower_bound(begin + lo, begin + hi, key);
   }
 
-  outcome::result<boost::optional<Row>> MemoryIndex::find(
+  outcome::result<boost::optional<Row>> MappedIndex::find(
       const CbCid &key) const {
-    auto it{std::lower_bound(rows.begin(), rows.end(), key)};
-    if (it != rows.end() && it->key == key) {
+    const auto it{lowerBound(rows, key)};
+    if (it != rows.data() + rows.size() && it->key == key) {
       if (it->isMeta()) {
-        return ERROR_TEXT("MemoryIndex.find: inconsistent");
+        return ERROR_TEXT("MappedIndex.find: inconsistent");
       }
       return *it;
     }
     return boost::none;
   }
 
-  size_t MemoryIndex::size() const {
+  size_t MappedIndex::size() const {
     return rows.size();
   }
 
-  outcome::result<std::shared_ptr<MemoryIndex>> MemoryIndex::load(
-      std::ifstream &file, size_t count) {
-    auto index{std::make_shared<MemoryIndex>()};
-    index->rows.resize(count);
-    if (!common::read(file, gsl::make_span(index->rows))) {
-      return ERROR_TEXT("MemoryIndex::load: read rows failed");
-    }
-    for (auto &row : index->rows) {
+  outcome::result<std::shared_ptr<MappedIndex>> MappedIndex::load(
+      const std::string &index_path) {
+    auto index{std::make_shared<MappedIndex>()};
+    OUTCOME_TRY(mapped, common::mapFile(index_path));
+    OUTCOME_TRY(count, checkIndex(mapped.second));
+    index->file = std::move(mapped.first);
+    index->rows = asRows(mapped.second).subspan(1, count);
+    for (const auto &row : index->rows) {
       if (!index->info.feed(row).valid) {
-        return ERROR_TEXT("MemoryIndex::load: invalid index");
+        return ERROR_TEXT("MappedIndex::load: invalid index");
       }
     }
     return index;
@@ -311,19 +459,19 @@ namespace fc::storage::cids_index {
       i_begin = sparse_range.fromSparse(i_sparse - 1) + 1;
       --i_end;
     }
-    std::unique_lock lock{mutex};
-    index_file.seekg((1 + i_begin) * sizeof(Row));
-    for (auto i{i_begin}; i <= i_end; ++i) {
-      Row row;
-      if (!common::readStruct(index_file, row)) {
-        return ERROR_TEXT("SparseIndex.find: read error");
-      }
-      if (row.isMeta()) {
+    std::vector<Row> rows(i_end + 1 - i_begin);
+    const auto bytes{common::span::cast<uint8_t>(gsl::make_span(rows))};
+    const auto read{
+        common::readAt(index_file.get(), (1 + i_begin) * sizeof(Row), bytes)};
+    if (!read || read.value() != static_cast<size_t>(bytes.size())) {
+      return ERROR_TEXT("SparseIndex.find: read error");
+    }
+    const auto row{std::lower_bound(rows.begin(), rows.end(), key)};
+    if (row != rows.end() && row->key == key) {
+      if (row->isMeta()) {
         return ERROR_TEXT("SparseIndex.find: inconsistent");
       }
-      if (row.key == key) {
-        return row;
-      }
+      return *row;
     }
     return boost::none;
   }
@@ -333,7 +481,11 @@ namespace fc::storage::cids_index {
   }
 
   outcome::result<std::shared_ptr<SparseIndex>> SparseIndex::load(
-      std::ifstream &&file, size_t count, size_t max_keys) {
+      const std::string &index_path, size_t max_keys) {
+    std::ifstream file{index_path, std::ios::binary};
+    // estimated, 64kb
+    file.rdbuf()->pubsetbuf(nullptr, 64 << 10);
+    OUTCOME_TRY(count, checkIndex(file));
     auto index{std::make_shared<SparseIndex>()};
     index->sparse_range = {count, max_keys};
     index->sparse_keys.resize(index->sparse_range.buckets);
@@ -352,22 +504,31 @@ namespace fc::storage::cids_index {
       } while (i_row <= i_next);
       index->sparse_keys[i_sparse] = row.key;
     }
-    index->index_file = std::move(file);
+    auto index_file{fopen(index_path.c_str(), "rb")};
+    if (index_file == nullptr) {
+      return ERROR_TEXT("SparseIndex::load: open failed");
+    }
+    index->index_file = {index_file, fclose};
     return index;
   }
 
   outcome::result<std::shared_ptr<Index>> load(
       const std::string &index_path, boost::optional<size_t> max_memory) {
-    std::ifstream index_file{index_path, std::ios::binary};
-    // estimated
-    index_file.rdbuf()->pubsetbuf(nullptr, 64 << 10);
-    OUTCOME_TRY(count, checkIndex(index_file));
-    if (auto sparse{sparseSize(count, max_memory)}) {
-      OUTCOME_TRY(index,
-                  SparseIndex::load(std::move(index_file), count, *sparse));
-      return std::move(index);
-    }
-    OUTCOME_TRY(index, MemoryIndex::load(index_file, count));
+    if (max_memory) {
+      boost::system::error_code ec;
+      const auto size{boost::filesystem::file_size(index_path, ec)};
+      if (ec) {
+        return ec;
+      }
+      // mapped rows are resident after load checks them
+      if (size > *max_memory) {
+        OUTCOME_TRY(index,
+                    SparseIndex::load(index_path,
+                                      *max_memory / sizeof(CbCid)));
+        return std::move(index);
+      }
+    }
+    OUTCOME_TRY(index, MappedIndex::load(index_path));
     return std::move(index);
   }
 }  // namespace fc::storage::cids_index
@@ -7,10 +7,10 @@
 
 #include <boost/endian/buffers.hpp>
 #include <fstream>
-#include <mutex>
 
 #include "cbor_blake/cid.hpp"
 #include "common/enum.hpp"
+#include "common/file.hpp"
 #include "storage/ipfs/datastore.hpp"
 
 namespace boost {
@@ -33,6 +33,9 @@ namespace fc::storage::cids_index {
     return max_size64 * 64;
   }
 
+  /** Max size of car item, same as for blocks read from stream */
+  constexpr size_t kMaxCarItem{1 << 30};
+
   enum class Meta : uint8_t {
     kHeaderV0 = 1,
     kTrailerV0 = 2,
@@ -70,12 +73,32 @@ namespace fc::storage::cids_index {
 
   struct Progress;
 
-  outcome::result<size_t> checkIndex(std::ifstream &file);
+  /**
+   * Checks index header and trailer
+   * @return number of rows
+   */
+  outcome::result<size_t> checkIndex(BytesIn index);
+  outcome::result<size_t> checkIndex(std::istream &file);
 
   std::pair<bool, size_t> readCarItem(std::istream &car_file,
                                       const Row &row,
                                       uint64_t *end);
 
+  /**
+   * Reads car item of row from mapped car
+   * @return item value, or nothing if item is out of car or doesn't match row
+   */
+  boost::optional<BytesIn> readCarItem(BytesIn car, const Row &row);
+
+  /**
+   * Reads car item of row with pread, for items outside of mapped car
+   * @param buffer - owns returned value
+   * @return item value, or nothing if item doesn't match row
+   */
+  boost::optional<BytesIn> readCarItem(FILE *car,
+                                       const Row &row,
+                                       Bytes &buffer);
+
   struct RowsInfo {
     bool valid{true};
     bool sorted{true};
@@ -109,14 +132,27 @@ namespace fc::storage::cids_index {
   outcome::result<void> merge(std::ostream &out,
                               std::vector<MergeRange> &&ranges);
 
-  outcome::result<size_t> readCar(std::istream &car_file,
+  /** Sorts rows with given number of threads */
+  void parallelSort(std::vector<Row> &rows, size_t threads);
+
+  /**
+   * Scans mapped car and writes sorted runs of rows.
+   * Runs are sorted and written by background job while next run is scanned,
+   * each run is sorted by given number of threads.
+   * @param car - mapped car file
+   * @param max_memory - memory for rows, split between scanned and sorted run
+   * @param threads - number of sorting threads
+   * @return number of rows
+   */
+  outcome::result<size_t> readCar(BytesIn car,
                                   uint64_t car_min,
                                   uint64_t car_max,
                                   boost::optional<size_t> max_memory,
                                   IpldPtr ipld,
                                   Progress *progress,
                                   std::fstream &rows_file,
-                                  std::vector<MergeRange> &ranges);
+                                  std::vector<MergeRange> &ranges,
+                                  size_t threads);
 
   struct Index {
     RowsInfo info;
@@ -127,14 +163,19 @@ namespace fc::storage::cids_index {
     virtual size_t size() const = 0;
   };
 
-  struct MemoryIndex : Index {
-    std::vector<Row> rows;
+  /**
+   * Index file mapped to memory.
+   * Lookups don't lock or copy, concurrent readers only share page cache.
+   */
+  struct MappedIndex : Index {
+    common::MappedFile file;
+    gsl::span<const Row> rows;
 
     outcome::result<boost::optional<Row>> find(const CbCid &key) const override;
     size_t size() const override;
 
-    static outcome::result<std::shared_ptr<MemoryIndex>> load(
-        std::ifstream &file, size_t count);
+    static outcome::result<std::shared_ptr<MappedIndex>> load(
+        const std::string &index_path);
   };
 
   struct SparseRange {
@@ -145,9 +186,13 @@ namespace fc::storage::cids_index {
     size_t fromSparse(size_t bucket) const;
   };
 
+  /**
+   * Index larger than max memory.
+   * Keeps every n-th key in memory, rows between them are read with pread,
+   * so lookups don't lock.
+   */
   struct SparseIndex : Index {
-    mutable std::mutex mutex;
-    mutable std::ifstream index_file;
+    std::shared_ptr<FILE> index_file;
     SparseRange sparse_range;
     std::vector<CbCid> sparse_keys;
 
@@ -155,9 +200,19 @@ namespace fc::storage::cids_index {
     size_t size() const override;
 
     static outcome::result<std::shared_ptr<SparseIndex>> load(
-        std::ifstream &&file, size_t count, size_t max_keys);
+        const std::string &index_path, size_t max_keys);
   };
 
+  /**
+   * Finds first row not less than key.
+   * Keys are uniformly distributed hashes, so search starts at row predicted
+   * by key prefix and touches few pages.
+   */
+  const Row *lowerBound(gsl::span<const Row> rows, const CbCid &key);
+
+  /**
+   * Loads index, mapped unless it is larger than max memory
+   */
   outcome::result<std::shared_ptr<Index>> load(
       const std::string &index_path, boost::optional<size_t> max_memory);
 }  // namespace fc::storage::cids_index
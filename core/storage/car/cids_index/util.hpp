@@ -6,6 +6,7 @@
 #pragma once
 
 #include <boost/filesystem/operations.hpp>
+#include <thread>
 
 #include "codec/uvarint.hpp"
 #include "common/error_text.hpp"
@@ -105,14 +106,16 @@ namespace fc::storage::cids_index {
         std::fstream rows_file{
             rows_path,
             std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc};
-        OUTCOME_TRY(readCar(car_file,
+        OUTCOME_TRY(car_map, common::mapFile(car_path));
+        OUTCOME_TRY(readCar(car_map.second,
                             indexed_end,
                             car_size,
                             max_memory,
                             ipld,
                             &progress,
                             rows_file,
-                            ranges));
+                            ranges,
+                            std::max(1u, std::thread::hardware_concurrency())));
         auto tmp_cids_path{cids_path + ".tmp"};
         if (ranges.size() == 1) {
           tmp_cids_path = rows_path;
@@ -154,7 +157,15 @@ namespace fc::storage::cids_index {
       }
     }
     auto _ipld{std::make_shared<CidsIpld>()};
-    _ipld->car_file.open(car_path, std::ios::in | std::ios::binary);
+    OUTCOME_TRY(car_map,
+                common::mapFile(car_path, max_memory.value_or(SIZE_MAX)));
+    _ipld->car_map =
+        std::make_shared<const common::MappedFile>(std::move(car_map.first));
+    auto car_read{fopen(car_path.c_str(), "rb")};
+    if (car_read == nullptr) {
+      return ERROR_TEXT("loadOrCreateWithProgress: open car failed");
+    }
+    _ipld->car_file = {car_read, fclose};
     _ipld->index = index;
     _ipld->ipld = ipld;
     if (writable) {
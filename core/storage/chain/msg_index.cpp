@@ -0,0 +1,314 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/chain/msg_index.hpp"
+
+#include <boost/endian/conversion.hpp>
+
+#include "codec/cbor/cbor_codec.hpp"
+#include "common/endian.hpp"
+#include "common/error_text.hpp"
+#include "common/logger.hpp"
+#include "common/outcome_fmt.hpp"
+#include "common/span.hpp"
+#include "primitives/address/address_codec.hpp"
+
+namespace fc::storage::blockchain {
+  using primitives::tipset::HeadChangeType;
+  using primitives::tipset::MessageVisitor;
+
+  namespace {
+    /** Found with cbor encodable tipset key */
+    struct Row {
+      std::vector<CbCid> ts;
+      ChainEpoch height{};
+      uint64_t index{};
+    };
+    CBOR_TUPLE(Row, ts, height, index)
+
+    // key layout:
+    //   "h" height -> tipset key
+    //   "m" cid -> Row
+    //   "f" len from height cid -> to
+    //   "bottom" -> lowest indexed height
+    // heights are big-endian, so cursor iterates them in order
+    const Bytes kBottomKey{
+        copy(common::span::cbytes(std::string_view{"bottom"}))};
+
+    Bytes heightKey(ChainEpoch height) {
+      Bytes key{'h'};
+      common::putUint64BigEndian(key, height);
+      return key;
+    }
+
+    outcome::result<Bytes> msgKey(const CID &cid) {
+      OUTCOME_TRY(bytes, cid.toBytes());
+      Bytes key{'m'};
+      append(key, bytes);
+      return key;
+    }
+
+    Bytes fromPrefix(const Address &from) {
+      const auto bytes{primitives::address::encode(from)};
+      Bytes key{'f', static_cast<uint8_t>(bytes.size())};
+      append(key, bytes);
+      return key;
+    }
+
+    outcome::result<Bytes> fromKey(const Address &from,
+                                   ChainEpoch height,
+                                   const CID &cid) {
+      OUTCOME_TRY(bytes, cid.toBytes());
+      auto key{fromPrefix(from)};
+      common::putUint64BigEndian(key, height);
+      append(key, bytes);
+      return key;
+    }
+
+    auto log() {
+      static common::Logger logger = common::createLogger("msg_index");
+      return logger.get();
+    }
+  }  // namespace
+
+  MsgIndex::MsgIndex(TsLoadPtr ts_load, IpldPtr ipld, MapPtr kv)
+      : ts_load{std::move(ts_load)}, ipld{std::move(ipld)}, kv{std::move(kv)} {
+    if (this->kv->contains(kBottomKey)) {
+      bottom =
+          codec::cbor::decode<ChainEpoch>(this->kv->get(kBottomKey).value())
+              .value();
+    }
+  }
+
+  MsgIndex::~MsgIndex() {
+    stop = true;
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+
+  outcome::result<void> MsgIndex::onHeadChange(const HeadChange &change) {
+    std::unique_lock lock{mutex};
+    const auto &ts{change.value};
+    if (!bottom) {
+      return init(ts);
+    }
+    Batch batch{kv->batch(), {}};
+    if (change.type == HeadChangeType::APPLY) {
+      OUTCOME_TRY(apply(batch, ts));
+    } else if (change.type == HeadChangeType::REVERT) {
+      OUTCOME_TRY(revert(batch, ts));
+    } else {
+      // node was stopped, index tipsets from indexed chain to current head
+      std::vector<TipsetCPtr> applied;
+      auto it{ts};
+      while (it->height() > *bottom) {
+        const auto main{mainAt(it->height())};
+        if (main && *main == it->key) {
+          break;
+        }
+        applied.push_back(it);
+        OUTCOME_TRYA(it, ts_load->load(it->getParents()));
+      }
+      // revert indexed tipsets above fork
+      if (auto cursor{kv->cursor()}) {
+        for (cursor->seek(heightKey(it->height() + 1));
+             cursor->isValid() && cursor->key()[0] == 'h';
+             cursor->next()) {
+          OUTCOME_TRY(cids,
+                      codec::cbor::decode<std::vector<CbCid>>(cursor->value()));
+          OUTCOME_TRY(reverted_ts, ts_load->load(cids));
+          OUTCOME_TRY(revert(batch, reverted_ts));
+        }
+      }
+      for (auto it2{applied.rbegin()}; it2 != applied.rend(); ++it2) {
+        OUTCOME_TRY(apply(batch, *it2));
+      }
+    }
+    return batch.kv->commit();
+  }
+
+  void MsgIndex::rebuild() {
+    if (thread.joinable()) {
+      return;
+    }
+    thread = std::thread{[this] {
+      while (!stop) {
+        std::unique_lock lock{mutex};
+        auto more{rebuildStep()};
+        if (!more) {
+          log()->error("rebuild: {:#}", more.error());
+          return;
+        }
+        if (!more.value()) {
+          log()->info("rebuild done");
+          return;
+        }
+      }
+    }};
+  }
+
+  bool MsgIndex::covers(const TipsetCPtr &ts, ChainEpoch min_height) const {
+    std::unique_lock lock{mutex};
+    if (!bottom || *bottom > std::max<ChainEpoch>(min_height, 0)) {
+      return false;
+    }
+    const auto main{mainAt(ts->height())};
+    return main && *main == ts->key;
+  }
+
+  outcome::result<boost::optional<MsgIndex::Found>> MsgIndex::find(
+      const CID &cid) const {
+    OUTCOME_TRY(key, msgKey(cid));
+    return find(Batch{}, key);
+  }
+
+  outcome::result<boost::optional<MsgIndex::Found>> MsgIndex::find(
+      const Batch &batch, const Bytes &key) const {
+    Bytes bytes;
+    const auto it{batch.rows.find(key)};
+    if (it != batch.rows.end()) {
+      if (!it->second) {
+        return boost::none;
+      }
+      bytes = *it->second;
+    } else {
+      if (!kv->contains(key)) {
+        return boost::none;
+      }
+      OUTCOME_TRYA(bytes, kv->get(key));
+    }
+    OUTCOME_TRY(row, codec::cbor::decode<Row>(bytes));
+    return Found{std::move(row.ts), row.height, row.index};
+  }
+
+  outcome::result<std::vector<CID>> MsgIndex::list(
+      const Address &from,
+      const Address &to,
+      ChainEpoch min_height,
+      ChainEpoch max_height) const {
+    std::vector<CID> cids;
+    const auto prefix{fromPrefix(from)};
+    const auto encoded_to{primitives::address::encode(to)};
+    if (auto cursor{kv->cursor()}) {
+      auto key{prefix};
+      common::putUint64BigEndian(key, std::max<ChainEpoch>(min_height, 0));
+      for (cursor->seek(key); cursor->isValid(); cursor->next()) {
+        key = cursor->key();
+        if (key.size() < prefix.size() + sizeof(uint64_t)
+            || !std::equal(prefix.begin(), prefix.end(), key.begin())) {
+          break;
+        }
+        const auto height{static_cast<ChainEpoch>(
+            boost::endian::load_big_u64(key.data() + prefix.size()))};
+        if (height > max_height) {
+          break;
+        }
+        if (cursor->value() != encoded_to) {
+          continue;
+        }
+        OUTCOME_TRY(cid,
+                    CID::fromBytes(BytesIn{key}.subspan(
+                        static_cast<ptrdiff_t>(prefix.size()
+                                               + sizeof(uint64_t)))));
+        cids.push_back(std::move(cid));
+      }
+    }
+    std::reverse(cids.begin(), cids.end());
+    return cids;
+  }
+
+  outcome::result<void> MsgIndex::apply(Batch &batch, const TipsetCPtr &ts) {
+    OUTCOME_TRY(key_cbor, codec::cbor::encode(ts->key.cids()));
+    OUTCOME_TRY(batch.kv->put(heightKey(ts->height()), std::move(key_cbor)));
+    OUTCOME_TRY(ts->visitMessages(
+        {ipld, false, true},
+        [&](auto, auto, auto &cid, auto, auto msg) -> outcome::result<void> {
+          OUTCOME_TRY(key, fromKey(msg->from, ts->height(), cid));
+          return batch.kv->put(key, primitives::address::encode(msg->to));
+        }));
+    if (ts->height() != 0) {
+      OUTCOME_TRY(parent, ts_load->load(ts->getParents()));
+      OUTCOME_TRY(parent->visitMessages(
+          {ipld, true, true},
+          [&](auto i, auto, auto &cid, auto, auto) -> outcome::result<void> {
+            OUTCOME_TRY(key, msgKey(cid));
+            OUTCOME_TRY(
+                row, codec::cbor::encode(Row{ts->key.cids(), ts->height(), i}));
+            batch.rows[key] = row;
+            return batch.kv->put(key, std::move(row));
+          }));
+    }
+    return outcome::success();
+  }
+
+  outcome::result<void> MsgIndex::revert(Batch &batch, const TipsetCPtr &ts) {
+    OUTCOME_TRY(batch.kv->remove(heightKey(ts->height())));
+    OUTCOME_TRY(ts->visitMessages(
+        {ipld, false, true},
+        [&](auto, auto, auto &cid, auto, auto msg) -> outcome::result<void> {
+          OUTCOME_TRY(key, fromKey(msg->from, ts->height(), cid));
+          return batch.kv->remove(key);
+        }));
+    if (ts->height() != 0) {
+      OUTCOME_TRY(parent, ts_load->load(ts->getParents()));
+      // same messages as in apply, filtering needs loaded messages
+      OUTCOME_TRY(parent->visitMessages(
+          {ipld, true, true},
+          [&](auto, auto, auto &cid, auto, auto) -> outcome::result<void> {
+            // message may be executed again by other tipset later
+            OUTCOME_TRY(key, msgKey(cid));
+            OUTCOME_TRY(found, find(batch, key));
+            if (found && found->ts == ts->key) {
+              batch.rows[key] = boost::none;
+              return batch.kv->remove(key);
+            }
+            return outcome::success();
+          }));
+    }
+    return outcome::success();
+  }
+
+  outcome::result<void> MsgIndex::init(const TipsetCPtr &head) {
+    Batch batch{kv->batch(), {}};
+    OUTCOME_TRY(apply(batch, head));
+    OUTCOME_TRY(bottom_cbor, codec::cbor::encode(head->height()));
+    OUTCOME_TRY(batch.kv->put(kBottomKey, std::move(bottom_cbor)));
+    OUTCOME_TRY(batch.kv->commit());
+    bottom = head->height();
+    return outcome::success();
+  }
+
+  outcome::result<bool> MsgIndex::rebuildStep() {
+    if (!bottom || *bottom == 0) {
+      return false;
+    }
+    const auto main{mainAt(*bottom)};
+    if (!main) {
+      return ERROR_TEXT("MsgIndex: bottom tipset not indexed");
+    }
+    OUTCOME_TRY(ts, ts_load->load(*main));
+    OUTCOME_TRY(parent, ts_load->load(ts->getParents()));
+    Batch batch{kv->batch(), {}};
+    OUTCOME_TRY(apply(batch, parent));
+    OUTCOME_TRY(bottom_cbor, codec::cbor::encode(parent->height()));
+    OUTCOME_TRY(batch.kv->put(kBottomKey, std::move(bottom_cbor)));
+    OUTCOME_TRY(batch.kv->commit());
+    bottom = parent->height();
+    return true;
+  }
+
+  boost::optional<TipsetKey> MsgIndex::mainAt(ChainEpoch height) const {
+    const auto key{heightKey(height)};
+    if (!kv->contains(key)) {
+      return boost::none;
+    }
+    if (auto cids{
+            codec::cbor::decode<std::vector<CbCid>>(kv->get(key).value())}) {
+      return TipsetKey{std::move(cids.value())};
+    }
+    return boost::none;
+  }
+}  // namespace fc::storage::blockchain
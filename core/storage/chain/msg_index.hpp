@@ -0,0 +1,101 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include "primitives/tipset/load.hpp"
+#include "storage/map_prefix/prefix.hpp"
+
+namespace fc::storage::blockchain {
+  using primitives::address::Address;
+  using primitives::tipset::HeadChange;
+  using primitives::tipset::TipsetCPtr;
+  using primitives::tipset::TipsetKey;
+  using primitives::tipset::TsLoadPtr;
+
+  /**
+   * Persistent index of main chain messages.
+   * Maps message cid to tipset where message was executed, and sender to
+   * messages included by height.
+   * Indexed heights form range from bottom to head, tipsets below bottom are
+   * indexed by background rebuild.
+   */
+  class MsgIndex {
+   public:
+    /** Where message was executed */
+    struct Found {
+      /** Tipset with receipt in parent receipts */
+      TipsetKey ts;
+      ChainEpoch height{};
+      /** Receipt index */
+      uint64_t index{};
+    };
+
+    MsgIndex(TsLoadPtr ts_load, IpldPtr ipld, MapPtr kv);
+    MsgIndex(const MsgIndex &) = delete;
+    MsgIndex(MsgIndex &&) = delete;
+    ~MsgIndex();
+    MsgIndex &operator=(const MsgIndex &) = delete;
+    MsgIndex &operator=(MsgIndex &&) = delete;
+
+    /** Indexes applied tipsets and removes reverted */
+    outcome::result<void> onHeadChange(const HeadChange &change);
+
+    /** Starts indexing chain below bottom down to genesis in background */
+    void rebuild();
+
+    /**
+     * Whether index has all tipsets of ts chain from ts down to min_height
+     */
+    bool covers(const TipsetCPtr &ts, ChainEpoch min_height) const;
+
+    /** @return where message was executed on main chain */
+    outcome::result<boost::optional<Found>> find(const CID &cid) const;
+
+    /**
+     * @return messages from sender to receiver included in main chain tipsets
+     * with height between min_height and max_height, higher first
+     */
+    outcome::result<std::vector<CID>> list(const Address &from,
+                                           const Address &to,
+                                           ChainEpoch min_height,
+                                           ChainEpoch max_height) const;
+
+   private:
+    /** Batch of head change, remembers message rows it writes */
+    struct Batch {
+      std::unique_ptr<BufferBatch> kv;
+      /** Pending message rows, none if removed */
+      std::map<Bytes, boost::optional<Bytes>> rows;
+    };
+
+    /** Writes included and executed messages of tipset */
+    outcome::result<void> apply(Batch &batch, const TipsetCPtr &ts);
+    /** Removes entries written by apply */
+    outcome::result<void> revert(Batch &batch, const TipsetCPtr &ts);
+    /** Finds message row in pending batch, then in kv */
+    outcome::result<boost::optional<Found>> find(const Batch &batch,
+                                                 const Bytes &key) const;
+    /** Indexes head when index is empty */
+    outcome::result<void> init(const TipsetCPtr &head);
+    /** Indexes parent of bottom tipset */
+    outcome::result<bool> rebuildStep();
+    boost::optional<TipsetKey> mainAt(ChainEpoch height) const;
+
+    TsLoadPtr ts_load;
+    IpldPtr ipld;
+    MapPtr kv;
+    mutable std::mutex mutex;
+    /** Lowest indexed height */
+    boost::optional<ChainEpoch> bottom;
+    std::atomic_bool stop{false};
+    std::thread thread;
+  };
+}  // namespace fc::storage::blockchain
@@ -22,14 +22,22 @@ namespace fc::storage::blockchain {
       TsLoadPtr ts_load,
       IpldPtr ipld,
       std::shared_ptr<boost::asio::io_context> io,
-      const std::shared_ptr<ChainStore> &chain_store) {
+      const std::shared_ptr<ChainStore> &chain_store,
+      std::shared_ptr<MsgIndex> index) {
     auto waiter{std::make_shared<MsgWaiter>()};
     waiter->ts_load = std::move(ts_load);
     waiter->ipld = std::move(ipld);
     waiter->io = std::move(io);
+    waiter->index = std::move(index);
     waiter->head_sub =
         chain_store->subscribeHeadChanges([=](const auto &changes) {
           for (const auto &change : changes) {
+            if (waiter->index) {
+              auto res{waiter->index->onHeadChange(change)};
+              if (!res) {
+                spdlog::error("MsgIndex.onHeadChange: {:#}", res.error());
+              }
+            }
             auto res{waiter->onHeadChange(change)};
             if (!res) {
               spdlog::error("MsgWaiter.onHeadChange: {:#}", res.error());
@@ -89,6 +97,10 @@ namespace fc::storage::blockchain {
     waiting[cid].callbacks.emplace(confidence, std::move(cb));
   }
 
+  const std::shared_ptr<MsgIndex> &MsgWaiter::msgIndex() const {
+    return index;
+  }
+
   // NOLIINTNEXTLINE(readability-function-cognitive-complexity)
   outcome::result<void> MsgWaiter::onHeadChange(const HeadChange &change) {
     std::unique_lock lock{mutex};
@@ -143,10 +155,34 @@ namespace fc::storage::blockchain {
     search.cb = std::move(cb);
     search.min_height =
         lookback_limit == -1 ? 0 : head->epoch() - lookback_limit;
+    if (index && index->covers(ts, search.min_height)) {
+      auto found{indexSearch(ts, cid, search.min_height)};
+      if (found) {
+        return search.cb(std::move(found.value().first),
+                         std::move(found.value().second));
+      }
+      spdlog::warn("MsgWaiter.indexSearch: {:#}", found.error());
+    }
     search.ts = std::move(ts);
     searchLoop(searching.emplace(searching.end(), std::move(search)));
   }
 
+  outcome::result<std::pair<TipsetCPtr, MessageReceipt>>
+  MsgWaiter::indexSearch(const TipsetCPtr &ts,
+                         const CID &cid,
+                         ChainEpoch min_height) {
+    OUTCOME_TRY(found, index->find(cid));
+    if (!found || found->height > ts->height()
+        || found->height < min_height) {
+      return std::make_pair(nullptr, MessageReceipt{});
+    }
+    OUTCOME_TRY(ts_found, ts_load->load(found->ts));
+    adt::Array<MessageReceipt> receipts{ts_found->getParentMessageReceipts(),
+                                        ipld};
+    OUTCOME_TRY(receipt, receipts.get(found->index));
+    return std::make_pair(std::move(ts_found), std::move(receipt));
+  }
+
   void MsgWaiter::searchLoop(Searching::iterator it) {
     auto &search{*it};
     TipsetCPtr ts_found;
@@ -9,6 +9,7 @@
 
 #include "fwd.hpp"
 #include "storage/chain/chain_store.hpp"
+#include "storage/chain/msg_index.hpp"
 #include "vm/runtime/runtime_types.hpp"
 
 namespace fc::storage::blockchain {
@@ -37,7 +38,8 @@ namespace fc::storage::blockchain {
         TsLoadPtr ts_load,
         IpldPtr ipld,
         std::shared_ptr<boost::asio::io_context> io,
-        const std::shared_ptr<ChainStore>& chain_store);
+        const std::shared_ptr<ChainStore>& chain_store,
+        std::shared_ptr<MsgIndex> index = nullptr);
 
     void search(TipsetCPtr ts,
                 const CID &cid,
@@ -48,6 +50,9 @@ namespace fc::storage::blockchain {
               EpochDuration confidence,
               Callback cb);
 
+    /** @return index updated on head change, may be null */
+    const std::shared_ptr<MsgIndex> &msgIndex() const;
+
    private:
     /** Head change subscription. */
     outcome::result<void> onHeadChange(const HeadChange &change);
@@ -56,12 +61,16 @@ namespace fc::storage::blockchain {
                  const CID &cid,
                  ChainEpoch lookback_limit,
                  Callback cb);
+    /** Finds message with index, ts must be covered by index */
+    outcome::result<std::pair<TipsetCPtr, MessageReceipt>> indexSearch(
+        const TipsetCPtr &ts, const CID &cid, ChainEpoch min_height);
     void searchLoop(Searching::iterator it);
     Waiting::iterator checkWait(Waiting::iterator it);
 
     TsLoadPtr ts_load;
     IpldPtr ipld;
     std::shared_ptr<boost::asio::io_context> io;
+    std::shared_ptr<MsgIndex> index;
     ChainStore::connection_t head_sub;
     mutable std::mutex mutex;
     TipsetCPtr head;
@@ -214,16 +214,12 @@ namespace fc::storage::compacter {
   }
 
   void CompacterIpld::queueLoop() {
-    auto &value{reuse_buffer};
-    while (auto key{queue->pop()}) {
-      if (!old_ipld->get(*key, value)) {
-        spdlog::warn("CompacterIpld.queueLoop not found {}",
-                     common::hex_lower(*key));
-        continue;
-      }
-      queue->pushChildren(value);
-      new_ipld->put(*key, BytesIn{value});
-    }
+    queue->walk(
+        walk_threads,
+        [&](const CbCid &key, Bytes &value) {
+          return old_ipld->get(key, value);
+        },
+        [&](const CbCid &key, BytesIn value) { new_ipld->put(key, value); });
   }
 
   void CompacterIpld::finish() {
@@ -63,6 +63,8 @@ namespace fc::storage::compacter {
     size_t epochs_full_state{};
     size_t epochs_lookback_state{};
     size_t epochs_messages{};
+    /** Number of threads walking reachable state */
+    size_t walk_threads{1};
 
     std::string path;
     IoThread thread;
@@ -6,10 +6,14 @@
 #include "storage/compacter/queue.hpp"
 
 #include <boost/filesystem/operations.hpp>
+#include <thread>
 
 #include "codec/cbor/light_reader/cid.hpp"
+#include "common/append.hpp"
 #include "common/error_text.hpp"
 #include "common/file.hpp"
+#include "common/hexutil.hpp"
+#include "common/logger.hpp"
 
 namespace fc::storage::compacter {
   inline void _error() {
@@ -63,8 +67,11 @@ namespace fc::storage::compacter {
 
   void CompacterQueue::push(const CbCid &key) {
     std::unique_lock lock{mutex};
-    if (_push(key) && !writer.flush()) {
-      _error();
+    if (_push(key)) {
+      if (!writer.flush()) {
+        _error();
+      }
+      pushed.notify_all();
     }
   }
 
@@ -76,8 +83,11 @@ namespace fc::storage::compacter {
         any = true;
       }
     }
-    if (any && !writer.flush()) {
-      _error();
+    if (any) {
+      if (!writer.flush()) {
+        _error();
+      }
+      pushed.notify_all();
     }
   }
 
@@ -93,8 +103,11 @@ namespace fc::storage::compacter {
         }
       }
     }
-    if (any && !writer.flush()) {
-      _error();
+    if (any) {
+      if (!writer.flush()) {
+        _error();
+      }
+      pushed.notify_all();
     }
   }
 
@@ -116,4 +129,164 @@ namespace fc::storage::compacter {
       }
     }
   }
+
+  void CompacterQueue::walk(size_t threads, const Get &get, const Put &put) {
+    // estimated, amortizes queue file writes
+    constexpr size_t kBatch{64};
+    struct Worker {
+      std::mutex mutex;
+      std::vector<CbCid> stack;
+    };
+    threads = std::max<size_t>(threads, 1);
+    std::vector<Worker> workers(threads);
+    // keys in worker stacks and keys being processed
+    std::atomic_size_t pending{};
+    // changed when keys are added to worker stacks
+    std::atomic_size_t version{};
+    std::atomic_bool stop{false};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    {
+      std::unique_lock lock{mutex};
+      for (size_t i{0}; i < stack.size(); ++i) {
+        workers[i % threads].stack.push_back(stack[i]);
+      }
+      pending = stack.size();
+      stack.clear();
+    }
+
+    auto take{[&](size_t i, std::vector<CbCid> &batch) {
+      auto &own{workers[i]};
+      std::unique_lock lock{own.mutex};
+      const auto n{std::min(own.stack.size(), kBatch)};
+      batch.assign(own.stack.end() - n, own.stack.end());
+      own.stack.resize(own.stack.size() - n);
+      lock.unlock();
+      if (!batch.empty()) {
+        return;
+      }
+      for (size_t j{1}; j < threads; ++j) {
+        auto &victim{workers[(i + j) % threads]};
+        std::unique_lock victim_lock{victim.mutex};
+        if (victim.stack.empty()) {
+          continue;
+        }
+        // steal bottom half, it is closer to roots and has more work
+        const auto half{(victim.stack.size() + 1) / 2};
+        batch.assign(victim.stack.begin(), victim.stack.begin() + half);
+        victim.stack.erase(victim.stack.begin(), victim.stack.begin() + half);
+        victim_lock.unlock();
+        if (batch.size() > kBatch) {
+          std::unique_lock own_lock{own.mutex};
+          own.stack.insert(
+              own.stack.begin(), batch.begin() + kBatch, batch.end());
+          batch.resize(kBatch);
+        }
+        return;
+      }
+      // keys pushed to queue during walk, e.g. children of new values
+      std::unique_lock queue_lock{mutex};
+      const auto queued{std::min(stack.size(), kBatch)};
+      batch.assign(stack.end() - queued, stack.end());
+      stack.resize(stack.size() - queued);
+      pending += queued;
+    }};
+    auto wake{[&] {
+      // waiting thread checks condition under queue mutex
+      std::unique_lock lock{mutex};
+      pushed.notify_all();
+    }};
+
+    auto run{[&](size_t i) {
+      std::vector<CbCid> batch;
+      std::vector<Bytes> values;
+      std::vector<CbCid> children;
+      while (!stop) {
+        const size_t seen{version};
+        take(i, batch);
+        if (batch.empty()) {
+          std::unique_lock lock{mutex};
+          if (pending == 0 && stack.empty()) {
+            break;
+          }
+          pushed.wait(lock, [&] {
+            return stop || version != seen || pending == 0 || !stack.empty();
+          });
+          continue;
+        }
+        values.resize(batch.size());
+        children.clear();
+        for (size_t j{0}; j < batch.size(); ++j) {
+          auto &value{values[j]};
+          value.clear();
+          if (visited->has(batch[j])) {
+            continue;
+          }
+          if (!get(batch[j], value)) {
+            spdlog::warn("CompacterQueue.walk not found {}",
+                         common::hex_lower(batch[j]));
+            continue;
+          }
+          BytesIn input{value};
+          BytesIn cid;
+          while (codec::cbor::findCid(cid, input)) {
+            const CbCid *key = nullptr;
+            if (codec::cbor::light_reader::readCborBlake(key, cid)
+                && !visited->has(*key)) {
+              children.push_back(*key);
+            }
+          }
+        }
+        std::sort(children.begin(), children.end());
+        children.erase(std::unique(children.begin(), children.end()),
+                       children.end());
+        if (!children.empty()) {
+          std::unique_lock lock{mutex};
+          if (!common::write(writer, gsl::make_span(children))
+              || !writer.flush()) {
+            _error();
+          }
+        }
+        pending += children.size();
+        if (!children.empty()) {
+          {
+            std::unique_lock lock{workers[i].mutex};
+            append(workers[i].stack, children);
+          }
+          ++version;
+          wake();
+        }
+        for (size_t j{0}; j < batch.size(); ++j) {
+          if (!values[j].empty()) {
+            put(batch[j], values[j]);
+          }
+        }
+        if ((pending -= batch.size()) == 0) {
+          wake();
+        }
+      }
+    }};
+
+    std::vector<std::thread> pool;
+    for (size_t i{0}; i < threads; ++i) {
+      pool.emplace_back([&, i] {
+        try {
+          run(i);
+        } catch (...) {
+          std::unique_lock lock{error_mutex};
+          if (!error) {
+            error = std::current_exception();
+          }
+          stop = true;
+          wake();
+        }
+      });
+    }
+    for (auto &thread : pool) {
+      thread.join();
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
 }  // namespace fc::storage::compacter
@@ -5,7 +5,9 @@
 
 #pragma once
 
+#include <condition_variable>
 #include <fstream>
+#include <functional>
 #include <mutex>
 #include <optional>
 
@@ -13,6 +15,9 @@
 
 namespace fc::storage::compacter {
   struct CompacterQueue {
+    using Get = std::function<bool(const CbCid &key, Bytes &value)>;
+    using Put = std::function<void(const CbCid &key, BytesIn value)>;
+
     void open(bool clear);
     void clear();
     bool _push(const CbCid &key);
@@ -21,12 +26,27 @@ namespace fc::storage::compacter {
     void pushChildren(BytesIn input);
     bool empty();
     std::optional<CbCid> pop();
+    /**
+     * Pops keys and pushes their children until all reachable keys are
+     * visited.
+     * Each thread pops from own stack and steals from other stacks when own
+     * stack is empty, then takes keys pushed to queue during walk.
+     * Threads without keys wait for keys to be pushed.
+     * Children are written to queue file before parent is put, so walk is
+     * resumed from queue file after restart.
+     * @param threads - number of walking threads
+     * @param get - get value of key, false if not found
+     * @param put - put value of key, marks key visited
+     */
+    void walk(size_t threads, const Get &get, const Put &put);
 
     std::string path;
     CbIpldPtr visited;
 
     std::mutex mutex;
     std::vector<CbCid> stack;
+    /** Notified with mutex when keys are pushed, wakes walking threads */
+    std::condition_variable pushed;
     std::ofstream writer;
   };
 }  // namespace fc::storage::compacter
@@ -6,6 +6,7 @@
 #include "storage/hamt/hamt.hpp"
 
 #include "common/which.hpp"
+#include "storage/ipfs/node_cache.hpp"
 #include "crypto/sha/sha256.hpp"
 
 OUTCOME_CPP_DEFINE_CATEGORY(fc::storage::hamt, HamtError, e) {
@@ -27,7 +28,8 @@ namespace fc::storage::hamt {
   using codec::cbor::CborEncodeStream;
   using common::which;
 
-  inline auto leafFind(Node::Leaf &leaf, BytesIn key) {
+  template <typename Leaf>
+  inline auto leafFind(Leaf &leaf, BytesIn key) {
     return std::find_if(
         leaf.begin(), leaf.end(), [&](auto &p) { return p.first == key; });
   }
@@ -42,11 +44,10 @@ namespace fc::storage::hamt {
   }
 
   CBOR2_ENCODE(Node) {
-    Bits bits;
     auto l_items{CborEncodeStream::list()};
     for (const auto &[index, value] : v.items) {
-      bit_set(bits, index);
-      if (boost::get<Node::Ptr>(&value) != nullptr) {
+      if (boost::get<Node::Ptr>(&value) != nullptr
+          || boost::get<Node::Shared>(&value) != nullptr) {
         outcome::raise(HamtError::kExpectedCID);
       }
       codec::cbor::CborEncodeStream _item;
@@ -69,7 +70,7 @@ namespace fc::storage::hamt {
         l_items << m_item;
       }
     }
-    return s << (CborEncodeStream::list() << bits << l_items);
+    return s << (CborEncodeStream::list() << v.items.bits() << l_items);
   }
 
   CBOR2_DECODE(Node) {
@@ -78,10 +79,14 @@ namespace fc::storage::hamt {
     Bits bits;
     l_node >> bits;
     auto n_items = l_node.listLength();
+    if (n_items != bits.count()) {
+      outcome::raise(HamtError::kInconsistent);
+    }
+    v.items.reserve(n_items);
     auto l_items = l_node.list();
     size_t j = 0;
     for (size_t i = 0; i < n_items; ++i) {
-      while (!bit_test(bits, j)) {
+      while (!bits.test(j)) {
         ++j;
       }
       auto _item{l_items};
@@ -101,7 +106,7 @@ namespace fc::storage::hamt {
         outcome::raise(HamtError::kInconsistent);
       }
       if (_item.isCid()) {
-        v.items[j] = _item.get<CID>();
+        v.items.push_back(j, _item.get<CID>());
       } else {
         auto n_leaf{_item.listLength()};
         auto l_leaf{_item.list()};
@@ -111,7 +116,7 @@ namespace fc::storage::hamt {
           auto key{l_pair.get<Bytes>()};
           leaf.emplace_back(std::move(key), l_pair.raw());
         }
-        v.items[j] = std::move(leaf);
+        v.items.push_back(j, std::move(leaf));
       }
       ++j;
     }
@@ -138,7 +143,8 @@ namespace fc::storage::hamt {
       : ipld_{std::move(store)}, root_{root}, bit_width_{bit_width} {}
 
   outcome::result<void> Hamt::set(BytesIn key, BytesCow &&value) {
-    OUTCOME_TRY(loadRoot());
+    lazyCreateRoot();
+    OUTCOME_TRY(loadMutable(root_));
     return set(*boost::get<Node::Ptr>(root_),
                keyToIndices(key),
                key,
@@ -147,20 +153,39 @@ namespace fc::storage::hamt {
 
   outcome::result<Bytes> Hamt::get(BytesIn key) const {
     OUTCOME_TRY(loadRoot());
-    auto node = boost::get<Node::Ptr>(root_);
+    auto item{root_};
     for (auto index : keyToIndices(key)) {
-      auto it = node->items.find(index);
-      if (it == node->items.end()) {
-        return HamtError::kNotFound;
-      }
-      auto &item = it->second;
-      OUTCOME_TRY(loadItem(item));
+      const Node::Leaf *leaf{};
       if (which<Node::Ptr>(item)) {
-        node = boost::get<Node::Ptr>(item);
+        // loaded children of own node are kept
+        const auto node{boost::get<Node::Ptr>(item)};
+        auto it = node->items.find(index);
+        if (it == node->items.end()) {
+          return HamtError::kNotFound;
+        }
+        OUTCOME_TRY(loadItem(it->second));
+        if (which<Node::Leaf>(it->second)) {
+          leaf = &boost::get<Node::Leaf>(it->second);
+        } else {
+          item = it->second;
+        }
       } else {
-        auto &leaf = boost::get<Node::Leaf>(item);
-        auto it{leafFind(leaf, key)};
-        if (it == leaf.end()) {
+        const auto node{boost::get<Node::Shared>(item).node};
+        auto it = node->items.find(index);
+        if (it == node->items.end()) {
+          return HamtError::kNotFound;
+        }
+        if (which<Node::Leaf>(it->second)) {
+          leaf = &boost::get<Node::Leaf>(it->second);
+        } else {
+          const auto &cid{boost::get<CID>(it->second)};
+          OUTCOME_TRY(child, loadShared(cid));
+          item = Node::Shared{cid, std::move(child)};
+        }
+      }
+      if (leaf != nullptr) {
+        auto it{leafFind(*leaf, key)};
+        if (it == leaf->end()) {
           return HamtError::kNotFound;
         }
         return it->second;
@@ -170,7 +195,8 @@ namespace fc::storage::hamt {
   }
 
   outcome::result<void> Hamt::remove(BytesIn key) {
-    OUTCOME_TRY(loadRoot());
+    lazyCreateRoot();
+    OUTCOME_TRY(loadMutable(root_));
     return remove(*boost::get<Node::Ptr>(root_), keyToIndices(key), key);
   }
 
@@ -195,8 +221,8 @@ namespace fc::storage::hamt {
 
   std::vector<size_t> Hamt::keyToIndices(BytesIn key, int n) const {
     const auto bits{v3() ? bit_width_ : kDefaultBitWidth};
-    std::vector<uint8_t> key_bytes(key.begin(), key.end());
-    auto hash = crypto::sha::sha256(key_bytes);
+    assert(bits <= kMaxBitWidth);
+    auto hash = crypto::sha::sha256(key);
     std::vector<size_t> indices;
     constexpr auto byte_bits = 8;
     auto max_bits = byte_bits * hash.size();
@@ -232,7 +258,7 @@ namespace fc::storage::hamt {
       return outcome::success();
     }
     auto &item = it->second;
-    OUTCOME_TRY(loadItem(item));
+    OUTCOME_TRY(loadMutable(item));
     if (which<Node::Ptr>(item)) {
       return set(*boost::get<Node::Ptr>(item),
                  consumeIndex(indices),
@@ -270,7 +296,7 @@ namespace fc::storage::hamt {
       return HamtError::kNotFound;
     }
     auto &item = it->second;
-    OUTCOME_TRY(loadItem(item));
+    OUTCOME_TRY(loadMutable(item));
     if (which<Node::Ptr>(item)) {
       OUTCOME_TRY(
           remove(*boost::get<Node::Ptr>(item), consumeIndex(indices), key));
@@ -322,6 +348,9 @@ namespace fc::storage::hamt {
         OUTCOME_TRY(flush(item2.second));
       }
       OUTCOME_TRYA(item, fc::setCbor(ipld_, node));
+    } else if (which<Node::Shared>(item)) {
+      // unmodified
+      item = CID{boost::get<Node::Shared>(item).cid};
     }
     return outcome::success();
   }
@@ -333,17 +362,41 @@ namespace fc::storage::hamt {
 
   outcome::result<void> Hamt::loadItem(Node::Item &item) const {
     if (which<CID>(item)) {
-      OUTCOME_TRY(child, fc::getCbor<Node>(ipld_, boost::get<CID>(item)));
-      if (!child.v3) {
-        child.v3 = v3();
-      } else if (*child.v3 != v3()) {
+      const auto &cid{boost::get<CID>(item)};
+      if (ipld_->node_cache) {
+        OUTCOME_TRY(node, loadShared(cid));
+        item = Node::Shared{cid, std::move(node)};
+        return outcome::success();
+      }
+      OUTCOME_TRY(node, fc::getCbor<Node>(ipld_, cid));
+      if (node.v3 && *node.v3 != v3()) {
         return HamtError::kInconsistent;
       }
-      item = std::make_shared<Node>(std::move(child));
+      node.v3 = v3();
+      item = std::make_shared<Node>(std::move(node));
     }
     return outcome::success();
   }
 
+  outcome::result<void> Hamt::loadMutable(Node::Item &item) const {
+    OUTCOME_TRY(loadItem(item));
+    if (which<Node::Shared>(item)) {
+      auto node{std::make_shared<Node>(*boost::get<Node::Shared>(item).node)};
+      node->v3 = v3();
+      item = std::move(node);
+    }
+    return outcome::success();
+  }
+
+  outcome::result<std::shared_ptr<const Node>> Hamt::loadShared(
+      const CID &cid) const {
+    OUTCOME_TRY(node, storage::ipfs::getCborCached<Node>(ipld_, cid));
+    if (node->v3 && *node->v3 != v3()) {
+      return HamtError::kInconsistent;
+    }
+    return std::move(node);
+  }
+
   outcome::result<void> Hamt::visit(const Visitor &visitor) const {
     lazyCreateRoot();
     return visit(root_, visitor);
@@ -356,6 +409,8 @@ namespace fc::storage::hamt {
       for (auto &item2 : boost::get<Node::Ptr>(item)->items) {
         OUTCOME_TRY(visit(item2.second, visitor));
       }
+    } else if (which<Node::Shared>(item)) {
+      return visit(*boost::get<Node::Shared>(item).node, visitor);
     } else {
       for (auto &pair : boost::get<Node::Leaf>(item)) {
         OUTCOME_TRY(visitor(pair.first, pair.second));
@@ -364,6 +419,21 @@ namespace fc::storage::hamt {
     return outcome::success();
   }
 
+  outcome::result<void> Hamt::visit(const Node &node,
+                                    const Visitor &visitor) const {
+    for (const auto &item : node.items) {
+      if (which<Node::Leaf>(item.second)) {
+        for (const auto &pair : boost::get<Node::Leaf>(item.second)) {
+          OUTCOME_TRY(visitor(pair.first, pair.second));
+        }
+      } else {
+        OUTCOME_TRY(child, loadShared(boost::get<CID>(item.second)));
+        OUTCOME_TRY(visit(*child, visitor));
+      }
+    }
+    return outcome::success();
+  }
+
   void Hamt::lazyCreateRoot() const {
     if (auto *root{boost::get<Node::Ptr>(&root_)};
         (root != nullptr) && !*root) {
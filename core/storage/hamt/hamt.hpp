@@ -5,11 +5,11 @@
 
 #pragma once
 
-#include <boost/multiprecision/cpp_int.hpp>
 #include <boost/variant.hpp>
 
 #include "codec/cbor/cbor_codec.hpp"
 #include "codec/cbor/streams_annotation.hpp"
+#include "common/bitsutil.hpp"
 #include "common/outcome.hpp"
 #include "common/span.hpp"
 #include "common/visitor.hpp"
@@ -28,17 +28,66 @@ namespace fc::storage::hamt {
 OUTCOME_HPP_DECLARE_ERROR(fc::storage::hamt, HamtError);
 
 namespace fc::storage::hamt {
-  using boost::multiprecision::cpp_int;
-
   constexpr size_t kLeafMax = 3;
   constexpr size_t kDefaultBitWidth = 5;
+  /** Max supported bit width, node bitmap is fixed 256 bits */
+  constexpr size_t kMaxBitWidth = 8;
+
+  /**
+   * Fixed-width node bitmap.
+   * Child position in dense items vector is popcount of lower bits.
+   */
+  struct Bits {
+    static constexpr size_t kWordBits{64};
+    static constexpr size_t kWords{(size_t{1} << kMaxBitWidth) / kWordBits};
+
+    std::array<uint64_t, kWords> words{};
+
+    inline bool test(size_t index) const {
+      return ((words[index / kWordBits] >> (index % kWordBits)) & 1) != 0;
+    }
+
+    inline void set(size_t index) {
+      words[index / kWordBits] |= uint64_t{1} << (index % kWordBits);
+    }
+
+    inline void reset(size_t index) {
+      words[index / kWordBits] &= ~(uint64_t{1} << (index % kWordBits));
+    }
+
+    /** Number of set bits below index */
+    inline size_t rank(size_t index) const {
+      size_t count{0};
+      for (size_t i{0}; i < index / kWordBits; ++i) {
+        count += common::countSetBits(words[i]);
+      }
+      if (const auto bit{index % kWordBits}; bit != 0) {
+        count += common::countSetBits(words[index / kWordBits]
+                                      & ((uint64_t{1} << bit) - 1));
+      }
+      return count;
+    }
 
-  struct Bits : cpp_int {};
+    inline size_t count() const {
+      size_t count{0};
+      for (const auto word : words) {
+        count += common::countSetBits(word);
+      }
+      return count;
+    }
+  };
 
+  /** Big-endian bytes without leading zeros, same as big.Int in go */
   CBOR_ENCODE(Bits, bits) {
     std::vector<uint8_t> bytes;
-    if (bits != 0) {
-      export_bits(bits, std::back_inserter(bytes), 8);
+    for (auto i{Bits::kWords}; i != 0; --i) {
+      const auto word{bits.words[i - 1]};
+      for (auto j{sizeof(word)}; j != 0; --j) {
+        const auto byte{static_cast<uint8_t>(word >> (8 * (j - 1)))};
+        if (byte != 0 || !bytes.empty()) {
+          bytes.push_back(byte);
+        }
+      }
     }
     return s << bytes;
   }
@@ -46,10 +95,14 @@ namespace fc::storage::hamt {
   CBOR_DECODE(Bits, bits) {
     std::vector<uint8_t> bytes;
     s >> bytes;
-    if (bytes.empty()) {
-      bits = {0};
-    } else {
-      import_bits(bits, bytes.begin(), bytes.end());
+    if (bytes.size() > sizeof(bits.words)) {
+      outcome::raise(HamtError::kInconsistent);
+    }
+    bits = {};
+    size_t shift{0};
+    for (auto it{bytes.rbegin()}; it != bytes.rend(); ++it, shift += 8) {
+      bits.words[shift / Bits::kWordBits] |= uint64_t{*it}
+                                             << (shift % Bits::kWordBits);
     }
     return s;
   }
@@ -57,10 +110,109 @@ namespace fc::storage::hamt {
   /** Hamt node representation */
   struct Node {
     using Ptr = std::shared_ptr<Node>;
+    /**
+     * Unmodified node from node cache, shared with other users.
+     * Copied to Ptr before modification.
+     */
+    struct Shared {
+      CID cid;
+      std::shared_ptr<const Node> node;
+    };
     using Leaf = std::vector<std::pair<Bytes, Bytes>>;
-    using Item = boost::variant<CID, Ptr, Leaf>;
+    using Item = boost::variant<CID, Ptr, Shared, Leaf>;
+
+    /**
+     * Sparse node children, map-like interface over bitmap and dense vector.
+     * Lookup is popcount of bitmap, no allocation per child.
+     */
+    class Items {
+     public:
+      using value_type = std::pair<size_t, Item>;
+      using iterator = std::vector<value_type>::iterator;
+      using const_iterator = std::vector<value_type>::const_iterator;
+
+      inline const Bits &bits() const {
+        return bits_;
+      }
+
+      inline iterator find(size_t index) {
+        if (index >= Bits::kWords * Bits::kWordBits || !bits_.test(index)) {
+          return end();
+        }
+        return begin() + static_cast<ptrdiff_t>(bits_.rank(index));
+      }
+
+      inline const_iterator find(size_t index) const {
+        return const_cast<Items *>(this)->find(index);
+      }
+
+      /** Get or default-insert child at index */
+      inline Item &operator[](size_t index) {
+        assert(index < Bits::kWords * Bits::kWordBits);
+        const auto it{begin() + static_cast<ptrdiff_t>(bits_.rank(index))};
+        if (bits_.test(index)) {
+          return it->second;
+        }
+        bits_.set(index);
+        return items_.emplace(it, index, Item{})->second;
+      }
+
+      /** Append child, index must be greater than existing */
+      inline void push_back(size_t index, Item item) {
+        assert(items_.empty() || items_.back().first < index);
+        bits_.set(index);
+        items_.emplace_back(index, std::move(item));
+      }
+
+      inline size_t erase(size_t index) {
+        const auto it{find(index)};
+        if (it == end()) {
+          return 0;
+        }
+        items_.erase(it);
+        bits_.reset(index);
+        return 1;
+      }
+
+      inline size_t size() const {
+        return items_.size();
+      }
+
+      inline bool empty() const {
+        return items_.empty();
+      }
 
-    std::map<size_t, Item> items;
+      inline void clear() {
+        items_.clear();
+        bits_ = {};
+      }
+
+      inline void reserve(size_t n) {
+        items_.reserve(n);
+      }
+
+      inline iterator begin() {
+        return items_.begin();
+      }
+
+      inline iterator end() {
+        return items_.end();
+      }
+
+      inline const_iterator begin() const {
+        return items_.begin();
+      }
+
+      inline const_iterator end() const {
+        return items_.end();
+      }
+
+     private:
+      Bits bits_;
+      std::vector<value_type> items_;
+    };
+
+    Items items;
     boost::optional<bool> v3;
   };
   CBOR2_DECODE_ENCODE(Node)
@@ -160,8 +312,17 @@ namespace fc::storage::hamt {
                                  BytesIn key);
     static outcome::result<void> cleanShard(Node::Item &item);
     outcome::result<void> flush(Node::Item &item);
+    /**
+     * Loads node from node cache if ipld has it, decodes own copy otherwise
+     */
     outcome::result<void> loadItem(Node::Item &item) const;
+    /** Loads node and copies it if it is shared */
+    outcome::result<void> loadMutable(Node::Item &item) const;
+    outcome::result<std::shared_ptr<const Node>> loadShared(
+        const CID &cid) const;
     outcome::result<void> visit(Node::Item &item, const Visitor &visitor) const;
+    outcome::result<void> visit(const Node &node,
+                                const Visitor &visitor) const;
 
     void lazyCreateRoot() const;
     bool v3() const;
@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+
 #include "storage/in_memory/in_memory_storage.hpp"
 
 namespace fc::storage {
@@ -19,13 +21,17 @@ namespace fc::storage {
     }
 
     outcome::result<void> remove(const Bytes &key) override {
-      entries.erase(key);
+      entries[key] = boost::none;
       return outcome::success();
     }
 
     outcome::result<void> commit() override {
       for (auto &entry : entries) {
-        OUTCOME_TRY(db.put(entry.first, std::move(entry.second)));
+        if (entry.second) {
+          OUTCOME_TRY(db.put(entry.first, std::move(*entry.second)));
+        } else {
+          OUTCOME_TRY(db.remove(entry.first));
+        }
       }
       return outcome::success();
     }
@@ -35,7 +41,8 @@ namespace fc::storage {
     }
 
    private:
-    std::map<Bytes, Bytes> entries;
+    /** Removed keys have no value */
+    std::map<Bytes, boost::optional<Bytes>> entries;
     InMemoryStorage &db;
   };
 }  // namespace fc::storage
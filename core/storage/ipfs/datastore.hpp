@@ -13,6 +13,7 @@
 #include "vm/actor/version.hpp"
 
 namespace fc::storage::ipfs {
+  class NodeCache;
 
   struct IpfsDatastore : vm::actor::WithActorVersion {
     using Value = Bytes;
@@ -40,6 +41,12 @@ namespace fc::storage::ipfs {
      * @return value associated with key or error
      */
     virtual outcome::result<Value> get(const CID &key) const = 0;
+
+    /**
+     * Optional shared cache of decoded hamt/amt nodes, see getCborCached.
+     * Wrappers forward it, except gas charging ones.
+     */
+    std::shared_ptr<NodeCache> node_cache;
   };
 }  // namespace fc::storage::ipfs
 
@@ -0,0 +1,58 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/node_cache.hpp"
+
+#include "common/prometheus/metrics.hpp"
+
+namespace fc::storage::ipfs {
+  auto &metricNodeCacheHit() {
+    static auto &x{prometheus::BuildCounter()
+                       .Name("lotus_ipld_node_cache_hit")
+                       .Help("Counter for decoded ipld node cache hits")
+                       .Register(prometheusRegistry())
+                       .Add({})};
+    return x;
+  }
+
+  auto &metricNodeCacheMiss() {
+    static auto &x{prometheus::BuildCounter()
+                       .Name("lotus_ipld_node_cache_miss")
+                       .Help("Counter for decoded ipld node cache misses")
+                       .Register(prometheusRegistry())
+                       .Add({})};
+    return x;
+  }
+
+  NodeCache::NodeCache(size_t max_size) : cache_{max_size} {}
+
+  size_t NodeCache::size() const {
+    std::lock_guard lock{mutex_};
+    return cache_.size();
+  }
+
+  std::shared_ptr<const void> NodeCache::getAny(
+      const CbCid &key, const std::type_info &type) const {
+    std::unique_lock lock{mutex_};
+    auto entry{cache_.get(key)};
+    lock.unlock();
+    if (entry && *entry->type == type) {
+      metricNodeCacheHit().Increment();
+      return std::move(entry->value);
+    }
+    metricNodeCacheMiss().Increment();
+    return nullptr;
+  }
+
+  void NodeCache::putAny(const CbCid &key,
+                         const std::type_info &type,
+                         std::shared_ptr<const void> value) {
+    if (cache_.capacity() == 0) {
+      return;
+    }
+    std::lock_guard lock{mutex_};
+    cache_.insert(key, {&type, std::move(value)});
+  }
+}  // namespace fc::storage::ipfs
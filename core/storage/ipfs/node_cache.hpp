@@ -0,0 +1,82 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <boost/compute/detail/lru_cache.hpp>
+#include <mutex>
+#include <typeinfo>
+
+#include "cbor_blake/cid.hpp"
+#include "primitives/cid/cid.hpp"
+#include "storage/ipfs/datastore.hpp"
+
+namespace fc::storage::ipfs {
+  /**
+   * Thread-safe LRU cache of decoded immutable nodes (hamt, amt) keyed by
+   * CbCid, shared by all ipld users it is attached to.
+   * Cached values must not be mutated, callers copy them before modification.
+   * Must not be attached to gas charging ipld, because cache hits skip ipld
+   * reads.
+   */
+  class NodeCache {
+   public:
+    /** @param max_size - max number of cached nodes */
+    explicit NodeCache(size_t max_size);
+
+    template <typename T>
+    std::shared_ptr<const T> get(const CbCid &key) const {
+      return std::static_pointer_cast<const T>(getAny(key, typeid(T)));
+    }
+
+    template <typename T>
+    void put(const CbCid &key, std::shared_ptr<const T> value) {
+      putAny(key, typeid(T), std::move(value));
+    }
+
+    size_t size() const;
+
+   private:
+    struct Entry {
+      const std::type_info *type{};
+      std::shared_ptr<const void> value;
+    };
+
+    std::shared_ptr<const void> getAny(const CbCid &key,
+                                       const std::type_info &type) const;
+    void putAny(const CbCid &key,
+                const std::type_info &type,
+                std::shared_ptr<const void> value);
+
+    mutable std::mutex mutex_;
+    mutable boost::compute::detail::lru_cache<CbCid, Entry> cache_;
+  };
+
+  /**
+   * Get decoded node from ipld node cache, or load it from ipld and cache.
+   * Falls back to plain getCbor if ipld has no node cache or cid is not
+   * "DAG_CBOR blake2b_256".
+   */
+  template <typename T>
+  outcome::result<std::shared_ptr<const T>> getCborCached(const IpldPtr &ipld,
+                                                          const CID &key) {
+    const auto &cache{ipld->node_cache};
+    boost::optional<CbCid> cb_key;
+    if (cache) {
+      cb_key = asBlake(key);
+      if (cb_key) {
+        if (auto cached{cache->get<T>(*cb_key)}) {
+          return cached;
+        }
+      }
+    }
+    OUTCOME_TRY(value, getCbor<T>(ipld, key));
+    auto node{std::make_shared<const T>(std::move(value))};
+    if (cb_key) {
+      cache->put(*cb_key, node);
+    }
+    return node;
+  }
+}  // namespace fc::storage::ipfs
@@ -20,6 +20,15 @@ namespace fc::storage::ipld {
   using cids_index::maxSize64;
   using cids_index::MergeRange;
 
+  namespace {
+    boost::optional<BytesIn> readCarItem(const common::MappedFile &map,
+                                         const Row &row) {
+      return cids_index::readCarItem(
+          common::span::cbytes(std::string_view{map.data(), map.size()}),
+          row);
+    }
+  }  // namespace
+
   boost::optional<Row> CidsIpld::findWritten(const CbCid &key) const {
     assert(writable != nullptr);
     auto it{written.lower_bound(Row{key, {}, {}})};
@@ -122,40 +131,47 @@ namespace fc::storage::ipld {
     return outcome::success();
   }
 
-  bool CidsIpld::get(const CbCid &key, Bytes *value) const {
-    if (value != nullptr) {
-      value->resize(0);
-    }
+  boost::optional<Row> CidsIpld::findRow(const CbCid &key) const {
     std::shared_lock index_lock{index_mutex};
-    auto row{index->find(key).value()};
+    auto _index{index};
     index_lock.unlock();
+    auto row{_index->find(key).value()};
     if (!row && writable != nullptr) {
       std::shared_lock written_lock{written_mutex};
       row = findWritten(key);
     }
-    if (!row) {
-      if (ipld) {
-        return AnyAsCbIpld::get(ipld, key, value);
-      }
-      return false;
-    }
-    if (value != nullptr) {
-      if (carGet(*row, *value)) {
+    return row;
+  }
+
+  bool CidsIpld::get(const CbCid &key, Bytes *value) const {
+    if (value == nullptr) {
+      if (findRow(key)) {
         return true;
       }
-      std::unique_lock car_lock{car_mutex};
-      auto [good, size]{readCarItem(car_file, *row, nullptr)};
-      if (!good) {
-        spdlog::error("CidsIpld.get inconsistent");
-        outcome::raise(ERROR_TEXT("CidsIpld.get: inconsistent"));
-      }
-      value->resize(size);
-      if (!common::read(car_file, *value)) {
-        spdlog::error("CidsIpld.get read error");
-        outcome::raise(ERROR_TEXT("CidsIpld.get: read error"));
+    } else {
+      value->resize(0);
+      if (auto _view{view(key)}) {
+        copy(*value, _view->value);
+        return true;
       }
     }
-    return true;
+    if (ipld) {
+      return AnyAsCbIpld::get(ipld, key, value);
+    }
+    return false;
+  }
+
+  boost::optional<CidsIpld::View> CidsIpld::view(const CbCid &key) const {
+    auto row{findRow(key)};
+    if (!row) {
+      return boost::none;
+    }
+    Bytes queued;
+    if (carGet(*row, queued)) {
+      auto owner{std::make_shared<const Bytes>(std::move(queued))};
+      return View{owner, *owner};
+    }
+    return carRead(*row);
   }
 
   void CidsIpld::put(const CbCid &key, BytesCow &&value) {
@@ -218,6 +234,57 @@ namespace fc::storage::ipld {
     outcome::raise(ERROR_TEXT("CidsIpld.carGet decode error"));
   }
 
+  CidsIpld::View CidsIpld::carRead(const Row &row) const {
+    auto map{std::atomic_load(&car_map)};
+    if (map) {
+      if (auto value{readCarItem(*map, row)}) {
+        return {map, *value};
+      }
+    }
+    // item was flushed after car was mapped
+    map = carRemap(row);
+    if (map) {
+      if (auto value{readCarItem(*map, row)}) {
+        return {map, *value};
+      }
+    }
+    auto buffer{std::make_shared<Bytes>()};
+    if (auto value{cids_index::readCarItem(car_file.get(), row, *buffer)}) {
+      return {buffer, *value};
+    }
+    spdlog::error("CidsIpld.get inconsistent");
+    outcome::raise(ERROR_TEXT("CidsIpld.get: inconsistent"));
+  }
+
+  std::shared_ptr<const common::MappedFile> CidsIpld::carRemap(
+      const Row &row) const {
+    std::unique_lock lock{car_mutex};
+    auto map{std::atomic_load(&car_map)};
+    // other reader may have remapped, but maybe before row was flushed
+    if (map && readCarItem(*map, row)) {
+      return map;
+    }
+    boost::system::error_code ec;
+    const auto car_size{boost::filesystem::file_size(car_path, ec)};
+    if (ec) {
+      spdlog::error("CidsIpld.carRemap file size error");
+      outcome::raise(ERROR_TEXT("CidsIpld.carRemap: file size error"));
+    }
+    const auto size{std::min<uint64_t>(car_size, max_memory.value_or(-1))};
+    if (size < (map ? map->size() : 0) + kRemapStep) {
+      return map;
+    }
+    auto mapped{common::mapFile(car_path, size)};
+    if (!mapped) {
+      spdlog::error("CidsIpld.carRemap map error");
+      outcome::raise(ERROR_TEXT("CidsIpld.carRemap: map error"));
+    }
+    map = std::make_shared<const common::MappedFile>(
+        std::move(mapped.value().first));
+    std::atomic_store(&car_map, map);
+    return map;
+  }
+
   void CidsIpld::carFlush(std::adopt_lock_t) {
     if (car_queue.empty()) {
       return;
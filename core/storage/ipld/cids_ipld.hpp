@@ -10,6 +10,7 @@
 #include <shared_mutex>
 
 #include "cbor_blake/ipld.hpp"
+#include "common/file.hpp"
 #include "common/outcome2.hpp"
 #include "primitives/cid/cid.hpp"
 #include "storage/car/cids_index/cids_index.hpp"
@@ -31,8 +32,28 @@ namespace fc::storage::ipld {
     bool get(const CbCid &key, Bytes *value) const override;
     void put(const CbCid &key, BytesCow &&value) override;
 
+    /** Value bytes, kept valid by owner */
+    struct View {
+      std::shared_ptr<const void> owner;
+      BytesIn value;
+    };
+    /**
+     * Get value without copying it from mapped car
+     * @return value view, or nothing if value is not in this car
+     */
+    boost::optional<View> view(const CbCid &key) const;
+
+    boost::optional<Row> findRow(const CbCid &key) const;
     void carPut(const Row &row, Bytes &&item);
     bool carGet(const Row &row, Bytes &value) const;
+    /** Reads from mapped car, or with pread if item is not mapped */
+    View carRead(const Row &row) const;
+    /**
+     * Remaps car if it has grown by kRemapStep since it was mapped,
+     * mapping is limited by max memory
+     * @return current mapping
+     */
+    std::shared_ptr<const common::MappedFile> carRemap(const Row &row) const;
     void carFlush(std::adopt_lock_t);
     void carFlush();
 
@@ -41,8 +62,15 @@ namespace fc::storage::ipld {
     inline boost::optional<Row> findWritten(const CbCid &key) const;
     Outcome<void> doFlush();
 
+    /** Car growth before remapping, items past mapping are read with pread */
+    static constexpr size_t kRemapStep{64 << 20};
+
+    /** Guards car remapping, reads don't lock */
     mutable std::mutex car_mutex;
-    mutable std::ifstream car_file;
+    /** Mapped car prefix, remapped when car grows by kRemapStep */
+    mutable std::shared_ptr<const common::MappedFile> car_map;
+    /** Car opened for pread of items past mapping */
+    std::shared_ptr<FILE> car_file;
     mutable std::shared_mutex index_mutex;
     std::shared_ptr<Index> index;
     IpldPtr ipld;
@@ -5,6 +5,12 @@
 
 #include "keystore.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <boost/asio/post.hpp>
+#include <condition_variable>
+#include <mutex>
+
 #include "common/visitor.hpp"
 #include "crypto/blake2/blake2b160.hpp"
 
@@ -96,6 +102,45 @@ namespace fc::storage::keystore {
         });
   }
 
+  std::vector<bool> KeyStore::verifyBatch(
+      gsl::span<const SignatureCheck> checks,
+      boost::asio::thread_pool &pool,
+      size_t threads) const {
+    // std::vector<bool> can't be written from several threads
+    std::vector<uint8_t> valid(checks.size());
+    // Aggregated pairing check of BLS signatures doesn't prove each of them,
+    // errors of several signatures can cancel each other. Per-item check
+    // with random scalar weights needs point multiplication, which bls
+    // provider doesn't expose, so each signature is verified separately.
+    const auto size{static_cast<size_t>(checks.size())};
+    std::atomic_size_t next{0};
+    auto verifyNext{[&] {
+      for (size_t j{next++}; j < size; j = next++) {
+        const auto &check{checks[j]};
+        auto res{verify(check.address, check.data, check.signature)};
+        valid[j] = res && res.value();
+      }
+    }};
+    std::mutex mutex;
+    std::condition_variable cv;
+    const auto helpers{std::max<size_t>(std::min(threads, size), 1) - 1};
+    size_t running{helpers};
+    for (size_t i{0}; i < helpers; ++i) {
+      boost::asio::post(pool, [&] {
+        verifyNext();
+        std::unique_lock lock{mutex};
+        if (--running == 0) {
+          cv.notify_one();
+        }
+      });
+    }
+    verifyNext();
+    // helpers reference locals, wait even if they had nothing left to do
+    std::unique_lock lock{mutex};
+    cv.wait(lock, [&] { return running == 0; });
+    return {valid.begin(), valid.end()};
+  }
+
   outcome::result<Address> KeyStore::put(SignatureType type, TPrivateKey key) {
     Address address;
     switch (type) {
@@ -7,6 +7,7 @@
 
 #include <gsl/span>
 
+#include <boost/asio/thread_pool.hpp>
 #include <boost/variant.hpp>
 #include "common/outcome.hpp"
 #include "crypto/bls/bls_provider.hpp"
@@ -32,6 +33,14 @@ namespace fc::storage::keystore {
   using Secp256k1Signature = crypto::secp256k1::Signature;
   using SignatureType = crypto::signature::Type;
 
+  /** Signature to verify in batch */
+  struct SignatureCheck {
+    /** Pubkey address of signer */
+    Address address;
+    Bytes data;
+    Signature signature;
+  };
+
   /**
    * An interface to a facility to store and use cryptographic keys
    */
@@ -90,6 +99,19 @@ namespace fc::storage::keystore {
                                          gsl::span<const uint8_t> data,
                                          const Signature &signature) const;
 
+    /**
+     * @brief verify several signatures on calling thread and thread pool.
+     * Each signature is verified separately, because aggregated pairing
+     * check of BLS signatures passes if errors of signatures cancel out.
+     * @param checks - signatures to verify
+     * @param pool - shared pool, bounds threads of concurrent batches
+     * @param threads - max number of threads, including calling thread
+     * @return verification result for each signature
+     */
+    std::vector<bool> verifyBatch(gsl::span<const SignatureCheck> checks,
+                                  boost::asio::thread_pool &pool,
+                                  size_t threads) const;
+
     outcome::result<Address> put(SignatureType type, TPrivateKey key);
 
    protected:
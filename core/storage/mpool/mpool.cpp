@@ -11,6 +11,7 @@
 #include <thread>
 
 #include "cbor_blake/ipld_version.hpp"
+#include "codec/cbor/cbor_codec.hpp"
 #include "common/append.hpp"
 #include "common/logger.hpp"
 #include "common/outcome_fmt.hpp"
@@ -25,7 +26,6 @@
 #include "vm/toolchain/toolchain.hpp"
 
 namespace fc::storage::mpool {
-  using primitives::GasAmount;
   using primitives::block::MsgMeta;
   using primitives::tipset::HeadChangeType;
   using vm::actor::builtin::types::miner::kChainFinality;
@@ -115,7 +115,8 @@ namespace fc::storage::mpool {
   struct MsgChain {
     using Ptr = std::shared_ptr<MsgChain>;
 
-    std::vector<SignedMessage> msgs;
+    /** Points to messages owned by pending map chain was created from */
+    std::vector<const SignedMessage *> msgs;
     TokenAmount gas_reward;
     GasAmount gas_limit{};
     double gas_perf{};
@@ -185,7 +186,7 @@ namespace fc::storage::mpool {
 
   void trim(MsgChain &mc, GasAmount gas_limit, const TokenAmount &base_fee) {
     while (!mc.msgs.empty() && (mc.gas_limit > gas_limit || mc.gas_perf < 0)) {
-      auto &msg{mc.msgs.back().message};
+      auto &msg{mc.msgs.back()->message};
       mc.gas_reward -= getGasReward(msg, base_fee);
       mc.gas_limit -= msg.gas_limit;
       if (mc.gas_limit > 0) {
@@ -218,15 +219,17 @@ namespace fc::storage::mpool {
     mc.eff_perf = std::min<double>(mc.gas_perf, 0);
   }
 
-  // NOLINTNEXTLINE(readability-function-cognitive-complexity)
-  std::vector<MsgChain::Ptr> createMessageChains(
+  /**
+   * Messages which can be included in block, in nonce order.
+   * Depends only on actor state, not on base fee.
+   */
+  std::vector<const SignedMessage *> selectableMessages(
       const std::map<Nonce, SignedMessage> &pending,
-      const TokenAmount &base_fee,
       Nonce actor_nonce,
       TokenAmount actor_balance,
       const vm::runtime::Pricelist &pricelist) {
     auto gas_limit{kBlockGasLimit};
-    std::vector<SignedMessage> msgs;
+    std::vector<const SignedMessage *> msgs;
     for (const auto &[nonce, msg] : pending) {
       if (nonce < actor_nonce) {
         continue;
@@ -247,7 +250,18 @@ namespace fc::storage::mpool {
       }
       actor_balance -= msg.message.requiredFunds();
       actor_balance -= msg.message.value;
-      msgs.push_back(msg);
+      msgs.push_back(&msg);
+    }
+    return msgs;
+  }
+
+  // NOLINTNEXTLINE(readability-function-cognitive-complexity)
+  std::vector<MsgChain::Ptr> createMessageChains(
+      const std::vector<const SignedMessage *> &msgs,
+      const TokenAmount &base_fee) {
+    auto gas_limit{kBlockGasLimit};
+    for (const auto *msg : msgs) {
+      gas_limit -= msg->message.gas_limit;
     }
     std::vector<MsgChain::Ptr> chains;
     if (msgs.empty()) {
@@ -260,15 +274,15 @@ namespace fc::storage::mpool {
       return chain;
     }};
     auto cur_chain{new_chain()};
-    for (auto &msg : msgs) {
-      auto reward{getGasReward(msg.message, base_fee)};
+    for (const auto *msg : msgs) {
+      auto reward{getGasReward(msg->message, base_fee)};
       TokenAmount gas_reward{cur_chain->gas_reward + reward};
-      const auto chain_gas_limit{cur_chain->gas_limit + msg.message.gas_limit};
+      const auto chain_gas_limit{cur_chain->gas_limit + msg->message.gas_limit};
       auto gas_perf{getGasPerf(gas_reward, gas_limit)};
       if (!cur_chain->msgs.empty() && gas_perf < cur_chain->gas_perf) {
         cur_chain = new_chain();
         cur_chain->gas_reward = reward;
-        cur_chain->gas_limit = msg.message.gas_limit;
+        cur_chain->gas_limit = msg->message.gas_limit;
         cur_chain->gas_perf =
             getGasPerf(cur_chain->gas_reward, cur_chain->gas_limit);
       } else {
@@ -276,7 +290,7 @@ namespace fc::storage::mpool {
         cur_chain->gas_limit = chain_gas_limit;
         cur_chain->gas_perf = gas_perf;
       }
-      cur_chain->msgs.push_back(std::move(msg));
+      cur_chain->msgs.push_back(msg);
     }
     while (true) {
       auto merged{0};
@@ -313,6 +327,24 @@ namespace fc::storage::mpool {
     return chains;
   }
 
+  std::vector<MsgChain::Ptr> createMessageChains(
+      const std::map<Nonce, SignedMessage> &pending,
+      const TokenAmount &base_fee,
+      Nonce actor_nonce,
+      TokenAmount actor_balance,
+      const vm::runtime::Pricelist &pricelist) {
+    return createMessageChains(
+        selectableMessages(
+            pending, actor_nonce, std::move(actor_balance), pricelist),
+        base_fee);
+  }
+
+  void appendMsgs(std::vector<SignedMessage> &messages, const MsgChain &chain) {
+    for (const auto *msg : chain.msgs) {
+      messages.push_back(*msg);
+    }
+  }
+
   auto greedy(std::vector<MsgChain::Ptr> &chains,
               GasAmount &gas_limit,
               const TokenAmount &base_fee) {
@@ -328,7 +360,7 @@ namespace fc::storage::mpool {
       }
       if (chain->gas_limit <= gas_limit) {
         gas_limit -= chain->gas_limit;
-        append(messages, chain->msgs);
+        appendMsgs(messages, *chain);
       } else {
         if (gas_limit < kMinGas) {
           break;
@@ -404,7 +436,7 @@ namespace fc::storage::mpool {
       } else {
         while (true) {
           dep->merged = true;
-          append(messages, dep->msgs);
+          appendMsgs(messages, *dep);
           gas_limit -= dep->gas_limit;
           if (dep == chain) {
             break;
@@ -451,7 +483,7 @@ namespace fc::storage::mpool {
       if (chain->valid) {
         do {
           dep->merged = true;
-          append(messages, dep->msgs);
+          appendMsgs(messages, *dep);
           gas_limit -= dep->gas_limit;
           dep = mustLock(dep->next);
         } while (dep != chain);
@@ -460,6 +492,115 @@ namespace fc::storage::mpool {
     return messages;
   }
 
+  auto selectChains(std::vector<MsgChain::Ptr> &chains,
+                    const TokenAmount &base_fee,
+                    double ticket_quality,
+                    std::default_random_engine &generator) {
+    std::vector<SignedMessage> messages;
+    GasAmount gas_limit{kBlockGasLimit};
+    // TODO(turuslan): priority addrs
+    if (ticket_quality > 0.84) {
+      append(messages, greedy(chains, gas_limit, base_fee));
+    } else {
+      append(messages, optimal(chains, gas_limit, base_fee, ticket_quality));
+      append(messages, optimalRandom(chains, gas_limit, base_fee, generator));
+    }
+    messages.resize(std::min(kMaxBlockMessages, messages.size()));
+    return messages;
+  }
+
+  /**
+   * Chains of actor for selection index head.
+   * Chains point to messages owned by this struct, and are copied by each
+   * select, because selection modifies them.
+   */
+  struct ActorChains {
+    std::shared_ptr<const std::map<Nonce, SignedMessage>> msgs;
+    /** Messages allowed by actor nonce and balance at index head */
+    std::vector<const SignedMessage *> selectable;
+    std::vector<MsgChain> chains;
+  };
+
+  struct MessagePool::SelectIndex {
+    TipsetKey head;
+    TokenAmount base_fee;
+    ChainEpoch epoch{};
+    ChainEpoch height{};
+    CID state_root;
+    std::map<Address, std::shared_ptr<const ActorChains>> actors;
+  };
+
+  /** Head state with sender pending messages applied */
+  struct MessagePool::EstimateBase {
+    TipsetCPtr head;
+    /** Sender pending messages revision */
+    uint64_t revision{};
+    /**
+     * Buffer with writes of pending messages, never flushed to node ipld.
+     * Read only after creation, estimates write to own overlays.
+     */
+    std::shared_ptr<vm::IpldBuffered> ipld;
+    CID state;
+    Nonce nonce{};
+    CID code;
+    /** Gas limit by encoded message */
+    lru_cache<Bytes, GasAmount> gas{kEstimateCacheSize};
+    std::mutex gas_mutex;
+  };
+
+  void setChains(ActorChains &actor_chains, const TokenAmount &base_fee) {
+    actor_chains.chains.clear();
+    for (auto &chain :
+         createMessageChains(actor_chains.selectable, base_fee)) {
+      chain->prev.reset();
+      chain->next.reset();
+      actor_chains.chains.push_back(std::move(*chain));
+    }
+  }
+
+  outcome::result<std::shared_ptr<const ActorChains>> actorChains(
+      std::shared_ptr<const std::map<Nonce, SignedMessage>> msgs,
+      const Address &from,
+      StateTreeImpl &state_tree,
+      const TokenAmount &base_fee,
+      const vm::runtime::Pricelist &pricelist) {
+    OUTCOME_TRY(actor, state_tree.get(from));
+    auto actor_chains{std::make_shared<ActorChains>()};
+    actor_chains->selectable =
+        selectableMessages(*msgs, actor.nonce, actor.balance, pricelist);
+    actor_chains->msgs = std::move(msgs);
+    setChains(*actor_chains, base_fee);
+    return actor_chains;
+  }
+
+  /**
+   * Chains of actor not touched by head change, for new base fee.
+   * Its nonce is same, and its balance can't decrease without its messages,
+   * so selectable messages are still valid.
+   */
+  std::shared_ptr<const ActorChains> rechain(const ActorChains &actor_chains,
+                                             const TokenAmount &base_fee) {
+    auto rechained{std::make_shared<ActorChains>()};
+    rechained->msgs = actor_chains.msgs;
+    rechained->selectable = actor_chains.selectable;
+    setChains(*rechained, base_fee);
+    return rechained;
+  }
+
+  void appendChains(std::vector<MsgChain::Ptr> &chains,
+                    const ActorChains &actor_chains) {
+    MsgChain::Ptr prev;
+    for (const auto &chain : actor_chains.chains) {
+      auto copy{std::make_shared<MsgChain>(chain)};
+      if (prev) {
+        copy->prev = prev;
+        prev->next = copy;
+      }
+      prev = copy;
+      chains.push_back(std::move(copy));
+    }
+  }
+
   std::shared_ptr<MessagePool> MessagePool::create(
       const EnvironmentContext &env_context,
       TsBranchPtr ts_main,
@@ -480,6 +621,9 @@ namespace fc::storage::mpool {
                             res.error().message());
             }
           }
+          if (auto res{mpool->refreshSelectIndex()}; !res) {
+            spdlog::warn("MessagePool.refreshSelectIndex: {:#}", res.error());
+          }
         });
     mpool->bls_cache = {bls_cache_size};
     mpool->pubsub_gate_ = std::move(pubsub_gate);
@@ -525,6 +669,20 @@ namespace fc::storage::mpool {
   // NOLINTNEXTLINE(readability-function-cognitive-complexity)
   outcome::result<std::vector<SignedMessage>> MessagePool::select(
       const TipsetCPtr &tipset_ptr, double ticket_quality) const {
+    std::vector<MsgChain::Ptr> chains;
+    std::unique_lock index_lock{select_index_mutex_};
+    if (select_index_ && select_index_->head == tipset_ptr->key) {
+      OUTCOME_TRY(updateSelectIndex(*select_index_, false));
+      const auto base_fee{select_index_->base_fee};
+      const auto actors{select_index_->actors};
+      index_lock.unlock();
+      for (const auto &[from, actor_chains] : actors) {
+        appendChains(chains, *actor_chains);
+      }
+      std::lock_guard generator_lock{generator_mutex_};
+      return selectChains(chains, base_fee, ticket_quality, generator);
+    }
+    index_lock.unlock();
     OUTCOME_TRY(base_fee, tipset_ptr->nextBaseFee(env_context.ipld));
     vm::runtime::Pricelist pricelist{tipset_ptr->epoch()};
     OUTCOME_TRY(cached, env_context.interpreter_cache->get(tipset_ptr->key));
@@ -561,43 +719,142 @@ namespace fc::storage::mpool {
             return outcome::success();
           }));
     }
-    std::vector<SignedMessage> messages;
-    std::vector<MsgChain::Ptr> chains;
-    GasAmount gas_limit{kBlockGasLimit};
-    auto createChains{
-        [&](auto &chains, auto &from, auto &by_nonce) -> outcome::result<void> {
-          OUTCOME_TRY(actor, state_tree.get(from));
-          append(
-              chains,
-              createMessageChains(
-                  by_nonce, base_fee, actor.nonce, actor.balance, pricelist));
-          return outcome::success();
-        }};
-    // TODO(turuslan): priority addrs
-    std::vector<Address> priority_addrs;
-    for (auto &from : priority_addrs) {
-      auto it{pending.find(from)};
-      if (it != pending.end()) {
-        OUTCOME_TRY(createChains(chains, from, it->second));
-        pending.erase(it);
+    for (auto &[from, by_nonce] : pending) {
+      OUTCOME_TRY(actor, state_tree.get(from));
+      append(chains,
+             createMessageChains(
+                 by_nonce, base_fee, actor.nonce, actor.balance, pricelist));
+    }
+    std::lock_guard generator_lock{generator_mutex_};
+    return selectChains(chains, base_fee, ticket_quality, generator);
+  }
+
+  outcome::result<void> MessagePool::updateSelectIndex(SelectIndex &index,
+                                                       bool all) const {
+    using ByNonce = std::map<Nonce, SignedMessage>;
+    std::set<Address> dirty;
+    {
+      std::lock_guard dirty_lock{select_dirty_mutex_};
+      std::swap(dirty, select_dirty_);
+    }
+    if (!all && dirty.empty()) {
+      return outcome::success();
+    }
+    auto update{[&]() -> outcome::result<void> {
+      // copy messages only of changed actors, null if actor has none
+      std::vector<std::pair<Address, std::shared_ptr<const ByNonce>>> changed;
+      std::shared_lock pending_lock{pending_mutex_};
+      if (all) {
+        for (const auto &[from, by_nonce] : pending_) {
+          const auto it{index.actors.find(from)};
+          if (it != index.actors.end() && dirty.count(from) == 0) {
+            changed.emplace_back(from, it->second->msgs);
+          } else {
+            changed.emplace_back(from, std::make_shared<ByNonce>(by_nonce));
+          }
+        }
+      } else {
+        for (const auto &from : dirty) {
+          const auto it{pending_.find(from)};
+          changed.emplace_back(
+              from,
+              it == pending_.end() ? nullptr
+                                   : std::make_shared<ByNonce>(it->second));
+        }
+      }
+      pending_lock.unlock();
+      StateTreeImpl state_tree{withVersion(ipld, index.height),
+                               index.state_root};
+      const vm::runtime::Pricelist pricelist{index.epoch};
+      if (all) {
+        index.actors.clear();
       }
+      for (auto &[from, msgs] : changed) {
+        if (!msgs) {
+          index.actors.erase(from);
+          continue;
+        }
+        OUTCOME_TRY(
+            actor_chains,
+            actorChains(
+                std::move(msgs), from, state_tree, index.base_fee, pricelist));
+        index.actors[from] = std::move(actor_chains);
+      }
+      return outcome::success();
+    }};
+    auto res{update()};
+    if (!res) {
+      // retry changed actors later
+      std::lock_guard dirty_lock{select_dirty_mutex_};
+      select_dirty_.insert(dirty.begin(), dirty.end());
     }
-    append(messages, greedy(chains, gas_limit, base_fee));
-    chains.clear();
-    if (gas_limit < kMinGas) {
-      return messages;
+    return res;
+  }
+
+  outcome::result<void> MessagePool::refreshSelectIndex() {
+    std::shared_lock head_lock(head_mutex_);
+    const auto head{head_};
+    head_lock.unlock();
+    if (!head) {
+      return outcome::success();
     }
-    for (auto &[from, by_nonce] : pending) {
-      OUTCOME_TRY(createChains(chains, from, by_nonce));
+    OUTCOME_TRY(base_fee, head->nextBaseFee(ipld));
+    OUTCOME_TRY(cached, env_context.interpreter_cache->get(head->key));
+    std::set<Address> touched;
+    auto rebuild{false};
+    {
+      std::lock_guard dirty_lock{select_dirty_mutex_};
+      std::swap(touched, select_touched_);
+      std::swap(rebuild, select_rebuild_);
     }
-    if (ticket_quality > 0.84) {
-      append(messages, greedy(chains, gas_limit, base_fee));
+    std::lock_guard index_lock{select_index_mutex_};
+    // previous index messages are reused for unchanged actors
+    auto index{select_index_ ? std::make_shared<SelectIndex>(*select_index_)
+                             : std::make_shared<SelectIndex>()};
+    rebuild = rebuild || !select_index_
+              || vm::runtime::Pricelist{index->epoch}.calico
+                     != vm::runtime::Pricelist{head->epoch()}.calico;
+    if (!rebuild && index->base_fee != base_fee) {
+      for (auto &[from, actor_chains] : index->actors) {
+        if (touched.count(from) == 0) {
+          actor_chains = rechain(*actor_chains, base_fee);
+        }
+      }
+    }
+    index->head = head->key;
+    index->base_fee = base_fee;
+    index->epoch = head->epoch();
+    index->height = head->height();
+    index->state_root = cached.state_root;
+    if (!rebuild) {
+      // state of touched actors is loaded for new head
+      std::lock_guard dirty_lock{select_dirty_mutex_};
+      select_dirty_.insert(touched.begin(), touched.end());
+    }
+    auto updated{updateSelectIndex(*index, rebuild)};
+    if (!updated) {
+      // touched actors are unknown now
+      std::lock_guard dirty_lock{select_dirty_mutex_};
+      select_rebuild_ = true;
+      return updated.error();
+    }
+    select_index_ = std::move(index);
+    return outcome::success();
+  }
+
+  void MessagePool::pendingChanged(const Address &from) {
+    if (pending_.count(from) != 0) {
+      pending_revisions_[from] = ++pending_revision_;
     } else {
-      append(messages, optimal(chains, gas_limit, base_fee, ticket_quality));
-      append(messages, optimalRandom(chains, gas_limit, base_fee, generator));
+      pending_revisions_.erase(from);
     }
-    messages.resize(std::min(kMaxBlockMessages, messages.size()));
-    return messages;
+    std::lock_guard dirty_lock{select_dirty_mutex_};
+    select_dirty_.insert(from);
+  }
+
+  uint64_t MessagePool::pendingRevision(const Address &from) const {
+    const auto it{pending_revisions_.find(from)};
+    return it == pending_revisions_.end() ? 0 : it->second;
   }
 
   outcome::result<Nonce> MessagePool::nonce(const Address &from) const {
@@ -627,62 +884,19 @@ namespace fc::storage::mpool {
       msg.gas_limit = kBlockGasLimit;
       msg.gas_fee_cap = kMinimumBaseFee + 1;
       msg.gas_premium = 1;
-      std::shared_lock head_lock(head_mutex_);
-      const auto height = head_->height();
-      OUTCOME_TRY(interpeted, env_context.interpreter_cache->get(head_->key));
-      const auto buf_ipld{std::make_shared<vm::IpldBuffered>(ipld)};
-      OUTCOME_TRY(env,
-                  vm::makeVm(buf_ipld,
-                             env_context,
-                             ts_main,
-                             head_->getParentBaseFee(),
-                             interpeted.state_root,
-                             head_->epoch() + 1));
-      head_lock.unlock();
-      std::shared_lock pending_lock{pending_mutex_};
-      auto pending_it{pending_.find(msg.from)};
-      if (pending_it != pending_.end()) {
-        for (const auto &_msg : pending_it->second) {
-          OUTCOME_TRY(env->applyMessage(_msg.second.message, msg.chainSize()));
-        }
+      OUTCOME_TRY(base, estimateBase(msg.from));
+      msg.nonce = base->nonce;
+      // same message shape at same speculative state uses same gas
+      OUTCOME_TRY(key, codec::cbor::encode(msg));
+      std::unique_lock gas_lock{base->gas_mutex};
+      auto gas_limit{base->gas.get(key)};
+      gas_lock.unlock();
+      if (!gas_limit) {
+        OUTCOME_TRYA(gas_limit, estimateGasLimit(*base, msg));
+        gas_lock.lock();
+        base->gas.insert(key, *gas_limit);
       }
-      pending_lock.unlock();
-      OUTCOME_TRY(state, env->flush());
-      OUTCOME_TRY(actor,
-                  vm::state::StateTreeImpl{
-                      withVersion(buf_ipld, head_->height()), state}
-                      .get(msg.from));
-      OUTCOME_TRYA(env,
-                   vm::makeVm(buf_ipld,
-                              env_context,
-                              ts_main,
-                              head_->getParentBaseFee(),
-                              state,
-                              head_->epoch() + 1));
-      msg.nonce = actor.nonce;
-      OUTCOME_TRY(
-          apply,
-          env->applyMessage(
-              msg,
-              msg.from.isBls()
-                  ? msg.chainSize()
-                  : SignedMessage{msg, crypto::signature::Secp256k1Signature{}}
-                        .chainSize()));
-      if (apply.receipt.exit_code != vm::VMExitCode::kOk) {
-        return apply.receipt.exit_code;
-      }
-      if (msg.method == paych::Collect::Number) {
-        auto matcher{vm::toolchain::Toolchain::createAddressMatcher(
-            vm::version::getNetworkVersion(height))};
-        if (matcher->isPaymentChannelActor(actor.code)) {
-          // https://github.com/filecoin-project/lotus/blob/191a05da4872bf9849f178e6db5c0d6e87d05baa/node/impl/full/gas.go#L281
-          constexpr GasAmount kGas{76000};
-          apply.receipt.gas_used += kGas;
-        }
-      }
-      message.gas_limit = gsl::narrow_cast<GasAmount>(
-          gsl::narrow_cast<double>(apply.receipt.gas_used)
-          * kGasLimitOverestimation);
+      message.gas_limit = *gas_limit;
     }
     if (message.gas_premium == 0) {
       OUTCOME_TRYA(message.gas_premium, estimateGasPremium(10));
@@ -694,6 +908,97 @@ namespace fc::storage::mpool {
     return outcome::success();
   }
 
+  outcome::result<std::shared_ptr<MessagePool::EstimateBase>>
+  MessagePool::estimateBase(const Address &from) const {
+    std::shared_lock head_lock(head_mutex_);
+    const auto head{head_};
+    head_lock.unlock();
+    std::shared_lock pending_lock{pending_mutex_};
+    auto revision{pendingRevision(from)};
+    pending_lock.unlock();
+    // caller with head older than current one doesn't touch cache
+    std::unique_lock estimate_lock{estimate_mutex_};
+    const auto cached{estimate_head_ == head->key};
+    if (cached) {
+      if (auto base{estimate_bases_.get({from, revision})}) {
+        return *base;
+      }
+    }
+    estimate_lock.unlock();
+
+    OUTCOME_TRY(interpeted, env_context.interpreter_cache->get(head->key));
+    auto base{std::make_shared<EstimateBase>()};
+    base->head = head;
+    base->ipld = std::make_shared<vm::IpldBuffered>(ipld);
+    OUTCOME_TRY(env,
+                vm::makeVm(base->ipld,
+                           env_context,
+                           ts_main,
+                           head->getParentBaseFee(),
+                           interpeted.state_root,
+                           head->epoch() + 1));
+    pending_lock.lock();
+    base->revision = pendingRevision(from);
+    auto pending_it{pending_.find(from)};
+    if (pending_it != pending_.end()) {
+      for (const auto &[nonce, pending] : pending_it->second) {
+        OUTCOME_TRY(env->applyMessage(pending.message, pending.chainSize()));
+      }
+    }
+    pending_lock.unlock();
+    // copies vm writes into base buffer, underlying ipld is not written
+    OUTCOME_TRYA(base->state, env->flush());
+    OUTCOME_TRY(actor,
+                vm::state::StateTreeImpl{
+                    withVersion(base->ipld, head->height()), base->state}
+                    .get(from));
+    base->nonce = actor.nonce;
+    base->code = actor.code;
+    if (cached) {
+      estimate_lock.lock();
+      if (estimate_head_ == head->key) {
+        estimate_bases_.insert({from, base->revision}, base);
+      }
+    }
+    return base;
+  }
+
+  outcome::result<GasAmount> MessagePool::estimateGasLimit(
+      const EstimateBase &base, const UnsignedMessage &msg) const {
+    // estimates don't see each other writes
+    const auto buf_ipld{std::make_shared<vm::IpldBuffered>(base.ipld)};
+    OUTCOME_TRY(env,
+                vm::makeVm(buf_ipld,
+                           env_context,
+                           ts_main,
+                           base.head->getParentBaseFee(),
+                           base.state,
+                           base.head->epoch() + 1));
+    OUTCOME_TRY(
+        apply,
+        env->applyMessage(
+            msg,
+            msg.from.isBls()
+                ? msg.chainSize()
+                : SignedMessage{msg, crypto::signature::Secp256k1Signature{}}
+                      .chainSize()));
+    if (apply.receipt.exit_code != vm::VMExitCode::kOk) {
+      return apply.receipt.exit_code;
+    }
+    if (msg.method == paych::Collect::Number) {
+      auto matcher{vm::toolchain::Toolchain::createAddressMatcher(
+          vm::version::getNetworkVersion(base.head->height()))};
+      if (matcher->isPaymentChannelActor(base.code)) {
+        // https://github.com/filecoin-project/lotus/blob/191a05da4872bf9849f178e6db5c0d6e87d05baa/node/impl/full/gas.go#L281
+        constexpr GasAmount kGas{76000};
+        apply.receipt.gas_used += kGas;
+      }
+    }
+    return gsl::narrow_cast<GasAmount>(
+        gsl::narrow_cast<double>(apply.receipt.gas_used)
+        * kGasLimitOverestimation);
+  }
+
   TokenAmount MessagePool::estimateFeeCap(const TokenAmount &premium,
                                           int64_t max_blocks) const {
     std::shared_lock head_lock(head_mutex_);
@@ -759,7 +1064,9 @@ namespace fc::storage::mpool {
     }
 
     auto kPrecision{uint64_t{1} << 32};
+    std::unique_lock generator_lock{generator_mutex_};
     auto noise{1 + distribution(generator) * 0.005};
+    generator_lock.unlock();
     premium = bigdiv(premium
                          * gsl::narrow_cast<uint64_t>(
                              noise * static_cast<double>(kPrecision) + 1),
@@ -785,6 +1092,7 @@ namespace fc::storage::mpool {
     OUTCOME_TRY(setCbor(ipld, message.message));
     std::unique_lock pending_lock{pending_mutex_};
     mpool::add(pending_, message);
+    pendingChanged(message.message.from);
     signal({MpoolUpdate::Type::ADD, message});
     return outcome::success();
   }
@@ -792,6 +1100,7 @@ namespace fc::storage::mpool {
   void MessagePool::remove(const Address &from, Nonce nonce) {
     std::unique_lock pending_lock{pending_mutex_};
     if (auto smsg{mpool::remove(pending_, from, nonce)}) {
+      pendingChanged(from);
       signal({MpoolUpdate::Type::REMOVE, *smsg});
     }
   }
@@ -799,16 +1108,17 @@ namespace fc::storage::mpool {
   // NOLINTNEXTLINE(readability-function-cognitive-complexity)
   outcome::result<void> MessagePool::onHeadChange(const HeadChange &change) {
     if (change.type == HeadChangeType::CURRENT) {
-      std::unique_lock lock(head_mutex_);
-      head_ = change.value;
+      setHead(change.value);
     } else {
       auto apply{change.type == HeadChangeType::APPLY};
+      std::set<Address> touched;
       OUTCOME_TRY(change.value->visitMessages(
           {ipld, false, true},
           [&](auto, auto bls, auto &cid, auto *smsg, auto *msg)
               -> outcome::result<void> {
             if (apply) {
               remove(msg->from, msg->nonce);
+              touched.insert(msg->from);
             } else {
               if (bls) {
                 std::unique_lock bls_cache_lock{bls_cache_mutex_};
@@ -822,17 +1132,34 @@ namespace fc::storage::mpool {
             }
             return outcome::success();
           }));
-      std::unique_lock lock(head_mutex_);
+      {
+        std::lock_guard dirty_lock{select_dirty_mutex_};
+        if (apply) {
+          select_touched_.insert(touched.begin(), touched.end());
+        } else {
+          // reverted messages may decrease balance of any actor
+          select_rebuild_ = true;
+        }
+      }
       if (apply) {
-        head_ = change.value;
+        setHead(change.value);
       } else {
-        OUTCOME_TRYA(head_,
-                     env_context.ts_load->load(change.value->getParents()));
+        OUTCOME_TRY(parent,
+                    env_context.ts_load->load(change.value->getParents()));
+        setHead(parent);
       }
     }
     return outcome::success();
   }
 
+  void MessagePool::setHead(TipsetCPtr head) {
+    std::unique_lock lock(head_mutex_);
+    head_ = std::move(head);
+    std::unique_lock estimate_lock{estimate_mutex_};
+    estimate_bases_.clear();
+    estimate_head_ = head_->key;
+  }
+
   outcome::result<Address> MessagePool::resolveKeyAtHeight(
       const Address &address,
       const ChainEpoch &height,
@@ -947,13 +1274,13 @@ namespace fc::storage::mpool {
       if (chain->gas_limit <= gas_limit) {
         // check the baseFee lower bound -- only republish messages that can be
         // included in the chain within the next 20 blocks.
-        for (const auto &message : chain->msgs) {
-          if (message.message.gas_fee_cap < base_fee_lower_bound) {
+        for (const auto *message : chain->msgs) {
+          if (message->message.gas_fee_cap < base_fee_lower_bound) {
             invalidate(*chain);
             break;
           }
-          gas_limit -= message.message.gas_limit;
-          messages.push_back(message);
+          gas_limit -= message->message.gas_limit;
+          messages.push_back(*message);
         }
         continue;
       }
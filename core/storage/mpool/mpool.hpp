@@ -8,6 +8,7 @@
 #include <boost/compute/detail/lru_cache.hpp>
 #include <deque>
 #include <random>
+#include <set>
 
 #include "common/logger.hpp"
 #include "fwd.hpp"
@@ -20,6 +21,7 @@ namespace fc::storage::mpool {
   using boost::compute::detail::lru_cache;
   using crypto::signature::Signature;
   using primitives::BigInt;
+  using primitives::GasAmount;
   using primitives::Nonce;
   using primitives::TokenAmount;
   using primitives::address::Address;
@@ -38,6 +40,8 @@ namespace fc::storage::mpool {
   const BigInt kBaseFeeLowerBoundFactor{10};
   constexpr size_t kResolvedCacheSize{1000};
   constexpr size_t kLocalAddressesCacheSize{1000};
+  constexpr size_t kEstimateCacheSize{1000};
+  constexpr size_t kEstimateBaseCacheSize{100};
   constexpr std::chrono::milliseconds kRepublishBatchDelay{100};
 
   struct MpoolUpdate {
@@ -93,6 +97,9 @@ namespace fc::storage::mpool {
 
     void remove(const Address &from, Nonce nonce);
     outcome::result<void> onHeadChange(const HeadChange &change);
+
+    /** Sets head and drops estimate bases of previous head */
+    void setHead(TipsetCPtr head);
     connection_t subscribe(const std::function<Subscriber> &subscriber) {
       return signal.connect(subscriber);
     }
@@ -142,10 +149,53 @@ namespace fc::storage::mpool {
     static TokenAmount getBaseFeeLowerBound(const TokenAmount &base_fee,
                                             const BigInt &factor);
 
+    struct EstimateBase;
+
+    /**
+     * Returns head state with sender pending messages applied.
+     * It is shared by estimates until head or sender pending messages change.
+     */
+    outcome::result<std::shared_ptr<EstimateBase>> estimateBase(
+        const Address &from) const;
+
    private:
     // For empty value in lru cache
     struct Empty {};
 
+    struct SelectIndex;
+
+    /**
+     * Recreates chains of changed actors in selection index.
+     * @param all - recreate chains of all actors from index head state, used
+     * when head is reverted
+     */
+    outcome::result<void> updateSelectIndex(SelectIndex &index,
+                                            bool all) const;
+
+    /**
+     * Moves selection index to current head, so select for head doesn't
+     * create chains of all pending messages.
+     * State is loaded only for senders of applied messages, other actors are
+     * rechained for new base fee.
+     */
+    outcome::result<void> refreshSelectIndex();
+
+    /**
+     * Updates revision and marks actor in selection index.
+     * Called under pending messages lock.
+     */
+    void pendingChanged(const Address &from);
+
+    /**
+     * Revision of actor pending messages, zero when there are none.
+     * Called under pending messages lock.
+     */
+    uint64_t pendingRevision(const Address &from) const;
+
+    /** Applies message on own overlay of base state */
+    outcome::result<GasAmount> estimateGasLimit(
+        const EstimateBase &base, const UnsignedMessage &msg) const;
+
     /**
      * Resolves address at height
      */
@@ -166,6 +216,29 @@ namespace fc::storage::mpool {
     // pending messages, key is a from address
     std::map<Address, std::map<Nonce, SignedMessage>> pending_;
     mutable std::shared_mutex pending_mutex_;
+    // changes when actor pending messages change
+    std::map<Address, uint64_t> pending_revisions_;
+    uint64_t pending_revision_{};
+
+    // estimate bases for current head, by sender and pending revision
+    mutable lru_cache<std::pair<Address, uint64_t>,
+                      std::shared_ptr<EstimateBase>>
+        estimate_bases_{kEstimateBaseCacheSize};
+    // head of estimate bases, changed only by head change
+    TipsetKey estimate_head_;
+    mutable std::mutex estimate_mutex_;
+
+    // message chains for head, recreated only for changed actors
+    mutable std::shared_ptr<SelectIndex> select_index_;
+    mutable std::mutex select_index_mutex_;
+
+    // actors with pending messages changed since last index update
+    mutable std::set<Address> select_dirty_;
+    // senders of messages applied since last index refresh
+    std::set<Address> select_touched_;
+    // index must load state of all actors, e.g. after revert
+    bool select_rebuild_{};
+    mutable std::mutex select_dirty_mutex_;
 
     std::deque<SignedMessage> publishing_;
     std::mutex publishing_mutex_;
@@ -176,6 +249,7 @@ namespace fc::storage::mpool {
     boost::signals2::signal<Subscriber> signal;
     mutable std::default_random_engine generator;
     mutable std::normal_distribution<> distribution;
+    mutable std::mutex generator_mutex_;
 
     // cache of resolved addresses
     mutable lru_cache<Address, Address> resolved_cache_{kResolvedCacheSize};
@@ -39,9 +39,7 @@ namespace fc::vm::actor::builtin::states {
       return VMExitCode::kErrIllegalArgument;
     }
 
-    const auto &last_sector = *std::prev(sector_nos.end());
-
-    if (last_sector > kMaxSectorNumber) {
+    if (sector_nos.back() > kMaxSectorNumber) {
       return VMExitCode::kErrIllegalArgument;
     }
 
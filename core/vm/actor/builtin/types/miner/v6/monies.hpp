@@ -14,8 +14,8 @@ namespace fc::vm::actor::builtin::v6::miner {
   const BigInt kBatchDiscountDenominator = 20;
   const BigInt kBatchBalancer = 5 * kOneNanoFil;
 
-  TokenAmount aggregatePreCommitNetworkFee(uint64_t aggregate_size,
-                                           const TokenAmount &base_fee) {
+  inline TokenAmount aggregatePreCommitNetworkFee(
+      uint64_t aggregate_size, const TokenAmount &base_fee) {
     const TokenAmount effectiveGasFee = std::max(base_fee, kBatchBalancer);
     const TokenAmount networkFeeNum =
         effectiveGasFee * kEstimatedSinglePreCommitGasUsage * aggregate_size
@@ -23,4 +23,13 @@ namespace fc::vm::actor::builtin::v6::miner {
     return bigdiv(networkFeeNum, kBatchDiscountDenominator);
   }
 
+  inline TokenAmount aggregateProveCommitNetworkFee(
+      uint64_t aggregate_size, const TokenAmount &base_fee) {
+    const TokenAmount effectiveGasFee = std::max(base_fee, kBatchBalancer);
+    const TokenAmount networkFeeNum =
+        effectiveGasFee * kEstimatedSingleProveCommitGasUsage * aggregate_size
+        * kBatchDiscountNumerator;
+    return bigdiv(networkFeeNum, kBatchDiscountDenominator);
+  }
+
 }  // namespace fc::vm::actor::builtin::v6::miner
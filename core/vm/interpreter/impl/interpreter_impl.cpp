@@ -5,6 +5,7 @@
 
 #include "vm/interpreter/impl/interpreter_impl.hpp"
 
+#include <future>
 #include <utility>
 
 #include "blockchain/block_validator/validator.hpp"
@@ -74,9 +75,16 @@ namespace fc::vm::interpreter {
       std::vector<MessageReceipt> *all_receipts) const {
     const auto &ipld{env_context_.ipld};
 
+    // validation depends only on parent state, so blocks are validated on
+    // other threads while messages are applied.
+    // validators find lookback under shared branches lock, lazy loads of
+    // branch are serialized by its updater.
+    std::vector<std::future<outcome::result<void>>> validating;
     if (validator_) {
       for (const auto &block : tipset->blks) {
-        OUTCOME_TRY(validator_->validate(ts_branch, block));
+        validating.push_back(std::async(std::launch::async, [&, ts_branch] {
+          return validator_->validate(ts_branch, block);
+        }));
       }
     }
 
@@ -236,6 +244,10 @@ namespace fc::vm::interpreter {
 
     nextStep(&metricFlush);
 
+    for (auto &validated : validating) {
+      OUTCOME_TRY(validated.get());
+    }
+
     OUTCOME_TRY(new_state_root, env->flush());
     OUTCOME_TRY(buf_ipld->flush(new_state_root));
 
@@ -0,0 +1,41 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <boost/compute/detail/lru_cache.hpp>
+#include <mutex>
+
+#include "primitives/address/address.hpp"
+#include "primitives/cid/cid.hpp"
+
+namespace fc::vm::message {
+  using primitives::address::Address;
+
+  /**
+   * Remembers signed messages with verified signatures.
+   * Signed message cid covers signature, so only signer key is stored.
+   */
+  class SignatureCache {
+   public:
+    explicit SignatureCache(size_t capacity) : cache_{capacity} {}
+
+    /** Whether signature of message was verified for key */
+    bool has(const CID &cid, const Address &key) {
+      std::lock_guard lock{mutex_};
+      const auto cached{cache_.get(cid)};
+      return cached && *cached == key;
+    }
+
+    void add(const CID &cid, const Address &key) {
+      std::lock_guard lock{mutex_};
+      cache_.insert(cid, key);
+    }
+
+   private:
+    std::mutex mutex_;
+    boost::compute::detail::lru_cache<CID, Address> cache_;
+  };
+}  // namespace fc::vm::message
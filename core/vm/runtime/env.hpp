@@ -13,6 +13,7 @@
 #include "vm/runtime/pricelist.hpp"
 #include "vm/runtime/runtime_randomness.hpp"
 #include "vm/runtime/virtual_machine.hpp"
+#include "vm/runtime/write_buffer.hpp"
 #include "vm/state/impl/state_tree_impl.hpp"
 
 namespace fc::vm::runtime {
@@ -32,7 +33,7 @@ namespace fc::vm::runtime {
 
     IpldPtr ipld;
     // vm only stores "DAG_CBOR blake2b_256" cids
-    std::unordered_map<CbCid, Bytes> write;
+    WriteBuffer write;
     bool flushed{false};
   };
 
@@ -87,6 +88,7 @@ namespace fc::vm::runtime {
     size_t actors_created{0};
   };
 
+  /// Charges gas for reads, so node_cache is not forwarded
   struct ChargingIpld : Ipld {
     explicit ChargingIpld(const std::shared_ptr<Execution> &execution)
         : execution_{execution} {
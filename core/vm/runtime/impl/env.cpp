@@ -5,6 +5,8 @@
 
 #include "vm/runtime/env.hpp"
 
+#include <unordered_set>
+
 #include "cbor_blake/cid.hpp"
 #include "codec/cbor/light_reader/cid.hpp"
 #include "common/prometheus/metrics.hpp"
@@ -39,7 +41,9 @@ namespace fc::vm::runtime {
     return x;
   }
 
-  IpldBuffered::IpldBuffered(IpldPtr ipld) : ipld{std::move(ipld)} {}
+  IpldBuffered::IpldBuffered(IpldPtr ipld) : ipld{std::move(ipld)} {
+    node_cache = this->ipld->node_cache;
+  }
 
   outcome::result<void> IpldBuffered::flush(const CID &root) {
     assert(!flushed);
@@ -55,32 +59,39 @@ namespace fc::vm::runtime {
                                  .Help("Number of copied objects")
                                  .Register(prometheusRegistry())
                                  .Add({})};
+    static auto &metricChunks{prometheus::BuildCounter()
+                                  .Name("lotus_vm_flush_arena_chunks")
+                                  .Help("Number of VM write buffer allocations")
+                                  .Register(prometheusRegistry())
+                                  .Add({})};
     const Since since;
 
     assert(isCbor(root));
     auto _root{*asBlake(root)};
-    assert(write.count(_root));
-    std::vector<const CbCid *> queue{&_root};
-    std::set<CbCid> visited{_root};
+    assert(write.find(_root));
+    std::vector<std::pair<const CbCid *, BytesIn>> queue{
+        {&_root, *write.find(_root)}};
+    std::unordered_set<CbCid> visited{_root};
     size_t next{};
     while (next < queue.size()) {
-      const auto &key{*queue[next++]};
-      BytesIn value{write.at(key)};
+      BytesIn value{queue[next++].second};
       BytesIn _cid;
       while (codec::cbor::findCid(_cid, value)) {
         const CbCid *cid = nullptr;
         if (codec::cbor::light_reader::readCborBlake(cid, _cid)) {
-          if (auto it{write.find(*cid)};
-              it != write.end() && visited.emplace(*cid).second) {
-            queue.push_back(&it->first);
+          if (auto found{write.find(*cid)};
+              found && visited.emplace(*cid).second) {
+            queue.emplace_back(cid, *found);
           }
         }
       }
     }
+    // values are passed as spans into arena, so ipld may write them without
+    // intermediate copy
     for (auto it{queue.rbegin()}; it != queue.rend(); ++it) {
-      const auto &key{**it};
-      OUTCOME_TRY(ipld->set(CID{key}, std::move(write.at(key))));
+      OUTCOME_TRY(ipld->set(CID{*it->first}, BytesCow{it->second}));
     }
+    metricChunks.Increment(write.chunks());
     write.clear();
 
     metricTime.Increment(since.ms());
@@ -90,7 +101,7 @@ namespace fc::vm::runtime {
   }
 
   outcome::result<bool> IpldBuffered::contains(const CID &cid) const {
-    if (auto it{write.find(*asBlake(cid))}; it != write.end()) {
+    if (write.find(*asBlake(cid))) {
       return true;
     }
     return ipld->contains(cid).value();
@@ -98,14 +109,14 @@ namespace fc::vm::runtime {
 
   outcome::result<void> IpldBuffered::set(const CID &cid, BytesCow &&value) {
     assert(isCbor(cid));
-    write.emplace(*asBlake(cid), value.into());
+    write.put(*asBlake(cid), value);
     return outcome::success();
   }
 
   outcome::result<Ipld::Value> IpldBuffered::get(const CID &cid) const {
     if (isCbor(cid)) {
-      if (auto it{write.find(*asBlake(cid))}; it != write.end()) {
-        return it->second;
+      if (auto value{write.find(*asBlake(cid))}) {
+        return Bytes{value->begin(), value->end()};
       }
       return ipld->get(cid);
     }
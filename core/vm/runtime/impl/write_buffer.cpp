@@ -0,0 +1,86 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "vm/runtime/write_buffer.hpp"
+
+#include <algorithm>
+
+namespace fc::vm::runtime {
+  /** Initial number of table slots, power of two */
+  constexpr size_t kInitialSlots{1 << 10};
+
+  const BytesIn *WriteBuffer::find(const CbCid &key) const {
+    if (slots_.empty()) {
+      return nullptr;
+    }
+    const auto &slot{slots_[this->slot(key)]};
+    if (slot.value.data() == nullptr) {
+      return nullptr;
+    }
+    return &slot.value;
+  }
+
+  void WriteBuffer::put(const CbCid &key, BytesIn value) {
+    // keep load factor below 1/2
+    if (2 * (size_ + 1) > slots_.size()) {
+      grow();
+    }
+    auto &slot{slots_[this->slot(key)]};
+    if (slot.value.data() == nullptr) {
+      auto data{alloc(value.size())};
+      std::copy(value.begin(), value.end(), data);
+      slot.key = key;
+      slot.value = {data, value.size()};
+      ++size_;
+    }
+  }
+
+  void WriteBuffer::clear() {
+    slots_ = std::vector<Slot>{};
+    size_ = 0;
+    chunks_.clear();
+    chunk_pos_ = nullptr;
+    chunk_left_ = 0;
+  }
+
+  size_t WriteBuffer::slot(const CbCid &key) const {
+    const auto mask{slots_.size() - 1};
+    // key is hash, so linear probing doesn't cluster
+    auto i{std::hash<CbCid>{}(key) & mask};
+    while (slots_[i].value.data() != nullptr && slots_[i].key != key) {
+      i = (i + 1) & mask;
+    }
+    return i;
+  }
+
+  void WriteBuffer::grow() {
+    auto slots{std::move(slots_)};
+    slots_.clear();
+    slots_.resize(slots.empty() ? kInitialSlots : 2 * slots.size());
+    for (auto &slot : slots) {
+      if (slot.value.data() != nullptr) {
+        slots_[this->slot(slot.key)] = slot;
+      }
+    }
+  }
+
+  uint8_t *WriteBuffer::alloc(size_t size) {
+    if (size > kChunkSize / 4) {
+      // large value gets own chunk, so current chunk is not wasted
+      chunks_.emplace(chunks_.begin(),
+                      std::make_unique<uint8_t[]>(std::max<size_t>(size, 1)));
+      return chunks_.front().get();
+    }
+    if (chunk_pos_ == nullptr || size > chunk_left_) {
+      chunks_.emplace_back(std::make_unique<uint8_t[]>(kChunkSize));
+      chunk_pos_ = chunks_.back().get();
+      chunk_left_ = kChunkSize;
+    }
+    auto data{chunk_pos_};
+    chunk_pos_ += size;
+    chunk_left_ -= size;
+    return data;
+  }
+}  // namespace fc::vm::runtime
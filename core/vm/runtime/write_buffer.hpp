@@ -0,0 +1,65 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "cbor_blake/cid.hpp"
+
+namespace fc::vm::runtime {
+  /**
+   * Buffer of blocks written during execution.
+   * Values are copied into arena chunks with bump allocation, keys are stored
+   * in flat open addressing table, so insert doesn't allocate per block.
+   * Returned spans are valid until clear.
+   */
+  class WriteBuffer {
+   public:
+    /** Values are allocated from chunks of this size */
+    static constexpr size_t kChunkSize{1 << 20};
+
+    /** @return value or nullptr */
+    const BytesIn *find(const CbCid &key) const;
+
+    /** Copies value into arena, existing value is kept */
+    void put(const CbCid &key, BytesIn value);
+
+    inline size_t size() const {
+      return size_;
+    }
+
+    inline bool empty() const {
+      return size_ == 0;
+    }
+
+    /** Number of arena chunks allocated */
+    inline size_t chunks() const {
+      return chunks_.size();
+    }
+
+    /** Frees table and arena */
+    void clear();
+
+   private:
+    struct Slot {
+      CbCid key;
+      /** Empty slot has null data */
+      BytesIn value;
+    };
+
+    /** @return slot with key or empty slot to insert key */
+    size_t slot(const CbCid &key) const;
+    void grow();
+    uint8_t *alloc(size_t size);
+
+    std::vector<Slot> slots_;
+    size_t size_{};
+    std::vector<std::unique_ptr<uint8_t[]>> chunks_;
+    uint8_t *chunk_pos_{};
+    size_t chunk_left_{};
+  };
+}  // namespace fc::vm::runtime
@@ -0,0 +1,43 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+namespace fc::benchmark {
+  using Clock = std::chrono::steady_clock;
+
+  /** Keeps value computed by benchmarked code from being optimized out */
+  template <typename T>
+  inline void doNotOptimize(const T &value) {
+    asm volatile("" : : "g"(&value) : "memory");
+  }
+
+  /**
+   * Runs f several times, prints time per run and records it as test
+   * property, so it is kept in xunit output.
+   * Sizes are small enough for ctest, numbers are for comparing variants
+   * within same run rather than across machines.
+   * @return nanoseconds per run
+   */
+  template <typename F>
+  double measure(const std::string &name, size_t runs, const F &f) {
+    const auto start{Clock::now()};
+    for (size_t i{0}; i < runs; ++i) {
+      f();
+    }
+    const auto ns{
+        std::chrono::duration<double, std::nano>(Clock::now() - start).count()
+        / static_cast<double>(runs)};
+    std::cout << "[ BENCH    ] " << name << ": " << static_cast<uint64_t>(ns)
+              << " ns" << std::endl;
+    testing::Test::RecordProperty(name, std::to_string(ns));
+    return ns;
+  }
+}  // namespace fc::benchmark
@@ -0,0 +1,44 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "crypto/blake2/blake2b160.hpp"
+
+#include "benchmark/benchmark.hpp"
+
+namespace fc::crypto::blake2b {
+  using benchmark::doNotOptimize;
+  using benchmark::measure;
+
+  /**
+   * @given inputs of ipld block size
+   * @when hash them one by one and together
+   * @then hashes are same, multi-buffer time is reported
+   */
+  TEST(Blake2bBenchmark, Many) {
+    constexpr size_t kInputs{64};
+    constexpr size_t kRuns{200};
+    std::vector<std::vector<uint8_t>> datas;
+    for (size_t i{0}; i < kInputs; ++i) {
+      auto &data{datas.emplace_back(1024 + 32 * i)};
+      for (size_t j{0}; j < data.size(); ++j) {
+        data[j] = static_cast<uint8_t>(i * 31 + j);
+      }
+    }
+    std::vector<BytesIn> inputs{datas.begin(), datas.end()};
+    std::vector<Blake2b256Hash> expected(kInputs), hashes(kInputs);
+
+    measure("blake2b_256", kRuns, [&] {
+      for (size_t i{0}; i < kInputs; ++i) {
+        expected[i] = blake2b_256(inputs[i]);
+      }
+      doNotOptimize(expected);
+    });
+    measure("blake2b_256_many", kRuns, [&] {
+      blake2b_256_many(inputs, hashes);
+      doNotOptimize(hashes);
+    });
+    EXPECT_EQ(hashes, expected);
+  }
+}  // namespace fc::crypto::blake2b
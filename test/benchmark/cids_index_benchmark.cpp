@@ -0,0 +1,59 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/car/cids_index/cids_index.hpp"
+
+#include "benchmark/benchmark.hpp"
+
+namespace fc::storage::cids_index {
+  using benchmark::doNotOptimize;
+  using benchmark::measure;
+
+  /**
+   * @given sorted index rows of hashed keys
+   * @when look up keys with prefix guess and with plain binary search
+   * @then same rows are found, time of both is reported
+   */
+  TEST(CidsIndexBenchmark, LowerBound) {
+    constexpr size_t kRows{1 << 18};
+    constexpr size_t kLookups{1 << 16};
+    constexpr size_t kRuns{5};
+    std::vector<Row> rows(kRows);
+    for (size_t i{0}; i < kRows; ++i) {
+      rows[i].key = CbCid::hash(Bytes{static_cast<uint8_t>(i),
+                                      static_cast<uint8_t>(i >> 8),
+                                      static_cast<uint8_t>(i >> 16)});
+      rows[i].offset = i;
+      rows[i].max_size64 = 1;
+    }
+    std::sort(rows.begin(), rows.end());
+    std::vector<CbCid> keys;
+    for (size_t i{0}; i < kLookups; ++i) {
+      // found and missing keys
+      keys.push_back(i % 2 == 0 ? rows[(i * 7919) % kRows].key
+                                : CbCid::hash(Bytes{static_cast<uint8_t>(i),
+                                                    static_cast<uint8_t>(i >> 8),
+                                                    0xff,
+                                                    0xff}));
+    }
+    const gsl::span<const Row> span{rows};
+
+    std::vector<const Row *> expected(kLookups), found(kLookups);
+    measure("std::lower_bound", kRuns, [&] {
+      for (size_t i{0}; i < kLookups; ++i) {
+        expected[i] = std::lower_bound(
+            rows.data(), rows.data() + rows.size(), keys[i]);
+      }
+      doNotOptimize(expected);
+    });
+    measure("lowerBound", kRuns, [&] {
+      for (size_t i{0}; i < kLookups; ++i) {
+        found[i] = lowerBound(span, keys[i]);
+      }
+      doNotOptimize(found);
+    });
+    EXPECT_EQ(found, expected);
+  }
+}  // namespace fc::storage::cids_index
@@ -0,0 +1,58 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/hamt/hamt.hpp"
+
+#include "benchmark/benchmark.hpp"
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "storage/ipfs/node_cache.hpp"
+#include "testutil/outcome.hpp"
+
+namespace fc::storage::hamt {
+  using benchmark::doNotOptimize;
+  using benchmark::measure;
+  using ipfs::InMemoryDatastore;
+  using ipfs::NodeCache;
+
+  Bytes key(uint32_t i) {
+    return {static_cast<uint8_t>(i >> 24),
+            static_cast<uint8_t>(i >> 16),
+            static_cast<uint8_t>(i >> 8),
+            static_cast<uint8_t>(i)};
+  }
+
+  /**
+   * @given state-like hamt
+   * @when get all keys from hamts loaded from same root, as actor state
+   * reads do, with and without node cache
+   * @then values are same, time of both is reported
+   */
+  TEST(HamtBenchmark, GetCached) {
+    constexpr uint32_t kKeys{10000};
+    constexpr size_t kRuns{5};
+    auto ipld{std::make_shared<InMemoryDatastore>()};
+    Hamt hamt{ipld, kDefaultBitWidth};
+    for (uint32_t i{0}; i < kKeys; ++i) {
+      EXPECT_OUTCOME_TRUE_1(hamt.setCbor(key(i), i));
+    }
+    const auto root{hamt.flush().value()};
+
+    size_t errors{};
+    const auto getAll{[&] {
+      Hamt loaded{ipld, root, kDefaultBitWidth};
+      for (uint32_t i{0}; i < kKeys; ++i) {
+        const auto value{loaded.getCbor<uint32_t>(key(i))};
+        if (!value || value.value() != i) {
+          ++errors;
+        }
+        doNotOptimize(value);
+      }
+    }};
+    measure("hamt get", kRuns, getAll);
+    ipld->node_cache = std::make_shared<NodeCache>(kKeys);
+    measure("hamt get cached", kRuns, getAll);
+    EXPECT_EQ(errors, 0);
+  }
+}  // namespace fc::storage::hamt
@@ -0,0 +1,88 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "primitives/rle_bitset/rle_bitset.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+#include "benchmark/benchmark.hpp"
+
+namespace fc::primitives {
+  using benchmark::doNotOptimize;
+  using benchmark::measure;
+  using Set = std::set<uint64_t>;
+
+  /** Sector numbers in ranges of given length with gaps between them */
+  Set sectorRanges(uint64_t first, size_t ranges, uint64_t length) {
+    Set set;
+    for (size_t i{0}; i < ranges; ++i) {
+      const auto begin{first + i * length * 2};
+      for (auto v{begin}; v < begin + length; ++v) {
+        set.insert(set.end(), v);
+      }
+    }
+    return set;
+  }
+
+  /**
+   * @given partition-like bitsets of mostly contiguous sectors
+   * @when union, subtract and check containment as runs and as std::set
+   * @then results are same, time of both is reported
+   */
+  TEST(RleBitsetBenchmark, SetOperations) {
+    constexpr size_t kRuns{20};
+    const auto set_a{sectorRanges(0, 100, 500)};
+    const auto set_b{sectorRanges(250, 100, 500)};
+    const RleBitset a{set_a};
+    const RleBitset b{set_b};
+
+    Set set_union, set_diff;
+    measure("std::set union", kRuns, [&] {
+      set_union.clear();
+      std::set_union(set_a.begin(),
+                     set_a.end(),
+                     set_b.begin(),
+                     set_b.end(),
+                     std::inserter(set_union, set_union.end()));
+      doNotOptimize(set_union);
+    });
+    RleBitset rle_union;
+    measure("RleBitset union", kRuns, [&] {
+      rle_union = a + b;
+      doNotOptimize(rle_union);
+    });
+    EXPECT_EQ(rle_union, RleBitset{set_union});
+
+    measure("std::set subtract", kRuns, [&] {
+      set_diff.clear();
+      std::set_difference(set_a.begin(),
+                          set_a.end(),
+                          set_b.begin(),
+                          set_b.end(),
+                          std::inserter(set_diff, set_diff.end()));
+      doNotOptimize(set_diff);
+    });
+    RleBitset rle_diff;
+    measure("RleBitset subtract", kRuns, [&] {
+      rle_diff = a - b;
+      doNotOptimize(rle_diff);
+    });
+    EXPECT_EQ(rle_diff, RleBitset{set_diff});
+
+    bool set_contains{}, rle_contains{};
+    measure("std::set contains", kRuns, [&] {
+      set_contains = std::includes(
+          set_union.begin(), set_union.end(), set_a.begin(), set_a.end());
+      doNotOptimize(set_contains);
+    });
+    measure("RleBitset contains", kRuns, [&] {
+      rle_contains = rle_union.contains(a);
+      doNotOptimize(rle_contains);
+    });
+    EXPECT_TRUE(set_contains);
+    EXPECT_TRUE(rle_contains);
+  }
+}  // namespace fc::primitives
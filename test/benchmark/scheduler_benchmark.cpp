@@ -0,0 +1,159 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "sector_storage/impl/new_scheduler_impl.hpp"
+
+#include <gmock/gmock.h>
+#include <boost/optional/optional_io.hpp>
+#include <algorithm>
+#include <map>
+
+#include "benchmark/benchmark.hpp"
+#include "storage/in_memory/in_memory_storage.hpp"
+#include "testutil/mocks/sector_storage/stores/sector_index_mock.hpp"
+#include "testutil/mocks/sector_storage/worker_mock.hpp"
+#include "testutil/outcome.hpp"
+
+namespace fc::sector_storage {
+  using benchmark::measure;
+  using primitives::SectorNumber;
+  using primitives::StoragePath;
+  using primitives::WorkerInfo;
+  using primitives::WorkerResources;
+  using storage::InMemoryStorage;
+  using stores::SectorIndexMock;
+  using stores::SectorStorageInfo;
+  using ::testing::_;
+  using ::testing::Return;
+
+  /** Estimator with fixed task duration of each worker */
+  struct FixedEstimator : Estimator {
+    void startWork(WorkerId, TaskType, CallId) override {}
+
+    void finishWork(CallId) override {}
+
+    void abortWork(CallId) override {}
+
+    boost::optional<double> getTime(WorkerId worker,
+                                    TaskType) const override {
+      return durations.at(worker);
+    }
+
+    std::vector<double> durations;
+  };
+
+  /** Selector accepting every worker without preference */
+  struct AnySelector : WorkerSelector {
+    outcome::result<bool> is_satisfying(
+        const TaskType &,
+        RegisteredSealProof,
+        const std::shared_ptr<WorkerHandle> &) override {
+      return true;
+    }
+
+    outcome::result<bool> is_preferred(
+        const TaskType &,
+        const std::shared_ptr<WorkerHandle> &,
+        const std::shared_ptr<WorkerHandle> &) override {
+      return false;
+    }
+  };
+
+  /**
+   * @given workers of different speed running one PreCommit2 at a time
+   * @when tasks are scheduled and completed in simulated time
+   * @then all tasks complete, scheduling time and simulated makespan
+   * compared to lower bound are reported
+   */
+  TEST(SchedulerBenchmark, Simulation) {
+    constexpr size_t kWorkers{8};
+    constexpr SectorNumber kTasks{256};
+    auto io{std::make_shared<boost::asio::io_context>()};
+    auto estimator{std::make_shared<FixedEstimator>()};
+    auto index{std::make_shared<SectorIndexMock>()};
+    EXPECT_CALL(*index, storageFindSector(_, _, _))
+        .WillRepeatedly(Return(std::vector<SectorStorageInfo>{}));
+    std::shared_ptr<Scheduler> scheduler{
+        EstimateSchedulerImpl::newScheduler(
+            io, std::make_shared<InMemoryStorage>(), estimator, index)
+            .value()};
+    auto selector{std::make_shared<AnySelector>()};
+
+    // worker i takes 10 * (i + 1) milliseconds
+    double rate{};
+    for (size_t i{0}; i < kWorkers; ++i) {
+      const auto duration{10.0 * static_cast<double>(i + 1)};
+      estimator->durations.push_back(duration);
+      rate += 1 / duration;
+      auto worker{std::make_shared<WorkerMock>()};
+      EXPECT_CALL(*worker, getInfo)
+          .WillRepeatedly(Return(WorkerInfo{.hostname = std::to_string(i)}));
+      EXPECT_CALL(*worker, getAccessiblePaths())
+          .WillRepeatedly(Return(std::vector<StoragePath>{}));
+      auto handle{std::make_unique<WorkerHandle>()};
+      handle->worker = worker;
+      handle->info =
+          WorkerInfo{.hostname = std::to_string(i),
+                     .resources = WorkerResources{.physical_memory = 1ul << 20,
+                                                  .swap_memory = 0,
+                                                  .reserved_memory = 0,
+                                                  .cpus = 1,
+                                                  .gpus = {}}};
+      scheduler->newWorker(std::move(handle));
+    }
+
+    // simulated time in milliseconds, calls by finish time,
+    // each worker runs its calls one at a time
+    double now{};
+    std::multimap<double, CallId> running;
+    std::vector<double> busy_until(kWorkers);
+    size_t done{};
+    const auto poll{[&] {
+      io->restart();
+      io->poll();
+    }};
+    measure("schedule and complete", 1, [&] {
+      for (SectorNumber sector{0}; sector < kTasks; ++sector) {
+        const SectorRef ref{
+            .id = SectorId{.miner = 42, .sector = sector},
+            .proof_type = RegisteredSealProof::kStackedDrg2KiBV1};
+        EXPECT_OUTCOME_TRUE_1(scheduler->schedule(
+            ref,
+            primitives::kTTPreCommit2,
+            selector,
+            WorkerAction(),
+            [&, id{ref.id}](auto &worker) -> outcome::result<CallId> {
+              OUTCOME_TRY(info, worker->getInfo());
+              const auto wid{std::stoul(info.hostname)};
+              busy_until[wid] = std::max(now, busy_until[wid])
+                                + estimator->durations.at(wid);
+              CallId call_id{.sector = id, .id = std::to_string(id.sector)};
+              running.emplace(busy_until[wid], call_id);
+              return call_id;
+            },
+            [&](const outcome::result<CallResult> &) { ++done; },
+            kDefaultTaskPriority,
+            boost::none));
+      }
+      poll();
+      while (!running.empty()) {
+        const auto it{running.begin()};
+        now = it->first;
+        const auto call_id{it->second};
+        running.erase(it);
+        EXPECT_OUTCOME_TRUE_1(scheduler->returnResult(call_id, {}));
+        poll();
+      }
+    });
+    EXPECT_EQ(done, kTasks);
+
+    const auto lower_bound{static_cast<double>(kTasks) / rate};
+    std::cout << "[ BENCH    ] simulated makespan: " << now
+              << " ms, lower bound: " << lower_bound << " ms" << std::endl;
+    testing::Test::RecordProperty("makespan", std::to_string(now));
+    testing::Test::RecordProperty("makespan lower bound",
+                                  std::to_string(lower_bound));
+  }
+}  // namespace fc::sector_storage
@@ -0,0 +1,68 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "miner/storage_fsm/impl/sector_journal.hpp"
+
+#include <libp2p/basic/scheduler/manual_scheduler_backend.hpp>
+#include <libp2p/basic/scheduler/scheduler_impl.hpp>
+
+#include "benchmark/benchmark.hpp"
+#include "storage/in_memory/in_memory_storage.hpp"
+#include "testutil/outcome.hpp"
+
+namespace fc::mining {
+  using benchmark::measure;
+  using primitives::ChainEpoch;
+  using libp2p::basic::ManualSchedulerBackend;
+  using libp2p::basic::SchedulerImpl;
+  using primitives::sector::RegisteredSealProof;
+  using storage::InMemoryStorage;
+
+  /**
+   * @given sectors saved with several transitions each
+   * @when journal is loaded with log replay, then from snapshots only
+   * @then latest states are loaded, time of both loads is reported
+   */
+  TEST(SectorJournalBenchmark, Load) {
+    constexpr SectorNumber kSectors{2000};
+    auto kv{std::make_shared<InMemoryStorage>()};
+    std::shared_ptr<Scheduler> scheduler{std::make_shared<SchedulerImpl>(
+        std::make_shared<ManualSchedulerBackend>(), Scheduler::Config{})};
+    auto journal{std::make_unique<SectorJournal>(kv, scheduler)};
+
+    measure("save", 1, [&] {
+      for (SectorNumber sector{0}; sector < kSectors; ++sector) {
+        SectorInfo info;
+        info.sector_number = sector;
+        info.sector_type = RegisteredSealProof::kStackedDrg2KiBV1_1;
+        for (auto state : {SealingState::kPacking,
+                           SealingState::kPreCommit1,
+                           SealingState::kPreCommit2,
+                           SealingState::kPreCommitting,
+                           SealingState::kProving}) {
+          info.state = state;
+          if (state == SealingState::kPreCommit1) {
+            info.ticket_epoch = static_cast<ChainEpoch>(sector);
+          }
+          EXPECT_OUTCOME_TRUE_1(journal->save(info));
+        }
+      }
+      EXPECT_OUTCOME_TRUE_1(journal->flush());
+    });
+
+    const auto load{[&] {
+      journal = std::make_unique<SectorJournal>(kv, scheduler);
+      EXPECT_OUTCOME_TRUE(sectors, journal->load());
+      EXPECT_EQ(sectors.size(), kSectors);
+      for (const auto &info : sectors) {
+        EXPECT_EQ(info->state, SealingState::kProving);
+        EXPECT_EQ(info->ticket_epoch,
+                  static_cast<ChainEpoch>(info->sector_number));
+      }
+    }};
+    measure("load with replay", 1, load);
+    measure("load snapshots", 3, load);
+  }
+}  // namespace fc::mining
@@ -0,0 +1,116 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "api/rpc/chunk_queue.hpp"
+
+#include <gtest/gtest.h>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+
+#include "common/error_text.hpp"
+
+namespace fc::api::rpc {
+  struct ChunkQueueTest : ::testing::Test {
+    using Chunk = std::pair<outcome::result<Bytes>, bool>;
+
+    /** Takes next chunk, waits for producer */
+    Chunk next(ChunkQueue &queue) {
+      std::promise<Chunk> promise;
+      queue.next([&](outcome::result<Bytes> chunk, bool last) {
+        promise.set_value({std::move(chunk), last});
+      });
+      return promise.get_future().get();
+    }
+
+    /** Producer waits until chunk is produced */
+    void waitProduced(size_t count) {
+      std::unique_lock lock{mutex};
+      cv.wait(lock, [&] { return produced == count; });
+    }
+
+    void produce(const ChunkQueue::Sink &sink, uint8_t count) {
+      for (uint8_t i{}; i < count; ++i) {
+        sink(Bytes{i});
+        std::unique_lock lock{mutex};
+        ++produced;
+        cv.notify_all();
+      }
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    size_t produced{};
+  };
+
+  /**
+   * @given producer of several chunks
+   * @when chunks are not taken
+   * @then producer waits, chunks are produced as they are taken
+   */
+  TEST_F(ChunkQueueTest, Backpressure) {
+    auto queue{ChunkQueue::start([&](const ChunkQueue::Sink &sink) {
+      produce(sink, 5);
+    })};
+    waitProduced(ChunkQueue::kMaxChunks);
+    {
+      std::unique_lock lock{mutex};
+      EXPECT_FALSE(cv.wait_for(lock, std::chrono::milliseconds{50}, [&] {
+        return produced > ChunkQueue::kMaxChunks;
+      }));
+    }
+    Bytes all;
+    while (true) {
+      auto [chunk, last]{next(*queue)};
+      append(all, chunk.value());
+      if (last) {
+        break;
+      }
+    }
+    EXPECT_EQ(all, (Bytes{0, 1, 2, 3, 4}));
+  }
+
+  /**
+   * @given producer which fails after first chunk
+   * @when chunks are taken
+   * @then error is returned after first chunk
+   */
+  TEST_F(ChunkQueueTest, Error) {
+    auto queue{ChunkQueue::start([&](const ChunkQueue::Sink &sink) {
+      sink(Bytes{1});
+      waitProduced(1);
+      throw std::system_error{ERROR_TEXT("ChunkQueueTest error")};
+    })};
+    EXPECT_EQ(next(*queue).first.value(), Bytes{1});
+    {
+      std::unique_lock lock{mutex};
+      produced = 1;
+      cv.notify_all();
+    }
+    EXPECT_EQ(next(*queue).first.error(), ERROR_TEXT("ChunkQueueTest error"));
+  }
+
+  /**
+   * @given producer waiting for chunks to be taken
+   * @when queue is destroyed
+   * @then producer is stopped
+   */
+  TEST_F(ChunkQueueTest, Cancel) {
+    std::promise<void> stopped;
+    auto queue{ChunkQueue::start([&](const ChunkQueue::Sink &sink) {
+      try {
+        produce(sink, 100);
+      } catch (...) {
+        stopped.set_value();
+        throw;
+      }
+    })};
+    waitProduced(ChunkQueue::kMaxChunks);
+    queue.reset();
+    EXPECT_EQ(stopped.get_future().wait_for(std::chrono::seconds{1}),
+              std::future_status::ready);
+    EXPECT_EQ(produced, ChunkQueue::kMaxChunks);
+  }
+}  // namespace fc::api::rpc
@@ -0,0 +1,119 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "api/rpc/executor.hpp"
+
+#include <gtest/gtest.h>
+#include <condition_variable>
+
+namespace fc::api::rpc {
+  struct RpcExecutorTest : ::testing::Test {
+    using Result = boost::variant<Response::Error, Document, Response::Stream>;
+
+    void SetUp() override {
+      rpc.setup("Slow",
+                [this](auto &, Respond respond, auto, auto, auto &) {
+                  std::unique_lock lock{mutex};
+                  handlers.push_back(std::move(respond));
+                  ++running;
+                  cv.notify_all();
+                });
+      rpc.setup("Fast", [this](auto &, Respond respond, auto, auto, auto &) {
+        fast_thread = std::this_thread::get_id();
+        respond(Document{});
+      });
+      executor->wrap(rpc, {{"Slow", {1, 1}}});
+    }
+
+    void call(const std::string &method) {
+      Document params;
+      rpc.ms.at(method)(
+          params,
+          [this](Result result) {
+            std::unique_lock lock{mutex};
+            results.push_back(std::move(result));
+            cv.notify_all();
+          },
+          {},
+          {},
+          {});
+    }
+
+    template <typename F>
+    void wait(F f) {
+      std::unique_lock lock{mutex};
+      EXPECT_TRUE(cv.wait_for(lock, std::chrono::seconds{5}, f));
+    }
+
+    Rpc rpc;
+    std::shared_ptr<Executor> executor{std::make_shared<Executor>(2)};
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<Respond> handlers;
+    size_t running{};
+    std::vector<Result> results;
+    std::thread::id fast_thread;
+  };
+
+  /**
+   * @given method limited to 1 running and 1 waiting request
+   * @when 3 requests are sent
+   * @then third is rejected, second runs after first responds
+   */
+  TEST_F(RpcExecutorTest, Limits) {
+    call("Slow");
+    call("Slow");
+    call("Slow");
+    wait([&] { return running == 1 && results.size() == 1; });
+    {
+      std::unique_lock lock{mutex};
+      ASSERT_EQ(results.size(), 1);
+      const auto *error{boost::get<Response::Error>(&results[0])};
+      ASSERT_TRUE(error);
+      EXPECT_EQ(error->code, kServerBusy);
+    }
+
+    Respond respond;
+    {
+      std::unique_lock lock{mutex};
+      respond = handlers[0];
+    }
+    respond(Document{});
+    wait([&] { return running == 2 && results.size() == 2; });
+    {
+      std::unique_lock lock{mutex};
+      respond = handlers[1];
+    }
+    respond(Document{});
+    wait([&] { return results.size() == 3; });
+  }
+
+  /**
+   * @given method without limits
+   * @when request is sent
+   * @then it runs on caller thread
+   */
+  TEST_F(RpcExecutorTest, NotWrapped) {
+    call("Fast");
+    EXPECT_EQ(fast_thread, std::this_thread::get_id());
+    EXPECT_EQ(results.size(), 1);
+  }
+
+  /**
+   * @given method holding slot
+   * @when handler drops respond without calling it
+   * @then slot is released
+   */
+  TEST_F(RpcExecutorTest, DroppedRespond) {
+    call("Slow");
+    call("Slow");
+    wait([&] { return running == 1; });
+    {
+      std::unique_lock lock{mutex};
+      handlers.clear();
+    }
+    wait([&] { return running == 2; });
+  }
+}  // namespace fc::api::rpc
@@ -48,6 +48,45 @@ namespace fc::codec::cbor {
                       Blob3::fromHex("CAFEDE").value());
   }
 
+  /**
+   * @given CBOR list of bytes, string, CID and list
+   * @when decode views
+   * @then views point into encoded buffer, list is decoded on visit
+   */
+  TEST(Cbor, Views) {
+    CborEncodeStream encoder;
+    encoder << (encoder.list() << "CAFE"_unhex << std::string{"abc"} << kCidRaw
+                               << std::vector<uint64_t>{1, 2, 3});
+    const auto encoded{encoder.data()};
+    const auto inside{[&](const void *ptr) {
+      return ptr >= encoded.data() && ptr < encoded.data() + encoded.size();
+    }};
+
+    CborDecodeStream decoder{encoded};
+    auto list{decoder.list()};
+    BytesIn bytes;
+    std::string_view str;
+    CidView cid;
+    ListView<uint64_t> ints;
+    list >> bytes >> str >> cid >> ints;
+
+    EXPECT_EQ(copy(bytes), "CAFE"_unhex);
+    EXPECT_TRUE(inside(bytes.data()));
+    EXPECT_EQ(str, "abc");
+    EXPECT_TRUE(inside(str.data()));
+    EXPECT_OUTCOME_EQ(cid.toCid(), kCidRaw);
+    EXPECT_TRUE(inside(cid.bytes.data()));
+    EXPECT_EQ(cid.asCbCid(), nullptr);
+    EXPECT_EQ(ints.size(), 3);
+    std::vector<uint64_t> visited;
+    EXPECT_OUTCOME_TRUE_1(
+        ints.visit([&](uint64_t i) -> outcome::result<void> {
+          visited.push_back(i);
+          return outcome::success();
+        }));
+    EXPECT_EQ(visited, (std::vector<uint64_t>{1, 2, 3}));
+  }
+
   /** BigInt CBOR encoding and decoding */
   TEST(Cbor, BigInt) {
     using fc::primitives::BigInt;
@@ -6,11 +6,16 @@
 #include <gtest/gtest.h>
 
 #include "cbor_blake/ipld_any.hpp"
+#include "codec/cbor/light_reader/market_reader.hpp"
 #include "codec/cbor/light_reader/miner_actor_reader.hpp"
+#include "codec/cbor/light_reader/partition_reader.hpp"
+#include "codec/cbor/light_reader/sector_info_reader.hpp"
 #include "codec/cbor/light_reader/storage_power_actor_reader.hpp"
+#include "primitives/address/address_codec.hpp"
 #include "storage/ipfs/impl/in_memory_datastore.hpp"
 #include "testutil/literals.hpp"
 #include "testutil/outcome.hpp"
+#include "vm/actor/builtin/states/market/market_actor_state.hpp"
 #include "vm/actor/builtin/states/miner/v0/miner_actor_state.hpp"
 #include "vm/actor/builtin/states/miner/v2/miner_actor_state.hpp"
 #include "vm/actor/builtin/states/storage_power/v0/storage_power_actor_state.hpp"
@@ -20,13 +25,21 @@
 
 namespace fc::codec::cbor::light_reader {
   using primitives::RleBitset;
+  using primitives::address::Address;
   using primitives::sector::RegisteredSealProof;
   using storage::ipfs::InMemoryDatastore;
   using vm::actor::ActorVersion;
   using vm::actor::builtin::states::ChainEpochKeyer;
+  using vm::actor::builtin::states::kProposalsAmtBitwidth;
+  using vm::actor::builtin::states::kStatesAmtBitwidth;
   using vm::actor::builtin::types::Universal;
+  using vm::actor::builtin::types::market::DealProposal;
+  using vm::actor::builtin::types::market::DealState;
   using vm::actor::builtin::types::miner::Deadlines;
+  using vm::actor::builtin::types::miner::kPartitionsBitWidth;
   using vm::actor::builtin::types::miner::MinerInfo;
+  using vm::actor::builtin::types::miner::Partition;
+  using vm::actor::builtin::types::miner::SectorOnChainInfo;
   using vm::actor::builtin::types::miner::VestingFunds;
   using vm::actor::builtin::types::storage_power::Claim;
   using MinerActorStateV0 = vm::actor::builtin::v0::miner::MinerActorState;
@@ -80,6 +93,139 @@ namespace fc::codec::cbor::light_reader {
     EXPECT_EQ(*asBlake(expected_deadlines), actual_deadlines);
   }
 
+  /**
+   * @given Miner Actor V2 State with sectors in several AMT nodes
+   * @when visit sector views
+   * @then sectors are visited in order with fields borrowed from nodes
+   */
+  TEST_F(LightActorReader, MinerSectors) {
+    auto state =
+        makeSomeMinerActorState<MinerActorStateV2>(ActorVersion::kVersion2);
+    const std::vector<uint64_t> ids{1, 100, 1000};
+    for (const auto id : ids) {
+      Universal<SectorOnChainInfo> sector{ActorVersion::kVersion2};
+      sector->sector = id;
+      sector->sealed_cid = "010001020001"_cid;
+      sector->deals = {id, id + 1};
+      sector->expiration = static_cast<ChainEpoch>(id) * 2;
+      EXPECT_OUTCOME_TRUE_1(state.sectors.sectors.set(id, sector));
+    }
+    EXPECT_OUTCOME_TRUE_1(setCbor(ipld, state));
+    const auto root{*asBlake(state.sectors.sectors.amt.cid())};
+
+    std::vector<uint64_t> visited;
+    EXPECT_TRUE(minerSectors(light_ipld, root, [&](auto &view) {
+      visited.push_back(view.sector);
+      EXPECT_EQ(view.expiration, static_cast<ChainEpoch>(view.sector) * 2);
+      EXPECT_OUTCOME_EQ(view.sealed_cid.toCid(), "010001020001"_cid);
+      std::vector<uint64_t> deals;
+      EXPECT_OUTCOME_TRUE_1(
+          view.deals.visit([&](uint64_t deal) -> outcome::result<void> {
+            deals.push_back(deal);
+            return outcome::success();
+          }));
+      EXPECT_EQ(deals, (std::vector<uint64_t>{view.sector, view.sector + 1}));
+      return true;
+    }));
+    EXPECT_EQ(visited, ids);
+  }
+
+  /**
+   * @given market proposals and states of actor versions 0 and 3, spanning
+   * several AMT nodes, some deals without state
+   * @when visit proposal views and read states in deal id order
+   * @then deal ids, proposal fields and states are read
+   */
+  TEST_F(LightActorReader, MarketDeals) {
+    const std::vector<uint64_t> ids{1, 100, 1000, 70000};
+    for (const auto version :
+         {ActorVersion::kVersion0, ActorVersion::kVersion3}) {
+      ipld->actor_version = version;
+      adt::Array<Universal<DealProposal>, kProposalsAmtBitwidth> proposals{
+          ipld};
+      adt::Array<DealState, kStatesAmtBitwidth> states{ipld};
+      for (const auto id : ids) {
+        Universal<DealProposal> proposal{version};
+        proposal->piece_cid = "010001020001"_cid;
+        proposal->piece_size = id * 2;
+        proposal->provider = Address::makeFromId(id);
+        proposal->start_epoch = static_cast<ChainEpoch>(id);
+        proposal->end_epoch = static_cast<ChainEpoch>(id) * 3;
+        EXPECT_OUTCOME_TRUE_1(proposals.set(id, proposal));
+        if (id != 100) {
+          const auto epoch{static_cast<ChainEpoch>(id)};
+          EXPECT_OUTCOME_TRUE_1(states.set(id, {epoch, epoch + 1, -1}));
+        }
+      }
+      EXPECT_OUTCOME_TRUE(proposals_root, proposals.amt.flush());
+      EXPECT_OUTCOME_TRUE(states_root, states.amt.flush());
+
+      DealStatesCursor cursor{light_ipld, *asBlake(states_root)};
+      std::vector<uint64_t> visited;
+      EXPECT_TRUE(marketDealProposals(
+          light_ipld, *asBlake(proposals_root), [&](auto id, auto &view) {
+            visited.push_back(id);
+            EXPECT_OUTCOME_EQ(view.piece_cid.toCid(), "010001020001"_cid);
+            EXPECT_EQ(view.piece_size, id * 2);
+            const auto provider{
+                primitives::address::encode(Address::makeFromId(id))};
+            EXPECT_EQ(view.provider, BytesIn{provider});
+            EXPECT_EQ(view.start_epoch, static_cast<ChainEpoch>(id));
+            EXPECT_EQ(view.end_epoch, static_cast<ChainEpoch>(id) * 3);
+            bool found{};
+            DealStateView state;
+            EXPECT_TRUE(cursor.find(id, found, state));
+            EXPECT_EQ(found, id != 100);
+            if (found) {
+              EXPECT_EQ(state.sector_start_epoch, static_cast<ChainEpoch>(id));
+              EXPECT_EQ(state.last_updated_epoch,
+                        static_cast<ChainEpoch>(id) + 1);
+              EXPECT_EQ(state.slash_epoch, -1);
+            }
+            return true;
+          }));
+      EXPECT_EQ(visited, ids);
+    }
+  }
+
+  /**
+   * @given deadline partitions of actor versions 0 and 2
+   * @when visit partition views
+   * @then sector bitsets are read for both layouts
+   */
+  TEST_F(LightActorReader, MinerPartitions) {
+    for (const auto version :
+         {ActorVersion::kVersion0, ActorVersion::kVersion2}) {
+      ipld->actor_version = version;
+      adt::Array<Universal<Partition>, kPartitionsBitWidth> partitions{ipld};
+      for (uint64_t i{}; i < 2; ++i) {
+        Universal<Partition> partition{version};
+        partition->sectors = {i, i + 10, i + 20};
+        partition->unproven = {i + 10};
+        partition->faults = {i + 20};
+        partition->terminated = {i};
+        EXPECT_OUTCOME_TRUE_1(partitions.set(i, partition));
+      }
+      EXPECT_OUTCOME_TRUE_1(partitions.amt.flush());
+      const auto root{*asBlake(partitions.amt.cid())};
+
+      uint64_t i{};
+      EXPECT_TRUE(minerPartitions(light_ipld, root, [&](auto &view) {
+        EXPECT_OUTCOME_EQ(codec::cbor::decode<RleBitset>(view.sectors),
+                          RleBitset({i, i + 10, i + 20}));
+        EXPECT_OUTCOME_EQ(codec::cbor::decode<RleBitset>(view.faults),
+                          RleBitset({i + 20}));
+        EXPECT_OUTCOME_EQ(codec::cbor::decode<RleBitset>(view.recoveries),
+                          RleBitset{});
+        EXPECT_OUTCOME_EQ(codec::cbor::decode<RleBitset>(view.terminated),
+                          RleBitset({i}));
+        ++i;
+        return true;
+      }));
+      EXPECT_EQ(i, 2);
+    }
+  }
+
   /**
    * @given Miner Actor V2 State with fields set (miner_info, sectors,
    * deadlines)
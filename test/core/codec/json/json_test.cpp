@@ -7,6 +7,7 @@
 
 #include "api/rpc/json.hpp"
 #include "codec/json/json.hpp"
+#include "codec/json/stream.hpp"
 #include "testutil/literals.hpp"
 #include "testutil/outcome.hpp"
 
@@ -144,4 +145,39 @@ namespace fc::codec::json {
     expectJson(api::CodecSetAsMap<std::string>{s},
                R"({"a":{},"b":{},"c":{}})");
   }
+
+  /**
+   * @given vector of values and response
+   * @when JSON serialized with stream writer and small chunks
+   * @then equal to document serialization
+   */
+  TEST(ApiJsonTest, StreamEqualsDocument) {
+    auto expectStream{[](const auto &value, const Bytes &expected) {
+      EXPECT_EQ(formatStream(value), expected);
+      Bytes chunked;
+      size_t chunks{};
+      ChunkStream stream{[&](Bytes chunk) {
+                           append(chunked, chunk);
+                           ++chunks;
+                         },
+                         3};
+      writeJson(stream, value);
+      EXPECT_EQ(chunked, expected);
+      EXPECT_EQ(chunks, expected.size() / 3 + 1);
+    }};
+    const std::vector<Address> addresses{Address::makeFromId(1),
+                                         Address::makeFromId(2)};
+    expectStream(addresses, jsonEncode(encode(addresses)));
+    const std::vector<std::vector<uint64_t>> nested{{1, 2}, {}, {3}};
+    expectStream(nested, jsonEncode(encode(nested)));
+
+    api::Response response{1, {}};
+    response.result = api::Response::Stream{
+        [&](JsonWriter &writer) { writeJson(writer, addresses); }};
+    const auto expected{copy(common::span::cbytes(std::string_view{
+        R"({"jsonrpc":"2.0","id":1,"result":["t01","t02"]})"}))};
+    EXPECT_EQ(formatStream(response), expected);
+    // document is built without writing and parsing text
+    EXPECT_EQ(jsonEncode(encode(response)), expected);
+  }
 }  // namespace fc::api
@@ -8,6 +8,7 @@
 #include <gtest/gtest.h>
 #include <boost/filesystem.hpp>
 #include "common/span.hpp"
+#include "common/tar_stream.hpp"
 #include "testutil/outcome.hpp"
 #include "testutil/read_file.hpp"
 #include "testutil/resources/resources.hpp"
@@ -89,3 +90,93 @@ TEST_F(TarUtilTest, zipTar) {
 
   ASSERT_EQ(readFile(file_path), fc::common::span::cbytes(result_string));
 }
+
+/**
+ * @given sector.tar
+ * @when extract it by small chunks with TarReader
+ * @then all files are extracted. hierarchy and data do not changed.
+ */
+TEST_F(TarUtilTest, TarReader) {
+  const auto tar{readFile(resourcePath("sector.tar"))};
+  fc::common::TarReader reader{base_path};
+  const fc::BytesIn input{tar};
+  for (ptrdiff_t i{0}; i < input.size(); i += 100) {
+    EXPECT_OUTCOME_TRUE_1(reader.write(
+        input.subspan(i, std::min<ptrdiff_t>(100, input.size() - i))));
+  }
+  EXPECT_TRUE(reader.done());
+  ASSERT_TRUE(fs::exists((base_path / "Cache").string()));
+  ASSERT_TRUE(fs::exists((base_path / "Seal").string()));
+  ASSERT_TRUE(fs::exists((base_path / "Unseal").string()));
+  EXPECT_EQ(readFile((base_path / "Unseal" / "test.txt").string()),
+            fc::common::span::cbytes("some test data here\n"));
+}
+
+/**
+ * @given dir with empty dir, file, long named file
+ * @when read it with TarWriter by chunks, resuming from offset
+ * @then archive is same as read at once, extracted by TarReader and
+ * extractTar with same hierarchy and data
+ */
+TEST_F(TarUtilTest, TarWriter) {
+  const auto root_path{base_path / "test"};
+  const auto dir_path{root_path / "Cache"};
+  const auto long_path{root_path / std::string(90, 'd') / std::string(90, 'f')};
+  const auto file_path{dir_path / "test.txt"};
+  const auto long_file_path{long_path / "test.txt"};
+  const auto empty_dir_path{root_path / "Empty"};
+  const std::string result_string(1000, 'x');
+  fs::create_directories(dir_path);
+  fs::create_directories(long_path);
+  fs::create_directories(empty_dir_path);
+  std::ofstream{file_path.string()} << result_string;
+  std::ofstream{long_file_path.string()} << "test";
+
+  EXPECT_OUTCOME_TRUE(writer, fc::common::TarWriter::make(root_path));
+  EXPECT_OUTCOME_TRUE(tar, writer.read(SIZE_MAX));
+  EXPECT_EQ(tar.size(), writer.size());
+  EXPECT_EQ(tar.size() % fc::common::kTarRecordSize, 0);
+  EXPECT_OUTCOME_EQ(writer.read(100), fc::Bytes{});
+
+  // resume from offset inside file data
+  const size_t offset{1300};
+  EXPECT_OUTCOME_TRUE(writer2, fc::common::TarWriter::make(root_path));
+  EXPECT_OUTCOME_TRUE_1(writer2.seek(offset));
+  fc::Bytes resumed{tar.begin(), tar.begin() + offset};
+  while (true) {
+    EXPECT_OUTCOME_TRUE(chunk, writer2.read(7));
+    if (chunk.empty()) {
+      break;
+    }
+    fc::append(resumed, chunk);
+  }
+  EXPECT_EQ(resumed, tar);
+
+  const auto reader_path{base_path / "reader"};
+  fc::common::TarReader reader{reader_path};
+  const fc::BytesIn input{tar};
+  for (ptrdiff_t i{0}; i < input.size(); i += 300) {
+    EXPECT_OUTCOME_TRUE_1(reader.write(
+        input.subspan(i, std::min<ptrdiff_t>(300, input.size() - i))));
+  }
+  EXPECT_TRUE(reader.done());
+
+  const auto tar_path{base_path / "archive.tar"};
+  std::ofstream{tar_path.string(), std::ios::binary}.write(
+      fc::common::span::bytestr(tar).data(),
+      static_cast<std::streamsize>(tar.size()));
+  const auto extract_path{base_path / "extract"};
+  EXPECT_OUTCOME_TRUE_1(fc::common::extractTar(tar_path, extract_path));
+
+  for (const auto &path : {reader_path, extract_path}) {
+    const auto relative{[&](const fs::path &original) {
+      return path / fs::relative(original, base_path);
+    }};
+    EXPECT_TRUE(fs::is_directory(relative(empty_dir_path)));
+    EXPECT_TRUE(fs::is_empty(relative(empty_dir_path)));
+    EXPECT_EQ(readFile(relative(file_path)),
+              fc::common::span::cbytes(result_string));
+    EXPECT_EQ(readFile(relative(long_file_path)),
+              fc::common::span::cbytes("test"));
+  }
+}
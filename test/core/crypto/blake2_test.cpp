@@ -7,6 +7,7 @@
 #include <stdio.h>
 
 #include "crypto/blake2/blake2b160.hpp"
+#include "crypto/blake2/blake2b_kernel.hpp"
 #include "testutil/literals.hpp"
 
 // Deterministic sequences (Fibonacci generator).
@@ -58,3 +59,77 @@ TEST(Blake2b, Correctness) {
 
   EXPECT_EQ(memcmp(md, blake2b_res.data(), 32), 0) << "hashes are different";
 }
+
+/**
+ * @given random blocks and states
+ * @when compress with vector kernels supported by cpu
+ * @then state equals scalar kernel state
+ */
+TEST(Blake2b, KernelsMatchScalar) {
+  using namespace fc::crypto::blake2b::kernel;
+  uint8_t block[kBlock];
+  for (size_t seed{1}; seed < 16; ++seed) {
+    selftest_seq(block, kBlock, seed);
+    uint64_t expected[8], actual[8];
+    memcpy(expected, kIv, sizeof(expected));
+    compressScalar(expected, block, seed * 128, 0, seed % 2 == 0);
+#ifdef __x86_64__
+    if (hasAvx2()) {
+      memcpy(actual, kIv, sizeof(actual));
+      compressAvx2(actual, block, seed * 128, 0, seed % 2 == 0);
+      EXPECT_EQ(memcmp(actual, expected, sizeof(actual)), 0);
+    }
+    if (hasAvx512()) {
+      memcpy(actual, kIv, sizeof(actual));
+      compressAvx512(actual, block, seed * 128, 0, seed % 2 == 0);
+      EXPECT_EQ(memcmp(actual, expected, sizeof(actual)), 0);
+    }
+#endif
+  }
+}
+
+/**
+ * @given inputs of different sizes, including empty
+ * @when hash them together
+ * @then each hash equals single input hash
+ */
+TEST(Blake2b, Many) {
+  using fc::crypto::blake2b::blake2b_256;
+  std::vector<std::vector<uint8_t>> datas;
+  for (auto size : {0, 1, 3, 127, 128, 129, 255, 256, 1000, 1024, 5000}) {
+    for (size_t seed{0}; seed < 3; ++seed) {
+      auto &data{datas.emplace_back(size)};
+      selftest_seq(data.data(), data.size(), size + seed);
+    }
+  }
+  std::vector<fc::BytesIn> inputs;
+  for (auto &data : datas) {
+    inputs.emplace_back(data);
+  }
+  std::vector<fc::crypto::blake2b::Blake2b256Hash> hashes(inputs.size());
+  fc::crypto::blake2b::blake2b_256_many(inputs, hashes);
+  for (size_t i{0}; i < inputs.size(); ++i) {
+    EXPECT_EQ(hashes[i], blake2b_256(inputs[i])) << "input " << i;
+  }
+}
+
+/**
+ * @given input split into parts of different sizes
+ * @when update hash with parts
+ * @then hash equals hash of whole input
+ */
+TEST(Blake2b, UpdateParts) {
+  std::vector<uint8_t> data(1000);
+  selftest_seq(data.data(), data.size(), 7);
+  const auto expected{fc::crypto::blake2b::blake2b_256(data)};
+  for (size_t part : {1, 100, 127, 128, 129, 256, 300}) {
+    fc::crypto::blake2b::Ctx ctx{32};
+    for (size_t i{0}; i < data.size(); i += part) {
+      ctx.update(fc::BytesIn{data}.subspan(
+          i, std::min(part, data.size() - i)));
+    }
+    fc::crypto::blake2b::Blake2b256Hash actual;
+    ctx.final(actual);
+    EXPECT_EQ(actual, expected) << "part " << part;
+  }
+}
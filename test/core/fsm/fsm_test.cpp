@@ -5,6 +5,7 @@
 
 #include "fsm/fsm.hpp"
 
+#include <future>
 #include <gtest/gtest.h>
 #include <string>
 
@@ -271,4 +272,85 @@ namespace fc::fsm {
     EXPECT_TRUE(init2.has_error());
   }
 
+  /**
+   * @given parallel fsm and entity blocked in transition action
+   * @when other entity receives events
+   * @then other entity transitions are applied meanwhile
+   */
+  TEST_F(FsmTest, ParallelEntities) {
+    std::promise<void> other_stopped;
+    std::promise<void> blocked_stopped;
+    auto blocked = std::make_shared<Data>();
+    auto fsm =
+        Fsm::createParallelFsm(
+            {TransitionRule(Events::START)
+                 .from(States::READY)
+                 .to(States::WORKING)
+                 .action([&, blocked](auto data, auto, auto, auto, auto) {
+                   if (data == blocked) {
+                     auto ready{other_stopped.get_future().wait_for(
+                         std::chrono::seconds{5})};
+                     data->content = ready == std::future_status::ready
+                                         ? "unblocked"
+                                         : "timeout";
+                   }
+                 }),
+             TransitionRule(Events::STOP)
+                 .from(States::WORKING)
+                 .to(States::STOPPED)},
+            2,
+            true)
+            .value();
+    // called after state is updated
+    fsm->setAnyChangeAction([&](auto data, auto, auto, auto, auto to) {
+      if (to == States::STOPPED) {
+        (data == blocked ? blocked_stopped : other_stopped).set_value();
+      }
+    });
+    auto other = std::make_shared<Data>();
+    EXPECT_OUTCOME_TRUE_1(fsm->begin(blocked, States::READY));
+    EXPECT_OUTCOME_TRUE_1(fsm->begin(other, States::READY));
+    EXPECT_OUTCOME_TRUE_1(fsm->send(blocked, Events::START, {}));
+    EXPECT_OUTCOME_TRUE_1(fsm->send(blocked, Events::STOP, {}));
+    EXPECT_OUTCOME_TRUE_1(fsm->send(other, Events::START, {}));
+    EXPECT_OUTCOME_TRUE_1(fsm->send(other, Events::STOP, {}));
+
+    ASSERT_EQ(blocked_stopped.get_future().wait_for(std::chrono::seconds{10}),
+              std::future_status::ready);
+    EXPECT_EQ(blocked->content, "unblocked");
+    EXPECT_OUTCOME_EQ(fsm->get(blocked), States::STOPPED);
+    EXPECT_OUTCOME_EQ(fsm->get(other), States::STOPPED);
+  }
+
+  /**
+   * @given parallel fsm keeping events, events sent in reverse order
+   * @when execute
+   * @then postponed event is applied after next transition of entity
+   */
+  TEST_F(FsmTest, ParallelSendBeforeConditionMet) {
+    std::promise<void> stopped;
+    auto fsm = Fsm::createParallelFsm(
+                   {TransitionRule(Events::START)
+                        .from(States::READY)
+                        .to(States::WORKING),
+                    TransitionRule(Events::STOP)
+                        .from(States::WORKING)
+                        .to(States::STOPPED)},
+                   1,
+                   false)
+                   .value();
+    fsm->setAnyChangeAction([&](auto, auto, auto, auto, auto to) {
+      if (to == States::STOPPED) {
+        stopped.set_value();
+      }
+    });
+    auto entity = std::make_shared<Data>();
+    EXPECT_OUTCOME_TRUE_1(fsm->begin(entity, States::READY));
+    EXPECT_OUTCOME_TRUE_1(fsm->send(entity, Events::STOP, {}));
+    EXPECT_OUTCOME_TRUE_1(fsm->send(entity, Events::START, {}));
+
+    ASSERT_EQ(stopped.get_future().wait_for(std::chrono::seconds{10}),
+              std::future_status::ready);
+    EXPECT_OUTCOME_EQ(fsm->get(entity), States::STOPPED);
+  }
 }  // namespace fc::fsm
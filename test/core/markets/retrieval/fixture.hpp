@@ -78,6 +78,11 @@ namespace fc::markets::retrieval::test {
 
     MinerMockShPtr miner;
 
+    /** Unsealed pieces of provider, removed after test */
+    boost::filesystem::path unsealed_cache_dir{
+        boost::filesystem::temp_directory_path()
+        / boost::filesystem::unique_path()};
+
     DealInfo deal;
 
     /** IPFS datastore */
@@ -94,6 +99,10 @@ namespace fc::markets::retrieval::test {
 
     common::Logger logger = common::createLogger("RetrievalMarketTest");
 
+    void TearDown() override {
+      boost::filesystem::remove_all(unsealed_cache_dir);
+    }
+
     void SetUp() override {
       libp2pSoralog();
 
@@ -140,7 +149,14 @@ namespace fc::markets::retrieval::test {
           std::make_shared<fc::storage::OneKey>("config", storage_backend)};
       config_key->setCbor(config);
       provider = std::make_shared<provider::RetrievalProviderImpl>(
-          host, datatransfer, api, piece_storage, config_key, sealer, miner);
+          host,
+          datatransfer,
+          api,
+          piece_storage,
+          config_key,
+          sealer,
+          miner,
+          provider::UnsealedCache::make(unsealed_cache_dir, 1 << 20).value());
       client = std::make_shared<client::RetrievalClientImpl>(
           host, datatransfer, api, client_ipfs);
       provider->start();
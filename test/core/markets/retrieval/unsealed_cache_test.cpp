@@ -0,0 +1,118 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "markets/retrieval/provider/impl/unsealed_cache.hpp"
+
+#include <gtest/gtest.h>
+
+#include "common/file.hpp"
+#include "crypto/hasher/hasher.hpp"
+#include "primitives/cid/cid_of_cbor.hpp"
+#include "storage/car/car.hpp"
+#include "testutil/outcome.hpp"
+#include "testutil/storage/base_fs_test.hpp"
+
+namespace fc::markets::retrieval::provider {
+  using crypto::Hasher;
+  using primitives::cid::getCidOfCbor;
+
+  struct UnsealedCacheTest : test::BaseFS_Test {
+    UnsealedCacheTest() : test::BaseFS_Test("fc_unsealed_cache_test") {}
+
+    void SetUp() override {
+      const Bytes cbor{1, 2, 3};
+      cbor_cid = getCidOfCbor(cbor).value();
+      raw_cid = CID{CID::Version::V1,
+                    CID::Multicodec::RAW,
+                    Hasher::sha2_256(raw)};
+      storage::car::writeHeader(car, {cbor_cid});
+      storage::car::writeItem(car, cbor_cid, codec::cbor::encode(cbor).value());
+      storage::car::writeItem(car, raw_cid, raw);
+      // duplicate block
+      storage::car::writeItem(car, raw_cid, raw);
+      // unsealed piece is padded
+      car.resize(car.size() + 100, 0);
+    }
+
+    /** Writes car and counts unseals */
+    UnsealedCache::Unseal unseal() {
+      return [this](const std::string &path) -> outcome::result<void> {
+        ++unseals;
+        return common::writeFile(path, car);
+      };
+    }
+
+    auto cache(uint64_t max_size) {
+      return UnsealedCache::make(base_path / "cache", max_size).value();
+    }
+
+    Bytes raw{4, 5, 6};
+    CID cbor_cid;
+    CID raw_cid;
+    Bytes car;
+    CID piece1{getCidOfCbor(1).value()};
+    CID piece2{getCidOfCbor(2).value()};
+    size_t unseals{};
+  };
+
+  /**
+   * @given empty cache
+   * @when piece is requested twice
+   * @then piece is unsealed once, blocks are read from mapped car
+   */
+  TEST_F(UnsealedCacheTest, Hit) {
+    auto unsealed{cache(1 << 20)};
+    EXPECT_OUTCOME_TRUE(piece, unsealed->get(piece1, unseal()));
+    EXPECT_OUTCOME_TRUE(piece_hit, unsealed->get(piece1, unseal()));
+    EXPECT_EQ(unseals, 1);
+    EXPECT_EQ(piece, piece_hit);
+    EXPECT_EQ(piece->index->size(), 2);
+    EXPECT_OUTCOME_EQ(piece->get(raw_cid), raw);
+    EXPECT_OUTCOME_EQ(piece->get(cbor_cid),
+                      codec::cbor::encode(Bytes{1, 2, 3}).value());
+    EXPECT_OUTCOME_EQ(piece->contains(piece2), false);
+    EXPECT_OUTCOME_ERROR(storage::ipfs::IpfsDatastoreError::kNotFound,
+                         piece->get(piece2));
+  }
+
+  /**
+   * @given cache with piece and temp files of interrupted unseal
+   * @when cache is loaded again
+   * @then piece is not unsealed again, temp files are removed
+   */
+  TEST_F(UnsealedCacheTest, Restart) {
+    EXPECT_OUTCOME_TRUE_1(cache(1 << 20)->get(piece1, unseal()));
+    const auto temp{base_path / "cache" / "incomplete.car.tmp"};
+    const auto temp_index{base_path / "cache" / "incomplete.car.tmp.cids"};
+    common::writeFile(temp, car).value();
+    common::writeFile(temp_index, car).value();
+    auto unsealed{cache(1 << 20)};
+    EXPECT_FALSE(fs::exists(temp));
+    EXPECT_FALSE(fs::exists(temp_index));
+    EXPECT_GT(unsealed->size(), car.size());
+    EXPECT_OUTCOME_TRUE(piece, unsealed->get(piece1, unseal()));
+    EXPECT_EQ(unseals, 1);
+    EXPECT_OUTCOME_EQ(piece->get(raw_cid), raw);
+  }
+
+  /**
+   * @given cache fitting one piece
+   * @when second piece is cached
+   * @then first piece is evicted, its mapping is still readable
+   */
+  TEST_F(UnsealedCacheTest, Evict) {
+    EXPECT_OUTCOME_TRUE(piece, cache(1 << 20)->get(piece1, unseal()));
+    auto unsealed{cache(0)};
+    const auto piece_size{unsealed->size()};
+    unsealed = cache(piece_size * 3 / 2);
+    EXPECT_OUTCOME_TRUE_1(unsealed->get(piece2, unseal()));
+    EXPECT_EQ(unsealed->size(), piece_size);
+    EXPECT_OUTCOME_EQ(piece->get(raw_cid), raw);
+    EXPECT_OUTCOME_TRUE_1(unsealed->get(piece2, unseal()));
+    EXPECT_EQ(unseals, 2);
+    EXPECT_OUTCOME_TRUE_1(unsealed->get(piece1, unseal()));
+    EXPECT_EQ(unseals, 3);
+  }
+}  // namespace fc::markets::retrieval::provider
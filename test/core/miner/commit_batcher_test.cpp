@@ -0,0 +1,196 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+#include <libp2p/basic/scheduler/manual_scheduler_backend.hpp>
+#include <libp2p/basic/scheduler/scheduler_impl.hpp>
+
+#include "miner/storage_fsm/impl/commit_batcher_impl.hpp"
+#include "testutil/literals.hpp"
+#include "testutil/mocks/api.hpp"
+#include "testutil/mocks/proofs/proof_engine_mock.hpp"
+#include "testutil/outcome.hpp"
+#include "vm/actor/builtin/methods/miner.hpp"
+
+namespace fc::mining {
+  using api::SignedMessage;
+  using api::UnsignedMessage;
+  using libp2p::basic::ManualSchedulerBackend;
+  using libp2p::basic::SchedulerImpl;
+  using primitives::tipset::Tipset;
+  using primitives::tipset::TipsetKey;
+  using proofs::ProofEngineMock;
+  using testing::_;
+  namespace miner = vm::actor::builtin::miner;
+
+  class CommitBatcherTest : public testing::Test {
+   protected:
+    void SetUp() override {
+      scheduler_backend_ = std::make_shared<ManualSchedulerBackend>();
+      scheduler_ = std::make_shared<SchedulerImpl>(scheduler_backend_,
+                                                   Scheduler::Config{});
+
+      api::BlockHeader block;
+      block.height = kHeight;
+      EXPECT_CALL(mock_ChainHead, Call())
+          .WillRepeatedly(testing::Return(std::make_shared<Tipset>(
+              TipsetKey(), std::vector<api::BlockHeader>({block}))));
+
+      MinerInfo minfo;
+      minfo.worker = worker_;
+      EXPECT_CALL(mock_StateMinerInfo, Call(miner_address_, _))
+          .WillRepeatedly(testing::Return(minfo));
+
+      api_->MpoolPushMessage =
+          [&](const UnsignedMessage &msg,
+              const boost::optional<api::MessageSendSpec> &)
+          -> outcome::result<SignedMessage> {
+        messages_.push_back(msg);
+        return SignedMessage{.message = msg, .signature = BlsSignature()};
+      };
+
+      auto fee_config{std::make_shared<FeeConfig>()};
+      fee_config->max_commit_gas_fee = TokenAmount{"50000000000000000"};
+      fee_config->max_commit_batch_gas_fee.per_sector =
+          TokenAmount{"30000000000000000"};
+      batcher_ = std::make_shared<CommitBatcherImpl>(
+          std::chrono::seconds(60),
+          kMinAggregatedSectors,
+          kMaxAggregatedSectors,
+          api_,
+          miner_address_,
+          scheduler_,
+          [](const MinerInfo &miner_info,
+             const TokenAmount &,
+             const std::shared_ptr<FullNodeApi> &) -> outcome::result<Address> {
+            return miner_info.worker;
+          },
+          fee_config,
+          proofs_);
+    }
+
+    void addCommit(SectorNumber sector,
+                   ChainEpoch deadline = kHeight + 2 * kEpochsInDay) {
+      SectorInfo info;
+      info.sector_number = sector;
+      info.sector_type = RegisteredSealProof::kStackedDrg2KiBV1_1;
+      AggregateInput input{
+          .info = {.number = sector,
+                   .randomness = {},
+                   .interactive_randomness = {},
+                   .sealed_cid = "010001020001"_cid,
+                   .unsealed_cid = "010001020002"_cid},
+          .proof = Bytes{1, 2, 3},
+          .collateral = 10,
+          .deadline = deadline,
+      };
+      EXPECT_OUTCOME_TRUE_1(batcher_->addCommit(
+          info, input, [this](const outcome::result<CID> &cid) {
+            results_.push_back(cid);
+          }));
+    }
+
+    size_t countMethod(vm::actor::MethodNumber method) const {
+      return std::count_if(messages_.begin(),
+                           messages_.end(),
+                           [&](auto &msg) { return msg.method == method; });
+    }
+
+    static constexpr ChainEpoch kHeight{100};
+
+    std::shared_ptr<FullNodeApi> api_{std::make_shared<FullNodeApi>()};
+    std::shared_ptr<ProofEngineMock> proofs_{
+        std::make_shared<ProofEngineMock>()};
+    std::shared_ptr<ManualSchedulerBackend> scheduler_backend_;
+    std::shared_ptr<Scheduler> scheduler_;
+    std::shared_ptr<CommitBatcherImpl> batcher_;
+    Address miner_address_{Address::makeFromId(42)};
+    Address worker_{Address::makeFromId(43)};
+    std::vector<UnsignedMessage> messages_;
+    std::vector<outcome::result<CID>> results_;
+    MOCK_API(api_, StateMinerInfo);
+    MOCK_API(api_, ChainHead);
+  };
+
+  /**
+   * @given min batch of commits
+   * @when batch delay passes
+   * @then single ProveCommitAggregate is sent for all sectors
+   */
+  TEST_F(CommitBatcherTest, Aggregate) {
+    EXPECT_CALL(*proofs_, aggregateSealProofs(_, _))
+        .WillOnce(testing::Invoke([](auto &aggregate, auto &proofs) {
+          EXPECT_EQ(aggregate.infos.size(), kMinAggregatedSectors);
+          EXPECT_EQ(proofs.size(), kMinAggregatedSectors);
+          aggregate.proof = Bytes{4, 5, 6};
+          return outcome::success();
+        }));
+    for (SectorNumber sector{0}; sector < kMinAggregatedSectors; ++sector) {
+      addCommit(sector);
+    }
+    EXPECT_TRUE(messages_.empty());
+
+    scheduler_backend_->shiftToTimer();
+    ASSERT_EQ(messages_.size(), 1);
+    EXPECT_EQ(messages_[0].method, miner::ProveCommitAggregate::Number);
+    EXPECT_OUTCOME_TRUE(
+        params,
+        codec::cbor::decode<miner::ProveCommitAggregate::Params>(
+            messages_[0].params));
+    EXPECT_EQ(params.sectors.size(), kMinAggregatedSectors);
+    EXPECT_EQ(params.proof, (Bytes{4, 5, 6}));
+    ASSERT_EQ(results_.size(), kMinAggregatedSectors);
+    for (const auto &result : results_) {
+      EXPECT_EQ(result, results_[0]);
+    }
+  }
+
+  /**
+   * @given less than min batch of commits
+   * @when batch delay passes
+   * @then commits are sent one by one
+   */
+  TEST_F(CommitBatcherTest, SmallBatch) {
+    EXPECT_CALL(*proofs_, aggregateSealProofs(_, _)).Times(0);
+    addCommit(1);
+    addCommit(2);
+
+    scheduler_backend_->shiftToTimer();
+    EXPECT_EQ(countMethod(miner::ProveCommitSector::Number), 2);
+    EXPECT_EQ(results_.size(), 2);
+  }
+
+  /**
+   * @given min batch of commits
+   * @when aggregation fails
+   * @then commits are sent one by one
+   */
+  TEST_F(CommitBatcherTest, AggregateFallback) {
+    EXPECT_CALL(*proofs_, aggregateSealProofs(_, _))
+        .WillOnce(testing::Return(ERROR_TEXT("ERROR")));
+    for (SectorNumber sector{0}; sector < kMinAggregatedSectors; ++sector) {
+      addCommit(sector);
+    }
+
+    scheduler_backend_->shiftToTimer();
+    EXPECT_EQ(countMethod(miner::ProveCommitSector::Number),
+              kMinAggregatedSectors);
+    ASSERT_EQ(results_.size(), kMinAggregatedSectors);
+    for (const auto &result : results_) {
+      EXPECT_TRUE(result.has_value());
+    }
+  }
+
+  /**
+   * @given commit with precommit expiring within batch slack
+   * @when commit is added
+   * @then it is sent immediately
+   */
+  TEST_F(CommitBatcherTest, Deadline) {
+    addCommit(1, kHeight + kCommitBatchSlack);
+    EXPECT_EQ(countMethod(miner::ProveCommitSector::Number), 1);
+    EXPECT_EQ(results_.size(), 1);
+  }
+}  // namespace fc::mining
@@ -4,6 +4,7 @@
  */
 
 #include "core/miner/sealing_test_fixture.hpp"
+#include "miner/storage_fsm/impl/checks.hpp"
 #include "vm/actor/builtin/types/market/policy.hpp"
 
 namespace fc::mining {
@@ -755,4 +756,159 @@ namespace fc::mining {
     runForSteps(*context_, 100);
     EXPECT_EQ(sector->state, SealingState::kProving);
   }
+
+  /**
+   * Fixture resuming sector in Committing state with aggregated commits
+   */
+  class SealingAggregateTest : public SealingTestFixture {
+   protected:
+    void SetUp() override {
+      SealingTestFixture::SetUp();
+      config_.aggregate_commits = true;
+
+      TipsetKey key{{CbCid::hash("02"_unhex)}};
+      head_ = std::make_shared<Tipset>(
+          key, std::vector<BlockHeader>{BlockHeader{.height = 100}});
+      api_->ChainHead = [&]() -> outcome::result<TipsetCPtr> { return head_; };
+
+      info_ = std::make_shared<SectorInfo>();
+      info_->sector_number = sector_;
+      info_->state = SealingState::kCommitting;
+      info_->sector_type = seal_proof_type_;
+      info_->comm_r = "010001020010"_cid;
+      info_->comm_d = "010001020011"_cid;
+      info_->ticket = Randomness{{1, 2, 3}};
+      info_->seed = Randomness{{6, 7, 8, 9}};
+      info_->seed_epoch = precommit_epoch_ + kPreCommitChallengeDelay;
+      info_->proof = Proof{{7, 6, 5, 4, 3, 2, 1}};
+
+      // precommit of sector on chain
+      auto ipld{std::make_shared<InMemoryDatastore>()};
+      ipld->actor_version = actorVersion(version_);
+      auto actor_state = makeMinerActorState(ipld, ipld->actor_version);
+      SectorPreCommitOnChainInfo precommit;
+      precommit.info.sealed_cid = *info_->comm_r;
+      precommit.precommit_epoch = precommit_epoch_;
+      precommit.precommit_deposit = 10;
+      EXPECT_OUTCOME_TRUE_1(
+          actor_state->precommitted_sectors.set(sector_, precommit));
+      EXPECT_OUTCOME_TRUE(cid_root,
+                          actor_state->precommitted_sectors.hamt.flush());
+      const auto actor_key{"010001020003"_cid};
+      api_->ChainReadObj = [=](CID key) -> outcome::result<Bytes> {
+        if (key == actor_key) {
+          return codec::cbor::encode(actor_state);
+        }
+        if (key == cid_root) {
+          OUTCOME_TRY(root, getCbor<storage::hamt::Node>(ipld, cid_root));
+          return codec::cbor::encode(root);
+        }
+        return ERROR_TEXT("ERROR");
+      };
+      Actor actor;
+      actor.code = vm::actor::builtin::v0::kStorageMinerCodeId;
+      actor.head = actor_key;
+      api_->StateGetActor = [=](const Address &, const TipsetKey &)
+          -> outcome::result<Actor> { return actor; };
+      api_->ChainGetRandomnessFromBeacon =
+          [=](const TipsetKey &,
+              DomainSeparationTag,
+              ChainEpoch,
+              const Bytes &) -> outcome::result<Randomness> {
+        return info_->seed;
+      };
+      EXPECT_CALL(*proofs_, verifySeal(_))
+          .WillOnce(testing::Return(outcome::success(true)));
+      api_->StateMinerInitialPledgeCollateral =
+          [](const Address &,
+             const SectorPreCommitInfo &,
+             const TipsetKey &) -> outcome::result<TokenAmount> { return 30; };
+    }
+
+    /**
+     * Restarts sealing with sector saved in Committing state
+     * @return callback passed to commit batcher
+     */
+    CommitCallback resumeCommitting() {
+      CommitCallback callback;
+      EXPECT_OUTCOME_TRUE(max_duration,
+                          checks::getMaxProveCommitDuration(version_, info_));
+      EXPECT_CALL(*commit_batcher_, addCommit(_, _, _))
+          .WillOnce(testing::Invoke([&, max_duration](
+                                        const SectorInfo &sector_info,
+                                        const AggregateInput &input,
+                                        const CommitCallback &cb)
+                                        -> outcome::result<void> {
+            EXPECT_EQ(sector_info.sector_number, sector_);
+            EXPECT_EQ(input.info.number, sector_);
+            EXPECT_EQ(input.info.sealed_cid, *info_->comm_r);
+            EXPECT_EQ(input.info.unsealed_cid, *info_->comm_d);
+            EXPECT_EQ(input.proof, info_->proof);
+            EXPECT_EQ(input.collateral, 20);
+            EXPECT_EQ(input.deadline, precommit_epoch_ + max_duration);
+            callback = cb;
+            return outcome::success();
+          }));
+
+      sealing_.reset();
+      EXPECT_OUTCOME_TRUE(buf, codec::cbor::encode(*info_));
+      const std::string string_key{std::to_string(sector_)};
+      const Bytes key(string_key.begin(), string_key.end());
+      EXPECT_OUTCOME_TRUE_1(kv_->put(key, std::move(buf)));
+      EXPECT_OUTCOME_TRUE(sealing, makeSealing());
+      sealing_ = sealing;
+      return callback;
+    }
+
+    SectorNumber sector_{1};
+    ChainEpoch precommit_epoch_{10};
+    TipsetCPtr head_;
+    std::shared_ptr<SectorInfo> info_;
+  };
+
+  /**
+   * @given aggregate commits enabled, sector in Committing state
+   * @when batcher sends aggregate message
+   * @then sector waits for the message
+   */
+  TEST_F(SealingAggregateTest, CommittingToCommitWait) {
+    const auto callback{resumeCommitting()};
+    ASSERT_TRUE(callback);
+    EXPECT_OUTCOME_TRUE(sector_info, sealing_->getSectorInfo(sector_));
+    EXPECT_EQ(sector_info->state, SealingState::kCommitting);
+
+    const auto aggregate_cid{"010001020042"_cid};
+    boost::optional<CID> waited;
+    // hold message wait, so sector stays in CommitWait
+    api_->StateWaitMsg = [&](auto &&, const CID &cid, auto, auto, auto) {
+      waited = cid;
+    };
+    callback(aggregate_cid);
+    runForSteps(*context_, 100);
+
+    EXPECT_EQ(sector_info->state, SealingState::kCommitWait);
+    EXPECT_EQ(sector_info->message, aggregate_cid);
+    EXPECT_EQ(waited, aggregate_cid);
+  }
+
+  /**
+   * @given aggregate commits enabled, sector in Committing state
+   * @when batcher fails to send aggregate message
+   * @then sector fails commit
+   */
+  TEST_F(SealingAggregateTest, CommittingToCommitFail) {
+    const auto callback{resumeCommitting()};
+    ASSERT_TRUE(callback);
+    EXPECT_OUTCOME_TRUE(sector_info, sealing_->getSectorInfo(sector_));
+
+    // stop CommitFail handler, so sector stays in CommitFail
+    api_->ChainHead = []() -> outcome::result<TipsetCPtr> {
+      return ERROR_TEXT("ERROR");
+    };
+    callback(ERROR_TEXT("aggregate failed"));
+    runForSteps(*context_, 100);
+
+    EXPECT_EQ(sector_info->state, SealingState::kCommitFail);
+    EXPECT_FALSE(sector_info->message);
+  }
 }  // namespace fc::mining
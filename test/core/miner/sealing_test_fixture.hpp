@@ -20,6 +20,7 @@
 #include "testutil/default_print.hpp"
 #include "testutil/literals.hpp"
 #include "testutil/mocks/api.hpp"
+#include "testutil/mocks/miner/commit_batcher_mock.hpp"
 #include "testutil/mocks/miner/events_mock.hpp"
 #include "testutil/mocks/miner/precommit_batcher_mock.hpp"
 #include "testutil/mocks/miner/precommit_policy_mock.hpp"
@@ -130,28 +131,9 @@ namespace fc::mining {
       scheduler_ = std::make_shared<SchedulerImpl>(scheduler_backend_,
                                                    Scheduler::Config{});
       precommit_batcher_ = std::make_shared<PreCommitBatcherMock>();
+      commit_batcher_ = std::make_shared<CommitBatcherMock>();
 
-      EXPECT_OUTCOME_TRUE(sealing,
-                          SealingImpl::newSealing(
-                              api_,
-                              events_,
-                              miner_addr_,
-                              counter_,
-                              kv_,
-                              manager_,
-                              policy_,
-                              context_,
-                              scheduler_,
-                              precommit_batcher_,
-                              [=](const MinerInfo &miner_info,
-                                  const TokenAmount &good_funds,
-                                  const std::shared_ptr<FullNodeApi> &api)
-                                  -> outcome::result<Address> {
-                                return SelectAddress(
-                                    miner_info, good_funds, api);
-                              },
-                              fee_config_,
-                              config_));
+      EXPECT_OUTCOME_TRUE(sealing, makeSealing());
       sealing_ = sealing;
 
       MinerInfo minfo;
@@ -168,6 +150,30 @@ namespace fc::mining {
       context_->stop();
     }
 
+    /** Creates sealing with fixture members, restoring sectors from kv */
+    outcome::result<std::shared_ptr<SealingImpl>> makeSealing() {
+      return SealingImpl::newSealing(
+          api_,
+          events_,
+          miner_addr_,
+          counter_,
+          kv_,
+          manager_,
+          policy_,
+          context_,
+          scheduler_,
+          precommit_batcher_,
+          commit_batcher_,
+          [=](const MinerInfo &miner_info,
+              const TokenAmount &good_funds,
+              const std::shared_ptr<FullNodeApi> &api)
+              -> outcome::result<Address> {
+            return SelectAddress(miner_info, good_funds, api);
+          },
+          fee_config_,
+          config_);
+    }
+
     uint64_t update_sector_id_{2};
     RegisteredSealProof seal_proof_type_{
         RegisteredSealProof::kStackedDrg2KiBV1_1};
@@ -191,6 +197,7 @@ namespace fc::mining {
 
     std::shared_ptr<Sealing> sealing_;
     std::shared_ptr<PreCommitBatcherMock> precommit_batcher_;
+    std::shared_ptr<CommitBatcherMock> commit_batcher_;
     MOCK_API(api_, StateMinerInfo);
     MOCK_API(api_, StateNetworkVersion);
   };
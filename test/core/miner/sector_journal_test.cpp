@@ -0,0 +1,311 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "miner/storage_fsm/impl/sector_journal.hpp"
+
+#include <gtest/gtest.h>
+#include <libp2p/basic/scheduler/manual_scheduler_backend.hpp>
+#include <libp2p/basic/scheduler/scheduler_impl.hpp>
+
+#include "common/error_text.hpp"
+#include "storage/in_memory/in_memory_storage.hpp"
+#include "testutil/literals.hpp"
+#include "testutil/outcome.hpp"
+
+namespace fc::mining {
+  using libp2p::basic::ManualSchedulerBackend;
+  using libp2p::basic::SchedulerImpl;
+  using primitives::sector::RegisteredSealProof;
+  using storage::InMemoryStorage;
+
+  /** Storage with batch commit number fail_commit failing */
+  struct FailingStorage : InMemoryStorage {
+    struct Batch : BufferBatch {
+      Batch(std::unique_ptr<BufferBatch> batch, FailingStorage &storage)
+          : batch{std::move(batch)}, storage{storage} {}
+
+      outcome::result<void> put(const Bytes &key, BytesCow &&value) override {
+        return batch->put(key, std::move(value));
+      }
+
+      outcome::result<void> remove(const Bytes &key) override {
+        return batch->remove(key);
+      }
+
+      outcome::result<void> commit() override {
+        if (storage.commits++ == storage.fail_commit) {
+          return ERROR_TEXT("FailingStorage: commit failed");
+        }
+        return batch->commit();
+      }
+
+      void clear() override {
+        batch->clear();
+      }
+
+      std::unique_ptr<BufferBatch> batch;
+      FailingStorage &storage;
+    };
+
+    std::unique_ptr<BufferBatch> batch() override {
+      return std::make_unique<Batch>(InMemoryStorage::batch(), *this);
+    }
+
+    size_t commits{};
+    size_t fail_commit{SIZE_MAX};
+  };
+
+  struct SectorJournalTest : testing::Test {
+    void SetUp() override {
+      scheduler_backend_ = std::make_shared<ManualSchedulerBackend>();
+      scheduler_ = std::make_shared<SchedulerImpl>(scheduler_backend_,
+                                                   Scheduler::Config{});
+      journal_ = std::make_unique<SectorJournal>(kv_, scheduler_);
+    }
+
+    static SectorInfo makeSector(SectorNumber sector, SealingState state) {
+      SectorInfo info;
+      info.sector_number = sector;
+      info.state = state;
+      info.sector_type = RegisteredSealProof::kStackedDrg2KiBV1_1;
+      return info;
+    }
+
+    /** Reopens journal and loads sectors */
+    std::vector<std::shared_ptr<SectorInfo>> reload() {
+      journal_.reset();
+      journal_ = std::make_unique<SectorJournal>(kv_, scheduler_);
+      auto sectors{journal_->load()};
+      EXPECT_TRUE(sectors);
+      return sectors ? sectors.value()
+                     : std::vector<std::shared_ptr<SectorInfo>>{};
+    }
+
+    static Bytes key(const std::string &key) {
+      return copy(common::span::cbytes(key));
+    }
+
+    static Bytes logKey(uint64_t seq) {
+      Bytes key{0, 'l', 'o', 'g', '/'};
+      for (auto i{0}; i < 8; ++i) {
+        key.push_back(static_cast<uint8_t>(seq >> (56 - 8 * i)));
+      }
+      return key;
+    }
+
+    std::vector<SectorJournalRecord> logRecords() {
+      std::vector<SectorJournalRecord> records;
+      auto it{kv_->cursor()};
+      for (it->seekToFirst(); it->isValid(); it->next()) {
+        if (it->key()[0] == 0) {
+          records.push_back(
+              codec::cbor::decode<SectorJournalRecord>(it->value()).value());
+        }
+      }
+      return records;
+    }
+
+    std::shared_ptr<FailingStorage> kv_{std::make_shared<FailingStorage>()};
+    std::shared_ptr<ManualSchedulerBackend> scheduler_backend_;
+    std::shared_ptr<Scheduler> scheduler_;
+    std::unique_ptr<SectorJournal> journal_;
+  };
+
+  /**
+   * @given sector with several transitions
+   * @when journal is reloaded
+   * @then latest sector info is loaded and log is folded into snapshot
+   */
+  TEST_F(SectorJournalTest, Replay) {
+    auto info{makeSector(1, SealingState::kPacking)};
+    EXPECT_OUTCOME_TRUE_1(journal_->save(info));
+    info.state = SealingState::kPreCommit1;
+    info.ticket_epoch = 10;
+    EXPECT_OUTCOME_TRUE_1(journal_->save(info));
+    info.state = SealingState::kPreCommit2;
+    EXPECT_OUTCOME_TRUE_1(journal_->save(info));
+    EXPECT_OUTCOME_TRUE_1(
+        journal_->save(makeSector(2, SealingState::kProving)));
+    EXPECT_OUTCOME_TRUE_1(journal_->flush());
+    EXPECT_EQ(logRecords().size(), 4);
+
+    const auto sectors{reload()};
+    ASSERT_EQ(sectors.size(), 2);
+    EXPECT_EQ(codec::cbor::encode(*sectors[0]).value(),
+              codec::cbor::encode(info).value());
+    EXPECT_EQ(sectors[1]->state, SealingState::kProving);
+    EXPECT_TRUE(logRecords().empty());
+    EXPECT_TRUE(kv_->contains(key("1")));
+  }
+
+  /**
+   * @given saved sector
+   * @when only its state changes
+   * @then log record doesn't contain sector info
+   */
+  TEST_F(SectorJournalTest, StateOnly) {
+    auto info{makeSector(1, SealingState::kCommitting)};
+    EXPECT_OUTCOME_TRUE_1(journal_->save(info));
+    info.state = SealingState::kCommitFail;
+    EXPECT_OUTCOME_TRUE_1(journal_->save(info));
+    info.state = SealingState::kCommitting;
+    info.invalid_proofs = 1;
+    EXPECT_OUTCOME_TRUE_1(journal_->save(info));
+    EXPECT_OUTCOME_TRUE_1(journal_->flush());
+
+    const auto records{logRecords()};
+    ASSERT_EQ(records.size(), 3);
+    EXPECT_TRUE(records[0].info);
+    EXPECT_FALSE(records[1].info);
+    EXPECT_EQ(records[1].state, SealingState::kCommitFail);
+    EXPECT_TRUE(records[2].info);
+  }
+
+  /**
+   * @given few transitions
+   * @when they are saved
+   * @then they are written together after group commit delay
+   */
+  TEST_F(SectorJournalTest, GroupCommit) {
+    for (SectorNumber sector{0}; sector < 10; ++sector) {
+      EXPECT_OUTCOME_TRUE_1(
+          journal_->save(makeSector(sector, SealingState::kPacking)));
+    }
+    EXPECT_TRUE(logRecords().empty());
+    scheduler_backend_->shiftToTimer();
+    EXPECT_EQ(logRecords().size(), 10);
+  }
+
+  /**
+   * @given sector saved under key of other format
+   * @when journal is loaded
+   * @then sector is moved to sector number key
+   */
+  TEST_F(SectorJournalTest, Migrate) {
+    const auto info{makeSector(7, SealingState::kProving)};
+    const auto legacy_key{key("empty_sector")};
+    EXPECT_OUTCOME_TRUE_1(
+        kv_->put(legacy_key, codec::cbor::encode(info).value()));
+
+    const auto sectors{reload()};
+    ASSERT_EQ(sectors.size(), 1);
+    EXPECT_EQ(codec::cbor::encode(*sectors[0]).value(),
+              codec::cbor::encode(info).value());
+    EXPECT_FALSE(kv_->contains(legacy_key));
+    EXPECT_TRUE(kv_->contains(key("7")));
+  }
+
+  /**
+   * @given log record of sector without snapshot
+   * @when journal is loaded and sector is saved
+   * @then record is removed, and new record follows its sequence
+   */
+  TEST_F(SectorJournalTest, UnknownSectorLog) {
+    const SectorJournalRecord record{9, SealingState::kProving, {}};
+    EXPECT_OUTCOME_TRUE_1(
+        kv_->put(logKey(5), codec::cbor::encode(record).value()));
+
+    EXPECT_TRUE(reload().empty());
+    EXPECT_FALSE(kv_->contains(logKey(5)));
+
+    EXPECT_OUTCOME_TRUE_1(
+        journal_->save(makeSector(1, SealingState::kPacking)));
+    EXPECT_OUTCOME_TRUE_1(journal_->flush());
+    EXPECT_TRUE(kv_->contains(logKey(6)));
+  }
+
+  /**
+   * @given sector
+   * @when precommit message cid is saved
+   * @then it is written without group commit delay
+   */
+  TEST_F(SectorJournalTest, MessageWrittenAtOnce) {
+    auto info{makeSector(1, SealingState::kPreCommitting)};
+    EXPECT_OUTCOME_TRUE_1(journal_->save(info));
+    EXPECT_TRUE(logRecords().empty());
+
+    info.state = SealingState::kPreCommittingWait;
+    info.precommit_message = "010001020001"_cid;
+    EXPECT_OUTCOME_TRUE_1(journal_->save(info));
+    EXPECT_EQ(logRecords().size(), 2);
+
+    info.state = SealingState::kWaitSeed;
+    EXPECT_OUTCOME_TRUE_1(journal_->save(info));
+    EXPECT_EQ(logRecords().size(), 2);
+  }
+
+  /**
+   * @given sector with kSnapshotInterval transitions
+   * @when they are written
+   * @then log is folded into snapshot, and log continues after it
+   */
+  TEST_F(SectorJournalTest, FoldLog) {
+    auto info{makeSector(1, SealingState::kPacking)};
+    for (size_t i{0}; i < SectorJournal::kSnapshotInterval; ++i) {
+      info.state = i % 2 == 0 ? SealingState::kCommitting
+                              : SealingState::kCommitFail;
+      EXPECT_OUTCOME_TRUE_1(journal_->save(info));
+    }
+    EXPECT_OUTCOME_TRUE_1(journal_->flush());
+    EXPECT_TRUE(logRecords().empty());
+    EXPECT_OUTCOME_TRUE(snapshot, kv_->get(key("1")));
+    EXPECT_EQ(snapshot, codec::cbor::encode(info).value());
+
+    info.state = SealingState::kCommitting;
+    EXPECT_OUTCOME_TRUE_1(journal_->save(info));
+    EXPECT_OUTCOME_TRUE_1(journal_->flush());
+    EXPECT_EQ(logRecords().size(), 1);
+
+    const auto sectors{reload()};
+    ASSERT_EQ(sectors.size(), 1);
+    EXPECT_EQ(sectors[0]->state, SealingState::kCommitting);
+  }
+
+  /**
+   * @given kSnapshotInterval transitions
+   * @when batch with records and then fold batch fail to commit
+   * @then log is kept, and fold is retried by next flush
+   */
+  TEST_F(SectorJournalTest, FailedCommit) {
+    auto info{makeSector(1, SealingState::kPacking)};
+    auto save{[&](size_t count) {
+      for (size_t i{0}; i < count; ++i) {
+        info.state = info.state == SealingState::kCommitting
+                         ? SealingState::kCommitFail
+                         : SealingState::kCommitting;
+        EXPECT_OUTCOME_TRUE_1(journal_->save(info));
+      }
+    }};
+    save(SectorJournal::kSnapshotInterval - 1);
+    EXPECT_OUTCOME_TRUE_1(journal_->flush());
+    const auto written{logRecords().size()};
+    EXPECT_EQ(written, SectorJournal::kSnapshotInterval - 1);
+
+    // records are lost, but log is not folded
+    kv_->fail_commit = kv_->commits;
+    save(1);
+    EXPECT_OUTCOME_FALSE_1(journal_->flush());
+    EXPECT_EQ(logRecords().size(), written);
+    EXPECT_FALSE(kv_->contains(key("1")));
+
+    // records are written, fold fails
+    kv_->fail_commit = kv_->commits + 1;
+    save(1);
+    EXPECT_OUTCOME_TRUE_1(journal_->flush());
+    EXPECT_EQ(logRecords().size(), written + 1);
+    EXPECT_FALSE(kv_->contains(key("1")));
+
+    // fold includes info of lost record
+    save(1);
+    EXPECT_OUTCOME_TRUE_1(journal_->flush());
+    EXPECT_TRUE(logRecords().empty());
+    EXPECT_OUTCOME_TRUE(snapshot, kv_->get(key("1")));
+    EXPECT_EQ(snapshot, codec::cbor::encode(info).value());
+
+    const auto sectors{reload()};
+    ASSERT_EQ(sectors.size(), 1);
+    EXPECT_EQ(sectors[0]->state, info.state);
+  }
+}  // namespace fc::mining
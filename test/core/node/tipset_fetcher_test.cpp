@@ -0,0 +1,189 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "node/tipset_fetcher.hpp"
+
+#include <gtest/gtest.h>
+
+#include "testutil/peer_id.hpp"
+
+namespace fc::sync {
+  using Clock = TipsetFetcher::Clock;
+  using std::chrono::milliseconds;
+
+  /** Sent request, handle is dropped when request is cancelled */
+  struct Sent {
+    PeerId peer;
+    TipsetKey tsk;
+    std::weak_ptr<void> handle;
+  };
+
+  class TipsetFetcherTest : public testing::Test {
+   public:
+    TipsetKey key(uint8_t i) {
+      return TipsetKey{{CbCid::hash(Bytes{i})}};
+    }
+
+    /** Mocked peers with their heights */
+    std::vector<std::pair<PeerId, ChainEpoch>> peers;
+    std::vector<Sent> sent;
+    TipsetFetcher fetcher{
+        [this](const PeerId &peer, const TipsetKey &tsk) {
+          auto handle{std::make_shared<int>()};
+          sent.push_back({peer, tsk, handle});
+          return handle;
+        },
+        [this](ChainEpoch height, const auto &f) {
+          for (const auto &[peer, peer_height] : peers) {
+            if (peer_height >= height && !f(peer)) {
+              break;
+            }
+          }
+        }};
+    PeerId a{generatePeerId(1)};
+    PeerId b{generatePeerId(2)};
+    PeerId c{generatePeerId(3)};
+    Clock::time_point now{Clock::now()};
+  };
+
+  /**
+   * @given peers with different response times
+   * @when fetch tipsets
+   * @then unknown peers are tried first, then the fastest one
+   */
+  TEST_F(TipsetFetcherTest, ChoosePeer) {
+    peers = {{a, 10}, {b, 10}, {c, 10}};
+    const std::vector<std::pair<PeerId, milliseconds>> responses{
+        {a, milliseconds{1000}},
+        {b, milliseconds{10}},
+        {c, milliseconds{100}},
+    };
+    uint8_t i{};
+    for (const auto &[peer, elapsed] : responses) {
+      EXPECT_TRUE(fetcher.fetch(key(i), 10, a, now));
+      ASSERT_EQ(sent.size(), i + 1u);
+      EXPECT_EQ(sent.back().peer, peer);
+      fetcher.onResponse(key(i), peer, 1, now + elapsed);
+      ++i;
+    }
+    EXPECT_EQ(fetcher.size(), 0);
+
+    EXPECT_TRUE(fetcher.fetch(key(i), 10, a, now));
+    EXPECT_EQ(sent.back().peer, b);
+  }
+
+  /**
+   * @given peer behind needed height
+   * @when fetch tipset announced by other peer
+   * @then peer behind is not asked
+   */
+  TEST_F(TipsetFetcherTest, PeerHeight) {
+    peers = {{b, 5}};
+    EXPECT_TRUE(fetcher.fetch(key(1), 10, a, now));
+    fetcher.onResponse(key(1), a, 0, now);
+    fetcher.tick(now);
+    EXPECT_EQ(sent.size(), 1);
+    EXPECT_EQ(fetcher.size(), 0);
+  }
+
+  /**
+   * @given peers returning different count of parents
+   * @when fetch tipsets
+   * @then peers are ranked by time per returned tipset
+   */
+  TEST_F(TipsetFetcherTest, PartialResponse) {
+    peers = {{a, 10}, {b, 10}};
+    EXPECT_TRUE(fetcher.fetch(key(1), 10, a, now));
+    EXPECT_EQ(sent.back().peer, a);
+    // full depth
+    fetcher.onResponse(
+        key(1), a, TipsetFetcher::kDepth, now + milliseconds{500});
+    EXPECT_TRUE(fetcher.fetch(key(2), 10, a, now));
+    EXPECT_EQ(sent.back().peer, b);
+    // faster response, but only requested tipset
+    fetcher.onResponse(key(2), b, 1, now + milliseconds{50});
+
+    EXPECT_TRUE(fetcher.fetch(key(3), 10, b, now));
+    EXPECT_EQ(sent.back().peer, a);
+  }
+
+  /**
+   * @given peer response without requested tipset
+   * @when fetcher ticks
+   * @then another peer is asked, and failed peer is penalized
+   */
+  TEST_F(TipsetFetcherTest, RetryOtherPeer) {
+    peers = {{a, 10}, {b, 10}};
+    EXPECT_TRUE(fetcher.fetch(key(1), 10, a, now));
+    EXPECT_EQ(sent.back().peer, a);
+    fetcher.onResponse(key(1), a, 0, now);
+    EXPECT_TRUE(sent.back().handle.expired());
+    EXPECT_EQ(fetcher.size(), 1);
+
+    fetcher.tick(now);
+    ASSERT_EQ(sent.size(), 2);
+    EXPECT_EQ(sent.back().peer, b);
+    EXPECT_EQ(sent.back().tsk, key(1));
+    fetcher.onResponse(key(1), b, 1, now + milliseconds{10});
+    EXPECT_EQ(fetcher.size(), 0);
+
+    // penalized peer is slower than known one
+    EXPECT_TRUE(fetcher.fetch(key(2), 10, a, now));
+    EXPECT_EQ(sent.back().peer, b);
+  }
+
+  /**
+   * @given slow peer
+   * @when hedge time passes
+   * @then another peer is asked, first response wins
+   */
+  TEST_F(TipsetFetcherTest, HedgeSlowPeer) {
+    peers = {{a, 10}, {b, 10}};
+    EXPECT_TRUE(fetcher.fetch(key(1), 10, a, now));
+    fetcher.tick(now + TipsetFetcher::kHedgeMin - milliseconds{1});
+    EXPECT_EQ(sent.size(), 1);
+
+    fetcher.tick(now + TipsetFetcher::kHedgeMin);
+    ASSERT_EQ(sent.size(), 2);
+    EXPECT_EQ(sent[1].peer, b);
+    EXPECT_FALSE(sent[0].handle.expired());
+
+    fetcher.onResponse(key(1), b, 1, now + TipsetFetcher::kHedgeMin);
+    EXPECT_EQ(fetcher.size(), 0);
+    EXPECT_TRUE(sent[0].handle.expired());
+    EXPECT_TRUE(sent[1].handle.expired());
+
+    // late response is ignored
+    fetcher.onResponse(key(1), a, 1, now + TipsetFetcher::kExpiry);
+    EXPECT_EQ(fetcher.size(), 0);
+  }
+
+  /**
+   * @given peer not responding
+   * @when expiry time passes
+   * @then fetch is dropped
+   */
+  TEST_F(TipsetFetcherTest, Expiry) {
+    EXPECT_TRUE(fetcher.fetch(key(1), 10, a, now));
+    fetcher.tick(now + TipsetFetcher::kExpiry);
+    EXPECT_EQ(fetcher.size(), 0);
+    EXPECT_TRUE(sent.back().handle.expired());
+  }
+
+  /**
+   * @given peer with max requests in flight
+   * @when fetch other tipset
+   * @then peer is asked only if it announced tipset
+   */
+  TEST_F(TipsetFetcherTest, BusyPeer) {
+    peers = {{a, 10}};
+    for (uint8_t i{}; i < TipsetFetcher::kMaxFetchPerPeer; ++i) {
+      EXPECT_TRUE(fetcher.fetch(key(i), 10, boost::none, now));
+    }
+    EXPECT_FALSE(fetcher.fetch(key(10), 10, boost::none, now));
+    EXPECT_TRUE(fetcher.fetch(key(10), 10, a, now));
+    EXPECT_EQ(sent.size(), TipsetFetcher::kMaxFetchPerPeer + 1);
+  }
+}  // namespace fc::sync
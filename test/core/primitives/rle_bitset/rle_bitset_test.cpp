@@ -6,6 +6,7 @@
 #include "primitives/rle_bitset/rle_bitset.hpp"
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include "testutil/cbor.hpp"
 
 /**
@@ -32,3 +33,64 @@ TEST(RleBitsetTest, Runs) {
   expect({1}, {1, 1});
   expect({1, 2}, {1, 2});
 }
+
+/// Set operations on runs match std::set semantics
+TEST(RleBitsetTest, SetOperations) {
+  using fc::primitives::RleBitset;
+  const RleBitset a{0, 1, 2, 5, 6, 9};
+  const RleBitset b{1, 2, 3, 6, 10};
+  EXPECT_EQ(a.runs(), (RleBitset::Runs{0, 3, 2, 2, 2, 1}));
+  EXPECT_EQ(a.size(), 6);
+  EXPECT_EQ(a + b, (RleBitset{0, 1, 2, 3, 5, 6, 9, 10}));
+  EXPECT_EQ(a - b, (RleBitset{0, 5, 9}));
+  EXPECT_EQ(a.intersect(b), (RleBitset{1, 2, 6}));
+  EXPECT_EQ(a.cut(b), (RleBitset{0, 2, 5}));
+  EXPECT_EQ(a.slice(2, 3), (RleBitset{2, 5, 6}));
+  EXPECT_TRUE(a.contains(RleBitset{1, 5, 9}));
+  EXPECT_FALSE(a.contains(b));
+  EXPECT_TRUE(a.containsAny(b));
+  EXPECT_FALSE(a.containsAny(RleBitset{3, 4, 7}));
+  EXPECT_TRUE(a.has(5));
+  EXPECT_FALSE(a.has(4));
+  EXPECT_EQ(std::vector<uint64_t>(a.find(5), a.end()),
+            (std::vector<uint64_t>{5, 6, 9}));
+}
+
+/// Insert and erase keep runs canonical
+TEST(RleBitsetTest, InsertErase) {
+  using fc::primitives::RleBitset;
+  RleBitset set;
+  for (auto i : {3, 4, 5, 1, 0, 2}) {
+    EXPECT_TRUE(set.insert(i));
+  }
+  EXPECT_FALSE(set.insert(4));
+  EXPECT_EQ(set.runs(), (RleBitset::Runs{0, 6}));
+  EXPECT_EQ(set.erase(3), 1);
+  EXPECT_EQ(set.erase(3), 0);
+  EXPECT_EQ(set.erase(5), 1);
+  EXPECT_EQ(set.runs(), (RleBitset::Runs{0, 3, 1, 1}));
+  EXPECT_EQ(set.size(), 4);
+  EXPECT_EQ(set, RleBitset::fromRuns({0, 0, 0, 3, 1, 1, 3}));
+}
+
+/// Large contiguous bitset encodes and decodes without expanding bits
+TEST(RleBitsetTest, LargeRunsCbor) {
+  using fc::primitives::RleBitset;
+  const auto set{RleBitset::fromRuns({0, 1000000, 10, 2000000})};
+  EXPECT_EQ(set.size(), 3000000);
+  expectEncodeAndReencode(set, "480498b0470530510f"_unhex);
+}
+
+/// Largest bit is read from runs, iterator is forward only
+TEST(RleBitsetTest, Back) {
+  using fc::primitives::RleBitset;
+  RleBitset set{3, 4, 9};
+  EXPECT_EQ(set.back(), 9);
+  set.erase(9);
+  EXPECT_EQ(set.back(), 4);
+  set += RleBitset::fromRuns({100, 5});
+  EXPECT_EQ(set.back(), 104);
+  set -= RleBitset{104};
+  EXPECT_EQ(set.back(), 103);
+  EXPECT_EQ(*std::max_element(set.begin(), set.end()), set.back());
+}
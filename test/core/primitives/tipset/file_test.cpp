@@ -167,6 +167,12 @@ namespace fc::primitives::tipset::chain::file {
 
     load({}, 1);
     EXPECT_EQ(branch->chain.size(), 1);
+    // height index points to hashes in mapped file
+    const auto &updater{*branch->updater};
+    EXPECT_EQ(updater.offsets.size(), updater.counts.size() + 1);
+    EXPECT_EQ(updater.mappedAt(0), gsl::make_span(&genesis, 1));
+    EXPECT_TRUE(updater.mappedAt(1).empty());
+    EXPECT_EQ(updater.mappedAt(2), gsl::make_span(head0));
     branch->lazy->min_load = 1;
     update(head2);
     EXPECT_EQ(branch->chain.size(), 4);
@@ -8,6 +8,7 @@
 #include "storage/ipfs/impl/in_memory_datastore.hpp"
 
 #include <gtest/gtest.h>
+#include <thread>
 #include "testutil/literals.hpp"
 #include "testutil/outcome.hpp"
 
@@ -58,4 +59,53 @@ namespace fc::primitives::tipset {
     }
   }
 
+  /**
+   * @given lazy tipset with cache index
+   * @when tipset is evicted and loaded lazily again
+   * @then stale index is counted, tipset is reloaded with new index
+   */
+  TEST_F(CacheLoadTest, StaleIndex) {
+    EXPECT_OUTCOME_TRUE(res, cache_load_->loadWithCacheInfo(keys_[0]));
+    const TsLazy lazy{keys_[0], res.index};
+
+    // evicts first tipset, it was not used
+    for (size_t i{1}; i < keys_.size(); ++i) {
+      EXPECT_OUTCOME_TRUE_1(cache_load_->load(keys_[i]));
+    }
+    EXPECT_OUTCOME_TRUE(ts, cache_load_->lazyLoad(lazy));
+    EXPECT_EQ(ts->key, keys_[0]);
+    const auto stats{cache_load_->stats()};
+    EXPECT_EQ(stats.stale, 1);
+    EXPECT_EQ(stats.misses, 5);
+    EXPECT_EQ(stats.size, size_);
+  }
+
+  /**
+   * @given sharded cache smaller than tipset count
+   * @when tipsets are loaded by several threads
+   * @then loaded tipsets match keys, cache size stays in capacity
+   */
+  TEST_F(CacheLoadTest, ConcurrentReaders) {
+    const auto cache{std::make_shared<TsLoadCache>(ipld_load_, size_, 2)};
+    std::vector<std::thread> threads;
+    for (size_t t{0}; t < 4; ++t) {
+      threads.emplace_back([&, t] {
+        for (size_t i{0}; i < 1000; ++i) {
+          const auto &key{keys_[(i + t) % keys_.size()]};
+          TsLazy lazy{key, 0};
+          const auto ts{cache->lazyLoad(lazy)};
+          EXPECT_TRUE(ts && ts.value()->key == key);
+          const auto ts2{cache->lazyLoad(lazy)};
+          EXPECT_TRUE(ts2 && ts2.value()->key == key);
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    const auto stats{cache->stats()};
+    EXPECT_LE(stats.size, size_ + 1);
+    EXPECT_GT(stats.hits, 0);
+    EXPECT_GT(stats.misses, 0);
+  }
 }  // namespace fc::primitives::tipset
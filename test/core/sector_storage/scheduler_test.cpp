@@ -15,14 +15,19 @@
 #include "sector_storage/scheduler_utils.hpp"
 #include "storage/in_memory/in_memory_storage.hpp"
 #include "testutil/mocks/sector_storage/selector_mock.hpp"
+#include "testutil/mocks/sector_storage/stores/sector_index_mock.hpp"
 #include "testutil/mocks/sector_storage/worker_estimator_mock.hpp"
 #include "testutil/mocks/sector_storage/worker_mock.hpp"
 #include "testutil/outcome.hpp"
 
 namespace fc::sector_storage {
+  using primitives::SectorNumber;
+  using primitives::StoragePath;
   using primitives::WorkerInfo;
   using primitives::WorkerResources;
   using storage::InMemoryStorage;
+  using stores::SectorIndexMock;
+  using stores::SectorStorageInfo;
   using ::testing::_;
 
   MATCHER_P(workerNameMatcher, worker_name, "compare workers name") {
@@ -478,6 +483,9 @@ namespace fc::sector_storage {
     EXPECT_CALL(*worker, getInfo)
         .WillRepeatedly(
             testing::Return(primitives::WorkerInfo{.hostname = name}));
+    EXPECT_CALL(*worker, getAccessiblePaths())
+        .WillRepeatedly(testing::Return(
+            std::vector<StoragePath>{{.id = "storage" + name}}));
 
     std::unique_ptr<WorkerHandle> worker_handle =
         std::make_unique<WorkerHandle>();
@@ -501,7 +509,14 @@ namespace fc::sector_storage {
 
       estimator_ = std::make_shared<EstimatorMock>();
 
-      EXPECT_OUTCOME_TRUE(scheduler, EstimateSchedulerImpl::newScheduler(io_, kv_, estimator_));
+      index_ = std::make_shared<SectorIndexMock>();
+      EXPECT_CALL(*index_, storageFindSector(_, _, _))
+          .WillRepeatedly(
+              testing::Return(std::vector<SectorStorageInfo>{}));
+
+      EXPECT_OUTCOME_TRUE(
+          scheduler,
+          EstimateSchedulerImpl::newScheduler(io_, kv_, estimator_, index_));
 
       scheduler_ = scheduler;
 
@@ -531,6 +546,7 @@ namespace fc::sector_storage {
     std::shared_ptr<boost::asio::io_context> io_;
     std::shared_ptr<SelectorMock> selector_;
     std::shared_ptr<EstimatorMock> estimator_;
+    std::shared_ptr<SectorIndexMock> index_;
     std::shared_ptr<Scheduler> scheduler_;
   };
 
@@ -670,4 +686,198 @@ namespace fc::sector_storage {
 
     io_->run_one();
   }
+
+  /**
+   * 3 workers with wid: 0, 1, 2
+   * Selector sorts by ids
+   * All workers don't have time data, worker i has access to "storage<i>",
+   * only worker 2 has access to sector
+   *
+   * Worker 2 should be chosen, others have to fetch sector
+   */
+  TEST_F(WorkersTest, Locality) {
+    auto task_type = primitives::kTTFinalize;
+
+    SectorRef sector{.id = SectorId{
+                         .miner = 42,
+                         .sector = 1,
+                     },
+                     .proof_type = RegisteredSealProof::kStackedDrg2KiBV1};
+
+    EXPECT_CALL(*estimator_, getTime(_, _))
+        .WillRepeatedly(testing::Return(boost::none));
+
+    EXPECT_CALL(*index_, storageFindSector(sector.id, _, _))
+        .WillRepeatedly(testing::Return(
+            std::vector<SectorStorageInfo>{{.id = "storage2"}}));
+
+    auto prepare = [&](auto &worker) -> outcome::result<CallId> {
+      EXPECT_OUTCOME_TRUE(info, worker->getInfo());
+      if (info.hostname != "2") {
+        return ERROR_TEXT("wrong worker was assigned");
+      }
+
+      return CallId{};
+    };
+
+    EXPECT_OUTCOME_TRUE_1(scheduler_->schedule(
+        sector,
+        task_type,
+        selector_,
+        prepare,
+        [](auto &worker) -> outcome::result<CallId> {
+          return ERROR_TEXT("must not be called");
+        },
+        [](const outcome::result<CallResult> &res) {
+          FAIL() << "must not be called";
+        },
+        kDefaultTaskPriority,
+        boost::none));
+
+    io_->run_one();
+  }
+
+  /**
+   * Simulates 2 workers running one PreCommit2 at a time.
+   * Worker 0 takes 10 seconds, worker 1 takes 1000 seconds.
+   * Commit1 doesn't need threads, so it fits next to PreCommit2.
+   */
+  class CostModelTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+      io_ = std::make_shared<boost::asio::io_context>();
+
+      estimator_ = std::make_shared<EstimatorMock>();
+      EXPECT_CALL(*estimator_, getTime(_, _))
+          .WillRepeatedly(testing::Return(boost::none));
+      EXPECT_CALL(*estimator_, getTime(0, primitives::kTTPreCommit2))
+          .WillRepeatedly(testing::Return(boost::make_optional(1e4)));
+      EXPECT_CALL(*estimator_, getTime(1, primitives::kTTPreCommit2))
+          .WillRepeatedly(testing::Return(boost::make_optional(1e6)));
+      EXPECT_CALL(*estimator_, startWork(_, _, _)).Times(testing::AnyNumber());
+      EXPECT_CALL(*estimator_, finishWork(_)).Times(testing::AnyNumber());
+
+      auto index = std::make_shared<SectorIndexMock>();
+      EXPECT_CALL(*index, storageFindSector(_, _, _))
+          .WillRepeatedly(
+              testing::Return(std::vector<SectorStorageInfo>{}));
+
+      EXPECT_OUTCOME_TRUE(scheduler,
+                          EstimateSchedulerImpl::newScheduler(
+                              io_,
+                              std::make_shared<InMemoryStorage>(),
+                              estimator_,
+                              index));
+      scheduler_ = scheduler;
+
+      for (size_t i = 0; i < 2; i++) {
+        auto worker_handle =
+            newWorker(std::to_string(i), std::make_shared<WorkerMock>());
+        worker_handle->info.resources.cpus = 1;
+        scheduler_->newWorker(std::move(worker_handle));
+      }
+
+      selector_ = std::make_shared<SelectorMock>();
+      EXPECT_CALL(*selector_, is_satisfying(_, _, _))
+          .WillRepeatedly(testing::Return(outcome::success(true)));
+      EXPECT_CALL(*selector_, is_preferred(_, _, _))
+          .WillRepeatedly(testing::Invoke(
+              [](auto, auto &lhs, auto &rhs) { return lhs < rhs; }));
+    }
+
+    /** Schedules task, records worker hostname when its work starts */
+    void schedule(SectorNumber sector,
+                  TaskType task_type,
+                  uint64_t priority,
+                  std::string &hostname) {
+      SectorRef ref{.id = SectorId{.miner = 42, .sector = sector},
+                    .proof_type = RegisteredSealProof::kStackedDrg2KiBV1};
+      EXPECT_OUTCOME_TRUE_1(scheduler_->schedule(
+          ref,
+          task_type,
+          selector_,
+          WorkerAction(),
+          [&hostname, id{ref.id}](auto &worker) -> outcome::result<CallId> {
+            EXPECT_OUTCOME_TRUE(info, worker->getInfo());
+            hostname = info.hostname;
+            return CallId{.sector = id, .id = std::to_string(id.sector)};
+          },
+          [](const outcome::result<CallResult> &res) {},
+          priority,
+          boost::none));
+    }
+
+    std::shared_ptr<boost::asio::io_context> io_;
+    std::shared_ptr<SelectorMock> selector_;
+    std::shared_ptr<EstimatorMock> estimator_;
+    std::shared_ptr<Scheduler> scheduler_;
+  };
+
+  /**
+   * @given worker 0 running PreCommit2
+   * @when other PreCommit2 and Finalize with lower priority are scheduled
+   * @then PreCommit2 waits for worker 0 instead of slow idle worker 1,
+   * Finalize is backfilled to worker 1, as it cannot finish before worker 0
+   * is free
+   */
+  TEST_F(CostModelTest, WaitForFasterWorker) {
+    std::string first, second, finalize;
+    schedule(1, primitives::kTTPreCommit2, 1, first);
+    schedule(2, primitives::kTTPreCommit2, 1, second);
+    schedule(3, primitives::kTTFinalize, 0, finalize);
+    io_->poll();
+    io_->restart();
+    EXPECT_EQ(first, "0");
+    EXPECT_EQ(second, "");
+    EXPECT_EQ(finalize, "1");
+
+    EXPECT_OUTCOME_TRUE_1(scheduler_->returnResult(
+        CallId{.sector = SectorId{.miner = 42, .sector = 1}, .id = "1"}, {}));
+    io_->poll();
+    EXPECT_EQ(second, "0");
+  }
+
+  /**
+   * @given worker 0 running PreCommit2 and reserved for other PreCommit2
+   * @when Commit1 with lower priority, which worker 0 finishes in 1 ms, is
+   * scheduled
+   * @then Commit1 is backfilled to reserved worker 0, as it finishes before
+   * worker 0 is free
+   */
+  TEST_F(CostModelTest, BackfillShortTask) {
+    EXPECT_CALL(*estimator_, getTime(0, primitives::kTTCommit1))
+        .WillRepeatedly(testing::Return(boost::make_optional(1.0)));
+    EXPECT_CALL(*estimator_, getTime(1, primitives::kTTCommit1))
+        .WillRepeatedly(testing::Return(boost::make_optional(1e6)));
+    std::string first, second, commit;
+    schedule(1, primitives::kTTPreCommit2, 1, first);
+    schedule(2, primitives::kTTPreCommit2, 1, second);
+    schedule(3, primitives::kTTCommit1, 0, commit);
+    io_->poll();
+    EXPECT_EQ(first, "0");
+    EXPECT_EQ(second, "");
+    EXPECT_EQ(commit, "0");
+  }
+
+  /**
+   * @given worker 0 running PreCommit2 and reserved for other PreCommit2
+   * @when Commit1 with lower priority, which worker 0 finishes in 100
+   * seconds, is scheduled
+   * @then Commit1 is refused by reserved worker 0, as it would delay waiting
+   * PreCommit2, and is assigned to slower worker 1
+   */
+  TEST_F(CostModelTest, RefuseBackfillLongTask) {
+    EXPECT_CALL(*estimator_, getTime(0, primitives::kTTCommit1))
+        .WillRepeatedly(testing::Return(boost::make_optional(1e5)));
+    EXPECT_CALL(*estimator_, getTime(1, primitives::kTTCommit1))
+        .WillRepeatedly(testing::Return(boost::make_optional(1e6)));
+    std::string first, second, commit;
+    schedule(1, primitives::kTTPreCommit2, 1, first);
+    schedule(2, primitives::kTTPreCommit2, 1, second);
+    schedule(3, primitives::kTTCommit1, 0, commit);
+    io_->poll();
+    EXPECT_EQ(first, "0");
+    EXPECT_EQ(second, "");
+    EXPECT_EQ(commit, "1");
+  }
 }  // namespace fc::sector_storage
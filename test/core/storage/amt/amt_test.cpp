@@ -155,7 +155,7 @@ TEST_F(AmtVisitTest, VisitError) {
 }
 
 /*
- * walk visits amt values
+ * walk visits amt values with their indices
  */
 TEST_F(AmtVisitTest, Walk) {
   using namespace fc;
@@ -167,8 +167,10 @@ TEST_F(AmtVisitTest, Walk) {
   EXPECT_TRUE(walk.next(value));
   EXPECT_FALSE(walk.empty());
   EXPECT_EQ(value, BytesIn{items[0].second});
+  EXPECT_EQ(walk.index, static_cast<uint64_t>(items[0].first));
   EXPECT_TRUE(walk.next(value));
   EXPECT_TRUE(walk.empty());
   EXPECT_EQ(value, BytesIn{items[1].second});
+  EXPECT_EQ(walk.index, static_cast<uint64_t>(items[1].first));
   EXPECT_FALSE(walk.next(value));
 }
@@ -6,7 +6,9 @@
 #include "storage/car/cids_index/util.hpp"
 
 #include <future>
+#include <thread>
 
+#include "codec/uvarint.hpp"
 #include "common/io_thread.hpp"
 #include "primitives/cid/cid_of_cbor.hpp"
 #include "storage/ipld/cids_ipld.hpp"
@@ -148,4 +150,118 @@ namespace fc::storage::cids_index {
     EXPECT_OUTCOME_EQ(getCbor<int>(ipld, c1), 1);
     EXPECT_OUTCOME_EQ(getCbor<int>(ipld, c2), 2);
   }
+
+  /** Values are viewed from mapped car without copy */
+  TEST_F(CidsIndexTest, View) {
+    ipld = *load(true);
+    const auto key{*asBlake(setCbor(ipld, value1).value())};
+    const auto cbor{codec::cbor::encode(value1).value()};
+    EXPECT_EQ(ipld->view(key)->value, cbor);
+    ipld->carFlush();
+    EXPECT_EQ(ipld->view(key)->value, cbor);
+
+    ipld = *load(false);
+    const auto view{ipld->view(key)};
+    EXPECT_EQ(view->value, cbor);
+    EXPECT_EQ(view->owner, ipld->car_map);
+    EXPECT_FALSE(ipld->view(*asBlake(cid2)));
+  }
+
+  /** Items flushed after car was mapped are read without remapping */
+  TEST_F(CidsIndexTest, ReadPastMapping) {
+    ipld = *load(true);
+    const auto map{ipld->car_map};
+    const auto key{*asBlake(setCbor(ipld, value1).value())};
+    ipld->carFlush();
+    const auto view{ipld->view(key)};
+    EXPECT_EQ(view->value, codec::cbor::encode(value1).value());
+    EXPECT_NE(view->owner, ipld->car_map);
+    EXPECT_EQ(ipld->car_map, map);
+  }
+
+  /** Index and mapped car are limited by max memory */
+  TEST_F(CidsIndexTest, MaxMemory) {
+    ipld = *load(true);
+    std::vector<CID> cids;
+    for (auto i{0}; i < 100; ++i) {
+      cids.push_back(setCbor(ipld, i).value());
+    }
+    ipld->carFlush();
+    // index is generated in runs of few rows
+    const size_t max_memory{1000};
+    ipld = *loadOrCreateWithProgress(
+        car_path, false, max_memory, nullptr, nullptr);
+    EXPECT_TRUE(std::dynamic_pointer_cast<SparseIndex>(ipld->index));
+    EXPECT_LE(ipld->car_map->size(), max_memory);
+    for (auto i{0}; i < (int)cids.size(); ++i) {
+      EXPECT_OUTCOME_EQ(getCbor<int>(ipld, cids[i]), i);
+    }
+    EXPECT_FALSE(ipld->view(*asBlake(cid2)));
+  }
+
+  /** Concurrent readers get consistent values */
+  TEST_F(CidsIndexTest, ConcurrentGet) {
+    ipld = *load(true);
+    std::vector<CID> cids;
+    for (auto i{0}; i < 100; ++i) {
+      cids.push_back(setCbor(ipld, i).value());
+    }
+    ipld->carFlush();
+    ipld = *load(false);
+    std::vector<std::thread> threads;
+    std::atomic_size_t errors{};
+    for (auto t{0}; t < 4; ++t) {
+      threads.emplace_back([&] {
+        for (auto i{0}; i < (int)cids.size(); ++i) {
+          const auto value{getCbor<int>(ipld, cids[i])};
+          if (!value || value.value() != i) {
+            ++errors;
+          }
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    EXPECT_EQ(errors, 0);
+  }
+
+  /** Rows sorted by threads are same as sorted by one thread */
+  TEST_F(CidsIndexTest, ParallelSort) {
+    std::vector<Row> rows(300000);
+    for (size_t i{0}; i < rows.size(); ++i) {
+      rows[i].key = CbCid::hash(Bytes{static_cast<uint8_t>(i % 251)});
+      rows[i].offset = i;
+      rows[i].max_size64 = 1;
+    }
+    auto expected{rows};
+    std::sort(expected.begin(), expected.end());
+    parallelSort(rows, 5);
+    EXPECT_EQ(rows, expected);
+  }
+
+  /**
+   * @given car with item length above limit
+   * @when scan car
+   * @then error is returned instead of stopping silently
+   */
+  TEST_F(CidsIndexTest, ItemTooLarge) {
+    Bytes car;
+    codec::uvarint::VarintEncoder varint{kMaxCarItem + 1};
+    append(car, varint.bytes());
+    car.resize(car.size() + 8);
+    std::fstream rows_file{cids_path,
+                           std::ios::in | std::ios::out | std::ios::binary
+                               | std::ios::trunc};
+    std::vector<MergeRange> ranges;
+    EXPECT_OUTCOME_FALSE_1(readCar(car,
+                                   0,
+                                   car.size(),
+                                   size_t{64} << 20,
+                                   nullptr,
+                                   nullptr,
+                                   rows_file,
+                                   ranges,
+                                   1));
+  }
 }  // namespace fc::storage::cids_index
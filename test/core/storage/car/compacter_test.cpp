@@ -128,4 +128,15 @@ namespace fc::storage::compacter {
     EXPECT_FALSE(compacter->asyncStart());
     runOne();
   }
+
+  TEST_F(CompacterTest, ParallelWalk) {
+    compacter->walk_threads = 4;
+    compacter->open();
+    EXPECT_TRUE(compacter->asyncStart());
+    runOne();
+    runOne();
+    EXPECT_FALSE(compacter->use_new_ipld);
+    EXPECT_NE(compacter->old_ipld, old_ipld);
+    EXPECT_TRUE(compacter->old_ipld->has(*asBlake(head->getParentStateRoot())));
+  }
 }  // namespace fc::storage::compacter
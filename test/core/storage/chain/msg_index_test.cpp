@@ -0,0 +1,93 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/chain/msg_index.hpp"
+
+#include <gtest/gtest.h>
+
+#include "storage/car/car.hpp"
+#include "storage/in_memory/in_memory_storage.hpp"
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "testutil/resources/resources.hpp"
+
+namespace fc::storage::blockchain {
+  using primitives::tipset::HeadChangeType;
+  using vm::message::UnsignedMessage;
+
+  struct Msg {
+    CID cid;
+    UnsignedMessage msg;
+  };
+
+  auto tipsetMessages(IpldPtr ipld, TipsetCPtr ts) {
+    std::vector<Msg> msgs;
+    ts->visitMessages({ipld, false, true},
+                      [&](auto, auto, auto &cid, auto, auto msg) {
+                        msgs.push_back({cid, *msg});
+                        return outcome::success();
+                      })
+        .value();
+    return msgs;
+  }
+
+  auto ipld{std::make_shared<ipfs::InMemoryDatastore>()};
+  auto ts_load{std::make_shared<primitives::tipset::TsLoadIpld>(ipld)};
+  auto car_roots{car::loadCar(*ipld, resourcePath("mpool.car")).value()};
+  auto ts0{ts_load->load(*TipsetKey::make(car_roots)).value()};
+  auto msgs0{tipsetMessages(ipld, ts0)};
+  auto ts1{ts_load->load(ts0->getParents()).value()};
+  auto msgs1{tipsetMessages(ipld, ts1)};
+
+  bool contains(const std::vector<CID> &cids, const CID &cid) {
+    return std::find(cids.begin(), cids.end(), cid) != cids.end();
+  }
+
+  /**
+   * @given index initialized with tipset
+   * @when child tipset is applied and reverted
+   * @then executed and included messages are found only while applied
+   */
+  TEST(MsgIndex, ApplyRevert) {
+    ASSERT_FALSE(msgs0.empty());
+    ASSERT_FALSE(msgs1.empty());
+    const auto &msg0{msgs0[0]};
+    const auto &msg1{msgs1[0]};
+    MsgIndex index{ts_load, ipld, std::make_shared<InMemoryStorage>()};
+
+    index.onHeadChange({HeadChangeType::CURRENT, ts1}).value();
+    EXPECT_TRUE(index.covers(ts1, ts1->height()));
+    EXPECT_FALSE(index.covers(ts1, 0));
+    EXPECT_FALSE(index.find(msg1.cid).value());
+    EXPECT_TRUE(contains(
+        index.list(msg1.msg.from, msg1.msg.to, ts1->height(), ts1->height())
+            .value(),
+        msg1.cid));
+
+    index.onHeadChange({HeadChangeType::APPLY, ts0}).value();
+    EXPECT_TRUE(index.covers(ts0, ts1->height()));
+    const auto found{index.find(msg1.cid).value()};
+    ASSERT_TRUE(found);
+    EXPECT_EQ(found->ts, ts0->key);
+    EXPECT_EQ(found->height, ts0->height());
+    EXPECT_TRUE(contains(
+        index.list(msg0.msg.from, msg0.msg.to, ts1->height(), ts0->height())
+            .value(),
+        msg0.cid));
+    EXPECT_FALSE(contains(
+        index.list(msg0.msg.from, msg0.msg.to, ts1->height(), ts1->height())
+            .value(),
+        msg0.cid));
+
+    index.onHeadChange({HeadChangeType::REVERT, ts0}).value();
+    EXPECT_FALSE(index.covers(ts0, ts1->height()));
+    for (const auto &msg : msgs1) {
+      EXPECT_FALSE(index.find(msg.cid).value());
+    }
+    EXPECT_FALSE(contains(
+        index.list(msg0.msg.from, msg0.msg.to, ts1->height(), ts0->height())
+            .value(),
+        msg0.cid));
+  }
+}  // namespace fc::storage::blockchain
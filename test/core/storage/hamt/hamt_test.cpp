@@ -56,6 +56,25 @@ namespace fc::storage::hamt {
     EXPECT_OUTCOME_ERROR(HamtError::kExpectedCID, codec::cbor::encode(n));
   }
 
+  /** Bitmap of bit width 8 node is 256 bits wide */
+  TEST_F(HamtTest, NodeCborWide) {
+    Node n{{}, false};
+    n.items[255] = "010000020000"_cid;
+    expectEncodeAndReencode(
+        n,
+        "825820"
+        "8000000000000000000000000000000000000000000000000000000000000000"
+        "81a16130d82a4700010000020000"_unhex);
+    EXPECT_EQ(n.items.find(17), n.items.end());
+
+    n.items[3] = "010000020000"_cid;
+    EXPECT_EQ(n.items.begin()->first, 3);
+    EXPECT_EQ(n.items.find(255) - n.items.begin(), 1);
+    EXPECT_EQ(n.items.erase(3), 1);
+    EXPECT_EQ(n.items.erase(3), 0);
+    EXPECT_EQ(n.items.size(), 1);
+  }
+
   /** Set-remove single element */
   TEST_F(HamtTest, SetRemoveOne) {
     EXPECT_OUTCOME_ERROR(HamtError::kNotFound, get(hamt_, "aai"));
@@ -0,0 +1,122 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "storage/ipfs/node_cache.hpp"
+
+#include <gtest/gtest.h>
+
+#include "storage/amt/amt.hpp"
+#include "storage/hamt/hamt.hpp"
+#include "storage/ipfs/impl/in_memory_datastore.hpp"
+#include "testutil/outcome.hpp"
+
+namespace fc::storage::ipfs {
+  using amt::Amt;
+  using hamt::Hamt;
+
+  auto cborInt(int64_t v) {
+    return codec::cbor::encode(v).value();
+  }
+
+  struct NodeCacheTest : ::testing::Test {
+    void SetUp() override {
+      ipld->node_cache = cache;
+    }
+
+    std::shared_ptr<NodeCache> cache{std::make_shared<NodeCache>(2)};
+    IpldPtr ipld{std::make_shared<InMemoryDatastore>()};
+  };
+
+  /** Least recently used node is evicted, type mismatch is a miss */
+  TEST_F(NodeCacheTest, Lru) {
+    const auto a{CbCid::hash(Bytes{1})};
+    const auto b{CbCid::hash(Bytes{2})};
+    const auto c{CbCid::hash(Bytes{3})};
+    cache->put(a, std::make_shared<const int>(1));
+    cache->put(b, std::make_shared<const int>(2));
+    EXPECT_EQ(*cache->get<int>(a), 1);
+    cache->put(c, std::make_shared<const int>(3));
+    EXPECT_EQ(cache->size(), 2);
+    EXPECT_EQ(cache->get<int>(b), nullptr);
+    EXPECT_EQ(*cache->get<int>(a), 1);
+    EXPECT_EQ(*cache->get<int>(c), 3);
+    EXPECT_EQ(cache->get<std::string>(a), nullptr);
+  }
+
+  /** Hamt instances share cached nodes, modification doesn't affect cache */
+  TEST_F(NodeCacheTest, Hamt) {
+    const auto key{common::span::cbytes(std::string_view{"a"})};
+    Hamt hamt{ipld, 5};
+    EXPECT_OUTCOME_TRUE_1(hamt.set(key, cborInt(1)));
+    EXPECT_OUTCOME_TRUE(root, hamt.flush());
+    EXPECT_EQ(cache->size(), 0);
+
+    Hamt hamt1{ipld, root, 5};
+    EXPECT_OUTCOME_EQ(hamt1.get(key), cborInt(1));
+    EXPECT_EQ(cache->size(), 1);
+    EXPECT_OUTCOME_TRUE_1(hamt1.set(key, cborInt(2)));
+
+    Hamt hamt2{ipld, root, 5};
+    EXPECT_OUTCOME_EQ(hamt2.get(key), cborInt(1));
+    EXPECT_EQ(cache->size(), 1);
+  }
+
+  /** Hamt reads share cached nodes, writes copy only modified path */
+  TEST_F(NodeCacheTest, HamtShared) {
+    cache = std::make_shared<NodeCache>(100);
+    ipld->node_cache = cache;
+    const auto key{[](int i) { return Bytes{static_cast<uint8_t>(i)}; }};
+    Hamt hamt{ipld, 5};
+    for (auto i{0}; i < 100; ++i) {
+      EXPECT_OUTCOME_TRUE_1(hamt.set(key(i), cborInt(i)));
+    }
+    EXPECT_OUTCOME_TRUE(root, hamt.flush());
+
+    Hamt hamt1{ipld, root, 5};
+    Hamt hamt2{ipld, root, 5};
+    for (auto i{0}; i < 100; ++i) {
+      EXPECT_OUTCOME_EQ(hamt1.get(key(i)), cborInt(i));
+      EXPECT_OUTCOME_EQ(hamt2.get(key(i)), cborInt(i));
+    }
+    const auto cached{cache->size()};
+    EXPECT_GT(cached, 1);
+    // cache, hamt1, hamt2 and this reference
+    EXPECT_EQ(cache->get<hamt::Node>(*asBlake(root)).use_count(), 4);
+
+    size_t visited{};
+    EXPECT_OUTCOME_TRUE_1(hamt2.visit([&](BytesIn, BytesIn) {
+      ++visited;
+      return outcome::success();
+    }));
+    EXPECT_EQ(visited, 100);
+    EXPECT_OUTCOME_EQ(hamt2.flush(), root);
+
+    EXPECT_OUTCOME_TRUE_1(hamt1.set(key(1), cborInt(-1)));
+    EXPECT_OUTCOME_EQ(hamt1.get(key(1)), cborInt(-1));
+    EXPECT_OUTCOME_EQ(hamt2.get(key(1)), cborInt(1));
+    EXPECT_OUTCOME_TRUE(root1, hamt1.flush());
+    EXPECT_NE(root1, root);
+    Hamt hamt3{ipld, root, 5};
+    EXPECT_OUTCOME_EQ(hamt3.get(key(1)), cborInt(1));
+    EXPECT_EQ(cache->size(), cached);
+  }
+
+  /** Amt root and nodes are cached */
+  TEST_F(NodeCacheTest, Amt) {
+    Amt amt{ipld};
+    EXPECT_OUTCOME_TRUE_1(amt.set(0, cborInt(1)));
+    EXPECT_OUTCOME_TRUE_1(amt.set(10, cborInt(2)));
+    EXPECT_OUTCOME_TRUE(root, amt.flush());
+
+    Amt amt1{ipld, root};
+    EXPECT_OUTCOME_EQ(amt1.get(10), cborInt(2));
+    EXPECT_EQ(cache->size(), 2);
+    EXPECT_OUTCOME_TRUE_1(amt1.remove(10));
+
+    Amt amt2{ipld, root};
+    EXPECT_OUTCOME_EQ(amt2.get(10), cborInt(2));
+    EXPECT_OUTCOME_EQ(amt2.count(), 2);
+  }
+}  // namespace fc::storage::ipfs
@@ -7,6 +7,7 @@
 
 #include <gtest/gtest.h>
 
+#include "crypto/blake2/blake2b160.hpp"
 #include "crypto/bls/impl/bls_provider_impl.hpp"
 #include "crypto/secp256k1/impl/secp256k1_sha256_provider_impl.hpp"
 #include "crypto/secp256k1/secp256k1_error.hpp"
@@ -277,4 +278,59 @@ namespace fc::storage::keystore {
     ASSERT_TRUE(res);
   }
 
+  /**
+   * @given Keystore and several bls and secp256k1 signatures, one of each
+   * type is wrong
+   * @when verifyBatch() called
+   * @then wrong signatures are reported, other are valid
+   */
+  TEST_F(InMemoryKeyStoreTest, VerifyBatch) {
+    std::vector<SignatureCheck> checks;
+    for (uint8_t i{0}; i < 4; ++i) {
+      Bytes data{data_};
+      data.push_back(i);
+      EXPECT_OUTCOME_TRUE(bls_signature,
+                          bls_provider_->sign(data, bls_keypair_.private_key));
+      checks.push_back({bls_address_, data, bls_signature});
+      EXPECT_OUTCOME_TRUE(
+          secp256k1_signature,
+          secp256k1_provider_->sign(crypto::blake2b::blake2b_256(data),
+                                    secp256k1_keypair_.private_key));
+      checks.push_back({secp256k1_address_, data, secp256k1_signature});
+    }
+    boost::asio::thread_pool pool{2};
+    const std::vector<bool> all_valid(checks.size(), true);
+    EXPECT_EQ(ks->verifyBatch(checks, pool, 1), all_valid);
+    EXPECT_EQ(ks->verifyBatch(checks, pool, 3), all_valid);
+
+    checks[2].data.push_back(0);
+    checks[5].data.push_back(0);
+    auto expected{all_valid};
+    expected[2] = false;
+    expected[5] = false;
+    EXPECT_EQ(ks->verifyBatch(checks, pool, 1), expected);
+    EXPECT_EQ(ks->verifyBatch(checks, pool, 3), expected);
+  }
+
+  /**
+   * @given two bls signatures swapped between their messages, so their
+   * aggregate is still valid
+   * @when verifyBatch() called
+   * @then both signatures are reported as wrong
+   */
+  TEST_F(InMemoryKeyStoreTest, VerifyBatchCancellingErrors) {
+    std::vector<SignatureCheck> checks;
+    for (uint8_t i{0}; i < 2; ++i) {
+      Bytes data{data_};
+      data.push_back(i);
+      EXPECT_OUTCOME_TRUE(bls_signature,
+                          bls_provider_->sign(data, bls_keypair_.private_key));
+      checks.push_back({bls_address_, data, bls_signature});
+    }
+    std::swap(checks[0].signature, checks[1].signature);
+    boost::asio::thread_pool pool{1};
+    const std::vector<bool> all_invalid(checks.size(), false);
+    EXPECT_EQ(ks->verifyBatch(checks, pool, 1), all_invalid);
+    EXPECT_EQ(ks->verifyBatch(checks, pool, 2), all_invalid);
+  }
 }  // namespace fc::storage::keystore
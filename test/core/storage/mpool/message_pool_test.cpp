@@ -4,6 +4,7 @@
  */
 
 #include <gtest/gtest.h>
+#include <algorithm>
 
 #include "cbor_blake/ipld_any.hpp"
 #include "storage/car/car.hpp"
@@ -134,7 +135,135 @@ namespace fc::storage::mpool {
     EXPECT_FALSE(testMpoolSelectRevert(fix, ticket_quality).empty());
   }
 
+  auto cids(const std::vector<SignedMessage> &msgs) {
+    std::vector<CID> cids;
+    for (const auto &msg : msgs) {
+      cids.push_back(msg.getCid());
+    }
+    return cids;
+  }
+
+  /** Selection index, by ticket quality for greedy and optimal selection */
+  struct MpoolSelectIndexTest : ::testing::TestWithParam<double> {};
+
+  /**
+   * @given selection index for head
+   * @when pending messages change
+   * @then select for head returns same messages as select without index
+   */
+  TEST_P(MpoolSelectIndexTest, Pending) {
+    const auto ticket_quality{GetParam()};
+    Fixture expected_fix;
+    const auto expected{testMpoolSelectRevert(expected_fix, ticket_quality)};
+    ASSERT_FALSE(expected.empty());
+    // random selection advances generator
+    const auto expected2{
+        expected_fix.mpool->select(ts1, ticket_quality).value()};
+
+    Fixture fix;
+    cacheParentState(ts0);
+    fix.setHead(ts1);
+    fix.addMsgs(msgs0, false);
+    EXPECT_EQ(cids(fix.mpool->select(ts1, ticket_quality).value()),
+              cids(expected));
+    EXPECT_EQ(cids(fix.mpool->select(ts1, ticket_quality).value()),
+              cids(expected2));
+
+    for (const auto &msg : msgs0) {
+      fix.mpool->remove(msg.message.from, msg.message.nonce);
+    }
+    EXPECT_TRUE(fix.mpool->select(ts1, ticket_quality).value().empty());
+  }
+
+  /**
+   * @given selection index for head
+   * @when tipset is applied
+   * @then index is moved to new head, and select for it returns same
+   * messages as select without index
+   */
+  TEST_P(MpoolSelectIndexTest, Apply) {
+    const auto ticket_quality{GetParam()};
+    Fixture expected_fix;
+    const auto expected{testMpoolSelectRevert(expected_fix, ticket_quality)};
+    ASSERT_FALSE(expected.empty());
+
+    Fixture fix;
+    cacheParentState(ts1);
+    cacheParentState(ts0);
+    fix.setHead(ts2);
+    // msgs1 will be removed by apply
+    fix.addMsgs(msgs1, false);
+    fix.addMsgs(msgs0, false);
+    fix.chain_store->signal(
+        {{primitives::tipset::HeadChangeType::APPLY, ts1}});
+    EXPECT_EQ(cids(fix.mpool->select(ts1, ticket_quality).value()),
+              cids(expected));
+  }
+
+  struct MpoolEstimateTest : testing::Test {
+    void SetUp() override {
+      cacheParentState(ts0);
+      fix.setHead(ts1);
+    }
+
+    auto base() {
+      return fix.mpool->estimateBase(from).value();
+    }
+
+    Fixture fix;
+    Address from{msgs0[0].message.from};
+  };
+
+  /**
+   * @given estimate base for sender
+   * @when estimate again without pending messages or head change
+   * @then base is reused
+   */
+  TEST_F(MpoolEstimateTest, CacheHit) {
+    const auto base1{base()};
+    EXPECT_EQ(base(), base1);
+  }
+
+  /**
+   * @given estimate base for sender
+   * @when pending message of sender is added or removed
+   * @then base is created again
+   */
+  TEST_F(MpoolEstimateTest, PendingChanged) {
+    const auto base1{base()};
+    fix.addMsgs(msgs0, false);
+    const auto base2{base()};
+    EXPECT_NE(base2, base1);
+    EXPECT_EQ(base(), base2);
+
+    const auto it{std::find_if(msgs0.rbegin(), msgs0.rend(), [&](auto &msg) {
+      return msg.message.from == from;
+    })};
+    fix.mpool->remove(from, it->message.nonce);
+    const auto base3{base()};
+    EXPECT_NE(base3, base2);
+    EXPECT_EQ(base(), base3);
+  }
+
+  /**
+   * @given estimate base for head
+   * @when head changes
+   * @then base is created again
+   */
+  TEST_F(MpoolEstimateTest, HeadChanged) {
+    const auto base1{base()};
+    fix.setHead(ts2);
+    fix.setHead(ts1);
+    const auto base2{base()};
+    EXPECT_NE(base2, base1);
+    EXPECT_EQ(base(), base2);
+  }
+
   INSTANTIATE_TEST_SUITE_P(MpoolSelectQualityTest,
                            MpoolSelectQualityTest,
                            ::testing::Values(0.8, 0.9));
+
+  INSTANTIATE_TEST_SUITE_P(MpoolSelectIndexTest,
+                           MpoolSelectIndexTest,
+                           ::testing::Values(0.5, 0.9));
 }  // namespace fc::storage::mpool
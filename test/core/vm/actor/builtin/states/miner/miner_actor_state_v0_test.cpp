@@ -597,6 +597,23 @@ namespace fc::vm::actor::builtin::v0::miner {
     EXPECT_OUTCOME_TRUE_1(state.allocateSectorNumber(4));
   }
 
+  /**
+   * @given sector numbers stored as large runs
+   * @when mask them
+   * @then largest sector is checked against max sector number
+   */
+  TEST_F(MinerActorStateTestV0, MaskSectorNumberRuns) {
+    EXPECT_OUTCOME_TRUE_1(
+        state.maskSectorNumbers(RleBitset::fromRuns({10, 1000, 90, 1})));
+    EXPECT_OUTCOME_ERROR(VMExitCode::kErrIllegalArgument,
+                         state.allocateSectorNumber(1100));
+    EXPECT_OUTCOME_TRUE_1(state.allocateSectorNumber(1099));
+
+    EXPECT_OUTCOME_ERROR(
+        VMExitCode::kErrIllegalArgument,
+        state.maskSectorNumbers(RleBitset::fromRuns({kMaxSectorNumber, 2})));
+  }
+
   TEST_F(MinerActorStateTestV0, CantAllocateOrMaskOutOfRange) {
     EXPECT_OUTCOME_ERROR(VMExitCode::kErrIllegalArgument,
                          state.allocateSectorNumber(kMaxSectorNumber + 1));
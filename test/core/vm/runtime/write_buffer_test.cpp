@@ -0,0 +1,74 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "vm/runtime/write_buffer.hpp"
+
+#include <gtest/gtest.h>
+
+namespace fc::vm::runtime {
+  Bytes value(size_t i, size_t size) {
+    Bytes value(size);
+    for (size_t j{0}; j < size; ++j) {
+      value[j] = static_cast<uint8_t>(i + j);
+    }
+    return value;
+  }
+
+  CbCid key(size_t i) {
+    Bytes bytes;
+    for (size_t j{0}; j < sizeof(i); ++j) {
+      bytes.push_back(static_cast<uint8_t>(i >> (8 * j)));
+    }
+    return CbCid::hash(bytes);
+  }
+
+  Bytes copy(const BytesIn *value) {
+    return {value->begin(), value->end()};
+  }
+
+  /**
+   * @given write buffer
+   * @when put many values, some larger than chunk
+   * @then values are found after table grows, missing keys are not found
+   */
+  TEST(WriteBuffer, PutFind) {
+    WriteBuffer buffer;
+    EXPECT_TRUE(buffer.empty());
+    EXPECT_FALSE(buffer.find(key(0)));
+
+    constexpr size_t kCount{5000};
+    auto size{[](size_t i) {
+      return i % 1000 == 0 ? WriteBuffer::kChunkSize + 1 : i % 100;
+    }};
+    for (size_t i{0}; i < kCount; ++i) {
+      buffer.put(key(i), value(i, size(i)));
+    }
+    EXPECT_EQ(buffer.size(), kCount);
+    for (size_t i{0}; i < kCount; ++i) {
+      const auto found{buffer.find(key(i))};
+      ASSERT_TRUE(found);
+      EXPECT_EQ(copy(found), value(i, size(i)));
+    }
+    EXPECT_FALSE(buffer.find(key(kCount)));
+
+    buffer.clear();
+    EXPECT_TRUE(buffer.empty());
+    EXPECT_EQ(buffer.chunks(), 0);
+    EXPECT_FALSE(buffer.find(key(0)));
+  }
+
+  /**
+   * @given write buffer with value
+   * @when put same key again
+   * @then first value is kept
+   */
+  TEST(WriteBuffer, PutExisting) {
+    WriteBuffer buffer;
+    buffer.put(key(1), value(1, 4));
+    buffer.put(key(1), value(2, 4));
+    EXPECT_EQ(buffer.size(), 1);
+    EXPECT_EQ(copy(buffer.find(key(1))), value(1, 4));
+  }
+}  // namespace fc::vm::runtime
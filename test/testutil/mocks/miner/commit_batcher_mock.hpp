@@ -0,0 +1,22 @@
+/**
+ * Copyright Soramitsu Co., Ltd. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <gmock/gmock.h>
+#include "miner/storage_fsm/commit_batcher.hpp"
+
+namespace fc::mining {
+
+  class CommitBatcherMock : public CommitBatcher {
+   public:
+    MOCK_METHOD3(addCommit,
+                 outcome::result<void>(const SectorInfo &,
+                                       const AggregateInput &,
+                                       const CommitCallback &));
+    MOCK_METHOD0(forceSend, void());
+  };
+
+}  // namespace fc::mining